@@ -0,0 +1,437 @@
+/***********************************************************************************
+* This file is part of The AHRS Project.                                           *
+*                                                                                  *
+* Copyright © 2020 By Nicola di Gruttola Giardino. All rights reserved.            *
+* @mail: nicoladgg@protonmail.com                                                  *
+*                                                                                  *
+* AHRS is free software: you can redistribute it and/or modify                     *
+* it under the terms of the GNU General Public License as published by             *
+* the Free Software Foundation, either version 3 of the License, or                *
+* (at your option) any later version.                                              *
+*                                                                                  *
+* AHRS is distributed in the hope that it will be useful,                          *
+* but WITHOUT ANY WARRANTY; without even the implied warranty of                   *
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the                    *
+* GNU General Public License for more details.                                     *
+*                                                                                  *
+* You should have received a copy of the GNU General Public License                *
+* along with The AHRS Project.  If not, see <https://www.gnu.org/licenses/>.       *
+*                                                                                  *
+* In case of use of this project, I ask you to mention me, to whom it may concern. *
+***********************************************************************************/
+
+/****************************************************************************************************
+* FILE NAME: bench_report.c                                                                         *
+*                                                                                                   *
+* PURPOSE: Writes benchmark results as a JSON array, one object per line, and compares a run        *
+*           against a baseline written by a previous run, relative to a reference kernel timed      *
+*           in both runs                                                                            *
+*                                                                                                   *
+* FILE REFERENCES:                                                                                  *
+*                                                                                                   *
+*   Name          I/O     Description                                                               *
+*   ----          ---     -----------                                                               *
+*   baseline      I       Reference run, see bench/Makefile                                         *
+*                                                                                                   *
+* EXTERNAL VARIABLES:                                                                               *
+*                                                                                                   *
+* Source: <bench_report.h>                                                                          *
+*                                                                                                   *
+* Name          Type        IO Description                                                          *
+* ------------- -------     -- -----------------------------                                        *
+*   BenchResult BenchResult    One measured kernel at one size                                      *
+*                                                                                                   *
+* STATIC VARIABLES:                                                                                 *
+*                                                                                                   *
+*   Name     Type       I/O      Description                                                        *
+*   ----     ----       ---      -----------                                                        *
+*   ref_a    float[][]  I        Operand of the reference kernel                                    *
+*   ref_c    float[][]  O        Product of the reference kernel                                    *
+*   ref_sink float      O        Result of the reference kernel, kept so it is not optimised out    *
+*                                                                                                   *
+* EXTERNAL REFERENCES:                                                                              *
+*                                                                                                   *
+*  Name                       Description                                                           *
+*  -------------              -----------                                                           *
+*  BENCH_UNIT                 bench_timer.h, "ns" on the host, "cycles" on the target               *
+*                                                                                                   *
+* ABNORMAL TERMINATION CONDITIONS, ERROR AND WARNING MESSAGES:                                      *
+*    iBench_Compare prints one line per regression on stderr                                        *
+*                                                                                                   *
+* ASSUMPTIONS, CONSTRAINTS, RESTRICTIONS: the baseline must have been written by vBench_Emit        *
+*                                                                                                   *
+* NOTES: see bench/Makefile                                                                         *
+*                                                                                                   *
+* REQUIREMENTS/FUNCTIONAL SPECIFICATIONS REFERENCES:                                                *
+*                                                                                                   *
+* DEVELOPMENT HISTORY:                                                                              *
+*                                                                                                   *
+*   Date          Author            Change Id     Release     Description Of Change                 *
+*   ----          ------            ---------     ------      ----------------------                *
+*   19-10-2026    AHRS Project       1               1         Split from matrix_bench.c            *
+*   19-10-2026    AHRS Project       2               1.1       Reference kernel, best of several    *
+*                                                               runs, baseline scaled by the        *
+*                                                               reference instead of absolute       *
+*                                                                                                   *
+****************************************************************************************************/
+
+/* Include Global Parameters */
+
+#include <stdio.h>
+#include <string.h>
+#include "bench_report.h"
+#include "bench_timer.h"
+
+/* Definition of Macros */
+
+#define BENCH_REF_N       16
+#define BENCH_REF_REPS    8
+#define BENCH_REF_RUNS    2000
+
+/* Define Static Variables */
+
+static float          ref_a[BENCH_REF_N][BENCH_REF_N];
+static float          ref_c[BENCH_REF_N][BENCH_REF_N];
+static volatile float ref_sink;
+
+/* Declare Prototypes */
+
+static void     fmt_fixed      (char *, size_t, double);
+static float    fRef_Kernel    (void);
+static int      iParse_Line    (const char *, char *, char *, unsigned int *, double *, double *);
+
+/********************************************************************************
+*                                                                               *
+* FUNCTION NAME: fmt_fixed                                                      *
+*                                                                               *
+* PURPOSE: Prints a positive value with 2 decimals using only integer           *
+*           formatting, newlib-nano on the target has no %f                     *
+*                                                                               *
+* ARGUMENT LIST:                                                                *
+*                                                                               *
+* Argument  Type         IO     Description                                     *
+* --------- --------     --     ---------------------------------               *
+* buf       char*        O      Destination                                     *
+* len       size_t       I      Size of buf                                     *
+* v         double       I      Value                                           *
+*                                                                               *
+* RETURN VALUE: void                                                            *
+********************************************************************************/
+static void fmt_fixed(char *buf, size_t len, double v)
+{
+    unsigned long c = (unsigned long)(v * 100.0 + 0.5);
+
+    snprintf(buf, len, "%lu.%02lu", c / 100, c % 100);
+}
+
+/********************************************************************************
+*                                                                               *
+* FUNCTION NAME: vBench_Emit                                                    *
+*                                                                               *
+* PURPOSE: Emits the results as a JSON array, one object per line               *
+*                                                                               *
+* ARGUMENT LIST:                                                                *
+*                                                                               *
+* Argument  Type         IO     Description                                     *
+* --------- --------     --     ---------------------------------               *
+* emit      BenchEmit    I      Line sink                                       *
+* res       BenchResult* I      Results                                         *
+* n         size_t       I      Number of results                               *
+*                                                                               *
+* RETURN VALUE: void                                                            *
+********************************************************************************/
+void vBench_Emit(BenchEmit emit, const BenchResult *res, size_t n)
+{
+    char   line[BENCH_LINE];
+    char   t[24];
+    char   a[24];
+    char   b[24];
+    size_t i;
+
+    emit("[\n");
+    for (i = 0; i < n; i++)
+    {
+        fmt_fixed(t, sizeof(t), res[i].per_op);
+        fmt_fixed(a, sizeof(a), res[i].allocs_per_op);
+        fmt_fixed(b, sizeof(b), res[i].bytes_per_op);
+        snprintf(line, sizeof(line),
+                 "  {\"kernel\": \"%s\", \"variant\": \"%s\", \"type\": \"float\", \"n\": %u, "
+                 "\"%s_per_op\": %s, \"allocs_per_op\": %s, \"bytes_per_op\": %s}%s\n",
+                 res[i].kernel, res[i].variant, res[i].n, BENCH_UNIT, t, a, b,
+                 (i + 1 < n) ? "," : "");
+        emit(line);
+    }
+    emit("]\n");
+}
+
+#if !defined(BENCH_NO_MAIN)
+
+/********************************************************************************
+*                                                                               *
+* FUNCTION NAME: fRef_Kernel                                                    *
+*                                                                               *
+* PURPOSE: Fixed work of the reference: BENCH_REF_REPS products of a            *
+*           BENCH_REF_N matrix by itself, plain loops on static arrays, so      *
+*           it loads, multiplies and adds like the kernels under test and       *
+*           slows down with them when the core is shared                        *
+*                                                                               *
+* ARGUMENT LIST: none                                                           *
+*                                                                               *
+* RETURN VALUE: float, one element of the product                               *
+********************************************************************************/
+static float fRef_Kernel(void)
+{
+    float acc;
+    int   r, i, j, k;
+
+    for (r = 0; r < BENCH_REF_REPS; r++)
+    {
+        for (i = 0; i < BENCH_REF_N; i++)
+        {
+            for (j = 0; j < BENCH_REF_N; j++)
+            {
+                acc = 0.0f;
+                for (k = 0; k < BENCH_REF_N; k++)
+                {
+                    acc += ref_a[i][k] * ref_a[k][j];
+                }
+                ref_c[i][j] = acc;
+            }
+        }
+        ref_a[r][r] = ref_c[r][r] * 1e-3f;
+    }
+
+    return ref_c[1][2];
+}
+
+/********************************************************************************
+*                                                                               *
+* FUNCTION NAME: vBench_Reference                                               *
+*                                                                               *
+* PURPOSE: Times the reference kernel, best of BENCH_REF_RUNS. Its entry in     *
+*           the report lets iBench_Compare scale a baseline taken on another    *
+*           machine, or on this one under another load                          *
+*                                                                               *
+* ARGUMENT LIST:                                                                *
+*                                                                               *
+* Argument  Type         IO     Description                                     *
+* --------- --------     --     ---------------------------------               *
+* res       BenchResult* O      Result, kernel "reference"                      *
+*                                                                               *
+* RETURN VALUE: void                                                            *
+********************************************************************************/
+void vBench_Reference(BenchResult *res)
+{
+    uint64_t t0;
+    double   dt;
+    double   best = -1;
+    int      i, j;
+
+    for (i = 0; i < BENCH_REF_N; i++)
+    {
+        for (j = 0; j < BENCH_REF_N; j++)
+        {
+            ref_a[i][j] = (float)((i + 2 * j) % 7) / 7.0f;
+        }
+    }
+    for (i = 0; i < BENCH_REF_RUNS; i++)
+    {
+        t0       = uBenchNow();
+        ref_sink = fRef_Kernel();
+        dt       = (double)(uBenchNow() - t0);
+        if (best < 0 || dt < best)
+        {
+            best = dt;
+        }
+    }
+
+    res->kernel        = "reference";
+    res->variant       = "matrix";
+    res->n             = BENCH_REF_N;
+    res->per_op        = best;
+    res->allocs_per_op = 0;
+    res->bytes_per_op  = 0;
+}
+
+/********************************************************************************
+*                                                                               *
+* FUNCTION NAME: vBench_Best                                                    *
+*                                                                               *
+* PURPOSE: Merges one more run of the same cases into best: the fastest time    *
+*           and the most allocations of each case                               *
+*                                                                               *
+* ARGUMENT LIST:                                                                *
+*                                                                               *
+* Argument  Type         IO     Description                                     *
+* --------- --------     --     ---------------------------------               *
+* best      BenchResult* IO     Results so far                                  *
+* res       BenchResult* I      Results of this run, same order                 *
+* n         size_t       I      Number of results                               *
+*                                                                               *
+* RETURN VALUE: void                                                            *
+********************************************************************************/
+void vBench_Best(BenchResult *best, const BenchResult *res, size_t n)
+{
+    size_t i;
+
+    for (i = 0; i < n; i++)
+    {
+        if (res[i].per_op < best[i].per_op)
+        {
+            best[i].per_op = res[i].per_op;
+        }
+        if (res[i].allocs_per_op > best[i].allocs_per_op)
+        {
+            best[i].allocs_per_op = res[i].allocs_per_op;
+            best[i].bytes_per_op  = res[i].bytes_per_op;
+        }
+    }
+}
+
+/********************************************************************************
+*                                                                               *
+* FUNCTION NAME: iParse_Line                                                    *
+*                                                                               *
+* PURPOSE: Reads one entry of a report written by vBench_Emit                   *
+*                                                                               *
+* ARGUMENT LIST:                                                                *
+*                                                                               *
+* Argument  Type         IO     Description                                     *
+* --------- --------     --     ---------------------------------               *
+* line      const char*  I      Line of the report                              *
+* kernel    char*        O      Kernel, 64 chars                                *
+* variant   char*        O      Variant, 16 chars                               *
+* size      unsigned*    O      Problem size                                    *
+* per_op    double*      O      Time per call                                   *
+* allocs    double*      O      Allocations per call                            *
+*                                                                               *
+* RETURN VALUE: int, 0 for an entry, -1 for any other line                      *
+********************************************************************************/
+static int iParse_Line(const char *line, char *kernel, char *variant, unsigned int *size,
+                       double *per_op, double *allocs)
+{
+    char   type[8];
+    char   unit[16];
+    double bytes;
+
+    if (sscanf(line, " {\"kernel\": \"%63[^\"]\", \"variant\": \"%15[^\"]\", \"type\": \"%7[^\"]\", "
+                     "\"n\": %u, \"%15[^\"]\": %lf, \"allocs_per_op\": %lf, \"bytes_per_op\": %lf",
+               kernel, variant, type, size, unit, per_op, allocs, &bytes) != 8)
+    {
+        return -1;
+    }
+
+    return 0;
+}
+
+/********************************************************************************
+*                                                                               *
+* FUNCTION NAME: iBench_Compare                                                 *
+*                                                                               *
+* PURPOSE: Compares the run with a baseline written by a previous run,          *
+*           returning the number of regressions, -1 if the file is missing.     *
+*           When both have a "reference" entry the baseline times are scaled    *
+*           by the ratio of the two references first; "worst-case" times are    *
+*           not compared. Slowdowns are printed, and counted only if strict:    *
+*           on a shared machine they are often the load of the others           *
+*                                                                               *
+* ARGUMENT LIST:                                                                *
+*                                                                               *
+* Argument  Type         IO     Description                                     *
+* --------- --------     --     ---------------------------------               *
+* path      const char*  I      Baseline file                                   *
+* res       BenchResult* I      Results of this run                             *
+* n         size_t       I      Number of results                               *
+* tol       double       I      Allowed relative slowdown, 0.25 is 25%          *
+* floor     double       I      Slowdowns below this many BENCH_UNIT are noise  *
+* strict    int          I      1 to count slowdowns as regressions             *
+*                                                                               *
+* RETURN VALUE: int                                                             *
+********************************************************************************/
+int iBench_Compare(const char *path, const BenchResult *res, size_t n, double tol, double floor,
+                   int strict)
+{
+    FILE        *f;
+    char         line[BENCH_LINE];
+    char         kernel[64];
+    char         variant[16];
+    unsigned int size;
+    double       per_op;
+    double       allocs;
+    double       scale = 1.0;
+    size_t       i;
+    int          slower = 0;
+    int          fails = 0;
+
+    f = fopen(path, "r");
+    if (f == NULL)
+    {
+        perror("failed to open baseline");
+        return -1;
+    }
+
+    while (fgets(line, sizeof(line), f) != NULL)
+    {
+        if (iParse_Line(line, kernel, variant, &size, &per_op, &allocs) != 0 ||
+            strcmp(kernel, "reference") != 0 || !(per_op > 0))
+        {
+            continue;
+        }
+        for (i = 0; i < n; i++)
+        {
+            if (strcmp(res[i].kernel, "reference") == 0 && res[i].per_op > 0)
+            {
+                scale = res[i].per_op / per_op;
+                fprintf(stderr, "reference %.2f -> %.2f %s, baseline scaled by %.2f\n",
+                        per_op, res[i].per_op, BENCH_UNIT, scale);
+            }
+        }
+    }
+    rewind(f);
+
+    while (fgets(line, sizeof(line), f) != NULL)
+    {
+        if (iParse_Line(line, kernel, variant, &size, &per_op, &allocs) != 0 ||
+            strcmp(kernel, "reference") == 0)
+        {
+            continue;
+        }
+        per_op *= scale;
+        for (i = 0; i < n; i++)
+        {
+            if (res[i].n != size || strcmp(res[i].kernel, kernel) != 0 ||
+                strcmp(res[i].variant, variant) != 0)
+            {
+                continue;
+            }
+            /* a worst case is the maximum of a run, reported but too noisy to compare */
+            if (res[i].per_op > per_op * (1.0 + tol) && res[i].per_op - per_op > floor &&
+                strcmp(variant, "worst-case") != 0)
+            {
+                fprintf(stderr, "SLOWER   %-14s n=%-2u %10.2f -> %10.2f %s/op\n",
+                        kernel, size, per_op, res[i].per_op, BENCH_UNIT);
+                slower++;
+            }
+            if (res[i].allocs_per_op > allocs + 0.005)
+            {
+                fprintf(stderr, "ALLOCS   %-14s n=%-2u %10.2f -> %10.2f allocs/op\n",
+                        kernel, size, allocs, res[i].allocs_per_op);
+                fails++;
+            }
+        }
+    }
+    fclose(f);
+
+    if (strict)
+    {
+        fails += slower;
+    }
+    else if (slower != 0)
+    {
+        fprintf(stderr, "%d kernel(s) slower than %s, not counted without -s\n", slower, path);
+    }
+
+    return fails;
+}
+
+#endif /* BENCH_NO_MAIN */
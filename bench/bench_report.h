@@ -0,0 +1,87 @@
+/***********************************************************************************
+* This file is part of The AHRS Project.                                           *
+*                                                                                  *
+* Copyright © 2020 By Nicola di Gruttola Giardino. All rights reserved.            *
+* @mail: nicoladgg@protonmail.com                                                  *
+*                                                                                  *
+* AHRS is free software: you can redistribute it and/or modify                     *
+* it under the terms of the GNU General Public License as published by             *
+* the Free Software Foundation, either version 3 of the License, or                *
+* (at your option) any later version.                                              *
+*                                                                                  *
+* AHRS is distributed in the hope that it will be useful,                          *
+* but WITHOUT ANY WARRANTY; without even the implied warranty of                   *
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the                    *
+* GNU General Public License for more details.                                     *
+*                                                                                  *
+* You should have received a copy of the GNU General Public License                *
+* along with The AHRS Project.  If not, see <https://www.gnu.org/licenses/>.       *
+*                                                                                  *
+* In case of use of this project, I ask you to mention me, to whom it may concern. *
+***********************************************************************************/
+
+/***************************************************************************************************
+*   FILENAME:  bench_report.h                                                                      *
+*                                                                                                  *
+*                                                                                                  *
+*   PURPOSE:   JSON report and baseline comparison shared by all the benchmarks                    *
+*                                                                                                  *
+*                                                                                                  *
+*                                                                                                  *
+*   GLOBAL VARIABLES:                                                                              *
+*                                                                                                  *
+*                                                                                                  *
+*   Variable        Type        Description                                                        *
+*   --------        ----        -------------------                                                *
+*   BenchResult     BenchResult One measured kernel at one size                                    *
+*   BenchEmit       function    Sink for the JSON report, one line per call                        *
+*                                                                                                  *
+*   DEVELOPMENT HISTORY :                                                                          *
+*                                                                                                  *
+*                                                                                                  *
+*   Date          Author            Change Id     Release     Description Of Change                *
+*   ----          ------            -------- -    ------      ----------------------               *
+*   19-10-2026    AHRS Project       1               1         Split from matrix_bench.c           *
+*   19-10-2026    AHRS Project       2               1.1       Reference kernel, best of runs      *
+*                                                                                                  *
+***************************************************************************************************/
+
+#ifndef BENCH_REPORT_h
+#define BENCH_REPORT_h
+
+/* Include Global Parameters */
+
+#include <stdint.h>
+#include <stddef.h>
+
+/* Definition of Macros */
+
+#define BENCH_LINE        256
+
+/*
+* BenchResult Object:
+*       kernel and variant being the benchmarked function and
+*       e.g. "alloc" (px*) or "alloc-free" (i*), n the problem size,
+*       per_op the time per call in BENCH_UNIT, allocs and bytes per call
+*/
+
+typedef struct BenchResult
+{
+    const char*  kernel;
+    const char*  variant;
+    unsigned int n;
+    double       per_op;
+    double       allocs_per_op;
+    double       bytes_per_op;
+}BenchResult;
+
+typedef void (*BenchEmit)(const char *);
+
+/* Declare Prototypes */
+
+void     vBench_Emit          (BenchEmit, const BenchResult *, size_t);
+void     vBench_Reference     (BenchResult *);
+void     vBench_Best          (BenchResult *, const BenchResult *, size_t);
+int      iBench_Compare       (const char *, const BenchResult *, size_t, double, double, int);
+
+#endif /* BENCH_REPORT_h */
@@ -0,0 +1,103 @@
+/***********************************************************************************
+* This file is part of The AHRS Project.                                           *
+*                                                                                  *
+* Copyright © 2020 By Nicola di Gruttola Giardino. All rights reserved.            *
+* @mail: nicoladgg@protonmail.com                                                  *
+*                                                                                  *
+* AHRS is free software: you can redistribute it and/or modify                     *
+* it under the terms of the GNU General Public License as published by             *
+* the Free Software Foundation, either version 3 of the License, or                *
+* (at your option) any later version.                                              *
+*                                                                                  *
+* AHRS is distributed in the hope that it will be useful,                          *
+* but WITHOUT ANY WARRANTY; without even the implied warranty of                   *
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the                    *
+* GNU General Public License for more details.                                     *
+*                                                                                  *
+* You should have received a copy of the GNU General Public License                *
+* along with The AHRS Project.  If not, see <https://www.gnu.org/licenses/>.       *
+*                                                                                  *
+* In case of use of this project, I ask you to mention me, to whom it may concern. *
+***********************************************************************************/
+
+/***************************************************************************************************
+*   FILENAME:  bench_timer.h                                                                       *
+*                                                                                                  *
+*                                                                                                  *
+*   PURPOSE:   Time base for the benchmarks: CLOCK_MONOTONIC in nanoseconds on the host,           *
+*               the DWT cycle counter on the Cortex-M7 target                                      *
+*                                                                                                  *
+*                                                                                                  *
+*   GLOBAL VARIABLES:                                                                              *
+*                                                                                                  *
+*                                                                                                  *
+*   Variable        Type        Description                                                        *
+*   --------        ----        -------------------                                                *
+*   BENCH_UNIT      macro       Name of the unit returned by uBenchNow, "ns" or "cycles"           *
+*                                                                                                  *
+*   DEVELOPMENT HISTORY :                                                                          *
+*                                                                                                  *
+*                                                                                                  *
+*   Date          Author            Change Id     Release     Description Of Change                *
+*   ----          ------            -------- -    ------      ----------------------               *
+*   19-10-2026    AHRS Project       1               1         Initial release                     *
+*                                                                                                  *
+***************************************************************************************************/
+
+#ifndef BENCH_TIMER_h
+#define BENCH_TIMER_h
+
+/* Include Global Parameters */
+
+#include <stdint.h>
+
+#if defined(__ARM_ARCH_7EM__)
+
+/* Definition of Macros */
+
+#define BENCH_UNIT       "cycles"
+#define DWT_CTRL         (*(volatile uint32_t *)0xE0001000UL)
+#define DWT_CYCCNT       (*(volatile uint32_t *)0xE0001004UL)
+#define DWT_LAR          (*(volatile uint32_t *)0xE0001FB0UL)
+#define DEMCR            (*(volatile uint32_t *)0xE000EDFCUL)
+#define DEMCR_TRCENA     (1UL << 24)
+#define DWT_CYCCNTENA    (1UL << 0)
+
+/* the F7 DWT is locked after reset, LAR must be written before enabling it */
+static inline void vBenchTimerInit(void)
+{
+    DEMCR     |= DEMCR_TRCENA;
+    DWT_LAR    = 0xC5ACCE55UL;
+    DWT_CYCCNT = 0;
+    DWT_CTRL  |= DWT_CYCCNTENA;
+}
+
+/* 32 bit counter, wraps after ~19 s at 216 MHz: keep every measured run shorter */
+static inline uint64_t uBenchNow(void)
+{
+    return DWT_CYCCNT;
+}
+
+#else
+
+#include <time.h>
+
+/* Definition of Macros */
+
+#define BENCH_UNIT       "ns"
+
+static inline void vBenchTimerInit(void)
+{
+}
+
+static inline uint64_t uBenchNow(void)
+{
+    struct timespec ts;
+
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000000ULL + (uint64_t)ts.tv_nsec;
+}
+
+#endif
+
+#endif /* BENCH_TIMER_h */
@@ -0,0 +1,1407 @@
+/***********************************************************************************
+* This file is part of The AHRS Project.                                           *
+*                                                                                  *
+* Copyright © 2020 By Nicola di Gruttola Giardino. All rights reserved.            *
+* @mail: nicoladgg@protonmail.com                                                  *
+*                                                                                  *
+* AHRS is free software: you can redistribute it and/or modify                     *
+* it under the terms of the GNU General Public License as published by             *
+* the Free Software Foundation, either version 3 of the License, or                *
+* (at your option) any later version.                                              *
+*                                                                                  *
+* AHRS is distributed in the hope that it will be useful,                          *
+* but WITHOUT ANY WARRANTY; without even the implied warranty of                   *
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the                    *
+* GNU General Public License for more details.                                     *
+*                                                                                  *
+* You should have received a copy of the GNU General Public License                *
+* along with The AHRS Project.  If not, see <https://www.gnu.org/licenses/>.       *
+*                                                                                  *
+* In case of use of this project, I ask you to mention me, to whom it may concern. *
+***********************************************************************************/
+
+/****************************************************************************************************
+* FILE NAME: kalman_bench.c                                                                         *
+*                                                                                                   *
+* PURPOSE: Runs the 2-state (position, velocity) filter of IMU.c for one million steps and          *
+*           reports time, allocations and allocated bytes per step of vKalman_Filter, with the      *
+*           full covariance filter, with the steady-state gain, with sequential updates and in      *
+*           square-root form, and of the generated straight-line filter and of the batched          *
+*           structure of arrays filter of the same model; then times predict and GPS update of the  *
+*           15-state error-state filter and predict + update of the standard and square-root UKF    *
+*           on the 2-state model, the replay of GPS fixes that arrive 200 ms late through           *
+*           KalmanHistory, the fixed-lag smoother and the IMM bank on a track that switches         *
+*           between stopping, cruising and manoeuvring, the information filter fusing three         *
+*           asynchronous sensors and the innovation gate on a track with outliers; the comparisons  *
+*           of the error-state, batched, unscented, delayed, smoothing, IMM and information         *
+*           filters with reference ones are in test/                                                *
+*                                                                                                   *
+* FILE REFERENCES:                                                                                  *
+*                                                                                                   *
+*   Name          I/O     Description                                                               *
+*   ----          ---     -----------                                                               *
+*   baseline.json I       Reference run, see bench/Makefile                                         *
+*                                                                                                   *
+* EXTERNAL VARIABLES:                                                                               *
+*                                                                                                   *
+* Source: <Kalman.h>                                                                                *
+*                                                                                                   *
+* Name          Type    IO Description                                                              *
+* ------------- ------- -- -----------------------------                                            *
+*   k           kalman     Kalman object                                                            *
+*                                                                                                   *
+* STATIC VARIABLES:                                                                                 *
+*                                                                                                   *
+*   Name     Type       I/O      Description                                                        *
+*   ----     ----       ---      -----------                                                        *
+*   out_file FILE*               Destination of the JSON report                                     *
+*   noise    float[]             Unit Gaussian samples, drawn once in main                          *
+*                                                                                                   *
+* EXTERNAL REFERENCES:                                                                              *
+*                                                                                                   *
+*  Name                       Description                                                           *
+*  -------------              -----------                                                           *
+*  uGetAllocCalls             matrix.c, number of heap allocations so far                           *
+*                                                                                                   *
+* ABNORMAL TERMINATION CONDITIONS, ERROR AND WARNING MESSAGES:                                      *
+*    exits with 1 if a step allocates, if the state is not finite or, with -s, if the step is       *
+*    slower than the baseline by more than the tolerance                                            *
+*                                                                                                   *
+* ASSUMPTIONS, CONSTRAINTS, RESTRICTIONS: host only                                                 *
+*                                                                                                   *
+* NOTES: the measurements are a constant acceleration track plus Gaussian noise, so that the        *
+*         filter does real work and the gain does not collapse to zero; the noise is drawn once     *
+*         into a table, so that the timings do not include the generator; each time is the best     *
+*         mean over chunks of a loop (see BenchChunk)                                               *
+*                                                                                                   *
+* REQUIREMENTS/FUNCTIONAL SPECIFICATIONS REFERENCES:                                                *
+*                                                                                                   *
+* DEVELOPMENT HISTORY:                                                                              *
+*                                                                                                   *
+*   Date          Author            Change Id     Release     Description Of Change                 *
+*   ----          ------            ---------     ------      ----------------------                *
+*   19-10-2026    AHRS Project       1               1         Initial release                      *
+*   19-10-2026    AHRS Project       2               1.1       Best chunk instead of the mean of    *
+*                                                               the loop, runs repeated with -r,    *
+*                                                               reference kernel                    *
+*   19-10-2026    AHRS Project       3               1.2       Reference comparisons moved to the   *
+*                                                               unit tests                          *
+*                                                                                                   *
+****************************************************************************************************/
+
+/* Include Global Parameters */
+
+#include <string.h>
+#include "bench_report.h"
+#include "bench_timer.h"
+#include "Kalman.h"
+#include "KalmanGen_CV2.h"
+#include "KalmanBatch.h"
+#include "ESKF.h"
+#include "UKF.h"
+#include "KalmanHistory.h"
+#include "KalmanSmoother.h"
+#include "KalmanIMM.h"
+#include "KalmanInfo.h"
+#include "Probe.h"
+#include "rng.h"
+
+/* Definition of Macros */
+
+#define KALMAN_STEPS     1000000UL
+#define KALMAN_DT        0.001f
+#define KALMAN_ACC       0.5f
+#define KALMAN_NOISE     4096   /* power of 2, unit Gaussian samples reused cyclically */
+
+#define RUN_FULL         0      /* vKalman_Filter */
+#define RUN_STEADY       1      /* vKalman_Filter after iKalman_SteadyState */
+#define RUN_SEQUENTIAL   2      /* vKalman_Predict + iKalman_UpdateSeq */
+#define RUN_SQRT         3      /* vKalman_Filter after iKalman_SquareRoot */
+
+#define ESKF_GPS_EVERY   1000   /* IMU samples per GPS fix, 1 Hz at 1 kHz */
+#define UKF_STEPS        100000UL
+#define DELAY_EVERY      1000   /* steps per fix of the delayed run */
+#define DELAY_STEPS      200    /* latency of each fix, 200 ms at 1 kHz */
+#define DELAY_HISTORY    256
+#define SMOOTH_STEPS     100000UL
+#define SMOOTH_LAG       50     /* epochs, 50 ms at 1 kHz */
+#define IMM_STEPS        300000UL
+#define IMM_SEGMENT      20000  /* steps of each regime of the IMM track */
+#define INFO_STEPS       100000UL
+#define GATE_STEPS       100000UL
+#define GATE_EVERY       1000   /* steps per outlier of the gated run */
+#define GATE_OUTLIER     50.0f  /* position error of an outlier, m */
+#define KALMAN_CHUNK     1000   /* steps per chunk of a timed loop, see BenchChunk */
+#define KALMAN_RESULTS   20     /* the cases, 7, 12 and 16 are second results, 19 the reference */
+
+static FILE *out_file;
+static float noise[KALMAN_NOISE];
+
+#if defined(USE_PROBES)
+static void emit_stderr(const char *s)
+{
+    fputs(s, stderr);
+}
+#endif
+
+static void emit_file(const char *s)
+{
+    fputs(s, out_file);
+}
+
+/*
+* BenchChunk Object:
+*       best mean time per op over chunks of len ops. A loop either times
+*       its calls and adds them, or calls vChunk_Step once per step and the
+*       clock is read at the end of each chunk only. A burst of other load
+*       on the machine spoils some chunks, not the best one
+*/
+
+typedef struct BenchChunk
+{
+    unsigned long len;
+    unsigned long n;
+    unsigned long steps;
+    uint64_t      t0;
+    uint64_t      acc;
+    double        best;
+}BenchChunk;
+
+static void vChunk_Init(BenchChunk *c, unsigned long len)
+{
+    c->len   = (len != 0) ? len : 1;
+    c->n     = 0;
+    c->steps = 0;
+    c->acc   = 0;
+    c->best  = -1;
+    c->t0    = uBenchNow();
+}
+
+static void vChunk_Add(BenchChunk *c, uint64_t dt, unsigned long ops)
+{
+    double per_op;
+
+    c->acc += dt;
+    c->n   += ops;
+    if (c->n >= c->len)
+    {
+        per_op = (double)c->acc / (double)c->n;
+        if (c->best < 0 || per_op < c->best)
+        {
+            c->best = per_op;
+        }
+        c->acc = 0;
+        c->n   = 0;
+    }
+}
+
+static void vChunk_Step(BenchChunk *c)
+{
+    uint64_t t;
+
+    if (++c->steps == c->len)
+    {
+        t = uBenchNow();
+        vChunk_Add(c, t - c->t0, c->steps);
+        c->t0    = t;
+        c->steps = 0;
+    }
+}
+
+static double dChunk_Best(const BenchChunk *c)
+{
+    if (c->best >= 0)
+    {
+        return c->best;
+    }
+    return (c->n != 0) ? (double)c->acc / (double)c->n : 0;
+}
+
+/********************************************************************************
+*                                                                               *
+* FUNCTION NAME: vSetup                                                         *
+*                                                                               *
+* PURPOSE: Fills in the model of one axis of IMU.c                              *
+*                                                                               *
+* ARGUMENT LIST:                                                                *
+*                                                                               *
+* Argument  Type         IO     Description                                     *
+* --------- --------     --     ---------------------------------               *
+* k         kalman*      IO     Kalman created by iKalman_Init(k, 2, 2)         *
+*                                                                               *
+* RETURN VALUE: void                                                            *
+********************************************************************************/
+static void vSetup(kalman *k)
+{
+    k->dt = KALMAN_DT;
+
+    k->A->matrix[0][0] = 1;
+    k->A->matrix[0][1] = k->dt;
+    k->A->matrix[1][1] = 1;
+
+    k->B->matrix[0][0] = k->dt * k->dt / 2;
+    k->B->matrix[1][0] = k->dt;
+
+    k->P->matrix[0][0] = 1;
+    k->P->matrix[1][1] = 1;
+
+    k->H->matrix[0][0] = 1;
+    k->H->matrix[1][1] = 1;
+
+    k->R->matrix[0][0] = 0.2f;
+    k->R->matrix[1][1] = 0.2f;
+
+    k->Q->matrix[0][0] = 1e-6f;
+    k->Q->matrix[1][1] = 1e-4f;
+}
+
+/********************************************************************************
+*                                                                               *
+* FUNCTION NAME: iRun                                                           *
+*                                                                               *
+* PURPOSE: Runs KALMAN_STEPS predict + update steps on a fresh filter           *
+*           returning the number of failed checks                               *
+*                                                                               *
+* ARGUMENT LIST:                                                                *
+*                                                                               *
+* Argument  Type         IO     Description                                     *
+* --------- --------     --     ---------------------------------               *
+* res       BenchResult* O      Result of the run                               *
+* variant   const char*  I      Name of the variant in the report               *
+* mode      int          I      RUN_FULL, RUN_STEADY, RUN_SEQUENTIAL, RUN_SQRT  *
+*                                                                               *
+* RETURN VALUE: int                                                             *
+********************************************************************************/
+static int iRun(BenchResult *res, const char *variant, int mode)
+{
+    kalman        k;
+    Matrix       *z;
+    unsigned long nz;
+    BenchChunk    c;
+    size_t        calls, bytes;
+    unsigned long i;
+    float         t;
+    int           fails = 0;
+
+    nz = 0;
+    if (iKalman_Init(&k, 2, 2) != 0)
+    {
+        fprintf(stderr, "iKalman_Init failed\n");
+        return 1;
+    }
+    vSetup(&k);
+    if (mode == RUN_STEADY && iKalman_SteadyState(&k, 100000, 1e-7f) != 0)
+    {
+        fprintf(stderr, "iKalman_SteadyState did not converge\n");
+        fails++;
+    }
+    if (mode == RUN_SQRT && iKalman_SquareRoot(&k, 1) != 0)
+    {
+        fprintf(stderr, "iKalman_SquareRoot failed\n");
+        fails++;
+    }
+    z = pxCreate(2, 1);
+
+    calls = uGetAllocCalls();
+    bytes = uGetAllocBytes();
+    vChunk_Init(&c, KALMAN_CHUNK);
+    for (i = 0; i < KALMAN_STEPS; i++)
+    {
+        t = (float)i * KALMAN_DT;
+        z->matrix[0][0] = 0.5f * KALMAN_ACC * t * t + 0.45f * noise[nz++ & (KALMAN_NOISE - 1)];
+        z->matrix[1][0] = KALMAN_ACC * t            + 0.45f * noise[nz++ & (KALMAN_NOISE - 1)];
+        if (mode == RUN_SEQUENTIAL)
+        {
+            vKalman_Predict(&k, KALMAN_DT, KALMAN_ACC);
+            iKalman_UpdateSeq(&k, z, NULL);
+        }
+        else
+        {
+            vKalman_Filter(&k, KALMAN_ACC, z);
+        }
+        vChunk_Step(&c);
+    }
+    calls = uGetAllocCalls() - calls;
+    bytes = uGetAllocBytes() - bytes;
+
+    res->kernel        = "vKalman_Filter";
+    res->variant       = variant;
+    res->n             = 2;
+    res->per_op        = dChunk_Best(&c);
+    res->allocs_per_op = (double)calls / (double)KALMAN_STEPS;
+    res->bytes_per_op  = (double)bytes / (double)KALMAN_STEPS;
+
+    if (calls != 0)
+    {
+        fprintf(stderr, "%s: vKalman_Filter allocated %lu time(s) in %lu steps\n",
+                variant, (unsigned long)calls, KALMAN_STEPS);
+        fails++;
+    }
+    if (!isfinite(k.x->matrix[0][0]) || !isfinite(k.x->matrix[1][0]))
+    {
+        fprintf(stderr, "%s: state is not finite after %lu steps\n", variant, KALMAN_STEPS);
+        fails++;
+    }
+    if (mode == RUN_STEADY && !k.steady)
+    {
+        fprintf(stderr, "%s: the filter left the steady-state mode\n", variant);
+        fails++;
+    }
+    if (mode == RUN_SQRT && (!k.sqrt || !(k.L->matrix[0][0] > 0) || !(k.L->matrix[1][1] > 0) ||
+                             k.P->matrix[0][1] != k.P->matrix[1][0]))
+    {
+        fprintf(stderr, "%s: the factor is not valid or P is not symmetric\n", variant);
+        fails++;
+    }
+
+    vDestroy(z);
+    vKalman_Destroy(&k);
+
+    return fails;
+}
+
+/********************************************************************************
+*                                                                               *
+* FUNCTION NAME: iRunGenerated                                                  *
+*                                                                               *
+* PURPOSE: Same run as iRun with the generated straight-line filter, checking   *
+*           that it ends in the state of the generic sequential filter          *
+*           returning the number of failed checks                               *
+*                                                                               *
+* ARGUMENT LIST:                                                                *
+*                                                                               *
+* Argument  Type         IO     Description                                     *
+* --------- --------     --     ---------------------------------               *
+* res       BenchResult* O      Result of the run                               *
+*                                                                               *
+* RETURN VALUE: int                                                             *
+********************************************************************************/
+static int iRunGenerated(BenchResult *res)
+{
+    KalmanGen_CV2 g = {0};
+    kalman        k;
+    unsigned long nz;
+    Matrix       *z;
+    float         zg[2];
+    BenchChunk    c;
+    unsigned long i;
+    float         t;
+    int           fails = 0;
+
+    iKalman_Init(&k, 2, 2);
+    vSetup(&k);
+    z = pxCreate(2, 1);
+
+    g.dt      = KALMAN_DT;
+    g.P[0][0] = k.P->matrix[0][0];
+    g.P[1][1] = k.P->matrix[1][1];
+    g.q[0]    = k.Q->matrix[0][0];
+    g.q[1]    = k.Q->matrix[1][1];
+    g.r[0]    = k.R->matrix[0][0];
+    g.r[1]    = k.R->matrix[1][1];
+
+    nz = 0;
+    vChunk_Init(&c, KALMAN_CHUNK);
+    for (i = 0; i < KALMAN_STEPS; i++)
+    {
+        t = (float)i * KALMAN_DT;
+        zg[0] = 0.5f * KALMAN_ACC * t * t + 0.45f * noise[nz++ & (KALMAN_NOISE - 1)];
+        zg[1] = KALMAN_ACC * t            + 0.45f * noise[nz++ & (KALMAN_NOISE - 1)];
+        vKalmanGen_CV2_Predict(&g, KALMAN_ACC);
+        vKalmanGen_CV2_Update(&g, zg, NULL);
+        vChunk_Step(&c);
+    }
+
+    res->kernel        = "vKalmanGen_CV2";
+    res->variant       = "generated";
+    res->n             = 2;
+    res->per_op        = dChunk_Best(&c);
+    res->allocs_per_op = 0;
+    res->bytes_per_op  = 0;
+
+    /* reference: the generic filter on the first steps of the same track */
+    nz = 0;
+    memset(&g.x, 0, sizeof(g.x));
+    g.P[0][0] = k.P->matrix[0][0];
+    g.P[0][1] = g.P[1][0] = 0;
+    g.P[1][1] = k.P->matrix[1][1];
+    for (i = 0; i < 1000; i++)
+    {
+        t = (float)i * KALMAN_DT;
+        zg[0] = z->matrix[0][0] = 0.5f * KALMAN_ACC * t * t + 0.45f * noise[nz++ & (KALMAN_NOISE - 1)];
+        zg[1] = z->matrix[1][0] = KALMAN_ACC * t            + 0.45f * noise[nz++ & (KALMAN_NOISE - 1)];
+        vKalmanGen_CV2_Predict(&g, KALMAN_ACC);
+        vKalmanGen_CV2_Update(&g, zg, NULL);
+        vKalman_Predict(&k, KALMAN_DT, KALMAN_ACC);
+        iKalman_UpdateSeq(&k, z, NULL);
+    }
+    if (fabsf(g.x[0] - k.x->matrix[0][0]) > 1e-4f * (1 + fabsf(g.x[0])) ||
+        fabsf(g.x[1] - k.x->matrix[1][0]) > 1e-4f * (1 + fabsf(g.x[1])))
+    {
+        fprintf(stderr, "generated: state %g %g differs from the generic filter %g %g\n",
+                g.x[0], g.x[1], k.x->matrix[0][0], k.x->matrix[1][0]);
+        fails++;
+    }
+
+    vDestroy(z);
+    vKalman_Destroy(&k);
+
+    return fails;
+}
+
+/********************************************************************************
+*                                                                               *
+* FUNCTION NAME: iRunESKF                                                       *
+*                                                                               *
+* PURPOSE: Runs the error-state filter at rest for KALMAN_STEPS IMU samples at  *
+*           1 kHz with a GPS fix every ESKF_GPS_EVERY samples, timing predict   *
+*           and update separately and checking that P stays finite              *
+*           returning the number of failed checks                               *
+*                                                                               *
+* ARGUMENT LIST:                                                                *
+*                                                                               *
+* Argument  Type         IO     Description                                     *
+* --------- --------     --     ---------------------------------               *
+* res       BenchResult* O      Two results, predict and update                 *
+*                                                                               *
+* RETURN VALUE: int                                                             *
+********************************************************************************/
+static int iRunESKF(BenchResult *res)
+{
+    static ESKF   f;
+    const float   bg[3] = {0.01f, -0.02f, 0.005f};
+    const float   ba[3] = {0.05f, 0.0f, -0.03f};
+    float         gyro[3], acc[3], pos[3], vel[3];
+    uint64_t      t0;
+    BenchChunk    tp, tu;
+    unsigned long nz;
+    unsigned long i;
+    int           j;
+    int           fails = 0;
+
+    vESKF_Init(&f, NULL);
+
+    nz = 0;
+    vChunk_Init(&tp, KALMAN_CHUNK);
+    vChunk_Init(&tu, KALMAN_CHUNK / ESKF_GPS_EVERY * 10);
+    for (i = 0; i < KALMAN_STEPS; i++)
+    {
+        for (j = 0; j < 3; j++)
+        {
+            gyro[j] = bg[j] + 0.002f * noise[nz++ & (KALMAN_NOISE - 1)];
+            acc[j]  = ba[j] + 0.02f * noise[nz++ & (KALMAN_NOISE - 1)];
+        }
+        acc[2] -= ESKF_GRAVITY;
+
+        t0  = uBenchNow();
+        vESKF_Predict(&f, gyro, acc, KALMAN_DT);
+        vChunk_Add(&tp, uBenchNow() - t0, 1);
+
+        if ((i + 1) % ESKF_GPS_EVERY == 0)
+        {
+            for (j = 0; j < 3; j++)
+            {
+                pos[j] = 1.0f * noise[nz++ & (KALMAN_NOISE - 1)];
+                vel[j] = 0.1f * noise[nz++ & (KALMAN_NOISE - 1)];
+            }
+            t0 = uBenchNow();
+            if (iESKF_UpdateGPS(&f, pos, vel, 1.0f, 0.01f) != 0)
+            {
+                fprintf(stderr, "eskf: iESKF_UpdateGPS failed at step %lu\n", i);
+                fails++;
+                break;
+            }
+            vChunk_Add(&tu, uBenchNow() - t0, 1);
+        }
+    }
+
+    res[0].kernel        = "vESKF_Predict";
+    res[0].variant       = "block-sparse";
+    res[0].n             = ESKF_N;
+    res[0].per_op        = dChunk_Best(&tp);
+    res[0].allocs_per_op = 0;
+    res[0].bytes_per_op  = 0;
+    res[1].kernel        = "iESKF_UpdateGPS";
+    res[1].variant       = "sequential";
+    res[1].n             = ESKF_N;
+    res[1].per_op        = dChunk_Best(&tu);
+    res[1].allocs_per_op = 0;
+    res[1].bytes_per_op  = 0;
+
+    for (j = 0; j < ESKF_N; j++)
+    {
+        if (!(f.P[j][j] > 0) || !isfinite(f.P[j][j]))
+        {
+            fprintf(stderr, "eskf: P[%d][%d] = %g\n", j, j, f.P[j][j]);
+            fails++;
+        }
+    }
+
+    return fails;
+}
+
+/********************************************************************************
+*                                                                               *
+* FUNCTION NAME: iUkfProcess                                                    *
+*                                                                               *
+* PURPOSE: Process model of the UKF run, Y = A*X + B*u for all the sigma        *
+*           points in one product, A and B being those of the kalman in ctx     *
+*                                                                               *
+* ARGUMENT LIST:                                                                *
+*                                                                               *
+* Argument  Type         IO     Description                                     *
+* --------- --------     --     ---------------------------------               *
+* u         UKF*         I      UKF, ctx is the reference kalman                *
+* Y         Matrix*      O      Propagated sigma points                         *
+* X         Matrix*      I      Sigma points                                    *
+* dt        float        I      Time step, A is built for KALMAN_DT             *
+*                                                                               *
+* RETURN VALUE: int                                                             *
+********************************************************************************/
+static int iUkfProcess(UKF *u, Matrix *Y, Matrix *X, float dt)
+{
+    kalman      *k = (kalman *)u->ctx;
+    unsigned int i;
+    unsigned int j;
+
+    (void)dt;
+    if (iMultiply(Y, k->A, X) != 0)
+    {
+        return -1;
+    }
+    for (i = 0; i < Y->r; i++)
+    {
+        for (j = 0; j < Y->c; j++)
+            Y->matrix[i][j] += k->B->matrix[i][0] * KALMAN_ACC;
+    }
+
+    return 0;
+}
+
+/********************************************************************************
+*                                                                               *
+* FUNCTION NAME: iUkfMeasure                                                    *
+*                                                                               *
+* PURPOSE: Measurement model of the UKF run, Z = H*X in one product             *
+*                                                                               *
+* ARGUMENT LIST:                                                                *
+*                                                                               *
+* Argument  Type         IO     Description                                     *
+* --------- --------     --     ---------------------------------               *
+* u         UKF*         I      UKF, ctx is the reference kalman                *
+* Z         Matrix*      O      Measured sigma points                           *
+* X         Matrix*      I      Sigma points                                    *
+*                                                                               *
+* RETURN VALUE: int                                                             *
+********************************************************************************/
+static int iUkfMeasure(UKF *u, Matrix *Z, Matrix *X)
+{
+    return iMultiply(Z, ((kalman *)u->ctx)->H, X);
+}
+
+/********************************************************************************
+*                                                                               *
+* FUNCTION NAME: iRunUKF                                                        *
+*                                                                               *
+* PURPOSE: Runs UKF_STEPS predict + update steps of the UKF on the model of     *
+*           iRun                                                                *
+*           returning the number of failed checks                               *
+*                                                                               *
+* ARGUMENT LIST:                                                                *
+*                                                                               *
+* Argument  Type         IO     Description                                     *
+* --------- --------     --     ---------------------------------               *
+* res       BenchResult* O      Result of the run                               *
+* mode      int          I      UKF_STANDARD or UKF_SQRT                        *
+*                                                                               *
+* RETURN VALUE: int                                                             *
+********************************************************************************/
+static int iRunUKF(BenchResult *res, int mode)
+{
+    const char   *variant = (mode == UKF_SQRT) ? "square-root" : "standard";
+    UKF           u;
+    kalman        k;
+    Matrix       *z;
+    unsigned long nz;
+    BenchChunk    c;
+    size_t        calls, bytes;
+    unsigned long i;
+    float         t;
+    int           fails = 0;
+
+    iKalman_Init(&k, 2, 2);
+    vSetup(&k);
+    z = pxCreate(2, 1);
+    if (iUKF_Init(&u, 2, 2, mode, 1.0f, 2.0f, 0.0f) != 0 ||
+        iUKF_SetState(&u, k.x, k.P) != 0 || iUKF_SetNoise(&u, k.Q, k.R) != 0)
+    {
+        fprintf(stderr, "ukf %s: setup failed\n", variant);
+        return 1;
+    }
+    u.iProcess = iUkfProcess;
+    u.iMeasure = iUkfMeasure;
+    u.ctx      = &k;
+
+    nz    = 0;
+    calls = uGetAllocCalls();
+    bytes = uGetAllocBytes();
+    vChunk_Init(&c, KALMAN_CHUNK / 10);
+    for (i = 0; i < UKF_STEPS; i++)
+    {
+        t = (float)i * KALMAN_DT;
+        z->matrix[0][0] = 0.5f * KALMAN_ACC * t * t + 0.45f * noise[nz++ & (KALMAN_NOISE - 1)];
+        z->matrix[1][0] = KALMAN_ACC * t            + 0.45f * noise[nz++ & (KALMAN_NOISE - 1)];
+        iUKF_Predict(&u, KALMAN_DT);
+        iUKF_Update(&u, z);
+        vChunk_Step(&c);
+    }
+    calls = uGetAllocCalls() - calls;
+    bytes = uGetAllocBytes() - bytes;
+
+    res->kernel        = "iUKF_Predict+Update";
+    res->variant       = variant;
+    res->n             = 2;
+    res->per_op        = dChunk_Best(&c);
+    res->allocs_per_op = (double)calls / (double)UKF_STEPS;
+    res->bytes_per_op  = (double)bytes / (double)UKF_STEPS;
+
+    if (calls != 0)
+    {
+        fprintf(stderr, "ukf %s: allocated %lu time(s)\n", variant, (unsigned long)calls);
+        fails++;
+    }
+    if (!isfinite(u.x->matrix[0][0]) || !isfinite(u.x->matrix[1][0]) ||
+        !(u.S->matrix[0][0] > 0) || !(u.S->matrix[1][1] > 0))
+    {
+        fprintf(stderr, "ukf %s: state or factor not valid after %lu steps\n", variant, UKF_STEPS);
+        fails++;
+    }
+
+    vDestroy(z);
+    vUKF_Destroy(&u);
+    vKalman_Destroy(&k);
+
+    return fails;
+}
+
+/********************************************************************************
+*                                                                               *
+* FUNCTION NAME: iRunBatch                                                      *
+*                                                                               *
+* PURPOSE: Runs nf filters of the same model in one KalmanBatch for             *
+*           KALMAN_STEPS / nf steps, each on its own noisy track                *
+*           returning the number of failed checks                               *
+*                                                                               *
+* ARGUMENT LIST:                                                                *
+*                                                                               *
+* Argument  Type         IO     Description                                     *
+* --------- --------     --     ---------------------------------               *
+* res       BenchResult* O      Result of the run, time per filter step         *
+* nf        unsigned int I      Number of filters in the batch                  *
+*                                                                               *
+* RETURN VALUE: int                                                             *
+********************************************************************************/
+static int iRunBatch(BenchResult *res, unsigned int nf)
+{
+    KalmanBatch   b;
+    kalman        k;
+    unsigned long nz;
+    float        *zp, *zv, *u;
+    BenchChunk    c;
+    unsigned long i, steps;
+    unsigned int  j;
+    float         t;
+    int           fails = 0;
+
+    if (iKalmanBatch_Init(&b, nf, KALMAN_DT) != 0)
+    {
+        fprintf(stderr, "iKalmanBatch_Init failed\n");
+        return 1;
+    }
+    iKalman_Init(&k, 2, 2);
+    vSetup(&k);
+    zp = malloc(3 * nf * sizeof(float));
+    zv = zp + nf;
+    u  = zp + 2 * nf;
+    for (j = 0; j < nf; j++)
+    {
+        b.q0[j] = k.Q->matrix[0][0];
+        b.q1[j] = k.Q->matrix[1][1];
+        u[j]    = KALMAN_ACC;
+    }
+
+    nz = 0;
+    steps = KALMAN_STEPS / nf;
+    vChunk_Init(&c, KALMAN_CHUNK / nf);
+    for (i = 0; i < steps; i++)
+    {
+        t = (float)i * KALMAN_DT;
+        for (j = 0; j < nf; j++)
+        {
+            zp[j] = 0.5f * KALMAN_ACC * t * t + 0.45f * noise[nz++ & (KALMAN_NOISE - 1)];
+            zv[j] = KALMAN_ACC * t            + 0.45f * noise[nz++ & (KALMAN_NOISE - 1)];
+        }
+        vKalmanBatch_Predict(&b, u);
+        vKalmanBatch_Update(&b, zp, zv, NULL);
+        vChunk_Step(&c);
+    }
+
+    res->kernel        = "vKalmanBatch";
+    res->variant       = "soa";
+    res->n             = nf;
+    res->per_op        = dChunk_Best(&c) / (double)nf;
+    res->allocs_per_op = 0;
+    res->bytes_per_op  = 0;
+
+    for (j = 0; j < nf; j++)
+    {
+        if (!isfinite(b.x0[j]) || !isfinite(b.x1[j]))
+        {
+            fprintf(stderr, "batch %u: state of filter %u is not finite\n", nf, j);
+            fails++;
+            break;
+        }
+    }
+
+    free(zp);
+    vKalman_Destroy(&k);
+    vKalmanBatch_Destroy(&b);
+
+    return fails;
+}
+
+/********************************************************************************
+*                                                                               *
+* FUNCTION NAME: iRunDelayed                                                    *
+*                                                                               *
+* PURPOSE: Runs KALMAN_STEPS predictions through a KalmanHistory with a fix     *
+*           every DELAY_EVERY steps that arrives DELAY_STEPS steps late         *
+*           returning the number of failed checks                               *
+*                                                                               *
+* ARGUMENT LIST:                                                                *
+*                                                                               *
+* Argument  Type         IO     Description                                     *
+* --------- --------     --     ---------------------------------               *
+* res       BenchResult* O      Mean and worst delayed update, 2 results        *
+*                                                                               *
+* RETURN VALUE: int                                                             *
+********************************************************************************/
+static int iRunDelayed(BenchResult *res)
+{
+    KalmanHistory h;
+    kalman        k;
+    Matrix       *z;
+    Matrix       *zl;
+    unsigned long nz;
+    uint64_t      t0;
+    BenchChunk    tu;
+    size_t        calls;
+    unsigned long i, nu;
+    float         t, tl;
+    int           fails = 0;
+
+    if (iKalman_Init(&k, 2, 2) != 0 || iKalmanHistory_Init(&h, &k, DELAY_HISTORY) != 0)
+    {
+        fprintf(stderr, "delayed: init failed\n");
+        return 1;
+    }
+    vSetup(&k);
+    z  = pxCreate(2, 1);
+    zl = pxCreate(2, 1);
+
+    nz    = 0;
+    nu    = 0;
+    vChunk_Init(&tu, 10);
+    tl    = -1;
+    calls = uGetAllocCalls();
+    for (i = 0; i < KALMAN_STEPS; i++)
+    {
+        t = (float)i * KALMAN_DT;
+        vKalmanHistory_Predict(&h, t, KALMAN_DT, KALMAN_ACC);
+        if (i % DELAY_EVERY == 0)
+        {
+            z->matrix[0][0] = 0.5f * KALMAN_ACC * t * t + 0.45f * noise[nz++ & (KALMAN_NOISE - 1)];
+            z->matrix[1][0] = KALMAN_ACC * t            + 0.45f * noise[nz++ & (KALMAN_NOISE - 1)];
+            iCopy(zl, z);
+            tl = t;
+        }
+        if (i % DELAY_EVERY == DELAY_STEPS && tl >= 0)
+        {
+            t0 = uBenchNow();
+            if (iKalmanHistory_Update(&h, tl, zl, NULL) != 0)
+            {
+                fails++;
+            }
+            vChunk_Add(&tu, uBenchNow() - t0, 1);
+            nu++;
+        }
+    }
+    calls = uGetAllocCalls() - calls;
+
+    res[0].kernel        = "iKalmanHistory_Update";
+    res[0].variant       = "replay";
+    res[0].n             = DELAY_STEPS;
+    res[0].per_op        = dChunk_Best(&tu);
+    res[0].allocs_per_op = (nu != 0) ? (double)calls / (double)nu : 0;
+    res[0].bytes_per_op  = 0;
+    res[1].kernel        = "iKalmanHistory_Update";
+    res[1].variant       = "worst-case";
+    res[1].n             = h.replay_max;
+    res[1].per_op        = (double)h.cycles_max;
+    res[1].allocs_per_op = 0;
+    res[1].bytes_per_op  = 0;
+
+    if (fails != 0)
+    {
+        fprintf(stderr, "delayed: %d update(s) rejected\n", fails);
+    }
+    if (calls != 0)
+    {
+        fprintf(stderr, "delayed: allocated %lu time(s) in %lu steps\n",
+                (unsigned long)calls, KALMAN_STEPS);
+        fails++;
+    }
+    if (!isfinite(k.x->matrix[0][0]) || !isfinite(k.x->matrix[1][0]))
+    {
+        fprintf(stderr, "delayed: state is not finite after %lu steps\n", KALMAN_STEPS);
+        fails++;
+    }
+
+    vDestroy(zl);
+    vDestroy(z);
+    vKalmanHistory_Destroy(&h);
+    vKalman_Destroy(&k);
+
+    return fails;
+}
+
+/********************************************************************************
+*                                                                               *
+* FUNCTION NAME: iRunSmoother                                                   *
+*                                                                               *
+* PURPOSE: Runs SMOOTH_STEPS steps of the 2-state filter through a fixed-lag    *
+*           smoother                                                            *
+*           returning the number of failed checks                               *
+*                                                                               *
+* ARGUMENT LIST:                                                                *
+*                                                                               *
+* Argument  Type         IO     Description                                     *
+* --------- --------     --     ---------------------------------               *
+* res       BenchResult* O      Result of the run, time per step                *
+*                                                                               *
+* RETURN VALUE: int                                                             *
+********************************************************************************/
+static int iRunSmoother(BenchResult *res)
+{
+    KalmanSmoother s;
+    kalman         k;
+    Matrix        *z;
+    unsigned long  nz;
+    BenchChunk     c;
+    size_t         calls;
+    unsigned long  i;
+    float          t;
+    int            fails = 0;
+
+    if (iKalman_Init(&k, 2, 2) != 0 || iKalmanSmoother_Init(&s, &k, SMOOTH_LAG) != 0)
+    {
+        fprintf(stderr, "smoother: init failed\n");
+        return 1;
+    }
+    vSetup(&k);
+    z = pxCreate(2, 1);
+
+    nz    = 0;
+    calls = uGetAllocCalls();
+    vChunk_Init(&c, KALMAN_CHUNK / 10);
+    for (i = 0; i < SMOOTH_STEPS; i++)
+    {
+        t = (float)i * KALMAN_DT;
+        z->matrix[0][0] = 0.5f * KALMAN_ACC * t * t + 0.45f * noise[nz++ & (KALMAN_NOISE - 1)];
+        z->matrix[1][0] = KALMAN_ACC * t            + 0.45f * noise[nz++ & (KALMAN_NOISE - 1)];
+        if (i != 0 && iKalmanSmoother_Predict(&s, KALMAN_DT, KALMAN_ACC) != 0)
+        {
+            fails++;
+        }
+        iKalman_Update(&k, z, NULL);
+        if (iKalmanSmoother_Push(&s, t) < 0)
+        {
+            fails++;
+        }
+        vChunk_Step(&c);
+    }
+    calls = uGetAllocCalls() - calls;
+
+    res->kernel        = "iKalmanSmoother_Push";
+    res->variant       = "fixed-lag";
+    res->n             = SMOOTH_LAG;
+    res->per_op        = dChunk_Best(&c);
+    res->allocs_per_op = (double)calls / (double)SMOOTH_STEPS;
+    res->bytes_per_op  = 0;
+
+    if (fails != 0)
+    {
+        fprintf(stderr, "smoother: %d failed prediction(s) or push(es)\n", fails);
+    }
+    if (calls != 0)
+    {
+        fprintf(stderr, "smoother: allocated %lu time(s) in %lu steps\n",
+                (unsigned long)calls, SMOOTH_STEPS);
+        fails++;
+    }
+    if (!isfinite(s.xs->matrix[0][0]) || !isfinite(s.xs->matrix[1][0]))
+    {
+        fprintf(stderr, "smoother: state is not finite after %lu steps\n", SMOOTH_STEPS);
+        fails++;
+    }
+
+    vDestroy(z);
+    vKalmanSmoother_Destroy(&s);
+    vKalman_Destroy(&k);
+
+    return fails;
+}
+
+/********************************************************************************
+*                                                                               *
+* FUNCTION NAME: iRunIMM                                                        *
+*                                                                               *
+* PURPOSE: Runs the IMM bank on a track that cycles through stopping,           *
+*           cruising and manoeuvring every IMM_SEGMENT steps, with no           *
+*           acceleration input                                                  *
+*           returning the number of failed checks                               *
+*                                                                               *
+* ARGUMENT LIST:                                                                *
+*                                                                               *
+* Argument  Type         IO     Description                                     *
+* --------- --------     --     ---------------------------------               *
+* res       BenchResult* O      Result of the run, time per step                *
+*                                                                               *
+* RETURN VALUE: int                                                             *
+********************************************************************************/
+static int iRunIMM(BenchResult *res)
+{
+    KalmanIMM     m;
+    float        *zp, *zv;
+    BenchChunk    c;
+    unsigned long i, nz;
+    unsigned int  j;
+    double        pos, vel, acc;
+    int           fails = 0;
+
+    if (iKalmanIMM_Init(&m, KALMAN_DT, 0.999f) != 0)
+    {
+        fprintf(stderr, "imm: init failed\n");
+        return 1;
+    }
+    zp = malloc(2 * IMM_STEPS * sizeof(float));
+    zv = zp + IMM_STEPS;
+
+    /* process noise of the velocity from 1e-8 (stopped) to 1e-2 (manoeuvring) */
+    for (j = 0; j < KALMAN_IMM_MODELS; j++)
+    {
+        m.q0[j] = 1e-9f;
+        m.q1[j] = (KALMAN_IMM_MODELS == 1) ? 1e-5f :
+                  1e-8f * powf(1e6f, (float)j / (float)(KALMAN_IMM_MODELS - 1));
+    }
+
+    pos = 0;
+    vel = 0;
+    nz  = 0;
+    for (i = 0; i < IMM_STEPS; i++)
+    {
+        switch ((i / IMM_SEGMENT) % 3)
+        {
+            case 0:  acc = -10.0 * vel;                          break;
+            case 1:  acc = (vel < 2.0) ? 1.0 : 0;                break;
+            default: acc = 3.0 * sin(2.0 * (double)i * KALMAN_DT); break;
+        }
+        vel  += acc * KALMAN_DT;
+        pos  += vel * KALMAN_DT;
+        zp[i] = (float)pos + 0.45f * noise[nz++ & (KALMAN_NOISE - 1)];
+        zv[i] = (float)vel + 0.45f * noise[nz++ & (KALMAN_NOISE - 1)];
+    }
+
+    vChunk_Init(&c, KALMAN_CHUNK);
+    for (i = 0; i < IMM_STEPS; i++)
+    {
+        vKalmanIMM_Predict(&m, 0);
+        vKalmanIMM_Update(&m, zp[i], zv[i]);
+        vChunk_Step(&c);
+    }
+
+    res->kernel        = "vKalmanIMM";
+    res->variant       = "predict+update";
+    res->n             = KALMAN_IMM_MODELS;
+    res->per_op        = dChunk_Best(&c);
+    res->allocs_per_op = 0;
+    res->bytes_per_op  = 0;
+
+    if (!isfinite(m.x[0]) || !isfinite(m.x[1]))
+    {
+        fprintf(stderr, "imm: state is not finite after %lu steps\n", IMM_STEPS);
+        fails++;
+    }
+
+    free(zp);
+
+    return fails;
+}
+
+/********************************************************************************
+*                                                                               *
+* FUNCTION NAME: iRunInfo                                                       *
+*                                                                               *
+* PURPOSE: Fuses three asynchronous sensors of the 2-state model, a position    *
+*           every step, a second position every 2 steps and a velocity every    *
+*           3 steps, with the information filter; kalman only gives the model   *
+*           and the prior                                                       *
+*           returning the number of failed checks                               *
+*                                                                               *
+* ARGUMENT LIST:                                                                *
+*                                                                               *
+* Argument  Type         IO     Description                                     *
+* --------- --------     --     ---------------------------------               *
+* res       BenchResult* O      Results of the run, time per sensor update      *
+*                               and time per prediction                         *
+*                                                                               *
+* RETURN VALUE: int                                                             *
+********************************************************************************/
+static int iRunInfo(BenchResult *res)
+{
+    static const float hp[2] = {1, 0};
+    static const float hv[2] = {0, 1};
+    KalmanInfo    f;
+    kalman        k;
+    Matrix       *z;
+    unsigned char valid[3];
+    unsigned long i, nz;
+    uint64_t      t0, t1;
+    BenchChunk    tp, tu;
+    size_t        calls;
+    float         t;
+    int           fails = 0;
+
+    if (iKalman_Init(&k, 2, 2) != 0 || iKalmanInfo_Init(&f, 2) != 0)
+    {
+        fprintf(stderr, "info: init failed\n");
+        return 1;
+    }
+    vSetup(&k);
+    iCopy(f.A, k.A);
+    iCopy(f.B, k.B);
+    iCopy(f.Q, k.Q);
+    if (iKalmanInfo_SetState(&f, k.x, k.P) != 0)
+    {
+        fprintf(stderr, "info: prior is not positive definite\n");
+        fails++;
+    }
+    z = pxCreate(3, 1);
+
+    nz    = 0;
+    vChunk_Init(&tp, KALMAN_CHUNK);
+    vChunk_Init(&tu, KALMAN_CHUNK);
+    calls = uGetAllocCalls();
+    for (i = 0; i < INFO_STEPS; i++)
+    {
+        t = (float)i * KALMAN_DT;
+        z->matrix[0][0] = 0.5f * KALMAN_ACC * t * t + 0.45f * noise[nz++ & (KALMAN_NOISE - 1)];
+        z->matrix[1][0] = 0.5f * KALMAN_ACC * t * t + 0.45f * noise[nz++ & (KALMAN_NOISE - 1)];
+        z->matrix[2][0] = KALMAN_ACC * t            + 0.45f * noise[nz++ & (KALMAN_NOISE - 1)];
+        valid[0] = 1;
+        valid[1] = (i % 2) == 0;
+        valid[2] = (i % 3) == 0;
+
+        if (i != 0)
+        {
+            t0 = uBenchNow();
+            if (iKalmanInfo_Predict(&f, KALMAN_ACC) != 0)
+            {
+                fails++;
+            }
+            vChunk_Add(&tp, uBenchNow() - t0, 1);
+        }
+        t0 = uBenchNow();
+        vKalmanInfo_UpdateScalar(&f, hp, z->matrix[0][0], 0.2f);
+        if (valid[1])
+        {
+            vKalmanInfo_UpdateScalar(&f, hp, z->matrix[1][0], 0.2f);
+        }
+        if (valid[2])
+        {
+            vKalmanInfo_UpdateScalar(&f, hv, z->matrix[2][0], 0.2f);
+        }
+        t1 = uBenchNow();
+        vChunk_Add(&tu, t1 - t0, 1 + valid[1] + valid[2]);
+    }
+    calls = uGetAllocCalls() - calls;
+
+    res[0].kernel        = "vKalmanInfo_UpdateScalar";
+    res[0].variant       = "additive";
+    res[0].n             = 2;
+    res[0].per_op        = dChunk_Best(&tu);
+    res[0].allocs_per_op = (double)calls / (double)INFO_STEPS;
+    res[0].bytes_per_op  = 0;
+    res[1].kernel        = "iKalmanInfo_Predict";
+    res[1].variant       = "information";
+    res[1].n             = 2;
+    res[1].per_op        = dChunk_Best(&tp);
+    res[1].allocs_per_op = 0;
+    res[1].bytes_per_op  = 0;
+
+    if (iKalmanInfo_State(&f, 1) != 0 ||
+        !isfinite(f.x->matrix[0][0]) || !isfinite(f.x->matrix[1][0]))
+    {
+        fprintf(stderr, "info: Y is not positive definite or the state is not finite\n");
+        fails++;
+    }
+    if (calls != 0)
+    {
+        fprintf(stderr, "info: allocated %lu time(s) in %lu steps\n",
+                (unsigned long)calls, INFO_STEPS);
+        fails++;
+    }
+
+    vDestroy(z);
+    vKalmanInfo_Destroy(&f);
+    vKalman_Destroy(&k);
+
+    return fails;
+}
+
+/********************************************************************************
+*                                                                               *
+* FUNCTION NAME: iRunGate                                                       *
+*                                                                               *
+* PURPOSE: Runs GATE_STEPS steps of the 2-state filter with the 99% gate on     *
+*           and a GATE_OUTLIER m position error every GATE_EVERY steps, and     *
+*           checks that every outlier is rejected leaving x and P untouched,    *
+*           that about 1% of the good measurements are rejected and that the    *
+*           mean NIS is near its expectation, 2                                 *
+*           returning the number of failed checks                               *
+*                                                                               *
+* ARGUMENT LIST:                                                                *
+*                                                                               *
+* Argument  Type         IO     Description                                     *
+* --------- --------     --     ---------------------------------               *
+* res       BenchResult* O      Result of the run, time per step                *
+* mode      int          I      RUN_FULL or RUN_SEQUENTIAL                      *
+*                                                                               *
+* RETURN VALUE: int                                                             *
+********************************************************************************/
+static int iRunGate(BenchResult *res, int mode)
+{
+    const char   *variant = (mode == RUN_SEQUENTIAL) ? "gated-sequential" : "gated";
+    kalman        k;
+    Matrix       *z;
+    unsigned long nz, nout, nmiss, ntouch;
+    BenchChunk    c;
+    size_t        calls;
+    unsigned long i;
+    float         t, x0, p00, p01;
+    int           outlier, ret;
+    int           fails = 0;
+
+    if (iKalman_Init(&k, 2, 2) != 0)
+    {
+        fprintf(stderr, "%s: iKalman_Init failed\n", variant);
+        return 1;
+    }
+    vSetup(&k);
+    if (iKalman_SetGate(&k, KALMAN_GATE_99) != 0)
+    {
+        fprintf(stderr, "%s: iKalman_SetGate failed\n", variant);
+        fails++;
+    }
+    z = pxCreate(2, 1);
+
+    nz     = 0;
+    nout   = 0;
+    nmiss  = 0;
+    ntouch = 0;
+    calls  = uGetAllocCalls();
+    vChunk_Init(&c, KALMAN_CHUNK);
+    for (i = 0; i < GATE_STEPS; i++)
+    {
+        t       = (float)i * KALMAN_DT;
+        outlier = (i % GATE_EVERY) == GATE_EVERY - 1;
+        z->matrix[0][0] = 0.5f * KALMAN_ACC * t * t + 0.45f * noise[nz++ & (KALMAN_NOISE - 1)] +
+                          (outlier ? GATE_OUTLIER : 0);
+        z->matrix[1][0] = KALMAN_ACC * t            + 0.45f * noise[nz++ & (KALMAN_NOISE - 1)];
+
+        vKalman_Predict(&k, KALMAN_DT, KALMAN_ACC);
+        x0  = k.x->matrix[0][0];
+        p00 = k.P->matrix[0][0];
+        p01 = k.P->matrix[0][1];
+        ret = (mode == RUN_SEQUENTIAL) ? iKalman_UpdateSeq(&k, z, NULL) :
+                                         iKalman_Update(&k, z, NULL);
+        if (outlier)
+        {
+            nout   += (ret == 1);
+            ntouch += (k.x->matrix[0][0] != x0 || k.P->matrix[0][0] != p00 ||
+                       k.P->matrix[0][1] != p01);
+        }
+        else
+        {
+            nmiss += (ret != 0);
+        }
+        vChunk_Step(&c);
+    }
+    calls = uGetAllocCalls() - calls;
+
+    res->kernel        = "iKalman_Update";
+    res->variant       = variant;
+    res->n             = 2;
+    res->per_op        = dChunk_Best(&c);
+    res->allocs_per_op = (double)calls / (double)GATE_STEPS;
+    res->bytes_per_op  = 0;
+
+    if (nout != GATE_STEPS / GATE_EVERY || ntouch != 0)
+    {
+        fprintf(stderr, "%s: %lu of %lu outliers rejected, %lu changed x or P\n",
+                variant, nout, GATE_STEPS / GATE_EVERY, ntouch);
+        fails++;
+    }
+    if (nmiss > GATE_STEPS / 50 || k.rejected != nout + nmiss)
+    {
+        fprintf(stderr, "%s: %lu good measurements rejected, %lu counted\n",
+                variant, nmiss, k.rejected);
+        fails++;
+    }
+    if (!(k.nis_mean > 1.0f && k.nis_mean < 3.0f))
+    {
+        fprintf(stderr, "%s: mean NIS %g, expected about 2\n", variant, k.nis_mean);
+        fails++;
+    }
+    if (calls != 0)
+    {
+        fprintf(stderr, "%s: allocated %lu time(s) in %lu steps\n",
+                variant, (unsigned long)calls, GATE_STEPS);
+        fails++;
+    }
+
+    vDestroy(z);
+    vKalman_Destroy(&k);
+
+    return fails;
+}
+
+/********************************************************************************
+*                                                                               *
+* FUNCTION NAME: iRunAll                                                        *
+*                                                                               *
+* PURPOSE: One run of every case and of the reference kernel                    *
+*                                                                               *
+* ARGUMENT LIST:                                                                *
+*                                                                               *
+* Argument  Type         IO     Description                                     *
+* --------- --------     --     ---------------------------------               *
+* res       BenchResult* O      KALMAN_RESULTS results                          *
+*                                                                               *
+* RETURN VALUE: int, number of failed checks                                    *
+*                                                                               *
+********************************************************************************/
+static int iRunAll(BenchResult *res)
+{
+    int fails = 0;
+
+    fails += iRun(&res[0], "2-state",      RUN_FULL);
+    fails += iRun(&res[1], "steady-state", RUN_STEADY);
+    fails += iRun(&res[2], "sequential",   RUN_SEQUENTIAL);
+    fails += iRunGenerated(&res[3]);
+    fails += iRunBatch(&res[4], 3);
+    fails += iRunBatch(&res[5], 256);
+    fails += iRunESKF(&res[6]);
+    fails += iRunUKF(&res[8], UKF_STANDARD);
+    fails += iRunUKF(&res[9], UKF_SQRT);
+    fails += iRun(&res[10], "square-root",  RUN_SQRT);
+    fails += iRunDelayed(&res[11]);
+    fails += iRunSmoother(&res[13]);
+    fails += iRunIMM(&res[14]);
+    fails += iRunInfo(&res[15]);
+    fails += iRunGate(&res[17], RUN_FULL);
+    fails += iRunGate(&res[18], RUN_SEQUENTIAL);
+    vBench_Reference(&res[19]);
+
+    return fails;
+}
+
+int main(int argc, char **argv)
+{
+    BenchResult res[KALMAN_RESULTS];
+    BenchResult run[KALMAN_RESULTS];
+    Rng         rng;
+    const char *out_path      = NULL;
+    const char *baseline_path = NULL;
+    double      tol           = 0.50;
+    double      floor         = 20.0;
+    int         strict        = 0;
+    int         reps          = 1;
+    int         opt;
+    int         fails = 0;
+
+    while ((opt = getopt(argc, argv, "o:b:t:a:r:s")) != -1)
+    {
+        switch (opt)
+        {
+            case 'o': out_path      = optarg;        break;
+            case 'b': baseline_path = optarg;        break;
+            case 't': tol           = atof(optarg);  break;
+            case 'a': floor         = atof(optarg);  break;
+            case 'r': reps          = atoi(optarg);  break;
+            case 's': strict        = 1;             break;
+            default:
+                fprintf(stderr, "usage: %s [-o out.json] [-b baseline.json] [-t tolerance] "
+                                "[-a abs_floor] [-r runs] [-s]\n", argv[0]);
+                return 2;
+        }
+    }
+
+    vBenchTimerInit();
+    vProbe_Init();
+    vRngSeed(&rng, 0, 0);
+    for (opt = 0; opt < KALMAN_NOISE; opt++)
+    {
+        noise[opt] = fRngNormal(&rng);
+    }
+
+    /* whole runs one after the other: a burst of load spoils one run of a case, not all */
+    fails += iRunAll(res);
+    for (opt = 1; opt < reps; opt++)
+    {
+        fails += iRunAll(run);
+        vBench_Best(res, run, KALMAN_RESULTS);
+    }
+
+    out_file = stdout;
+    if (out_path != NULL)
+    {
+        out_file = fopen(out_path, "w");
+        if (out_file == NULL)
+        {
+            perror("failed to open output");
+            return 2;
+        }
+    }
+    vBench_Emit(emit_file, res, KALMAN_RESULTS);
+#if defined(USE_PROBES)
+    vProbe_Print(emit_stderr);
+#endif
+    if (out_file != stdout)
+    {
+        fclose(out_file);
+    }
+
+    if (baseline_path != NULL && fails == 0)
+    {
+        fails = iBench_Compare(baseline_path, res, KALMAN_RESULTS, tol, floor, strict);
+        if (fails != 0)
+        {
+            fprintf(stderr, "%d regression(s) against %s\n", fails < 0 ? 0 : fails, baseline_path);
+            return 1;
+        }
+        fprintf(stderr, "no regression against %s (tolerance %.0f%%)\n", baseline_path, tol * 100.0);
+    }
+
+    return fails != 0;
+}
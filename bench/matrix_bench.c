@@ -0,0 +1,541 @@
+/***********************************************************************************
+* This file is part of The AHRS Project.                                           *
+*                                                                                  *
+* Copyright © 2020 By Nicola di Gruttola Giardino. All rights reserved.            *
+* @mail: nicoladgg@protonmail.com                                                  *
+*                                                                                  *
+* AHRS is free software: you can redistribute it and/or modify                     *
+* it under the terms of the GNU General Public License as published by             *
+* the Free Software Foundation, either version 3 of the License, or                *
+* (at your option) any later version.                                              *
+*                                                                                  *
+* AHRS is distributed in the hope that it will be useful,                          *
+* but WITHOUT ANY WARRANTY; without even the implied warranty of                   *
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the                    *
+* GNU General Public License for more details.                                     *
+*                                                                                  *
+* You should have received a copy of the GNU General Public License                *
+* along with The AHRS Project.  If not, see <https://www.gnu.org/licenses/>.       *
+*                                                                                  *
+* In case of use of this project, I ask you to mention me, to whom it may concern. *
+***********************************************************************************/
+
+/****************************************************************************************************
+* FILE NAME: matrix_bench.c                                                                         *
+*                                                                                                   *
+* PURPOSE: Measures time, allocations and allocated bytes per call of every public kernel of        *
+*           usrlib/matrix.c, for sizes 2 to 32, in the allocating (px*) and in the                  *
+*           allocation free (i*) variant. Reports JSON, one object per line, and on the host        *
+*           compares the run against a baseline file                                                *
+*                                                                                                   *
+* FILE REFERENCES:                                                                                  *
+*                                                                                                   *
+*   Name          I/O     Description                                                               *
+*   ----          ---     -----------                                                               *
+*   baseline.json I       Reference run, see bench/Makefile                                         *
+*                                                                                                   *
+* EXTERNAL VARIABLES:                                                                               *
+*                                                                                                   *
+* Source: <matrix.h>                                                                                *
+*                                                                                                   *
+* Name          Type    IO Description                                                              *
+* ------------- ------- -- -----------------------------                                            *
+*   m           Matrix     Matrix object                                                            *
+*                                                                                                   *
+* STATIC VARIABLES:                                                                                 *
+*                                                                                                   *
+*   Name     Type         I/O      Description                                                      *
+*   ----     ----         ---      -----------                                                      *
+*   cases    BenchCase[]           Table of the benchmarked kernels                                 *
+*   sizes    unsigned[]            Benchmarked matrix sizes                                         *
+*                                                                                                   *
+* EXTERNAL REFERENCES:                                                                              *
+*                                                                                                   *
+*  Name                       Description                                                           *
+*  -------------              -----------                                                           *
+*  uBenchNow                  bench_timer.h, ns on the host, DWT cycles on the target               *
+*                                                                                                   *
+* ABNORMAL TERMINATION CONDITIONS, ERROR AND WARNING MESSAGES:                                      *
+*    the host executable exits with 1 if a kernel allocates more than in the baseline, or with -s   *
+*    if it is slower than the baseline by more than the tolerance                                   *
+*                                                                                                   *
+* ASSUMPTIONS, CONSTRAINTS, RESTRICTIONS: the library is single precision only, so every case       *
+*    reports "type": "float"                                                                        *
+*                                                                                                   *
+* NOTES: iInverse and pxInverse destroy their input, their cases include an iCopy to restore it     *
+*                                                                                                   *
+* REQUIREMENTS/FUNCTIONAL SPECIFICATIONS REFERENCES:                                                *
+*                                                                                                   *
+* DEVELOPMENT HISTORY:                                                                              *
+*                                                                                                   *
+*   Date          Author            Change Id     Release     Description Of Change                 *
+*   ----          ------            ---------     ------      ----------------------                *
+*   19-10-2026    AHRS Project       1               1         Initial release                      *
+*                                                                                                   *
+****************************************************************************************************/
+
+/* Include Global Parameters */
+
+#include "matrix_bench.h"
+#include "bench_timer.h"
+#include "matrix.h"
+#include "rng.h"
+
+/* Definition of Macros */
+
+#define BENCH_MAX_N       32
+#define BENCH_RUNS        50       /* short runs: one of them falls between bursts of load */
+
+#if defined(__ARM_ARCH_7EM__)
+#define BENCH_MIN_TICKS   2000000ULL       /* ~10 ms at 216 MHz */
+#else
+#define BENCH_MIN_TICKS   20000000ULL      /* 20 ms */
+#endif
+
+/*
+* BenchCtx Object:
+*       operands shared by all the cases of one size, created once so the
+*       alloc-free cases really do not touch the heap
+*/
+
+typedef struct BenchCtx
+{
+    unsigned int n;
+    Matrix* A;         /* random, positive entries */
+    Matrix* B;         /* random, positive entries */
+    Matrix* S;         /* symmetric positive definite */
+    Matrix* C;         /* output */
+    Matrix* L;         /* output */
+    Matrix* U;         /* output */
+    Matrix* W;         /* scratch copy of S */
+    Matrix* D3;        /* 3n x 3n output */
+    Vector* v;         /* ones */
+    Vector* w;         /* output */
+    Rng     rng;
+}BenchCtx;
+
+typedef void (*BenchFn)(BenchCtx *);
+
+typedef struct BenchCase
+{
+    const char* kernel;
+    const char* variant;
+    BenchFn     fn;
+}BenchCase;
+
+/* Declare Prototypes */
+
+static void     ctx_create     (BenchCtx *, unsigned int);
+static void     ctx_destroy    (BenchCtx *);
+static double   measure        (const BenchCase *, BenchCtx *, uint64_t, BenchResult *);
+
+static void b_iSum          (BenchCtx *c) { iSum(c->C, c->A, c->B); }
+static void b_pxSum         (BenchCtx *c) { vDestroy(pxSum(c->A, c->B)); }
+static void b_iSubtract     (BenchCtx *c) { iSubtract(c->C, c->A, c->B); }
+static void b_pxSubtract    (BenchCtx *c) { vDestroy(pxSubtract(c->A, c->B)); }
+static void b_iMultiply     (BenchCtx *c) { iMultiply(c->C, c->A, c->B); }
+static void b_pxMultiply    (BenchCtx *c) { vDestroy(pxMultiply(c->A, c->B)); }
+static void b_iSc_Multiply  (BenchCtx *c) { iSc_Multiply(c->C, c->A, 0.5f); }
+static void b_pxSc_Multiply (BenchCtx *c) { vDestroy(pxSc_Multiply(c->A, 0.5f)); }
+static void b_iTranspose    (BenchCtx *c) { iTranspose(c->C, c->A); }
+static void b_pxTranspose   (BenchCtx *c) { vDestroy(pxTranspose(c->A)); }
+static void b_iInverse      (BenchCtx *c) { iCopy(c->W, c->S); iIdentity(c->C); iInverse(c->C, c->W); }
+static void b_pxInverse     (BenchCtx *c) { iCopy(c->W, c->S); vDestroy(pxInverse(c->W)); }
+static void b_iIdentity     (BenchCtx *c) { iIdentity(c->C); }
+static void b_pxIdentity    (BenchCtx *c) { vDestroy(pxIdentity(c->n)); }
+static void b_iCopy         (BenchCtx *c) { iCopy(c->C, c->A); }
+static void b_pxCopy        (BenchCtx *c) { vDestroy(pxCopy(c->A)); }
+static void b_iChol         (BenchCtx *c) { iChol(c->L, c->S); }
+static void b_pxChol        (BenchCtx *c) { vDestroy(pxChol(c->S)); }
+static void b_iSqrtm        (BenchCtx *c) { iSqrtm(c->C, c->A); }
+static void b_pxSqrtm       (BenchCtx *c) { vDestroy(pxSqrtm(c->A)); }
+static void b_iExpm         (BenchCtx *c) { iExpm(c->C, c->A, 2.0f); }
+static void b_pxExpm        (BenchCtx *c) { vDestroy(pxExpm(c->A, 2.0f)); }
+static void b_iDiag         (BenchCtx *c) { iDiag(c->C, c->A); }
+static void b_pxDiag        (BenchCtx *c) { vDestroy(pxDiag(c->A)); }
+static void b_iBlkdiag      (BenchCtx *c) { iBlkdiag(c->D3, c->A, c->B, c->S); }
+static void b_pxBlkdiag     (BenchCtx *c) { vDestroy(pxBlkdiag(c->A, c->B, c->S)); }
+static void b_iLU           (BenchCtx *c) { iLU(c->S, c->W, c->U); }
+static void b_iEigenvalues  (BenchCtx *c) { iEigenvalues(c->w, c->S); }
+static void b_iEquals       (BenchCtx *c) { iEquals(c->A, c->A); }
+static void b_fDeterminant  (BenchCtx *c) { c->C->matrix[0][0] = fDeterminant(c->S); }
+static void b_pxCreate      (BenchCtx *c) { vDestroy(pxCreate(c->n, c->n)); }
+static void b_iRandnMatrix  (BenchCtx *c) { iRandnMatrix(c->C, &c->rng, 1.0f); }
+static void b_iTrsv         (BenchCtx *c) { iTrsv(c->w, c->L, c->v, TRI_LOWER, TRI_NOTRANS); }
+static void b_iTrsm         (BenchCtx *c) { iTrsm(c->C, c->L, c->A, TRI_LOWER, TRI_TRANS); }
+static void b_iSyrk         (BenchCtx *c) { iSyrk(c->C, c->A, 1.0f, 0.0f, TRI_NOTRANS); }
+static void b_iSyr2k        (BenchCtx *c) { iSyr2k(c->C, c->A, c->B, 1.0f, 0.0f, TRI_NOTRANS); }
+static void b_iTria         (BenchCtx *c) { iCopy(c->W, c->A); iTria(c->C, c->W); }
+static void b_iCholUpdate   (BenchCtx *c) { iCopy(c->U, c->L); iCopy(c->W, c->A); iCholUpdate(c->U, c->W, 1.0f); }
+
+/* Declare Static Variables */
+
+static const BenchCase cases[] =
+{
+    { "iSum",          "alloc-free", b_iSum          },
+    { "pxSum",         "alloc",      b_pxSum         },
+    { "iSubtract",     "alloc-free", b_iSubtract     },
+    { "pxSubtract",    "alloc",      b_pxSubtract    },
+    { "iMultiply",     "alloc-free", b_iMultiply     },
+    { "pxMultiply",    "alloc",      b_pxMultiply    },
+    { "iSc_Multiply",  "alloc-free", b_iSc_Multiply  },
+    { "pxSc_Multiply", "alloc",      b_pxSc_Multiply },
+    { "iTranspose",    "alloc-free", b_iTranspose    },
+    { "pxTranspose",   "alloc",      b_pxTranspose   },
+    { "iInverse",      "alloc-free", b_iInverse      },
+    { "pxInverse",     "alloc",      b_pxInverse     },
+    { "iIdentity",     "alloc-free", b_iIdentity     },
+    { "pxIdentity",    "alloc",      b_pxIdentity    },
+    { "iCopy",         "alloc-free", b_iCopy         },
+    { "pxCopy",        "alloc",      b_pxCopy        },
+    { "iChol",         "alloc-free", b_iChol         },
+    { "pxChol",        "alloc",      b_pxChol        },
+    { "iSqrtm",        "alloc-free", b_iSqrtm        },
+    { "pxSqrtm",       "alloc",      b_pxSqrtm       },
+    { "iExpm",         "alloc-free", b_iExpm         },
+    { "pxExpm",        "alloc",      b_pxExpm        },
+    { "iDiag",         "alloc-free", b_iDiag         },
+    { "pxDiag",        "alloc",      b_pxDiag        },
+    { "iBlkdiag",      "alloc-free", b_iBlkdiag      },
+    { "pxBlkdiag",     "alloc",      b_pxBlkdiag     },
+    { "iLU",           "alloc-free", b_iLU           },
+    { "iEigenvalues",  "alloc-free", b_iEigenvalues  },
+    { "iEquals",       "alloc-free", b_iEquals       },
+    { "fDeterminant",  "alloc-free", b_fDeterminant  },
+    { "pxCreate",      "alloc",      b_pxCreate      },
+    { "iRandnMatrix",  "alloc-free", b_iRandnMatrix  },
+    { "iTrsv",         "alloc-free", b_iTrsv         },
+    { "iTrsm",         "alloc-free", b_iTrsm         },
+    { "iSyrk",         "alloc-free", b_iSyrk         },
+    { "iSyr2k",        "alloc-free", b_iSyr2k        },
+    { "iTria",         "alloc-free", b_iTria         },
+    { "iCholUpdate",   "alloc-free", b_iCholUpdate   },
+};
+
+static const unsigned int sizes[] = { 2, 3, 4, 6, 8, 12, 16, 24, 32 };
+
+#define N_CASES   (sizeof(cases) / sizeof(cases[0]))
+#define N_SIZES   (sizeof(sizes) / sizeof(sizes[0]))
+
+/********************************************************************************
+*                                                                               *
+* FUNCTION NAME: ctx_create                                                     *
+*                                                                               *
+* PURPOSE: Creates the operands of one size, S = A*A^T + n*I is SPD             *
+*                                                                               *
+* ARGUMENT LIST:                                                                *
+*                                                                               *
+* Argument  Type         IO     Description                                     *
+* --------- --------     --     ---------------------------------               *
+* c         BenchCtx*    O      Context to fill                                 *
+* n         unsigned int I      Matrix size                                     *
+*                                                                               *
+* RETURN VALUE: void                                                            *
+********************************************************************************/
+static void ctx_create(BenchCtx *c, unsigned int n)
+{
+    Matrix *At;
+    size_t  i;
+    size_t  j;
+
+    c->n  = n;
+    c->A  = pxCreate(n, n);
+    c->B  = pxCreate(n, n);
+    c->S  = pxCreate(n, n);
+    c->C  = pxCreate(n, n);
+    c->L  = pxCreate(n, n);
+    c->U  = pxCreate(n, n);
+    c->W  = pxCreate(n, n);
+    c->D3 = pxCreate(3 * n, 3 * n);
+    c->v  = pxVectorCreate(n);
+    c->w  = pxVectorCreate(n);
+    vRngSeed(&c->rng, 2020, n);
+
+    for (i = 0; i < n; i++)
+    {
+        for (j = 0; j < n; j++)
+        {
+            c->A->matrix[i][j] = 0.1f + fRngUniform(&c->rng);
+            c->B->matrix[i][j] = 0.1f + fRngUniform(&c->rng);
+        }
+    }
+
+    At = pxTranspose(c->A);
+    iMultiply(c->S, c->A, At);
+    for (i = 0; i < n; i++)
+    {
+        c->S->matrix[i][i] += (float)n;
+        c->v->vector[i] = 1.0f;
+    }
+    vDestroy(At);
+
+    /* L is the Cholesky factor of S, input of the triangular solves */
+    iChol(c->L, c->S);
+}
+
+/********************************************************************************
+*                                                                               *
+* FUNCTION NAME: ctx_destroy                                                    *
+*                                                                               *
+* PURPOSE: Destroys the operands of one size                                    *
+*                                                                               *
+* ARGUMENT LIST:                                                                *
+*                                                                               *
+* Argument  Type         IO     Description                                     *
+* --------- --------     --     ---------------------------------               *
+* c         BenchCtx*    IO     Context to empty                                *
+*                                                                               *
+* RETURN VALUE: void                                                            *
+********************************************************************************/
+static void ctx_destroy(BenchCtx *c)
+{
+    vDestroy(c->A);
+    vDestroy(c->B);
+    vDestroy(c->S);
+    vDestroy(c->C);
+    vDestroy(c->L);
+    vDestroy(c->U);
+    vDestroy(c->W);
+    vDestroy(c->D3);
+    vVectorDestroy(c->v);
+    vVectorDestroy(c->w);
+}
+
+/********************************************************************************
+*                                                                               *
+* FUNCTION NAME: measure                                                        *
+*                                                                               *
+* PURPOSE: Doubles the iterations until a run lasts min_ticks / BENCH_RUNS,    *
+*           then keeps the best of BENCH_RUNS runs of that length, the minimum  *
+*           is the estimate least disturbed by other load on the machine        *
+*                                                                               *
+* ARGUMENT LIST:                                                                *
+*                                                                               *
+* Argument  Type         IO     Description                                     *
+* --------- --------     --     ---------------------------------               *
+* bc        BenchCase*   I      Case to run                                     *
+* c         BenchCtx*    IO     Operands                                        *
+* min_ticks uint64_t     I      Minimum length of a run, in BENCH_UNIT          *
+* res       BenchResult* O      Result                                          *
+*                                                                               *
+* RETURN VALUE: double, time per call                                           *
+********************************************************************************/
+static double measure(const BenchCase *bc, BenchCtx *c, uint64_t min_ticks, BenchResult *res)
+{
+    unsigned long iters = 1;
+    unsigned long it;
+    unsigned long calls;
+    unsigned long bytes;
+    uint64_t      t0;
+    uint64_t      dt;
+    double        best = -1;
+    int           run;
+
+    for (;;)
+    {
+        t0 = uBenchNow();
+        for (it = 0; it < iters; it++)
+        {
+            bc->fn(c);
+        }
+        dt = uBenchNow() - t0;
+        if (dt * BENCH_RUNS >= min_ticks || iters >= (1UL << 30))
+        {
+            break;
+        }
+        iters *= 2;
+    }
+
+    calls = uGetAllocCalls();
+    bytes = uGetAllocBytes();
+    for (run = 0; run < BENCH_RUNS; run++)
+    {
+        double per_op;
+
+        t0 = uBenchNow();
+        for (it = 0; it < iters; it++)
+        {
+            bc->fn(c);
+        }
+        dt = uBenchNow() - t0;
+        per_op = (double)dt / (double)iters;
+        if (best < 0 || per_op < best)
+        {
+            best = per_op;
+        }
+    }
+
+    res->kernel        = bc->kernel;
+    res->variant       = bc->variant;
+    res->n             = c->n;
+    res->per_op        = best;
+    res->allocs_per_op = (double)(uGetAllocCalls() - calls) / ((double)BENCH_RUNS * (double)iters);
+    res->bytes_per_op  = (double)(uGetAllocBytes() - bytes) / ((double)BENCH_RUNS * (double)iters);
+
+    return best;
+}
+
+/********************************************************************************
+*                                                                               *
+* FUNCTION NAME: uMatrixBench_Run                                               *
+*                                                                               *
+* PURPOSE: Runs every case matching filter at every size                        *
+*                                                                               *
+* ARGUMENT LIST:                                                                *
+*                                                                               *
+* Argument  Type         IO     Description                                     *
+* --------- --------     --     ---------------------------------               *
+* out       BenchResult* O      Results                                         *
+* cap       size_t       I      Capacity of out                                 *
+* min_ticks uint64_t     I      Minimum length of a run, 0 for the default      *
+* filter    const char*  I      Substring of the kernel names to run, or NULL   *
+*                                                                               *
+* RETURN VALUE: size_t, number of results                                       *
+********************************************************************************/
+size_t uMatrixBench_Run(BenchResult *out, size_t cap, uint64_t min_ticks, const char *filter)
+{
+    BenchCtx c;
+    size_t   s;
+    size_t   k;
+    size_t   n = 0;
+
+    if (min_ticks == 0)
+    {
+        min_ticks = BENCH_MIN_TICKS;
+    }
+    vBenchTimerInit();
+
+    for (s = 0; s < N_SIZES; s++)
+    {
+        ctx_create(&c, sizes[s]);
+        for (k = 0; k < N_CASES && n < cap; k++)
+        {
+            if (filter != NULL && strstr(cases[k].kernel, filter) == NULL)
+            {
+                continue;
+            }
+            measure(&cases[k], &c, min_ticks, &out[n]);
+            n++;
+        }
+        ctx_destroy(&c);
+    }
+
+    return n;
+}
+
+/********************************************************************************
+*                                                                               *
+* FUNCTION NAME: vMatrixBench_Print                                             *
+*                                                                               *
+* PURPOSE: Runs the whole suite with the default run length and emits it,       *
+*           entry point for the firmware build                                  *
+*                                                                               *
+* ARGUMENT LIST:                                                                *
+*                                                                               *
+* Argument  Type         IO     Description                                     *
+* --------- --------     --     ---------------------------------               *
+* emit      BenchEmit    I      Line sink, e.g. chprintf on SD3                 *
+*                                                                               *
+* RETURN VALUE: void                                                            *
+********************************************************************************/
+void vMatrixBench_Print(BenchEmit emit)
+{
+    static BenchResult res[N_CASES * N_SIZES];
+    size_t n;
+
+    n = uMatrixBench_Run(res, N_CASES * N_SIZES, 0, NULL);
+    vBench_Emit(emit, res, n);
+}
+
+#if !defined(BENCH_NO_MAIN)
+
+/*
+ *=============================================================================*
+ *                               HOST EXECUTABLE                               *
+ *=============================================================================*
+ */
+
+static FILE *out_file;
+
+static void emit_file(const char *s)
+{
+    fputs(s, out_file);
+}
+
+int main(int argc, char **argv)
+{
+    static BenchResult res[N_CASES * N_SIZES + 1];
+    static BenchResult run[N_CASES * N_SIZES + 1];
+    const char *out_path      = NULL;
+    const char *baseline_path = NULL;
+    const char *filter        = NULL;
+    double      tol           = 0.50;
+    double      floor         = 20.0;
+    int         strict        = 0;
+    uint64_t    min_ticks     = 0;
+    int         reps          = 1;
+    size_t      n;
+    int         opt;
+    int         fails = 0;
+
+    while ((opt = getopt(argc, argv, "o:b:t:a:m:f:r:s")) != -1)
+    {
+        switch (opt)
+        {
+            case 'o': out_path      = optarg;                                break;
+            case 'b': baseline_path = optarg;                                break;
+            case 't': tol           = atof(optarg);                          break;
+            case 'a': floor         = atof(optarg);                          break;
+            case 'm': min_ticks     = (uint64_t)(atof(optarg) * 1000000.0);  break;
+            case 'f': filter        = optarg;                                break;
+            case 'r': reps          = atoi(optarg);                          break;
+            case 's': strict        = 1;                                     break;
+            default:
+                fprintf(stderr, "usage: %s [-o out.json] [-b baseline.json] [-t tolerance] "
+                                "[-a abs_floor] [-m min_ms] [-f kernel_filter] [-r runs] [-s]\n", argv[0]);
+                return 2;
+        }
+    }
+
+    /* whole runs one after the other: a burst of load spoils one run of a case, not all */
+    n = uMatrixBench_Run(res, N_CASES * N_SIZES, min_ticks, filter);
+    vBench_Reference(&res[n]);
+    for (opt = 1; opt < reps; opt++)
+    {
+        uMatrixBench_Run(run, N_CASES * N_SIZES, min_ticks, filter);
+        vBench_Reference(&run[n]);
+        vBench_Best(res, run, n + 1);
+    }
+    n++;
+
+    out_file = stdout;
+    if (out_path != NULL)
+    {
+        out_file = fopen(out_path, "w");
+        if (out_file == NULL)
+        {
+            perror("failed to open output");
+            return 2;
+        }
+    }
+    vBench_Emit(emit_file, res, n);
+    if (out_file != stdout)
+    {
+        fclose(out_file);
+    }
+
+    if (baseline_path != NULL)
+    {
+        fails = iBench_Compare(baseline_path, res, n, tol, floor, strict);
+        if (fails != 0)
+        {
+            fprintf(stderr, "%d regression(s) against %s\n", fails < 0 ? 0 : fails, baseline_path);
+            return 1;
+        }
+        fprintf(stderr, "no regression against %s (tolerance %.0f%%)\n", baseline_path, tol * 100.0);
+    }
+
+    return 0;
+}
+
+#endif /* BENCH_NO_MAIN */
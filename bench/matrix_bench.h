@@ -0,0 +1,61 @@
+/***********************************************************************************
+* This file is part of The AHRS Project.                                           *
+*                                                                                  *
+* Copyright © 2020 By Nicola di Gruttola Giardino. All rights reserved.            *
+* @mail: nicoladgg@protonmail.com                                                  *
+*                                                                                  *
+* AHRS is free software: you can redistribute it and/or modify                     *
+* it under the terms of the GNU General Public License as published by             *
+* the Free Software Foundation, either version 3 of the License, or                *
+* (at your option) any later version.                                              *
+*                                                                                  *
+* AHRS is distributed in the hope that it will be useful,                          *
+* but WITHOUT ANY WARRANTY; without even the implied warranty of                   *
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the                    *
+* GNU General Public License for more details.                                     *
+*                                                                                  *
+* You should have received a copy of the GNU General Public License                *
+* along with The AHRS Project.  If not, see <https://www.gnu.org/licenses/>.       *
+*                                                                                  *
+* In case of use of this project, I ask you to mention me, to whom it may concern. *
+***********************************************************************************/
+
+/***************************************************************************************************
+*   FILENAME:  matrix_bench.h                                                                      *
+*                                                                                                  *
+*                                                                                                  *
+*   PURPOSE:   Microbenchmark of every public kernel of usrlib/matrix.c, shared by the host        *
+*               executable and by the firmware (USE_MATRIX_BENCH = yes)                            *
+*                                                                                                  *
+*                                                                                                  *
+*                                                                                                  *
+*   GLOBAL VARIABLES:                                                                              *
+*                                                                                                  *
+*                                                                                                  *
+*   Variable        Type        Description                                                        *
+*   --------        ----        -------------------                                                *
+*   none                                                                                           *
+*                                                                                                  *
+*   DEVELOPMENT HISTORY :                                                                          *
+*                                                                                                  *
+*                                                                                                  *
+*   Date          Author            Change Id     Release     Description Of Change                *
+*   ----          ------            -------- -    ------      ----------------------               *
+*   19-10-2026    AHRS Project       1               1         Initial release                     *
+*                                                                                                  *
+***************************************************************************************************/
+
+#ifndef MATRIX_BENCH_h
+#define MATRIX_BENCH_h
+
+/* Include Global Parameters */
+
+#include "bench_report.h"
+
+
+/* Declare Prototypes */
+
+size_t   uMatrixBench_Run     (BenchResult *, size_t, uint64_t, const char *);
+void     vMatrixBench_Print   (BenchEmit);
+
+#endif /* MATRIX_BENCH_h */
@@ -27,6 +27,12 @@
 #include "chprintf.h"
 #include "usrlib/IMU.h"
 #include "usrlib/GPS_Lib.h"
+#if defined(USE_MATRIX_BENCH)
+#include "bench/matrix_bench.h"
+#endif
+#if defined(USE_CHECKPOINT)
+#include "usrlib/Checkpoint.h"
+#endif
 
 /* Definition of Macros */
 
@@ -40,6 +46,9 @@
 #define GPSNOTREADY 0
 #define idYPR 0x12
 #define idSPD 0x13
+#define idNIS 0x14
+#define CHECKPOINT_PERIOD 10000 //IMU samples between checkpoints, 10 s at 1 kHz
+#define PROBE_PERIOD 20 //main loop turns between probe reports, 10 s
 
 /* Define Static Variables */
 
@@ -48,6 +57,21 @@ static int temp_error=0;
 static uint8_t rxbuf[SPI_BUFFERS_SIZE];
 
 static int Release_Thread=0;
+static thread_t *CAN_TX;
+static thread_t *SPIIMU;
+static float quat[4];
+
+#if defined(USE_PROBES)
+static unsigned int probe_count=0;
+#endif
+
+#if defined(USE_CHECKPOINT)
+/* Warm start record, kept in the backup SRAM */
+static CheckpointMem    ckpt_mem;
+static CheckpointStore  ckpt;
+static CheckpointRecord ckpt_rec;
+static unsigned int     ckpt_count=0;
+#endif
 
 /* Define Global Variables */
 
@@ -62,6 +86,7 @@ static int SLEEP_MS = 500;
 HG1120CM hg1120;
 float YPR[3];
 float v[3];
+Matrix *accel;
 char rxUART;
 
 /* Peripherial Configurations */
@@ -75,14 +100,6 @@ static const SerialConfig mySerialConfig =
   0
 };
 
-struct can_instance
-{
-  CANDriver     *canp;
-  uint32_t      led;
-};
-
-static const struct can_instance can1 = {&CAND1, 0};
-
 static const CANConfig cancfg = 
 {
   CAN_MCR_ABOM | CAN_MCR_AWUM | CAN_MCR_TXFP,
@@ -119,6 +136,22 @@ static UARTConfig uart_cfg =
 
 
 
+#if defined(USE_PROBES)
+/* Sink of the probe report, see usrlib/Probe.h */
+static void probe_emit(const char *line)
+{
+  chprintf(chp, "%s", line);
+}
+#endif
+
+#if defined(USE_MATRIX_BENCH)
+/* Sink of the matrix benchmark report, see bench/Makefile */
+static void bench_emit(const char *line)
+{
+  chprintf(chp, "%s", line);
+}
+#endif
+
 /*
  *=============================================================================*
  *                                  THREAD
@@ -135,6 +168,8 @@ static THD_FUNCTION(can_tx, p)
 {
   (void)p;
   CANTxFrame txmsg;
+  float nis[3];
+  unsigned long rejected[3];
   chRegSetThreadName("Transmitter");
 
   while (true) 
@@ -157,6 +192,19 @@ static THD_FUNCTION(can_tx, p)
 	  txmsg.data16[1] = (int)(v[1]*100);
 	  txmsg.data16[2] = (int)(v[2]*100);
     canTransmit(&CAND1, CAN_ANY_MAILBOX, &txmsg, TIME_MS2I(100));
+
+    //GPS gate telemetry: mean NIS per axis and rejected fixes of all axes,
+    //right after the speed, YPR and SPD keep their period of 2*SLEEP_MS
+    vGet_NIS(nis, rejected);
+	  txmsg.IDE = CAN_IDE_EXT;
+ 	  txmsg.EID = idNIS;
+ 	  txmsg.RTR = CAN_RTR_DATA;
+ 	  txmsg.DLC = 8;
+ 	  txmsg.data16[0] = (int)(nis[0]*100);
+	  txmsg.data16[1] = (int)(nis[1]*100);
+	  txmsg.data16[2] = (int)(nis[2]*100);
+	  txmsg.data16[3] = (uint16_t)(rejected[0] + rejected[1] + rejected[2]);
+    canTransmit(&CAND1, CAN_ANY_MAILBOX, &txmsg, TIME_MS2I(100));
     chThdSleepMilliseconds(SLEEP_MS);
   }
   if (Release_Thread) chThdExit((msg_t)OK);
@@ -186,9 +234,18 @@ static THD_FUNCTION(spi_thread_1, p)
 		  spiUnselect(&SPID4);
 		  spiStop(&SPID4);
 		  spiReleaseBus(&SPID4);
+		  PROBE_BEGIN(PROBE_SAMPLE);
 		  Deserialize(rxbuf, 1, &hg1120, 0x04);
+		  PROBE_BEGIN(PROBE_MADGWICK);
 		  MadgwickAHRSupdate(hg1120.AngularRate[0],hg1120.AngularRate[1],hg1120.AngularRate[2],hg1120.LinearAcceleration[0],hg1120.LinearAcceleration[1],hg1120.LinearAcceleration[2],hg1120.MagField[0],hg1120.MagField[1],hg1120.MagField[2]);
-		  vCalculateYPR(YPR);
+		  PROBE_END(PROBE_MADGWICK);
+		  PROBE_BEGIN(PROBE_YPR);
+		  quat[0]=madgwick.q0; quat[1]=madgwick.q1; quat[2]=madgwick.q2; quat[3]=madgwick.q3;
+		  vCalculateYPR(quat, YPR);
+		  PROBE_END(PROBE_YPR);
+		  accel->matrix[0][0] = hg1120.LinearAcceleration[0];
+		  accel->matrix[1][0] = hg1120.LinearAcceleration[1];
+		  accel->matrix[2][0] = hg1120.LinearAcceleration[2];
 		  if(index==100)
       {
 			  //1Hz Frequency for GPS
@@ -202,18 +259,27 @@ static THD_FUNCTION(spi_thread_1, p)
 			  uartStop(&UARTD7);
 			  uartReleaseBus(&UARTD7);
 			  index=0;
-			  vCalculate_velocity(v,GPSREADY);
+			  vCalculate_velocity(v,accel,GPSREADY);
 		  } 
       else 
       {
-			  vCalculate_velocity(v,GPSNOTREADY);
+			  vCalculate_velocity(v,accel,GPSNOTREADY);
+		  }
+#if defined(USE_CHECKPOINT)
+		  if(++ckpt_count>=CHECKPOINT_PERIOD)
+      {
+			  ckpt_count=0;
+			  vCapture_Checkpoint(&ckpt_rec);
+			  iCheckpoint_Save(&ckpt,&ckpt_rec);
 		  }
+#endif
+		  PROBE_END(PROBE_SAMPLE);
 		  //1KHz Frequency for IMU
 		  chThdSleepMilliseconds(1);
 	  }
-	  if (Release_Thread) chThdExit((msg_t)OK);
-	  else chThdExit((msg_t)ERROR_THREAD);
   }
+  if (Release_Thread) chThdExit((msg_t)OK);
+  else chThdExit((msg_t)ERROR_THREAD);
 }
 
 /*
@@ -225,7 +291,33 @@ int main(void)
 {
   halInit();
   chSysInit();
-  vSetup_Kalman();
+#if defined(USE_PROBES)
+  vProbe_Init();
+#endif
+  //no navigation without the axis filters: a failed allocation stops here
+  if (iSetup_Kalman() != 0)
+  {
+    chSysHalt("AHRS filters");
+  }
+  accel = pxCreate(3, 1);
+#if defined(USE_CHECKPOINT)
+  //backup SRAM, kept by VBAT across resets and power cycles
+  rccEnablePWRInterface(true);
+  rccEnableAHB1(RCC_AHB1ENR_BKPSRAMEN, true);
+  PWR->CR1  |= PWR_CR1_DBP;
+  PWR->CSR1 |= PWR_CSR1_BRE;
+  while ((PWR->CSR1 & PWR_CSR1_BRR) == 0)
+  {
+  }
+  ckpt_mem.base = (volatile uint8_t *)BKPSRAM_BASE;
+  ckpt_mem.size = 4096;
+  vCheckpoint_MemStore(&ckpt, &ckpt_mem);
+  //warm start from the last checkpoint, defaults if there is none
+  if (iCheckpoint_Load(&ckpt, &ckpt_rec) == 0)
+  {
+    vRestore_Checkpoint(&ckpt_rec);
+  }
+#endif
   index=0;
   /*
    * ************************************************************************* *
@@ -242,6 +334,10 @@ int main(void)
   sdStart(&SD3, &mySerialConfig);
   //Activates the CAN drivers 1.
   canStart(&CAND1, &cancfg);
+#if defined(USE_MATRIX_BENCH)
+  //Matrix benchmark in DWT cycles, once at boot before the threads start
+  vMatrixBench_Print(bench_emit);
+#endif
 
   /*
    * ************************************************************************* *
@@ -273,11 +369,19 @@ int main(void)
    * ************************************************************************* *
    */
   cls(chp);
-  CAN_TX = chThdCreateStatic(can_rx_wa, sizeof(can_rx_wa), NORMALPRIO + 9,can_rx, (void *)&can1);
-  CAN_RX = chThdCreateStatic(can_tx_wa, sizeof(can_tx_wa), NORMALPRIO + 8,can_tx, NULL);
+  CAN_TX = chThdCreateStatic(can_tx_wa, sizeof(can_tx_wa), NORMALPRIO + 8,can_tx, NULL);
   SPIIMU = chThdCreateStatic(spi_thread_1_wa, sizeof(spi_thread_1_wa), NORMALPRIO + 4, spi_thread_1, NULL);
   while (true) 
   {
     chThdSleepMilliseconds(500);
+#if defined(USE_PROBES)
+    //phase timings of the last period on SD3, one JSON line per probe
+    if(++probe_count>=PROBE_PERIOD)
+    {
+      probe_count=0;
+      vProbe_Print(probe_emit);
+      vProbe_Reset();
+    }
+#endif
   }
 }
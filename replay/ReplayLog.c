@@ -0,0 +1,544 @@
+/***********************************************************************************
+* This file is part of The AHRS Project.                                           *
+*                                                                                  *
+* Copyright © 2020 By Nicola di Gruttola Giardino. All rights reserved.            *
+* @mail: nicoladgg@protonmail.com                                                  *
+*                                                                                  *
+* AHRS is free software: you can redistribute it and/or modify                     *
+* it under the terms of the GNU General Public License as published by             *
+* the Free Software Foundation, either version 3 of the License, or                *
+* (at your option) any later version.                                              *
+*                                                                                  *
+* AHRS is distributed in the hope that it will be useful,                          *
+* but WITHOUT ANY WARRANTY; without even the implied warranty of                   *
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the                    *
+* GNU General Public License for more details.                                     *
+*                                                                                  *
+* You should have received a copy of the GNU General Public License                *
+* along with The AHRS Project.  If not, see <https://www.gnu.org/licenses/>.       *
+*                                                                                  *
+* In case of use of this project, I ask you to mention me, to whom it may concern. *
+***********************************************************************************/
+
+/****************************************************************************************************
+* FILE NAME: ReplayLog.c                                                                            *
+*                                                                                                   *
+* PURPOSE: Reader and writer of the AHRSLOG1 sensor logs and writer of the AHRSCOL1 columnar        *
+*           results, see ReplayLog.h                                                                *
+*                                                                                                   *
+* FILE REFERENCES:                                                                                  *
+*                                                                                                   *
+*   Name    I/O     Description                                                                     *
+*   ----    ---     -----------                                                                     *
+*   none                                                                                            *
+*                                                                                                   *
+*                                                                                                   *
+* EXTERNAL VARIABLES:                                                                               *
+*                                                                                                   *
+* Source: <ReplayLog.h>                                                                             *
+*                                                                                                   *
+* Name          Type          IO Description                                                        *
+* ------------- -------       -- -----------------------------                                      *
+*   none                                                                                            *
+*                                                                                                   *
+* STATIC VARIABLES:                                                                                 *
+*                                                                                                   *
+*   Name         Type          I/O  Description                                                     *
+*   ----         ----          ---  -----------                                                     *
+*   col_desc     ReplayColDesc[]    Descriptors of the output columns                               *
+*                                                                                                   *
+* EXTERNAL REFERENCES:                                                                              *
+*                                                                                                   *
+*  Name                       Description                                                           *
+*  -------------              -----------                                                           *
+*  none                                                                                             *
+*                                                                                                   *
+* ABNORMAL TERMINATION CONDITIONS, ERROR AND WARNING MESSAGES:                                      *
+*    none, every function returns -1 on a short read or write, a bad header or an unknown record    *
+*                                                                                                   *
+* ASSUMPTIONS, CONSTRAINTS, RESTRICTIONS: none                                                      *
+*                                                                                                   *
+* NOTES: the byte order of the files does not depend on the host: every value goes through          *
+*    uLoad32 and vStore32                                                                           *
+*                                                                                                   *
+* REQUIREMENTS/FUNCTIONAL SPECIFICATIONS REFERENCES:                                                *
+*                                                                                                   *
+* DEVELOPMENT HISTORY:                                                                              *
+*                                                                                                   *
+*   Date          Author            Change Id     Release     Description Of Change                 *
+*   ----          ------            ---------     ------      ----------------------                *
+*   19-10-2026    AHRS Project       1               1         Initial release                      *
+*                                                                                                   *
+****************************************************************************************************/
+
+/* Include Global Parameters */
+
+#include <stdlib.h>
+#include <string.h>
+#include "ReplayLog.h"
+
+/*
+* ReplayColDesc Object:
+*       16 byte descriptor of one column of AHRSCOL1
+*/
+
+typedef struct ReplayColDesc
+{
+    char name[15];
+    char type;
+}ReplayColDesc;
+
+/* Define Static Variables */
+
+static const ReplayColDesc col_desc[REPLAY_COLUMNS] =
+{
+    {"sample", 'u'},
+    {"q0",     'f'},
+    {"q1",     'f'},
+    {"q2",     'f'},
+    {"q3",     'f'},
+    {"yaw",    'f'},
+    {"pitch",  'f'},
+    {"roll",   'f'},
+    {"pn",     'f'},
+    {"pe",     'f'},
+    {"pd",     'f'},
+    {"vn",     'f'},
+    {"ve",     'f'},
+    {"vd",     'f'},
+    {"gps",    'u'},
+};
+
+/********************************************************************************
+*                                                                               *
+* FUNCTION NAME: uLoad32                                                        *
+*                                                                               *
+* PURPOSE: Little endian uint32 of 4 bytes                                      *
+*                                                                               *
+* ARGUMENT LIST:                                                                *
+*                                                                               *
+* Argument  Type         IO     Description                                     *
+* --------- --------     --     ---------------------------------               *
+* b         uint8_t*     I      Bytes                                           *
+*                                                                               *
+* RETURN VALUE: uint32_t                                                        *
+*                                                                               *
+********************************************************************************/
+static uint32_t uLoad32(const uint8_t *b)
+{
+    return (uint32_t)b[0] | ((uint32_t)b[1] << 8) | ((uint32_t)b[2] << 16) | ((uint32_t)b[3] << 24);
+}
+
+/********************************************************************************
+*                                                                               *
+* FUNCTION NAME: vStore32                                                       *
+*                                                                               *
+* PURPOSE: 4 little endian bytes of a uint32                                    *
+*                                                                               *
+* ARGUMENT LIST:                                                                *
+*                                                                               *
+* Argument  Type         IO     Description                                     *
+* --------- --------     --     ---------------------------------               *
+* b         uint8_t*     O      Bytes                                           *
+* v         uint32_t     I      Value                                           *
+*                                                                               *
+* RETURN VALUE: void                                                            *
+*                                                                               *
+********************************************************************************/
+static void vStore32(uint8_t *b, uint32_t v)
+{
+    b[0] = (uint8_t)v;
+    b[1] = (uint8_t)(v >> 8);
+    b[2] = (uint8_t)(v >> 16);
+    b[3] = (uint8_t)(v >> 24);
+}
+
+/********************************************************************************
+*                                                                               *
+* FUNCTION NAME: uFloatBits                                                     *
+*                                                                               *
+* PURPOSE: Bits of a float32                                                    *
+*                                                                               *
+* ARGUMENT LIST:                                                                *
+*                                                                               *
+* Argument  Type         IO     Description                                     *
+* --------- --------     --     ---------------------------------               *
+* x         float        I      Value                                           *
+*                                                                               *
+* RETURN VALUE: uint32_t                                                        *
+*                                                                               *
+********************************************************************************/
+static uint32_t uFloatBits(float x)
+{
+    uint32_t u;
+
+    memcpy(&u, &x, sizeof(u));
+    return u;
+}
+
+/********************************************************************************
+*                                                                               *
+* FUNCTION NAME: iReplayLog_WriteHeader                                         *
+*                                                                               *
+* PURPOSE: Writes the header of a log, returning -1 if failed,                  *
+*           0 if successfull                                                    *
+*                                                                               *
+* ARGUMENT LIST:                                                                *
+*                                                                               *
+* Argument  Type         IO     Description                                     *
+* --------- --------     --     ---------------------------------               *
+* f         FILE*        O      Log, at its start                               *
+* rate      uint32_t     I      IMU rate in Hz                                  *
+*                                                                               *
+* RETURN VALUE: int                                                             *
+*                                                                               *
+********************************************************************************/
+int iReplayLog_WriteHeader(FILE *f, uint32_t rate)
+{
+    uint8_t b[16];
+
+    memcpy(b, REPLAY_LOG_MAGIC, 8);
+    vStore32(b + 8, REPLAY_LOG_VERSION);
+    vStore32(b + 12, rate);
+
+    return fwrite(b, sizeof(b), 1, f) == 1 ? 0 : -1;
+}
+
+/********************************************************************************
+*                                                                               *
+* FUNCTION NAME: iReplayLog_WriteIMU                                            *
+*                                                                               *
+* PURPOSE: Appends an IMU sample to a log, returning -1 if                      *
+*           failed, 0 if successfull                                            *
+*                                                                               *
+* ARGUMENT LIST:                                                                *
+*                                                                               *
+* Argument  Type         IO     Description                                     *
+* --------- --------     --     ---------------------------------               *
+* f         FILE*        O      Log                                             *
+* imu       const float* I      Rate, acceleration, field                       *
+*                                                                               *
+* RETURN VALUE: int                                                             *
+*                                                                               *
+********************************************************************************/
+int iReplayLog_WriteIMU(FILE *f, const float imu[REPLAY_IMU_FLOATS])
+{
+    uint8_t b[1 + 4 * REPLAY_IMU_FLOATS];
+
+    b[0] = REPLAY_REC_IMU;
+    for (int i = 0; i < REPLAY_IMU_FLOATS; i++)
+    {
+        vStore32(b + 1 + 4 * i, uFloatBits(imu[i]));
+    }
+
+    return fwrite(b, sizeof(b), 1, f) == 1 ? 0 : -1;
+}
+
+/********************************************************************************
+*                                                                               *
+* FUNCTION NAME: iReplayLog_WriteNMEA                                           *
+*                                                                               *
+* PURPOSE: Appends GPS bytes to a log, in records of at most                    *
+*           REPLAY_NMEA_MAX bytes, returning -1 if failed, 0 if                 *
+*           successfull                                                         *
+*                                                                               *
+* ARGUMENT LIST:                                                                *
+*                                                                               *
+* Argument  Type         IO     Description                                     *
+* --------- --------     --     ---------------------------------               *
+* f         FILE*        O      Log                                             *
+* nmea      const uint8_t*I      Bytes of the UART                              *
+* n         size_t       I      Number of bytes                                 *
+*                                                                               *
+* RETURN VALUE: int                                                             *
+*                                                                               *
+********************************************************************************/
+int iReplayLog_WriteNMEA(FILE *f, const uint8_t *nmea, size_t n)
+{
+    while (n > 0)
+    {
+        size_t  len = n < REPLAY_NMEA_MAX ? n : REPLAY_NMEA_MAX;
+        uint8_t b[3];
+
+        b[0] = REPLAY_REC_NMEA;
+        b[1] = (uint8_t)len;
+        b[2] = (uint8_t)(len >> 8);
+        if (fwrite(b, sizeof(b), 1, f) != 1 || fwrite(nmea, 1, len, f) != len)
+        {
+            return -1;
+        }
+        nmea += len;
+        n    -= len;
+    }
+
+    return 0;
+}
+
+/********************************************************************************
+*                                                                               *
+* FUNCTION NAME: iReplayLog_ReadHeader                                          *
+*                                                                               *
+* PURPOSE: Reads and checks the header of a log, returning -1                   *
+*           if it is not an AHRSLOG1 log of this version, 0 if                  *
+*           successfull                                                         *
+*                                                                               *
+* ARGUMENT LIST:                                                                *
+*                                                                               *
+* Argument  Type         IO     Description                                     *
+* --------- --------     --     ---------------------------------               *
+* f         FILE*        I      Log, at its start                               *
+* rate      uint32_t*    O      IMU rate in Hz                                  *
+*                                                                               *
+* RETURN VALUE: int                                                             *
+*                                                                               *
+********************************************************************************/
+int iReplayLog_ReadHeader(FILE *f, uint32_t *rate)
+{
+    uint8_t b[16];
+
+    if (fread(b, sizeof(b), 1, f) != 1 || memcmp(b, REPLAY_LOG_MAGIC, 8) != 0 ||
+        uLoad32(b + 8) != REPLAY_LOG_VERSION)
+    {
+        return -1;
+    }
+    *rate = uLoad32(b + 12);
+
+    return *rate > 0 ? 0 : -1;
+}
+
+/********************************************************************************
+*                                                                               *
+* FUNCTION NAME: iReplayLog_Read                                                *
+*                                                                               *
+* PURPOSE: Reads the next record of a log, returning 1 if a                     *
+*           record was read, 0 at the end of the log, -1 if it is               *
+*           truncated or the record is unknown                                  *
+*                                                                               *
+* ARGUMENT LIST:                                                                *
+*                                                                               *
+* Argument  Type         IO     Description                                     *
+* --------- --------     --     ---------------------------------               *
+* f         FILE*        I      Log, after the header                           *
+* r         ReplayRecord*O      Record                                          *
+*                                                                               *
+* RETURN VALUE: int                                                             *
+*                                                                               *
+********************************************************************************/
+int iReplayLog_Read(FILE *f, ReplayRecord *r)
+{
+    uint8_t b[4 * REPLAY_IMU_FLOATS];
+    int     type = getc(f);
+
+    if (type == EOF)
+    {
+        return ferror(f) ? -1 : 0;
+    }
+    r->type = type;
+    switch (type)
+    {
+    case REPLAY_REC_IMU:
+        if (fread(b, sizeof(b), 1, f) != 1)
+        {
+            return -1;
+        }
+        for (int i = 0; i < REPLAY_IMU_FLOATS; i++)
+        {
+            uint32_t u = uLoad32(b + 4 * i);
+
+            memcpy(&r->imu[i], &u, sizeof(u));
+        }
+        return 1;
+    case REPLAY_REC_NMEA:
+        if (fread(b, 2, 1, f) != 1)
+        {
+            return -1;
+        }
+        r->n = (uint16_t)(b[0] | (b[1] << 8));
+        return fread(r->nmea, 1, r->n, f) == r->n ? 1 : -1;
+    default:
+        return -1;
+    }
+}
+
+/********************************************************************************
+*                                                                               *
+* FUNCTION NAME: iReplayCol_Open                                                *
+*                                                                               *
+* PURPOSE: Creates an AHRSCOL1 file and writes its header,                      *
+*           returning -1 if failed, 0 if successfull                            *
+*                                                                               *
+* ARGUMENT LIST:                                                                *
+*                                                                               *
+* Argument  Type         IO     Description                                     *
+* --------- --------     --     ---------------------------------               *
+* c         ReplayColumns*O      Writer                                         *
+* path      const char*  I      File                                            *
+*                                                                               *
+* RETURN VALUE: int                                                             *
+*                                                                               *
+********************************************************************************/
+int iReplayCol_Open(ReplayColumns *c, const char *path)
+{
+    uint8_t b[16];
+
+    memset(c, 0, sizeof(*c));
+    for (int i = 0; i < REPLAY_COLUMNS; i++)
+    {
+        c->col[i] = malloc(REPLAY_BLOCK_ROWS * sizeof(uint32_t));
+        if (c->col[i] == NULL)
+        {
+            iReplayCol_Close(c);
+            return -1;
+        }
+    }
+    c->f = fopen(path, "wb");
+    if (c->f == NULL)
+    {
+        iReplayCol_Close(c);
+        return -1;
+    }
+
+    memcpy(b, REPLAY_COL_MAGIC, 8);
+    vStore32(b + 8, REPLAY_COL_VERSION);
+    vStore32(b + 12, REPLAY_COLUMNS);
+    if (fwrite(b, sizeof(b), 1, c->f) != 1 || fwrite(col_desc, sizeof(col_desc), 1, c->f) != 1)
+    {
+        iReplayCol_Close(c);
+        return -1;
+    }
+
+    return 0;
+}
+
+/********************************************************************************
+*                                                                               *
+* FUNCTION NAME: iReplayCol_Flush                                               *
+*                                                                               *
+* PURPOSE: Writes the block of the rows appended so far,                        *
+*           returning -1 if failed, 0 if successfull                            *
+*                                                                               *
+* ARGUMENT LIST:                                                                *
+*                                                                               *
+* Argument  Type         IO     Description                                     *
+* --------- --------     --     ---------------------------------               *
+* c         ReplayColumns*IO     Writer                                         *
+*                                                                               *
+* RETURN VALUE: int                                                             *
+*                                                                               *
+********************************************************************************/
+static int iReplayCol_Flush(ReplayColumns *c)
+{
+    uint8_t b[4];
+
+    if (c->rows == 0)
+    {
+        return 0;
+    }
+    vStore32(b, c->rows);
+    if (fwrite(b, sizeof(b), 1, c->f) != 1)
+    {
+        return -1;
+    }
+    for (int i = 0; i < REPLAY_COLUMNS; i++)
+    {
+        //the words are stored little endian already, see iReplayCol_Append
+        if (fwrite(c->col[i], sizeof(uint32_t), c->rows, c->f) != c->rows)
+        {
+            return -1;
+        }
+    }
+    c->rows = 0;
+
+    return 0;
+}
+
+/********************************************************************************
+*                                                                               *
+* FUNCTION NAME: iReplayCol_Append                                              *
+*                                                                               *
+* PURPOSE: Appends a row, writing the block when it is full,                    *
+*           returning -1 if failed, 0 if successfull                            *
+*                                                                               *
+* ARGUMENT LIST:                                                                *
+*                                                                               *
+* Argument  Type         IO     Description                                     *
+* --------- --------     --     ---------------------------------               *
+* c         ReplayColumns*IO     Writer                                         *
+* r         const ReplayRow*I      Row                                          *
+*                                                                               *
+* RETURN VALUE: int                                                             *
+*                                                                               *
+********************************************************************************/
+int iReplayCol_Append(ReplayColumns *c, const ReplayRow *r)
+{
+    uint32_t v[REPLAY_COLUMNS];
+    int      n = 0;
+
+    v[n++] = r->sample;
+    for (int i = 0; i < 4; i++)
+    {
+        v[n++] = uFloatBits(r->q[i]);
+    }
+    for (int i = 0; i < 3; i++)
+    {
+        v[n++] = uFloatBits(r->ypr[i]);
+    }
+    for (int i = 0; i < 3; i++)
+    {
+        v[n++] = uFloatBits(r->pos[i]);
+    }
+    for (int i = 0; i < 3; i++)
+    {
+        v[n++] = uFloatBits(r->vel[i]);
+    }
+    v[n++] = r->gps;
+
+    for (int i = 0; i < REPLAY_COLUMNS; i++)
+    {
+        vStore32((uint8_t *)&c->col[i][c->rows], v[i]);
+    }
+    if (++c->rows == REPLAY_BLOCK_ROWS)
+    {
+        return iReplayCol_Flush(c);
+    }
+
+    return 0;
+}
+
+/********************************************************************************
+*                                                                               *
+* FUNCTION NAME: iReplayCol_Close                                               *
+*                                                                               *
+* PURPOSE: Writes the last block and closes the file, returning                 *
+*           -1 if failed, 0 if successfull                                      *
+*                                                                               *
+* ARGUMENT LIST:                                                                *
+*                                                                               *
+* Argument  Type         IO     Description                                     *
+* --------- --------     --     ---------------------------------               *
+* c         ReplayColumns*IO     Writer                                         *
+*                                                                               *
+* RETURN VALUE: int                                                             *
+*                                                                               *
+********************************************************************************/
+int iReplayCol_Close(ReplayColumns *c)
+{
+    int ret = 0;
+
+    if (c->f != NULL)
+    {
+        ret = iReplayCol_Flush(c);
+        if (fclose(c->f) != 0)
+        {
+            ret = -1;
+        }
+        c->f = NULL;
+    }
+    for (int i = 0; i < REPLAY_COLUMNS; i++)
+    {
+        free(c->col[i]);
+        c->col[i] = NULL;
+    }
+
+    return ret;
+}
@@ -0,0 +1,145 @@
+/***********************************************************************************
+* This file is part of The AHRS Project.                                           *
+*                                                                                  *
+* Copyright © 2020 By Nicola di Gruttola Giardino. All rights reserved.            *
+* @mail: nicoladgg@protonmail.com                                                  *
+*                                                                                  *
+* AHRS is free software: you can redistribute it and/or modify                     *
+* it under the terms of the GNU General Public License as published by             *
+* the Free Software Foundation, either version 3 of the License, or                *
+* (at your option) any later version.                                              *
+*                                                                                  *
+* AHRS is distributed in the hope that it will be useful,                          *
+* but WITHOUT ANY WARRANTY; without even the implied warranty of                   *
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the                    *
+* GNU General Public License for more details.                                     *
+*                                                                                  *
+* You should have received a copy of the GNU General Public License                *
+* along with The AHRS Project.  If not, see <https://www.gnu.org/licenses/>.       *
+*                                                                                  *
+* In case of use of this project, I ask you to mention me, to whom it may concern. *
+***********************************************************************************/
+
+/***************************************************************************************************
+*   FILENAME:  ReplayLog.h                                                                         *
+*                                                                                                  *
+*                                                                                                  *
+*   PURPOSE:  Recorded sensor logs of the AHRS (AHRSLOG1: IMU samples and NMEA bytes in the        *
+*               order of arrival) and the columnar results of a replay (AHRSCOL1), shared by the   *
+*               replay and by the tools that write logs                                            *
+*                                                                                                  *
+*                                                                                                  *
+*                                                                                                  *
+*   GLOBAL VARIABLES:                                                                              *
+*                                                                                                  *
+*                                                                                                  *
+*   Variable        Type        Description                                                        *
+*   --------        ----        -------------------                                                *
+*   ReplayRecord    ReplayRecord One record of a log                                               *
+*   ReplayRow       ReplayRow   One output row, one IMU sample                                     *
+*   ReplayColumns   ReplayColumns Columnar writer of the rows                                      *
+*                                                                                                  *
+*   DEVELOPMENT HISTORY :                                                                          *
+*                                                                                                  *
+*                                                                                                  *
+*   Date          Author            Change Id     Release     Description Of Change                *
+*   ----          ------            -------- -    ------      ----------------------               *
+*   19-10-2026    AHRS Project       1               1         Initial release                     *
+*                                                                                                  *
+***************************************************************************************************/
+
+#ifndef ReplayLog_h
+#define ReplayLog_h
+
+/* Include Global Parameters */
+
+#include <stdint.h>
+#include <stdio.h>
+
+/* Definition of Macros */
+
+/*
+* AHRSLOG1, all little endian: a 16 byte header, "AHRSLOG1", uint32 version,
+* uint32 IMU rate in Hz, then records of one type byte each:
+*   'I'  9 float32, angular rate (rad/s), acceleration (m/s^2), magnetic field,
+*        x y z each, as in HG1120CM
+*   'G'  uint16 n, then n bytes of the GPS UART
+* the time of a record is the number of 'I' records before it over the rate
+*/
+#define REPLAY_LOG_MAGIC     "AHRSLOG1"
+#define REPLAY_LOG_VERSION   1U
+#define REPLAY_REC_IMU       'I'
+#define REPLAY_REC_NMEA      'G'
+#define REPLAY_IMU_FLOATS    9
+#define REPLAY_NMEA_MAX      65535U
+
+/*
+* AHRSCOL1, all little endian: "AHRSCOL1", uint32 version, uint32 number of
+* columns, a 16 byte descriptor per column (name NUL padded to 15 bytes, type
+* 'u' uint32 or 'f' float32), then blocks: uint32 rows, then the rows of the
+* first column, of the second and so on, 4 bytes each; the last block may be
+* shorter than REPLAY_BLOCK_ROWS
+*/
+#define REPLAY_COL_MAGIC     "AHRSCOL1"
+#define REPLAY_COL_VERSION   1U
+#define REPLAY_COLUMNS       15
+#define REPLAY_BLOCK_ROWS    65536U
+
+/*
+* ReplayRecord Object:
+*       one record of a log: type REPLAY_REC_IMU with imu, or REPLAY_REC_NMEA
+*       with n bytes in nmea
+*/
+
+typedef struct ReplayRecord
+{
+    int      type;
+    float    imu[REPLAY_IMU_FLOATS];
+    uint16_t n;
+    uint8_t  nmea[REPLAY_NMEA_MAX];
+}ReplayRecord;
+
+/*
+* ReplayRow Object:
+*       the state after one IMU sample: its index, the quaternion, yaw, pitch
+*       and roll, position and velocity North, East, Down of the axis filters
+*       and gps, 1 if a new GPS fix came with this sample (the gate of the
+*       filters may still have rejected it)
+*/
+
+typedef struct ReplayRow
+{
+    uint32_t sample;
+    float    q[4];
+    float    ypr[3];
+    float    pos[3];
+    float    vel[3];
+    uint32_t gps;
+}ReplayRow;
+
+/*
+* ReplayColumns Object:
+*       an AHRSCOL1 file being written: a block of REPLAY_BLOCK_ROWS rows per
+*       column, written when full and by iReplayCol_Close
+*/
+
+typedef struct ReplayColumns
+{
+    FILE*     f;
+    uint32_t  rows;
+    uint32_t* col[REPLAY_COLUMNS];
+}ReplayColumns;
+
+/* Declare Prototypes */
+
+int     iReplayLog_WriteHeader  (FILE *, uint32_t);
+int     iReplayLog_WriteIMU     (FILE *, const float [REPLAY_IMU_FLOATS]);
+int     iReplayLog_WriteNMEA    (FILE *, const uint8_t *, size_t);
+int     iReplayLog_ReadHeader   (FILE *, uint32_t *);
+int     iReplayLog_Read         (FILE *, ReplayRecord *);
+
+int     iReplayCol_Open         (ReplayColumns *, const char *);
+int     iReplayCol_Append       (ReplayColumns *, const ReplayRow *);
+int     iReplayCol_Close        (ReplayColumns *);
+
+#endif /* ReplayLog_h */
@@ -0,0 +1,741 @@
+/***********************************************************************************
+* This file is part of The AHRS Project.                                           *
+*                                                                                  *
+* Copyright © 2020 By Nicola di Gruttola Giardino. All rights reserved.            *
+* @mail: nicoladgg@protonmail.com                                                  *
+*                                                                                  *
+* AHRS is free software: you can redistribute it and/or modify                     *
+* it under the terms of the GNU General Public License as published by             *
+* the Free Software Foundation, either version 3 of the License, or                *
+* (at your option) any later version.                                              *
+*                                                                                  *
+* AHRS is distributed in the hope that it will be useful,                          *
+* but WITHOUT ANY WARRANTY; without even the implied warranty of                   *
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the                    *
+* GNU General Public License for more details.                                     *
+*                                                                                  *
+* You should have received a copy of the GNU General Public License                *
+* along with The AHRS Project.  If not, see <https://www.gnu.org/licenses/>.       *
+*                                                                                  *
+* In case of use of this project, I ask you to mention me, to whom it may concern. *
+***********************************************************************************/
+
+/****************************************************************************************************
+* FILE NAME: gen.c                                                                                  *
+*                                                                                                   *
+* PURPOSE: Synthetic sensor logs with known truth for the replay and the benchmarks: a trajectory   *
+*           (static, figure-8, coordinated turn, vibration), the HG1120 samples it produces with    *
+*           bias, scale error and noise, the GPRMC and GPGGA sentences of its GPS fixes, streamed   *
+*           as an AHRSLOG1 log, the truth as AHRSCOL1 columns                                       *
+*                                                                                                   *
+* FILE REFERENCES:                                                                                  *
+*                                                                                                   *
+*   Name    I/O     Description                                                                     *
+*   ----    ---     -----------                                                                     *
+*   none                                                                                            *
+*                                                                                                   *
+*                                                                                                   *
+* EXTERNAL VARIABLES:                                                                               *
+*                                                                                                   *
+* Source: <ReplayLog.h>                                                                             *
+*                                                                                                   *
+* Name          Type          IO Description                                                        *
+* ------------- -------       -- -----------------------------                                      *
+*   none                                                                                            *
+*                                                                                                   *
+* STATIC VARIABLES:                                                                                 *
+*                                                                                                   *
+*   Name         Type          I/O  Description                                                     *
+*   ----         ----          ---  -----------                                                     *
+*   traj         GenTrajectory[]    The trajectories by name                                        *
+*                                                                                                   *
+* EXTERNAL REFERENCES:                                                                              *
+*                                                                                                   *
+*  Name                       Description                                                           *
+*  -------------              -----------                                                           *
+*  fRngNormal                 Sensor errors, rng.c                                                  *
+*  iReplayLog_WriteIMU        Log, ReplayLog.c                                                      *
+*  iReplayCol_Append          Truth, ReplayLog.c                                                    *
+*                                                                                                   *
+* ABNORMAL TERMINATION CONDITIONS, ERROR AND WARNING MESSAGES:                                      *
+*    bad options: usage on stderr and exit status 1; an output that cannot be written: message on   *
+*    stderr and exit status 1                                                                       *
+*                                                                                                   *
+* ASSUMPTIONS, CONSTRAINTS, RESTRICTIONS: the log carries no time: the IMU samples are evenly       *
+*    spaced at the rate of its header, a fix is written just before the sample of its epoch         *
+*                                                                                                   *
+* NOTES: frames of Madgwick and of the recorded logs: sensor x forward, y left, z up,               *
+*    accelerometer +g on z at rest; navigation frame North, West, Up. The truth columns give        *
+*    position and velocity North, East, Down, the angles and the quaternion (sensor to navigation   *
+*    frame) as generated                                                                            *
+*                                                                                                   *
+* REQUIREMENTS/FUNCTIONAL SPECIFICATIONS REFERENCES:                                                *
+*                                                                                                   *
+* DEVELOPMENT HISTORY:                                                                              *
+*                                                                                                   *
+*   Date          Author            Change Id     Release     Description Of Change                 *
+*   ----          ------            ---------     ------      ----------------------                *
+*   19-10-2026    AHRS Project       1               1         Initial release                      *
+*                                                                                                   *
+****************************************************************************************************/
+
+/* Include Global Parameters */
+
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+#include "rng.h"
+#include "ReplayLog.h"
+
+/* Definition of Macros */
+
+#define GEN_G            9.80665        /* m/s^2 */
+#define GEN_R_EARTH      6378137.0      /* m, equatorial radius of WGS84 */
+#define GEN_MS_TO_KNOTS  1.943844
+#define GEN_EPOCH        1792411200L    /* 19/10/2026 12:00:00 UTC, time of the first sample */
+#define GEN_IO_BUFFER    (1 << 20)
+
+/* earth field, Gauss, and its inclination, about those of southern Italy */
+#define GEN_MAG_FIELD    0.45
+#define GEN_MAG_INCL     (56.0 * M_PI / 180.0)
+
+/* vibration: vertical acceleration and roll and pitch oscillations of an engine mount */
+#define GEN_VIB_ACC      3.0            /* m/s^2 */
+#define GEN_VIB_ACC_HZ   87.0
+#define GEN_VIB_ANGLE    (0.2 * M_PI / 180.0)
+#define GEN_VIB_ROLL_HZ  53.0
+#define GEN_VIB_PITCH_HZ 61.0
+
+/*
+* GenConfig Object:
+*       a run: duration (s), IMU and GPS rates (Hz, no GPS at 0), speed (m/s)
+*       and size (m) of the trajectory, the origin of the GPS (degrees and m),
+*       the sensor errors at an error scale of 1: gyro and accelerometer bias
+*       and noise (rad/s, m/s^2, standard deviation, the noise per sample),
+*       scale error (fraction), magnetometer noise (Gauss), GPS noise (m)
+*/
+
+typedef struct GenConfig
+{
+    double   duration;
+    uint32_t imu_rate;
+    uint32_t gps_rate;
+    double   speed;
+    double   size;
+    double   origin[3];
+    double   errors;
+    double   gyro_bias;
+    double   gyro_noise;
+    double   acc_bias;
+    double   acc_noise;
+    double   scale;
+    double   mag_noise;
+    double   gps_noise[2];
+}GenConfig;
+
+/*
+* GenState Object:
+*       the truth at one time: position, velocity and acceleration in the
+*       navigation frame, yaw, pitch and roll of the sensor and their rates
+*/
+
+typedef struct GenState
+{
+    double pos[3];
+    double vel[3];
+    double acc[3];
+    double euler[3];
+    double rate[3];
+}GenState;
+
+/*
+* GenSensor Object:
+*       errors of one triad: bias and scale error of each axis, drawn once per
+*       run, and the standard deviation of the noise
+*/
+
+typedef struct GenSensor
+{
+    double bias[3];
+    double scale[3];
+    double noise;
+}GenSensor;
+
+/*
+* GenTrajectory Object:
+*       name of a trajectory and the function of its truth at time t
+*/
+
+typedef struct GenTrajectory
+{
+    const char* name;
+    void      (*pvState)(const GenConfig *, double, GenState *);
+}GenTrajectory;
+
+/********************************************************************************
+*                                                                               *
+* FUNCTION NAME: vTraj_Static                                                   *
+*                                                                               *
+* PURPOSE: At rest, level, heading North                                        *
+*                                                                               *
+* ARGUMENT LIST:                                                                *
+*                                                                               *
+* Argument  Type         IO     Description                                     *
+* --------- --------     --     ---------------------------------               *
+* c         GenConfig*   I      Run                                             *
+* t         double       I      Time, s                                         *
+* s         GenState*    O      Truth                                           *
+*                                                                               *
+* RETURN VALUE: void                                                            *
+*                                                                               *
+********************************************************************************/
+static void vTraj_Static(const GenConfig *c, double t, GenState *s)
+{
+    (void)c;
+    (void)t;
+    memset(s, 0, sizeof(*s));
+}
+
+/********************************************************************************
+*                                                                               *
+* FUNCTION NAME: vTraj_Figure8                                                  *
+*                                                                               *
+* PURPOSE: Level figure-8 (lemniscate of Gerono) of half width                  *
+*           size, at speed about speed in its centre, banked as                 *
+*           a coordinated turn and heading along the path                       *
+*                                                                               *
+* ARGUMENT LIST:                                                                *
+*                                                                               *
+* Argument  Type         IO     Description                                     *
+* --------- --------     --     ---------------------------------               *
+* c         GenConfig*   I      Run                                             *
+* t         double       I      Time, s                                         *
+* s         GenState*    O      Truth                                           *
+*                                                                               *
+* RETURN VALUE: void                                                            *
+*                                                                               *
+********************************************************************************/
+static void vTraj_Figure8(const GenConfig *c, double t, GenState *s)
+{
+    const double a = c->size;
+    const double w = c->speed / (a * M_SQRT2);
+    const double s1 = sin(w * t), c1 = cos(w * t);
+    const double s2 = 2 * s1 * c1, c2 = c1 * c1 - s1 * s1;
+    double jerk[2], v, cross, u;
+
+    memset(s, 0, sizeof(*s));
+    s->pos[0] = a * s1;
+    s->pos[1] = a / 2 * s2;
+    s->vel[0] = a * w * c1;
+    s->vel[1] = a * w * c2;
+    s->acc[0] = -a * w * w * s1;
+    s->acc[1] = -2 * a * w * w * s2;
+    jerk[0]   = -a * w * w * w * c1;
+    jerk[1]   = -4 * a * w * w * w * c2;
+
+    //heading along the velocity, never 0 on this curve; the bank leaves no
+    //lateral force: roll = -atan(v * yaw rate / g)
+    v     = sqrt(s->vel[0] * s->vel[0] + s->vel[1] * s->vel[1]);
+    cross = s->vel[0] * s->acc[1] - s->vel[1] * s->acc[0];
+    u     = cross / (v * GEN_G);
+    s->euler[0] = atan2(s->vel[1], s->vel[0]);
+    s->euler[2] = -atan(u);
+    s->rate[0]  = cross / (v * v);
+    s->rate[2]  = -((s->vel[0] * jerk[1] - s->vel[1] * jerk[0]) * v -
+                    cross * (s->vel[0] * s->acc[0] + s->vel[1] * s->acc[1]) / v) /
+                  (v * v * GEN_G) / (1 + u * u);
+}
+
+/********************************************************************************
+*                                                                               *
+* FUNCTION NAME: vTraj_Turn                                                     *
+*                                                                               *
+* PURPOSE: Level coordinated turn to the left, a circle of                      *
+*           radius size at speed, starting North                                *
+*                                                                               *
+* ARGUMENT LIST:                                                                *
+*                                                                               *
+* Argument  Type         IO     Description                                     *
+* --------- --------     --     ---------------------------------               *
+* c         GenConfig*   I      Run                                             *
+* t         double       I      Time, s                                         *
+* s         GenState*    O      Truth                                           *
+*                                                                               *
+* RETURN VALUE: void                                                            *
+*                                                                               *
+********************************************************************************/
+static void vTraj_Turn(const GenConfig *c, double t, GenState *s)
+{
+    const double r = c->size;
+    const double v = c->speed;
+    const double w = v / r;
+    const double sn = sin(w * t), cs = cos(w * t);
+
+    memset(s, 0, sizeof(*s));
+    s->pos[0]   = r * sn;
+    s->pos[1]   = r * (1 - cs);
+    s->vel[0]   = v * cs;
+    s->vel[1]   = v * sn;
+    s->acc[0]   = -v * w * sn;
+    s->acc[1]   = v * w * cs;
+    s->euler[0] = w * t;
+    s->euler[2] = -atan(v * w / GEN_G);
+    s->rate[0]  = w;
+}
+
+/********************************************************************************
+*                                                                               *
+* FUNCTION NAME: vTraj_Vibration                                                *
+*                                                                               *
+* PURPOSE: At rest on a vibrating mount: vertical acceleration                  *
+*           and small roll and pitch oscillations, see GEN_VIB_*                *
+*                                                                               *
+* ARGUMENT LIST:                                                                *
+*                                                                               *
+* Argument  Type         IO     Description                                     *
+* --------- --------     --     ---------------------------------               *
+* c         GenConfig*   I      Run                                             *
+* t         double       I      Time, s                                         *
+* s         GenState*    O      Truth                                           *
+*                                                                               *
+* RETURN VALUE: void                                                            *
+*                                                                               *
+********************************************************************************/
+static void vTraj_Vibration(const GenConfig *c, double t, GenState *s)
+{
+    const double wa = 2 * M_PI * GEN_VIB_ACC_HZ;
+    const double wr = 2 * M_PI * GEN_VIB_ROLL_HZ;
+    const double wp = 2 * M_PI * GEN_VIB_PITCH_HZ;
+
+    (void)c;
+    memset(s, 0, sizeof(*s));
+    s->pos[2]   = GEN_VIB_ACC / (wa * wa) * sin(wa * t);
+    s->vel[2]   = GEN_VIB_ACC / wa * cos(wa * t);
+    s->acc[2]   = -GEN_VIB_ACC * sin(wa * t);
+    s->euler[1] = GEN_VIB_ANGLE * sin(wp * t);
+    s->euler[2] = GEN_VIB_ANGLE * sin(wr * t);
+    s->rate[1]  = GEN_VIB_ANGLE * wp * cos(wp * t);
+    s->rate[2]  = GEN_VIB_ANGLE * wr * cos(wr * t);
+}
+
+/* Define Static Variables */
+
+static const GenTrajectory traj[] =
+{
+    {"static",    vTraj_Static},
+    {"figure8",   vTraj_Figure8},
+    {"turn",      vTraj_Turn},
+    {"vibration", vTraj_Vibration},
+};
+
+/********************************************************************************
+*                                                                               *
+* FUNCTION NAME: vAttitude                                                      *
+*                                                                               *
+* PURPOSE: Quaternion (sensor to navigation frame) and angular                  *
+*           rate in the sensor frame of a truth, yaw, pitch and                 *
+*           roll being Z, Y, X rotations                                        *
+*                                                                               *
+* ARGUMENT LIST:                                                                *
+*                                                                               *
+* Argument  Type         IO     Description                                     *
+* --------- --------     --     ---------------------------------               *
+* s         GenState*    I      Truth                                           *
+* q         double*      O      Quaternion                                      *
+* w         double*      O      Angular rate, rad/s                             *
+*                                                                               *
+* RETURN VALUE: void                                                            *
+*                                                                               *
+********************************************************************************/
+static void vAttitude(const GenState *s, double q[4], double w[3])
+{
+    const double cy = cos(s->euler[0] / 2), sy = sin(s->euler[0] / 2);
+    const double cp = cos(s->euler[1] / 2), sp = sin(s->euler[1] / 2);
+    const double cr = cos(s->euler[2] / 2), sr = sin(s->euler[2] / 2);
+    //sine and cosine of pitch and roll from the half angles
+    const double sth = 2 * sp * cp, cth = cp * cp - sp * sp;
+    const double sph = 2 * sr * cr, cph = cr * cr - sr * sr;
+
+    q[0] = cr * cp * cy + sr * sp * sy;
+    q[1] = sr * cp * cy - cr * sp * sy;
+    q[2] = cr * sp * cy + sr * cp * sy;
+    q[3] = cr * cp * sy - sr * sp * cy;
+
+    w[0] = s->rate[2] - s->rate[0] * sth;
+    w[1] = s->rate[1] * cph + s->rate[0] * sph * cth;
+    w[2] = -s->rate[1] * sph + s->rate[0] * cph * cth;
+}
+
+/********************************************************************************
+*                                                                               *
+* FUNCTION NAME: vToSensor                                                      *
+*                                                                               *
+* PURPOSE: A vector of the navigation frame in the sensor frame                 *
+*                                                                               *
+* ARGUMENT LIST:                                                                *
+*                                                                               *
+* Argument  Type         IO     Description                                     *
+* --------- --------     --     ---------------------------------               *
+* q         const double*I      Quaternion                                      *
+* n         const double*I      Vector, navigation frame                        *
+* b         double*      O      Vector, sensor frame                            *
+*                                                                               *
+* RETURN VALUE: void                                                            *
+*                                                                               *
+********************************************************************************/
+static void vToSensor(const double q[4], const double n[3], double b[3])
+{
+    //transpose of the rotation of q
+    b[0] = (q[0] * q[0] + q[1] * q[1] - q[2] * q[2] - q[3] * q[3]) * n[0] +
+           2 * (q[1] * q[2] + q[0] * q[3]) * n[1] + 2 * (q[1] * q[3] - q[0] * q[2]) * n[2];
+    b[1] = 2 * (q[1] * q[2] - q[0] * q[3]) * n[0] +
+           (q[0] * q[0] - q[1] * q[1] + q[2] * q[2] - q[3] * q[3]) * n[1] +
+           2 * (q[2] * q[3] + q[0] * q[1]) * n[2];
+    b[2] = 2 * (q[1] * q[3] + q[0] * q[2]) * n[0] + 2 * (q[2] * q[3] - q[0] * q[1]) * n[1] +
+           (q[0] * q[0] - q[1] * q[1] - q[2] * q[2] + q[3] * q[3]) * n[2];
+}
+
+/********************************************************************************
+*                                                                               *
+* FUNCTION NAME: vSensor_Init                                                   *
+*                                                                               *
+* PURPOSE: Draws the bias and scale error of each axis of a                     *
+*           triad                                                               *
+*                                                                               *
+* ARGUMENT LIST:                                                                *
+*                                                                               *
+* Argument  Type         IO     Description                                     *
+* --------- --------     --     ---------------------------------               *
+* x         GenSensor*   O      Triad                                           *
+* bias      double       I      Bias, standard deviation                        *
+* scale     double       I      Scale error, std deviation                      *
+* noise     double       I      Noise, standard deviation                       *
+* rng       Rng*         IO     Generator                                       *
+*                                                                               *
+* RETURN VALUE: void                                                            *
+*                                                                               *
+********************************************************************************/
+static void vSensor_Init(GenSensor *x, double bias, double scale, double noise, Rng *rng)
+{
+    for (int i = 0; i < 3; i++)
+    {
+        x->bias[i]  = bias * fRngNormal(rng);
+        x->scale[i] = scale * fRngNormal(rng);
+    }
+    x->noise = noise;
+}
+
+/********************************************************************************
+*                                                                               *
+* FUNCTION NAME: vSensor_Read                                                   *
+*                                                                               *
+* PURPOSE: Measurement of a triad: (1 + scale) * truth + bias                   *
+*           + noise                                                             *
+*                                                                               *
+* ARGUMENT LIST:                                                                *
+*                                                                               *
+* Argument  Type         IO     Description                                     *
+* --------- --------     --     ---------------------------------               *
+* x         GenSensor*   I      Triad                                           *
+* v         const double*I      Truth                                           *
+* out       float*       O      Measurement                                     *
+* rng       Rng*         IO     Generator                                       *
+*                                                                               *
+* RETURN VALUE: void                                                            *
+*                                                                               *
+********************************************************************************/
+static void vSensor_Read(const GenSensor *x, const double v[3], float out[3], Rng *rng)
+{
+    for (int i = 0; i < 3; i++)
+    {
+        out[i] = (float)((1 + x->scale[i]) * v[i] + x->bias[i] + x->noise * fRngNormal(rng));
+    }
+}
+
+/********************************************************************************
+*                                                                               *
+* FUNCTION NAME: iNmeaEnd                                                       *
+*                                                                               *
+* PURPOSE: Appends the checksum and CR LF to a sentence,                        *
+*           returning its length                                                *
+*                                                                               *
+* ARGUMENT LIST:                                                                *
+*                                                                               *
+* Argument  Type         IO     Description                                     *
+* --------- --------     --     ---------------------------------               *
+* b         char*        IO     Sentence from $, 96 bytes                       *
+* n         int          I      Its length                                      *
+*                                                                               *
+* RETURN VALUE: int                                                             *
+*                                                                               *
+********************************************************************************/
+static int iNmeaEnd(char *b, int n)
+{
+    uint8_t cs = 0;
+
+    for (int i = 1; i < n; i++)
+    {
+        cs ^= (uint8_t)b[i];
+    }
+
+    return n + sprintf(b + n, "*%02X\r\n", cs);
+}
+
+/********************************************************************************
+*                                                                               *
+* FUNCTION NAME: iNmea                                                          *
+*                                                                               *
+* PURPOSE: GPRMC and GPGGA sentences of a fix, returning their length           *
+*                                                                               *
+* ARGUMENT LIST:                                                                *
+*                                                                               *
+* Argument  Type         IO     Description                                     *
+* --------- --------     --     ---------------------------------               *
+* b         char*        O      Sentences, 192 bytes                            *
+* t         double       I      Time of the fix, s                              *
+* lla       double*      I      Latitude, longitude (deg), m                    *
+* v         double*      I      Velocity North, West, m/s                       *
+*                                                                               *
+* RETURN VALUE: int                                                             *
+*                                                                               *
+********************************************************************************/
+static int iNmea(char *b, double t, const double lla[3], const double v[2])
+{
+    //time in centiseconds, minutes of arc in 1e-5, rounded once: no 60.00
+    const long   cs = lround(t * 100.0);
+    const long   lat = lround(fabs(lla[0]) * 60e5), lon = lround(fabs(lla[1]) * 60e5);
+    const time_t sec = GEN_EPOCH + cs / 100;
+    const char   ns = lla[0] < 0 ? 'S' : 'N', ew = lla[1] < 0 ? 'W' : 'E';
+    double       course = -atan2(v[1], v[0]) * 180.0 / M_PI;
+    char         hms[32], ll[64];
+    struct tm    tm;
+    int          n, m;
+
+    if (course < 0)
+    {
+        course += 360.0;
+    }
+    gmtime_r(&sec, &tm);
+    snprintf(hms, sizeof(hms), "%02d%02d%02d.%02ld", tm.tm_hour, tm.tm_min, tm.tm_sec, cs % 100);
+    snprintf(ll, sizeof(ll), "%02ld%02ld.%05ld,%c,%03ld%02ld.%05ld,%c",
+             lat / 6000000, lat / 100000 % 60, lat % 100000, ns,
+             lon / 6000000, lon / 100000 % 60, lon % 100000, ew);
+
+    n = sprintf(b, "$GPRMC,%s,A,%s,%.1f,%.1f,%02d%02d%02d,,,A", hms, ll,
+                sqrt(v[0] * v[0] + v[1] * v[1]) * GEN_MS_TO_KNOTS, course,
+                tm.tm_mday, tm.tm_mon + 1, tm.tm_year % 100);
+    n = iNmeaEnd(b, n);
+    m = sprintf(b + n, "$GPGGA,%s,%s,1,08,0.9,%.1f,M,46.9,M,,", hms, ll, lla[2]);
+
+    return n + iNmeaEnd(b + n, m);
+}
+
+/********************************************************************************
+*                                                                               *
+* FUNCTION NAME: vUsage                                                         *
+*                                                                               *
+* PURPOSE: Prints the options on stderr                                         *
+*                                                                               *
+* ARGUMENT LIST:                                                                *
+*                                                                               *
+* Argument  Type         IO     Description                                     *
+* --------- --------     --     ---------------------------------               *
+* name      const char*  I      Name of the program                             *
+*                                                                               *
+* RETURN VALUE: void                                                            *
+*                                                                               *
+********************************************************************************/
+static void vUsage(const char *name)
+{
+    fprintf(stderr,
+            "usage: %s [-t traj] [-d s] [-r Hz] [-g Hz] [-v m/s] [-R m] [-p lat,lon,alt]\n"
+            "          [-e scale] [-s seed] [-T truth.col] out.log\n"
+            "  out.log    AHRSLOG1 log (see ReplayLog.h), - for stdout\n"
+            "  -t traj    static, figure8, turn or vibration (figure8)\n"
+            "  -d s       duration (60)\n"
+            "  -r Hz      IMU rate, 1000 to 2000 for the HG1120 (1000)\n"
+            "  -g Hz      GPS rate, 1 to 10 and dividing the IMU rate, 0 for no GPS (1)\n"
+            "  -v m/s     speed of figure8 and turn (20)\n"
+            "  -R m       half width of figure8, radius of turn (200)\n"
+            "  -p origin  latitude and longitude (deg) and altitude (m) (40.85,14.25,10)\n"
+            "  -e scale   sensor and GPS errors times this, 0 for ideal sensors (1)\n"
+            "  -s seed    seed of the errors (1)\n"
+            "  -T file    truth, AHRSCOL1 columns, one row per IMU sample\n",
+            name);
+}
+
+int main(int argc, char **argv)
+{
+    GenConfig c =
+    {
+        60.0, 1000, 1, 20.0, 200.0, {40.85, 14.25, 10.0}, 1.0,
+        1e-3, 2e-3, 2e-2, 2e-2, 1e-3, 5e-3, {2.0, 4.0}
+    };
+    const GenTrajectory *tr = &traj[1];
+    const char   *truth_path = NULL;
+    const double  mag[3] = {GEN_MAG_FIELD * cos(GEN_MAG_INCL), 0.0, -GEN_MAG_FIELD * sin(GEN_MAG_INCL)};
+    uint64_t      seed = 1;
+    unsigned long samples, gps_every, fixes = 0;
+    ReplayColumns truth;
+    GenSensor     gyro, acc, mg;
+    Rng           rng;
+    FILE         *f;
+    int           ret = 0;
+    int           opt;
+
+    while ((opt = getopt(argc, argv, "t:d:r:g:v:R:p:e:s:T:h")) != -1)
+    {
+        switch (opt)
+        {
+        case 't':
+            tr = NULL;
+            for (size_t i = 0; i < sizeof(traj) / sizeof(traj[0]); i++)
+            {
+                if (strcmp(optarg, traj[i].name) == 0)
+                {
+                    tr = &traj[i];
+                }
+            }
+            break;
+        case 'd':
+            c.duration = atof(optarg);
+            break;
+        case 'r':
+            c.imu_rate = (uint32_t)strtoul(optarg, NULL, 10);
+            break;
+        case 'g':
+            c.gps_rate = (uint32_t)strtoul(optarg, NULL, 10);
+            break;
+        case 'v':
+            c.speed = atof(optarg);
+            break;
+        case 'R':
+            c.size = atof(optarg);
+            break;
+        case 'p':
+            if (sscanf(optarg, "%lf,%lf,%lf", &c.origin[0], &c.origin[1], &c.origin[2]) != 3)
+            {
+                tr = NULL;
+            }
+            break;
+        case 'e':
+            c.errors = atof(optarg);
+            break;
+        case 's':
+            seed = strtoull(optarg, NULL, 10);
+            break;
+        case 'T':
+            truth_path = optarg;
+            break;
+        default:
+            vUsage(argv[0]);
+            return opt == 'h' ? EXIT_SUCCESS : EXIT_FAILURE;
+        }
+    }
+    //the GPS epochs must fall on IMU samples, the origin is on the ground
+    if (optind != argc - 1 || tr == NULL || !(c.duration > 0) || c.imu_rate < 100 ||
+        c.imu_rate > 10000 || c.gps_rate > 10 || (c.gps_rate > 0 && c.imu_rate % c.gps_rate != 0) ||
+        !(c.speed > 0) || !(c.size > 0) || !(c.errors >= 0) || fabs(c.origin[0]) > 89.0 ||
+        fabs(c.origin[1]) > 180.0 || c.origin[2] < -400.0 || c.origin[2] > 9000.0)
+    {
+        vUsage(argv[0]);
+        return EXIT_FAILURE;
+    }
+
+    f = strcmp(argv[optind], "-") == 0 ? stdout : fopen(argv[optind], "wb");
+    if (f == NULL || setvbuf(f, NULL, _IOFBF, GEN_IO_BUFFER) != 0 ||
+        iReplayLog_WriteHeader(f, c.imu_rate) != 0)
+    {
+        fprintf(stderr, "%s: cannot write\n", argv[optind]);
+        return EXIT_FAILURE;
+    }
+    if (truth_path != NULL && iReplayCol_Open(&truth, truth_path) != 0)
+    {
+        fprintf(stderr, "%s: cannot write\n", truth_path);
+        return EXIT_FAILURE;
+    }
+
+    vRngSeed(&rng, seed, 0);
+    vSensor_Init(&gyro, c.errors * c.gyro_bias, c.errors * c.scale, c.errors * c.gyro_noise, &rng);
+    vSensor_Init(&acc, c.errors * c.acc_bias, c.errors * c.scale, c.errors * c.acc_noise, &rng);
+    vSensor_Init(&mg, 0.0, 0.0, c.errors * c.mag_noise, &rng);
+
+    samples   = (unsigned long)(c.duration * c.imu_rate);
+    gps_every = c.gps_rate > 0 ? c.imu_rate / c.gps_rate : 0;
+    for (unsigned long n = 0; n < samples && ret == 0; n++)
+    {
+        const double t = (double)n / c.imu_rate;
+        GenState     s;
+        ReplayRow    row;
+        double       q[4], w[3], fn[3], fb[3], mb[3];
+        float        imu[REPLAY_IMU_FLOATS];
+
+        tr->pvState(&c, t, &s);
+        vAttitude(&s, q, w);
+
+        //the accelerometer reads the specific force, +g up at rest
+        fn[0] = s.acc[0];
+        fn[1] = s.acc[1];
+        fn[2] = s.acc[2] + GEN_G;
+        vToSensor(q, fn, fb);
+        vToSensor(q, mag, mb);
+        vSensor_Read(&gyro, w, &imu[0], &rng);
+        vSensor_Read(&acc, fb, &imu[3], &rng);
+        vSensor_Read(&mg, mb, &imu[6], &rng);
+
+        row.gps = gps_every > 0 && n % gps_every == 0;
+        if (row.gps)
+        {
+            const double lat0 = c.origin[0] * M_PI / 180.0;
+            double       lla[3];
+            char         nmea[192];
+            int          len;
+
+            lla[0] = c.origin[0] + (s.pos[0] + c.errors * c.gps_noise[0] * fRngNormal(&rng)) /
+                     GEN_R_EARTH * 180.0 / M_PI;
+            lla[1] = c.origin[1] - (s.pos[1] + c.errors * c.gps_noise[0] * fRngNormal(&rng)) /
+                     (GEN_R_EARTH * cos(lat0)) * 180.0 / M_PI;
+            lla[2] = c.origin[2] + s.pos[2] + c.errors * c.gps_noise[1] * fRngNormal(&rng);
+            len = iNmea(nmea, t, lla, s.vel);
+            ret |= iReplayLog_WriteNMEA(f, (const uint8_t *)nmea, (size_t)len);
+            fixes++;
+        }
+        ret |= iReplayLog_WriteIMU(f, imu);
+
+        if (truth_path != NULL)
+        {
+            row.sample = (uint32_t)n;
+            for (int i = 0; i < 4; i++)
+            {
+                row.q[i] = (float)q[i];
+            }
+            for (int i = 0; i < 3; i++)
+            {
+                //North, East, Down from North, West, Up
+                const double sign = i == 0 ? 1.0 : -1.0;
+
+                row.ypr[i] = (float)s.euler[i];
+                row.pos[i] = (float)(sign * s.pos[i]);
+                row.vel[i] = (float)(sign * s.vel[i]);
+            }
+            ret |= iReplayCol_Append(&truth, &row);
+        }
+    }
+
+    if (truth_path != NULL)
+    {
+        ret |= iReplayCol_Close(&truth);
+    }
+    if (fclose(f) != 0 || ret != 0)
+    {
+        fprintf(stderr, "%s: write failed\n", argv[optind]);
+        return EXIT_FAILURE;
+    }
+    fprintf(stderr, "%s: %s, %lu samples at %u Hz, %lu fixes\n", argv[optind], tr->name, samples,
+            c.imu_rate, fixes);
+
+    return EXIT_SUCCESS;
+}
@@ -0,0 +1,557 @@
+/***********************************************************************************
+* This file is part of The AHRS Project.                                           *
+*                                                                                  *
+* Copyright © 2020 By Nicola di Gruttola Giardino. All rights reserved.            *
+* @mail: nicoladgg@protonmail.com                                                  *
+*                                                                                  *
+* AHRS is free software: you can redistribute it and/or modify                     *
+* it under the terms of the GNU General Public License as published by             *
+* the Free Software Foundation, either version 3 of the License, or                *
+* (at your option) any later version.                                              *
+*                                                                                  *
+* AHRS is distributed in the hope that it will be useful,                          *
+* but WITHOUT ANY WARRANTY; without even the implied warranty of                   *
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the                    *
+* GNU General Public License for more details.                                     *
+*                                                                                  *
+* You should have received a copy of the GNU General Public License                *
+* along with The AHRS Project.  If not, see <https://www.gnu.org/licenses/>.       *
+*                                                                                  *
+* In case of use of this project, I ask you to mention me, to whom it may concern. *
+***********************************************************************************/
+
+/****************************************************************************************************
+* FILE NAME: replay.c                                                                               *
+*                                                                                                   *
+* PURPOSE: Offline replay of recorded sensor logs through the AHRS pipeline of the board            *
+*           (MadgwickAHRS, GPS_Lib, IMU): one independent pipeline per log, the logs shared among   *
+*           a pool of worker threads, the state after every IMU sample written as AHRSCOL1          *
+*           columns, a JSON line per log and one for the run on stdout                              *
+*                                                                                                   *
+* FILE REFERENCES:                                                                                  *
+*                                                                                                   *
+*   Name    I/O     Description                                                                     *
+*   ----    ---     -----------                                                                     *
+*   none                                                                                            *
+*                                                                                                   *
+*                                                                                                   *
+* EXTERNAL VARIABLES:                                                                               *
+*                                                                                                   *
+* Source: <ReplayLog.h>                                                                             *
+*                                                                                                   *
+* Name          Type          IO Description                                                        *
+* ------------- -------       -- -----------------------------                                      *
+*   none                                                                                            *
+*                                                                                                   *
+* STATIC VARIABLES:                                                                                 *
+*                                                                                                   *
+*   Name         Type          I/O  Description                                                     *
+*   ----         ----          ---  -----------                                                     *
+*   jobs         ReplayJob*         The logs of the run                                             *
+*   njobs        int                Number of logs                                                  *
+*   next         int                First log not taken by a worker                                 *
+*   lock         pthread_mutex_t    next and stdout                                                 *
+*   heap_lock    pthread_mutex_t    Allocations of matrix.c                                         *
+*   kalman_set   unsigned int       Configuration of the axis filters                               *
+*                                                                                                   *
+* EXTERNAL REFERENCES:                                                                              *
+*                                                                                                   *
+*  Name                       Description                                                           *
+*  -------------              -----------                                                           *
+*  iAHRS_Init                 Axis filters of a pipeline, IMU.c                                     *
+*  MadgwickUpdate             Attitude of a pipeline                                                *
+*  GPSParserRead              NMEA parser of a pipeline                                             *
+*                                                                                                   *
+* ABNORMAL TERMINATION CONDITIONS, ERROR AND WARNING MESSAGES:                                      *
+*    bad options: usage on stderr and exit status 1; an output directory that cannot be created:    *
+*    its path and the reason on stderr and exit status 1; a log that cannot be read or an output    *
+*    that cannot be written: the path and the reason on stderr, status error in its JSON line and   *
+*    exit status 1, the other logs are replayed                                                     *
+*                                                                                                   *
+* ASSUMPTIONS, CONSTRAINTS, RESTRICTIONS: the matrix.c heap counter is shared: pipelines are        *
+*    created and destroyed under heap_lock, the samples allocate nothing; not built with            *
+*    USE_PROBES, the probes are global                                                              *
+*                                                                                                   *
+* NOTES: the filters run at the rates of the firmware (sampleFreq of MadgwickAHRS.h, dt of the      *
+*    configuration sets), the rate of the log only dates the samples                                *
+*                                                                                                   *
+* REQUIREMENTS/FUNCTIONAL SPECIFICATIONS REFERENCES:                                                *
+*                                                                                                   *
+* DEVELOPMENT HISTORY:                                                                              *
+*                                                                                                   *
+*   Date          Author            Change Id     Release     Description Of Change                 *
+*   ----          ------            ---------     ------      ----------------------                *
+*   19-10-2026    AHRS Project       1               1         Initial release                      *
+*   19-10-2026    AHRS Project       2               1.1       -o creates the directory, the reason *
+*                                                               of a failed log on stderr           *
+*                                                                                                   *
+****************************************************************************************************/
+
+/* Include Global Parameters */
+
+#include <errno.h>
+#include <limits.h>
+#include <pthread.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+#include <sys/stat.h>
+#include "IMU.h"
+#include "ReplayLog.h"
+
+/* Definition of Macros */
+
+#define REPLAY_MAX_JOBS   256           /* worker threads */
+#define REPLAY_IO_BUFFER  (1 << 20)     /* stdio buffer of a log */
+
+/*
+* ReplayJob Object:
+*       one log of the run: its path and the path of its columns, then the
+*       result of its replay, status 0 or -1, the IMU samples and GPS fixes,
+*       the recorded and the wall time, the NIS and rejected fixes of the axis
+*       filters at the end; on -1 the path that failed and its errno, 0 if the
+*       log is not an AHRSLOG1 one or is truncated
+*/
+
+typedef struct ReplayJob
+{
+    const char*   log;
+    char          out[PATH_MAX];
+    int           status;
+    unsigned long samples;
+    unsigned long fixes;
+    double        log_s;
+    double        wall_s;
+    float         nis[3];
+    unsigned long rejected[3];
+    const char*   fail;
+    int           err;
+}ReplayJob;
+
+/* Define Static Variables */
+
+static ReplayJob*      jobs=NULL;
+static int             njobs=0;
+static int             next=0;
+static pthread_mutex_t lock=PTHREAD_MUTEX_INITIALIZER;
+static pthread_mutex_t heap_lock=PTHREAD_MUTEX_INITIALIZER;
+static unsigned int    kalman_set=KALMAN_SET_DEFAULT;
+
+/********************************************************************************
+*                                                                               *
+* FUNCTION NAME: dNow                                                           *
+*                                                                               *
+* PURPOSE: Monotonic clock in seconds                                           *
+*                                                                               *
+* ARGUMENT LIST: none                                                           *
+*                                                                               *
+* RETURN VALUE: double                                                          *
+*                                                                               *
+********************************************************************************/
+static double dNow(void)
+{
+    struct timespec ts;
+
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (double)ts.tv_sec + (double)ts.tv_nsec / 1e9;
+}
+
+/********************************************************************************
+*                                                                               *
+* FUNCTION NAME: iReplay_Run                                                    *
+*                                                                               *
+* PURPOSE: Replays one log: reads its records in order, feeds                   *
+*           the NMEA bytes to the parser and every IMU sample to                *
+*           the attitude and the axis filters, with the fix                     *
+*           completed since the previous sample, and appends the                *
+*           state to the columns; returning -1 if failed, 0 if                  *
+*           successfull                                                         *
+*                                                                               *
+* ARGUMENT LIST:                                                                *
+*                                                                               *
+* Argument  Type         IO     Description                                     *
+* --------- --------     --     ---------------------------------               *
+* j         ReplayJob*   IO     Log, result filled in                           *
+*                                                                               *
+* RETURN VALUE: int                                                             *
+*                                                                               *
+********************************************************************************/
+static int iReplay_Run(ReplayJob *j)
+{
+    ReplayRecord *r = malloc(sizeof(ReplayRecord));
+    FILE         *f = fopen(j->log, "rb");
+    ReplayColumns cols;
+    ReplayRow     row;
+    madgwick_t    m;
+    GPSParser     gps;
+    AHRSState     s;
+    Matrix       *a;
+    uint32_t      rate;
+    int           fix = 0;
+    int           ret = 0;
+    int           rd = 0;
+
+    if (r == NULL || f == NULL || setvbuf(f, NULL, _IOFBF, REPLAY_IO_BUFFER) != 0 ||
+        iReplayLog_ReadHeader(f, &rate) != 0)
+    {
+        j->fail = j->log;
+        j->err  = r == NULL || f == NULL || ferror(f) ? errno : 0;
+        free(r);
+        if (f != NULL)
+        {
+            fclose(f);
+        }
+        return -1;
+    }
+    if (iReplayCol_Open(&cols, j->out) != 0)
+    {
+        j->fail = j->out;
+        j->err  = errno;
+        free(r);
+        fclose(f);
+        return -1;
+    }
+
+    MadgwickInit(&m);
+    GPSParserInit(&gps);
+    pthread_mutex_lock(&heap_lock);
+    ret = iAHRS_Init(&s, kalman_set);
+    a = pxCreate(3, 1);
+    pthread_mutex_unlock(&heap_lock);
+
+    while (ret == 0 && a != NULL && (rd = iReplayLog_Read(f, r)) == 1)
+    {
+        if (r->type == REPLAY_REC_NMEA)
+        {
+            for (int i = 0; i < r->n; i++)
+            {
+                if (GPSParserRead(&gps, r->nmea[i]) == GPSREADY)
+                {
+                    fix = 1;
+                }
+            }
+            continue;
+        }
+
+        //one sample of the SPI thread of main.c
+        MadgwickUpdate(&m, r->imu[0], r->imu[1], r->imu[2], r->imu[3], r->imu[4], r->imu[5],
+                       r->imu[6], r->imu[7], r->imu[8]);
+        row.q[0] = m.q0;
+        row.q[1] = m.q1;
+        row.q[2] = m.q2;
+        row.q[3] = m.q3;
+        vAHRS_YPR(&s, row.q, row.ypr);
+        a->matrix[0][0] = r->imu[3];
+        a->matrix[1][0] = r->imu[4];
+        a->matrix[2][0] = r->imu[5];
+        if (fix)
+        {
+            float lla[3];
+
+            lla[0] = GPSParserLatitude(&gps);
+            lla[1] = GPSParserLongitude(&gps);
+            lla[2] = GPSParserAltitude(&gps);
+            vAHRS_Velocity(&s, row.q, row.vel, a, lla);
+            j->fixes++;
+        }
+        else
+        {
+            vAHRS_Velocity(&s, row.q, row.vel, a, NULL);
+        }
+        for (int i = 0; i < 3; i++)
+        {
+            row.pos[i] = s.k[i].x->matrix[0][0];
+        }
+        row.sample = (uint32_t)j->samples++;
+        row.gps    = (uint32_t)fix;
+        fix = 0;
+        if (iReplayCol_Append(&cols, &row) != 0)
+        {
+            j->fail = j->out;
+            j->err  = errno;
+            rd = -1;
+            break;
+        }
+    }
+    if (ret != 0 || a == NULL)
+    {
+        j->fail = j->log;
+        j->err  = ENOMEM;
+        ret = -1;
+    }
+    else if (rd != 0)
+    {
+        if (j->fail == NULL)
+        {
+            j->fail = j->log;
+            j->err  = ferror(f) ? errno : 0;
+        }
+        ret = -1;
+    }
+    else
+    {
+        vAHRS_GetNIS(&s, j->nis, j->rejected);
+    }
+    j->log_s = (double)j->samples / (double)rate;
+
+    pthread_mutex_lock(&heap_lock);
+    vDestroy(a);
+    vAHRS_Destroy(&s);
+    pthread_mutex_unlock(&heap_lock);
+    if (iReplayCol_Close(&cols) != 0 && ret == 0)
+    {
+        j->fail = j->out;
+        j->err  = errno;
+        ret = -1;
+    }
+    fclose(f);
+    free(r);
+
+    return ret;
+}
+
+/********************************************************************************
+*                                                                               *
+* FUNCTION NAME: vPrintJob                                                      *
+*                                                                               *
+* PURPOSE: One JSON line of the result of a log, stdout held                    *
+*           by the caller; if it failed, the path and the reason on stderr      *
+*                                                                               *
+* ARGUMENT LIST:                                                                *
+*                                                                               *
+* Argument  Type         IO     Description                                     *
+* --------- --------     --     ---------------------------------               *
+* j         ReplayJob*   I      Log                                             *
+*                                                                               *
+* RETURN VALUE: void                                                            *
+*                                                                               *
+********************************************************************************/
+static void vPrintJob(const ReplayJob *j)
+{
+    if (j->status != 0)
+    {
+        fprintf(stderr, "%s: %s\n", j->fail != NULL ? j->fail : j->log,
+                j->err != 0 ? strerror(j->err) : "not an AHRSLOG1 log, or truncated");
+    }
+    printf("{\"replay\": \"log\", \"log\": \"%s\", \"out\": \"%s\", \"status\": \"%s\", "
+           "\"samples\": %lu, \"fixes\": %lu, \"log_s\": %.3f, \"wall_s\": %.3f, \"speedup\": %.1f, "
+           "\"nis\": [%.3f, %.3f, %.3f], \"rejected\": [%lu, %lu, %lu]}\n",
+           j->log, j->out, j->status == 0 ? "ok" : "error", j->samples, j->fixes, j->log_s,
+           j->wall_s, j->wall_s > 0.0 ? j->log_s / j->wall_s : 0.0,
+           j->nis[0], j->nis[1], j->nis[2], j->rejected[0], j->rejected[1], j->rejected[2]);
+    fflush(stdout);
+}
+
+/********************************************************************************
+*                                                                               *
+* FUNCTION NAME: pvWorker                                                       *
+*                                                                               *
+* PURPOSE: Worker thread: replays the next log not taken by                     *
+*           another worker until there is none                                  *
+*                                                                               *
+* ARGUMENT LIST:                                                                *
+*                                                                               *
+* Argument  Type         IO     Description                                     *
+* --------- --------     --     ---------------------------------               *
+* arg       void*        I      Unused                                          *
+*                                                                               *
+* RETURN VALUE: void*, NULL                                                     *
+*                                                                               *
+********************************************************************************/
+static void *pvWorker(void *arg)
+{
+    (void)arg;
+
+    for (;;)
+    {
+        ReplayJob *j;
+        double     t0;
+
+        pthread_mutex_lock(&lock);
+        j = next < njobs ? &jobs[next++] : NULL;
+        pthread_mutex_unlock(&lock);
+        if (j == NULL)
+        {
+            return NULL;
+        }
+
+        t0 = dNow();
+        j->status = iReplay_Run(j);
+        j->wall_s = dNow() - t0;
+
+        pthread_mutex_lock(&lock);
+        vPrintJob(j);
+        pthread_mutex_unlock(&lock);
+    }
+}
+
+/********************************************************************************
+*                                                                               *
+* FUNCTION NAME: iOutPath                                                       *
+*                                                                               *
+* PURPOSE: Path of the columns of a log: the log with the                       *
+*           extension .col, in dir if not NULL, returning -1 if                 *
+*           too long, 0 if successfull                                          *
+*                                                                               *
+* ARGUMENT LIST:                                                                *
+*                                                                               *
+* Argument  Type         IO     Description                                     *
+* --------- --------     --     ---------------------------------               *
+* out       char*        O      Path, PATH_MAX bytes                            *
+* log       const char*  I      Path of the log                                 *
+* dir       const char*  I      Output directory or NULL                        *
+*                                                                               *
+* RETURN VALUE: int                                                             *
+*                                                                               *
+********************************************************************************/
+static int iOutPath(char *out, const char *log, const char *dir)
+{
+    const char *base = strrchr(log, '/');
+    const char *dot;
+    int         n;
+
+    base = base != NULL ? base + 1 : log;
+    dot  = strrchr(base, '.');
+    if (dir != NULL)
+    {
+        n = snprintf(out, PATH_MAX, "%s/%.*s.col", dir,
+                     (int)(dot != NULL ? dot - base : (long)strlen(base)), base);
+    }
+    else
+    {
+        n = snprintf(out, PATH_MAX, "%.*s.col",
+                     (int)(dot != NULL ? dot - log : (long)strlen(log)), log);
+    }
+
+    return n > 0 && n < PATH_MAX ? 0 : -1;
+}
+
+/********************************************************************************
+*                                                                               *
+* FUNCTION NAME: vUsage                                                         *
+*                                                                               *
+* PURPOSE: Prints the options on stderr                                         *
+*                                                                               *
+* ARGUMENT LIST:                                                                *
+*                                                                               *
+* Argument  Type         IO     Description                                     *
+* --------- --------     --     ---------------------------------               *
+* name      const char*  I      Name of the program                             *
+*                                                                               *
+* RETURN VALUE: void                                                            *
+*                                                                               *
+********************************************************************************/
+static void vUsage(const char *name)
+{
+    fprintf(stderr,
+            "usage: %s [-j jobs] [-o dir] [-k set] log...\n"
+            "  log        recorded IMU samples and NMEA bytes, AHRSLOG1 (see ReplayLog.h)\n"
+            "  -j jobs    worker threads, one log each at a time (the online CPUs)\n"
+            "  -o dir     directory of the AHRSCOL1 outputs, created if missing (next to\n"
+            "             each log)\n"
+            "  -k set     configuration of the axis filters, 0 CV, 1 tuned (%u)\n",
+            name, (unsigned int)KALMAN_SET_DEFAULT);
+}
+
+int main(int argc, char **argv)
+{
+    pthread_t      tid[REPLAY_MAX_JOBS];
+    const char    *dir = NULL;
+    long           nworkers = sysconf(_SC_NPROCESSORS_ONLN);
+    unsigned long  samples = 0;
+    double         log_s = 0.0;
+    double         wall_s;
+    double         t0;
+    int            failed = 0;
+    int            c;
+
+    while ((c = getopt(argc, argv, "j:o:k:h")) != -1)
+    {
+        switch (c)
+        {
+        case 'j':
+            nworkers = strtol(optarg, NULL, 10);
+            break;
+        case 'o':
+            dir = optarg;
+            break;
+        case 'k':
+            kalman_set = (unsigned int)strtoul(optarg, NULL, 10);
+            break;
+        default:
+            vUsage(argv[0]);
+            return c == 'h' ? EXIT_SUCCESS : EXIT_FAILURE;
+        }
+    }
+    if (optind >= argc || nworkers < 1 || kalman_set >= KALMAN_SETS)
+    {
+        vUsage(argv[0]);
+        return EXIT_FAILURE;
+    }
+    if (dir != NULL && mkdir(dir, 0777) != 0 && errno != EEXIST)
+    {
+        fprintf(stderr, "%s: %s\n", dir, strerror(errno));
+        return EXIT_FAILURE;
+    }
+
+    njobs = argc - optind;
+    jobs  = calloc((size_t)njobs, sizeof(ReplayJob));
+    if (jobs == NULL)
+    {
+        return EXIT_FAILURE;
+    }
+    for (int i = 0; i < njobs; i++)
+    {
+        jobs[i].log = argv[optind + i];
+        if (iOutPath(jobs[i].out, jobs[i].log, dir) != 0)
+        {
+            fprintf(stderr, "%s: path too long\n", jobs[i].log);
+            free(jobs);
+            return EXIT_FAILURE;
+        }
+    }
+    if (nworkers > njobs)
+    {
+        nworkers = njobs;
+    }
+    if (nworkers > REPLAY_MAX_JOBS)
+    {
+        nworkers = REPLAY_MAX_JOBS;
+    }
+
+    t0 = dNow();
+    for (long i = 0; i < nworkers; i++)
+    {
+        if (pthread_create(&tid[i], NULL, pvWorker, NULL) != 0)
+        {
+            //the workers already started take the logs of this one
+            nworkers = i;
+            break;
+        }
+    }
+    if (nworkers == 0)
+    {
+        pvWorker(NULL);
+    }
+    for (long i = 0; i < nworkers; i++)
+    {
+        pthread_join(tid[i], NULL);
+    }
+    wall_s = dNow() - t0;
+
+    for (int i = 0; i < njobs; i++)
+    {
+        samples += jobs[i].samples;
+        log_s   += jobs[i].log_s;
+        failed  += jobs[i].status != 0;
+    }
+    printf("{\"replay\": \"run\", \"logs\": %d, \"failed\": %d, \"jobs\": %ld, \"samples\": %lu, "
+           "\"log_s\": %.3f, \"wall_s\": %.3f, \"speedup\": %.1f, \"samples_per_s\": %.1f}\n",
+           njobs, failed, nworkers > 0 ? nworkers : 1L, samples, log_s, wall_s,
+           wall_s > 0.0 ? log_s / wall_s : 0.0, wall_s > 0.0 ? (double)samples / wall_s : 0.0);
+    free(jobs);
+
+    return failed == 0 ? EXIT_SUCCESS : EXIT_FAILURE;
+}
@@ -0,0 +1,87 @@
+/***********************************************************************************
+* This file is part of The AHRS Project.                                           *
+*                                                                                  *
+* Copyright © 2020 By Nicola di Gruttola Giardino. All rights reserved.            *
+* @mail: nicoladgg@protonmail.com                                                  *
+*                                                                                  *
+* AHRS is free software: you can redistribute it and/or modify                     *
+* it under the terms of the GNU General Public License as published by             *
+* the Free Software Foundation, either version 3 of the License, or                *
+* (at your option) any later version.                                              *
+*                                                                                  *
+* AHRS is distributed in the hope that it will be useful,                          *
+* but WITHOUT ANY WARRANTY; without even the implied warranty of                   *
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the                    *
+* GNU General Public License for more details.                                     *
+*                                                                                  *
+* You should have received a copy of the GNU General Public License                *
+* along with The AHRS Project.  If not, see <https://www.gnu.org/licenses/>.       *
+*                                                                                  *
+* In case of use of this project, I ask you to mention me, to whom it may concern. *
+***********************************************************************************/
+
+/***************************************************************************************************
+*   FILENAME:  ch.h                                                                                *
+*                                                                                                  *
+*                                                                                                  *
+*   PURPOSE:  Stand-in of the ChibiOS RT header for the simulator: the subset of the kernel API    *
+*               called by main.c, implemented in sim_os.c on one pthread per thread                *
+*                                                                                                  *
+*                                                                                                  *
+*                                                                                                  *
+*   GLOBAL VARIABLES:                                                                              *
+*                                                                                                  *
+*                                                                                                  *
+*   Variable        Type        Description                                                        *
+*   --------        ----        -------------------                                                *
+*   thread_t        SimThread   A simulated thread                                                 *
+*   NORMALPRIO      macro       Priority of the main thread                                        *
+*                                                                                                  *
+*   DEVELOPMENT HISTORY :                                                                          *
+*                                                                                                  *
+*                                                                                                  *
+*   Date          Author            Change Id     Release     Description Of Change                *
+*   ----          ------            -------- -    ------      ----------------------               *
+*   19-10-2026    AHRS Project       1               1         Initial release                     *
+*                                                                                                  *
+***************************************************************************************************/
+
+#ifndef CH_h
+#define CH_h
+
+/* Include Global Parameters */
+
+#include <stddef.h>
+#include <stdint.h>
+#include <stdbool.h>
+
+/* Definition of Macros */
+
+#define CH_CFG_ST_FREQUENCY   1000000U      /* system tick of the simulator, 1 us */
+#define NORMALPRIO            128U
+
+/* the simulated threads run on pthread stacks, the working area is unused */
+#define THD_WORKING_AREA(s, n)   uint8_t s[(n)]
+#define THD_FUNCTION(tname, arg) void tname(void *arg)
+
+#define TIME_MS2I(ms)            ((sysinterval_t)(ms) * (CH_CFG_ST_FREQUENCY / 1000U))
+#define chThdSleepMilliseconds(ms) chThdSleep(TIME_MS2I(ms))
+
+typedef int32_t    msg_t;
+typedef uint32_t   tprio_t;
+typedef uint32_t   sysinterval_t;
+typedef void     (*tfunc_t)(void *);
+
+typedef struct SimThread thread_t;
+
+/* Declare Prototypes */
+
+void       chSysInit           (void);
+void       chSysHalt           (const char *) __attribute__((noreturn));
+thread_t*  chThdCreateStatic   (void *, size_t, tprio_t, tfunc_t, void *);
+thread_t*  chThdGetSelfX       (void);
+void       chThdSleep          (sysinterval_t);
+void       chThdExit           (msg_t) __attribute__((noreturn));
+void       chRegSetThreadName  (const char *);
+
+#endif /* CH_h */
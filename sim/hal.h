@@ -0,0 +1,240 @@
+/***********************************************************************************
+* This file is part of The AHRS Project.                                           *
+*                                                                                  *
+* Copyright © 2020 By Nicola di Gruttola Giardino. All rights reserved.            *
+* @mail: nicoladgg@protonmail.com                                                  *
+*                                                                                  *
+* AHRS is free software: you can redistribute it and/or modify                     *
+* it under the terms of the GNU General Public License as published by             *
+* the Free Software Foundation, either version 3 of the License, or                *
+* (at your option) any later version.                                              *
+*                                                                                  *
+* AHRS is distributed in the hope that it will be useful,                          *
+* but WITHOUT ANY WARRANTY; without even the implied warranty of                   *
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the                    *
+* GNU General Public License for more details.                                     *
+*                                                                                  *
+* You should have received a copy of the GNU General Public License                *
+* along with The AHRS Project.  If not, see <https://www.gnu.org/licenses/>.       *
+*                                                                                  *
+* In case of use of this project, I ask you to mention me, to whom it may concern. *
+***********************************************************************************/
+
+/***************************************************************************************************
+*   FILENAME:  hal.h                                                                               *
+*                                                                                                  *
+*                                                                                                  *
+*   PURPOSE:  Stand-in of the ChibiOS HAL header for the simulator: the serial, CAN, SPI, UART     *
+*               and PAL calls of main.c and the HG1120 sample, implemented in sim_hal.c on         *
+*               recorded files                                                                     *
+*                                                                                                  *
+*                                                                                                  *
+*                                                                                                  *
+*   GLOBAL VARIABLES:                                                                              *
+*                                                                                                  *
+*                                                                                                  *
+*   Variable        Type        Description                                                        *
+*   --------        ----        -------------------                                                *
+*   SD3             SerialDriver Virtual COM port, to stderr                                       *
+*   CAND1           CANDriver   CAN bus, to the log and SocketCAN                                  *
+*   SPID4           SPIDriver   IMU, from the recorded frames                                      *
+*   UARTD7          UARTDriver  GPS, from the NMEA bytes                                           *
+*   HG1120CM        HG1120CM    One IMU sample                                                     *
+*                                                                                                  *
+*   DEVELOPMENT HISTORY :                                                                          *
+*                                                                                                  *
+*                                                                                                  *
+*   Date          Author            Change Id     Release     Description Of Change                *
+*   ----          ------            -------- -    ------      ----------------------               *
+*   19-10-2026    AHRS Project       1               1         Initial release                     *
+*                                                                                                  *
+***************************************************************************************************/
+
+#ifndef HAL_h
+#define HAL_h
+
+/* Include Global Parameters */
+
+#include "ch.h"
+
+/* Definition of Macros */
+
+/* register bits of the configurations, kept only so that main.c compiles */
+#define USART_CR2_STOP1_BITS     0U
+#define USART_CR2_LINEN          (1U << 14)
+#define CAN_MCR_ABOM             (1U << 6)
+#define CAN_MCR_AWUM             (1U << 5)
+#define CAN_MCR_TXFP             (1U << 2)
+#define CAN_BTR_LBKM             (1U << 30)
+#define CAN_BTR_SJW(n)           ((uint32_t)(n) << 24)
+#define CAN_BTR_TS2(n)           ((uint32_t)(n) << 20)
+#define CAN_BTR_TS1(n)           ((uint32_t)(n) << 16)
+#define CAN_BTR_BRP(n)           ((uint32_t)(n) << 0)
+
+#define CAN_IDE_STD              0U
+#define CAN_IDE_EXT              1U
+#define CAN_RTR_DATA             0U
+#define CAN_ANY_MAILBOX          0U
+
+#define PAL_MODE_INPUT           0U
+#define PAL_MODE_OUTPUT_PUSHPULL 1U
+#define PAL_MODE_ALTERNATE(n)    (2U | ((uint32_t)(n) << 7))
+#define PAL_STM32_OSPEED_HIGHEST (3U << 3)
+#define PAL_STM32_OTYPE_PUSHPULL 0U
+
+/* ports and pads of the NUCLEO-F767ZI board used by main.c */
+#define GPIOC                    ((ioportid_t)2)
+#define GPIOD                    ((ioportid_t)3)
+#define GPIOE                    ((ioportid_t)4)
+#define GPIOF                    ((ioportid_t)5)
+#define GPIOD_USART3_TX          8U
+#define GPIOD_USART3_RX          9U
+#define GPIOD_ZIO_D66            0U
+#define GPIOD_ZIO_D67            1U
+#define GPIOE_ZIO_D38            6U
+#define GPIOE_ZIO_D39            2U
+#define GPIOE_ARD_D3             13U
+#define GPIOE_ARD_D5             11U
+#define GPIOF_ARD_D7             13U
+
+typedef uintptr_t ioportid_t;
+typedef uint32_t  iomode_t;
+
+/*
+* Serial driver: SD3 is the virtual COM port, written to stderr
+*/
+
+typedef struct BaseSequentialStream BaseSequentialStream;
+
+typedef struct SerialConfig
+{
+    uint32_t speed;
+    uint32_t cr1;
+    uint32_t cr2;
+    uint32_t cr3;
+}SerialConfig;
+
+typedef struct SerialDriver
+{
+    const SerialConfig* config;
+}SerialDriver;
+
+/*
+* CAN driver: the frames go to the candump log and to SocketCAN
+*/
+
+typedef struct CANConfig
+{
+    uint32_t mcr;
+    uint32_t btr;
+}CANConfig;
+
+typedef struct CANDriver
+{
+    const CANConfig* config;
+}CANDriver;
+
+typedef struct CANTxFrame
+{
+    uint8_t  DLC;
+    uint8_t  RTR;
+    uint8_t  IDE;
+    uint32_t SID;
+    uint32_t EID;
+    union
+    {
+        uint8_t  data8[8];
+        uint16_t data16[4];
+        uint32_t data32[2];
+    };
+}CANTxFrame;
+
+/*
+* SPI driver: every receive returns the next recorded frame
+*/
+
+typedef struct SPIConfig
+{
+    bool       circular;
+    void     (*end_cb)(void *);
+    ioportid_t ssport;
+    uint32_t   sspad;
+    uint32_t   cr1;
+    uint32_t   cr2;
+}SPIConfig;
+
+typedef struct SPIDriver
+{
+    const SPIConfig* config;
+}SPIDriver;
+
+/*
+* UART driver: every receive returns the next NMEA byte
+*/
+
+typedef struct UARTConfig
+{
+    void   (*txend1_cb)(void *);
+    void   (*txend2_cb)(void *);
+    void   (*rxend_cb)(void *);
+    void   (*rxchar_cb)(void *, uint16_t);
+    void   (*rxerr_cb)(void *, uint32_t);
+    void   (*timeout_cb)(void *);
+    uint32_t timeout;
+    uint32_t speed;
+    uint32_t cr1;
+    uint32_t cr2;
+    uint32_t cr3;
+}UARTConfig;
+
+typedef struct UARTDriver
+{
+    const UARTConfig* config;
+}UARTDriver;
+
+/*
+* HG1120CM Object:
+*       one sample of the Honeywell HG1120 IMU, as filled by Deserialize. The
+*       HG1120 driver is not part of this tree: the simulator reads a frame
+*       as SIM_IMU_FLOATS little endian floats, angular rate (rad/s), linear
+*       acceleration (m/s^2) and magnetic field, the rest of it is padding
+*/
+
+typedef struct HG1120CM
+{
+    float AngularRate[3];
+    float LinearAcceleration[3];
+    float MagField[3];
+}HG1120CM;
+
+extern SerialDriver SD3;
+extern CANDriver    CAND1;
+extern SPIDriver    SPID4;
+extern UARTDriver   UARTD7;
+extern int          TS_ON;
+
+/* Declare Prototypes */
+
+void      halInit             (void);
+void      sdStart             (SerialDriver *, const SerialConfig *);
+void      canInit             (void);
+void      canStart            (CANDriver *, const CANConfig *);
+msg_t     canTransmit         (CANDriver *, uint32_t, const CANTxFrame *, sysinterval_t);
+void      spiAcquireBus       (SPIDriver *);
+void      spiReleaseBus       (SPIDriver *);
+void      spiStart            (SPIDriver *, const SPIConfig *);
+void      spiStop             (SPIDriver *);
+void      spiSelect           (SPIDriver *);
+void      spiUnselect         (SPIDriver *);
+void      spiReceive          (SPIDriver *, size_t, void *);
+void      uartAcquireBus      (UARTDriver *);
+void      uartReleaseBus      (UARTDriver *);
+void      uartStart           (UARTDriver *, const UARTConfig *);
+void      uartStop            (UARTDriver *);
+void      uartStartReceiveI   (UARTDriver *, size_t, void *);
+size_t    uartStopReceiveI    (UARTDriver *);
+void      palSetPadMode       (ioportid_t, uint32_t, iomode_t);
+int       palReadPad          (ioportid_t, uint32_t);
+void      Deserialize         (const uint8_t *, int, HG1120CM *, uint8_t);
+
+#endif /* HAL_h */
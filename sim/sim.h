@@ -0,0 +1,136 @@
+/***********************************************************************************
+* This file is part of The AHRS Project.                                           *
+*                                                                                  *
+* Copyright © 2020 By Nicola di Gruttola Giardino. All rights reserved.            *
+* @mail: nicoladgg@protonmail.com                                                  *
+*                                                                                  *
+* AHRS is free software: you can redistribute it and/or modify                     *
+* it under the terms of the GNU General Public License as published by             *
+* the Free Software Foundation, either version 3 of the License, or                *
+* (at your option) any later version.                                              *
+*                                                                                  *
+* AHRS is distributed in the hope that it will be useful,                          *
+* but WITHOUT ANY WARRANTY; without even the implied warranty of                   *
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the                    *
+* GNU General Public License for more details.                                     *
+*                                                                                  *
+* You should have received a copy of the GNU General Public License                *
+* along with The AHRS Project.  If not, see <https://www.gnu.org/licenses/>.       *
+*                                                                                  *
+* In case of use of this project, I ask you to mention me, to whom it may concern. *
+***********************************************************************************/
+
+/***************************************************************************************************
+*   FILENAME:  sim.h                                                                               *
+*                                                                                                  *
+*                                                                                                  *
+*   PURPOSE:  Interface between the parts of the software in the loop simulator: options of a      *
+*               run, its report, the virtual clock of sim_os.c, the peripherals of sim_hal.c       *
+*                                                                                                  *
+*                                                                                                  *
+*                                                                                                  *
+*   GLOBAL VARIABLES:                                                                              *
+*                                                                                                  *
+*                                                                                                  *
+*   Variable        Type        Description                                                        *
+*   --------        ----        -------------------                                                *
+*   SimOptions      SimOptions  Inputs, outputs and clock of a run                                 *
+*   SimReport       SimReport   Counters and measures of a run                                     *
+*   xSimReport      SimReport   The report of the run                                              *
+*                                                                                                  *
+*   DEVELOPMENT HISTORY :                                                                          *
+*                                                                                                  *
+*                                                                                                  *
+*   Date          Author            Change Id     Release     Description Of Change                *
+*   ----          ------            -------- -    ------      ----------------------               *
+*   19-10-2026    AHRS Project       1               1         Initial release                     *
+*                                                                                                  *
+***************************************************************************************************/
+
+#ifndef SIM_h
+#define SIM_h
+
+/* Include Global Parameters */
+
+#include <stdint.h>
+
+/* Definition of Macros */
+
+#define SIM_THREADS      8          /* main thread included */
+#define SIM_IMU_FLOATS   9          /* gyro, accelerometer, magnetometer, x y z each */
+
+/*
+* SimOptions Object:
+*       imu the recorded SPI frames, nmea the GPS bytes (NULL: a receiver
+*       without a fix), can_log the candump -L capture and can_if the SocketCAN
+*       interface of the CAN frames (NULL: not written), cpu_scale the factor
+*       from host time to target time of the code between two sleeps,
+*       realtime paces the virtual clock to the wall clock, max_samples ends
+*       the run early (0: at the end of the frames)
+*/
+
+typedef struct SimOptions
+{
+    const char*   imu;
+    const char*   nmea;
+    const char*   can_log;
+    const char*   can_if;
+    double        cpu_scale;
+    int           realtime;
+    unsigned long max_samples;
+}SimOptions;
+
+/*
+* SimStat Object:
+*       count, sum, sum of squares, min and max of one measure
+*/
+
+typedef struct SimStat
+{
+    unsigned long count;
+    double        sum;
+    double        sumsq;
+    double        min;
+    double        max;
+}SimStat;
+
+/*
+* SimReport Object:
+*       samples the IMU frames processed, gps_bytes and gps_sentences the
+*       NMEA bytes and sentences read, can_frames the frames sent; period the
+*       virtual time between two samples, latency the virtual time from the
+*       SPI frame to the end of its processing, can_age the virtual time from
+*       the end of the last sample to a CAN frame, all in us
+*/
+
+typedef struct SimReport
+{
+    unsigned long samples;
+    unsigned long gps_bytes;
+    unsigned long gps_sentences;
+    unsigned long can_frames;
+    SimStat       period;
+    SimStat       latency;
+    SimStat       can_age;
+}SimReport;
+
+extern SimReport xSimReport;
+
+/* Declare Prototypes */
+
+/* sim_os.c, the scheduler */
+void      vSim_SetClock     (double, int);
+uint64_t  uSim_Now          (void);
+uint64_t  uSim_Wall         (void);
+void      vSim_Charge       (uint64_t);
+
+/* sim_hal.c, the peripherals */
+int       iSim_Open         (const SimOptions *);
+void      vSim_Close        (void);
+void      vSim_SampleEnd    (void);
+
+/* sim_main.c */
+void      vSimStat_Add      (SimStat *, double);
+void      vSim_Finish       (void) __attribute__((noreturn));
+
+#endif /* SIM_h */
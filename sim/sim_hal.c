@@ -0,0 +1,548 @@
+/***********************************************************************************
+* This file is part of The AHRS Project.                                           *
+*                                                                                  *
+* Copyright © 2020 By Nicola di Gruttola Giardino. All rights reserved.            *
+* @mail: nicoladgg@protonmail.com                                                  *
+*                                                                                  *
+* AHRS is free software: you can redistribute it and/or modify                     *
+* it under the terms of the GNU General Public License as published by             *
+* the Free Software Foundation, either version 3 of the License, or                *
+* (at your option) any later version.                                              *
+*                                                                                  *
+* AHRS is distributed in the hope that it will be useful,                          *
+* but WITHOUT ANY WARRANTY; without even the implied warranty of                   *
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the                    *
+* GNU General Public License for more details.                                     *
+*                                                                                  *
+* You should have received a copy of the GNU General Public License                *
+* along with The AHRS Project.  If not, see <https://www.gnu.org/licenses/>.       *
+*                                                                                  *
+* In case of use of this project, I ask you to mention me, to whom it may concern. *
+***********************************************************************************/
+
+/****************************************************************************************************
+* FILE NAME: sim_hal.c                                                                              *
+*                                                                                                   *
+* PURPOSE: Peripherals of the simulator: the SPI frames of the IMU and the NMEA bytes of the GPS    *
+*           are read from recorded files, the CAN frames are written to a candump -L log and to a   *
+*           SocketCAN interface. It also measures the period and the latency of the IMU samples     *
+*           and the age of the CAN frames                                                           *
+*                                                                                                   *
+* FILE REFERENCES:                                                                                  *
+*                                                                                                   *
+*   Name    I/O     Description                                                                     *
+*   ----    ---     -----------                                                                     *
+*   none                                                                                            *
+*                                                                                                   *
+*                                                                                                   *
+* EXTERNAL VARIABLES:                                                                               *
+*                                                                                                   *
+* Source: <hal.h>                                                                                   *
+*                                                                                                   *
+* Name          Type          IO Description                                                        *
+* ------------- -------       -- -----------------------------                                      *
+*   SD3         SerialDriver     Virtual COM port                                                   *
+*   CAND1       CANDriver        CAN bus                                                            *
+*   SPID4       SPIDriver        IMU                                                                *
+*   UARTD7      UARTDriver       GPS                                                                *
+*   TS_ON       int              Time stamp flag of the HG1120                                      *
+*                                                                                                   *
+* STATIC VARIABLES:                                                                                 *
+*                                                                                                   *
+*   Name         Type          I/O  Description                                                     *
+*   ----         ----          ---  -----------                                                     *
+*   imu_file     FILE*              Recorded SPI frames                                             *
+*   nmea_file    FILE*              Recorded NMEA bytes                                             *
+*   can_file     FILE*              candump -L log                                                  *
+*   can_sock     int                SocketCAN socket                                                *
+*   no_fix       const char[]       NMEA of a receiver without a fix                                *
+*   sample_start uint64_t           Virtual ns of the last SPI frame                                *
+*   sample_end   uint64_t           Virtual ns of the end of its sample                             *
+*                                                                                                   *
+* EXTERNAL REFERENCES:                                                                              *
+*                                                                                                   *
+*  Name                       Description                                                           *
+*  -------------              -----------                                                           *
+*  linux/can.h                SocketCAN                                                             *
+*                                                                                                   *
+* ABNORMAL TERMINATION CONDITIONS, ERROR AND WARNING MESSAGES:                                      *
+*    an input or output that cannot be opened: iSim_Open fails; the end of the frames ends the      *
+*    run                                                                                            *
+*                                                                                                   *
+* ASSUMPTIONS, CONSTRAINTS, RESTRICTIONS: one thread receives the SPI frames, a sample lasts from   *
+*    the frame to the next sleep of that thread                                                     *
+*                                                                                                   *
+* NOTES: a frame is SPI_BUFFERS_SIZE bytes of main.c, see HG1120CM in hal.h for its content         *
+*                                                                                                   *
+* REQUIREMENTS/FUNCTIONAL SPECIFICATIONS REFERENCES:                                                *
+*                                                                                                   *
+* DEVELOPMENT HISTORY:                                                                              *
+*                                                                                                   *
+*   Date          Author            Change Id     Release     Description Of Change                 *
+*   ----          ------            ---------     ------      ----------------------                *
+*   19-10-2026    AHRS Project       1               1         Initial release                      *
+*                                                                                                   *
+****************************************************************************************************/
+
+/* Include Global Parameters */
+
+#include <stdarg.h>
+#include <stdio.h>
+#include <string.h>
+#if defined(__linux__)
+#include <net/if.h>
+#include <sys/socket.h>
+#include <unistd.h>
+#include <linux/can.h>
+#include <linux/can/raw.h>
+#endif
+#include "hal.h"
+#include "chprintf.h"
+#include "sim.h"
+
+/* Definition of Macros */
+
+#define UART_BITS     10U     /* start, 8 data, stop */
+
+/* Define Global Variables */
+
+SerialDriver SD3;
+CANDriver    CAND1;
+SPIDriver    SPID4;
+UARTDriver   UARTD7;
+int          TS_ON=0;
+
+/* Define Static Variables */
+
+static FILE*          imu_file=NULL;
+static FILE*          nmea_file=NULL;
+static FILE*          can_file=NULL;
+static int            can_sock=-1;
+static unsigned long  max_samples=0;
+
+/* what a receiver without a fix sends, once the recorded bytes are over */
+static const char     no_fix[]="$GPRMC,,V,,,,,,,,,,N*53\r\n$GPGGA,,,,,,0,00,99.99,,,,,,*48\r\n";
+static unsigned int   no_fix_pos=0;
+
+static thread_t*      sample_thread=NULL;
+static uint64_t       sample_start=0;
+static uint64_t       sample_end=0;
+static int            sample_open=0;
+
+/********************************************************************************
+*                                                                               *
+* FUNCTION NAME: iSim_Open                                                      *
+*                                                                               *
+* PURPOSE: Opens the recorded inputs and the CAN outputs of a run               *
+*                                                                               *
+* ARGUMENT LIST:                                                                *
+*                                                                               *
+* Argument  Type         IO     Description                                     *
+* --------- --------     --     ---------------------------------               *
+* opt       SimOptions*  I      Options of the run                              *
+*                                                                               *
+* RETURN VALUE: int, 0 on success, -1 if a file or the interface cannot be      *
+*                opened                                                         *
+*                                                                               *
+********************************************************************************/
+int iSim_Open(const SimOptions *opt)
+{
+    max_samples = opt->max_samples;
+    imu_file = fopen(opt->imu, "rb");
+    if (imu_file == NULL)
+    {
+        perror(opt->imu);
+        return -1;
+    }
+    if (opt->nmea != NULL)
+    {
+        nmea_file = fopen(opt->nmea, "rb");
+        if (nmea_file == NULL)
+        {
+            perror(opt->nmea);
+            return -1;
+        }
+    }
+    if (opt->can_log != NULL)
+    {
+        can_file = fopen(opt->can_log, "w");
+        if (can_file == NULL)
+        {
+            perror(opt->can_log);
+            return -1;
+        }
+    }
+    if (opt->can_if != NULL)
+    {
+#if defined(__linux__)
+        struct sockaddr_can addr;
+
+        memset(&addr, 0, sizeof(addr));
+        addr.can_family = AF_CAN;
+        addr.can_ifindex = (int)if_nametoindex(opt->can_if);
+        can_sock = socket(PF_CAN, SOCK_RAW, CAN_RAW);
+        if (addr.can_ifindex == 0 || can_sock < 0 ||
+            bind(can_sock, (struct sockaddr *)&addr, sizeof(addr)) != 0)
+        {
+            perror(opt->can_if);
+            return -1;
+        }
+#else
+        fprintf(stderr, "%s: SocketCAN needs Linux\n", opt->can_if);
+        return -1;
+#endif
+    }
+    return 0;
+}
+
+/********************************************************************************
+*                                                                               *
+* FUNCTION NAME: vSim_Close                                                     *
+*                                                                               *
+* PURPOSE: Closes the files and the socket of iSim_Open                         *
+*                                                                               *
+* ARGUMENT LIST: none                                                           *
+*                                                                               *
+* RETURN VALUE: void                                                            *
+*                                                                               *
+********************************************************************************/
+void vSim_Close(void)
+{
+    if (imu_file != NULL)
+    {
+        fclose(imu_file);
+    }
+    if (nmea_file != NULL)
+    {
+        fclose(nmea_file);
+    }
+    if (can_file != NULL)
+    {
+        fclose(can_file);
+    }
+#if defined(__linux__)
+    if (can_sock >= 0)
+    {
+        close(can_sock);
+    }
+#endif
+}
+
+/********************************************************************************
+*                                                                               *
+* FUNCTION NAME: vSim_SampleEnd                                                 *
+*                                                                               *
+* PURPOSE: Closes the IMU sample opened by spiReceive, when the thread that     *
+*           received it goes to sleep                                           *
+*                                                                               *
+* ARGUMENT LIST: none                                                           *
+*                                                                               *
+* RETURN VALUE: void                                                            *
+*                                                                               *
+********************************************************************************/
+void vSim_SampleEnd(void)
+{
+    if (!sample_open || chThdGetSelfX() != sample_thread)
+    {
+        return;
+    }
+    sample_open = 0;
+    sample_end = uSim_Now();
+    vSimStat_Add(&xSimReport.latency, (double)(sample_end - sample_start) / 1000.0);
+}
+
+/* Serial driver */
+
+void halInit(void)
+{
+}
+
+void sdStart(SerialDriver *sdp, const SerialConfig *config)
+{
+    sdp->config = config;
+}
+
+int chprintf(BaseSequentialStream *chp, const char *fmt, ...)
+{
+    va_list ap;
+    int n;
+
+    (void)chp;
+    va_start(ap, fmt);
+    n = vfprintf(stderr, fmt, ap);
+    va_end(ap);
+    return n;
+}
+
+/* CAN driver */
+
+void canInit(void)
+{
+}
+
+void canStart(CANDriver *canp, const CANConfig *config)
+{
+    canp->config = config;
+}
+
+/********************************************************************************
+*                                                                               *
+* FUNCTION NAME: canTransmit                                                    *
+*                                                                               *
+* PURPOSE: Writes a frame to the candump -L log, stamped with the virtual time, *
+*           and to the SocketCAN interface                                      *
+*                                                                               *
+* ARGUMENT LIST:                                                                *
+*                                                                               *
+* Argument  Type          IO     Description                                    *
+* --------- --------      --     ---------------------------------              *
+* canp      CANDriver*    I      Driver, unused                                 *
+* mailbox   uint32_t      I      Mailbox, unused                                *
+* ctfp      CANTxFrame*   I      Frame                                          *
+* timeout   sysinterval_t I      Timeout, unused                                *
+*                                                                               *
+* RETURN VALUE: msg_t, 0                                                        *
+*                                                                               *
+********************************************************************************/
+msg_t canTransmit(CANDriver *canp, uint32_t mailbox, const CANTxFrame *ctfp, sysinterval_t timeout)
+{
+    uint64_t t = uSim_Now();
+    uint32_t id = ctfp->IDE == CAN_IDE_EXT ? ctfp->EID : ctfp->SID;
+    uint8_t dlc = ctfp->DLC > 8 ? 8 : ctfp->DLC;
+    uint8_t i;
+
+    (void)canp;
+    (void)mailbox;
+    (void)timeout;
+    xSimReport.can_frames++;
+    if (xSimReport.samples > 0)
+    {
+        vSimStat_Add(&xSimReport.can_age, (double)(t - sample_end) / 1000.0);
+    }
+    if (can_file != NULL)
+    {
+        fprintf(can_file, "(%llu.%06llu) sim ", (unsigned long long)(t / 1000000000ULL),
+                (unsigned long long)(t % 1000000000ULL / 1000ULL));
+        fprintf(can_file, ctfp->IDE == CAN_IDE_EXT ? "%08X#" : "%03X#", (unsigned int)id);
+        for (i = 0; i < dlc; i++)
+        {
+            fprintf(can_file, "%02X", ctfp->data8[i]);
+        }
+        fputc('\n', can_file);
+    }
+#if defined(__linux__)
+    if (can_sock >= 0)
+    {
+        struct can_frame frame;
+
+        memset(&frame, 0, sizeof(frame));
+        frame.can_id = ctfp->IDE == CAN_IDE_EXT ? (id & CAN_EFF_MASK) | CAN_EFF_FLAG
+                                                : id & CAN_SFF_MASK;
+        frame.can_dlc = dlc;
+        memcpy(frame.data, ctfp->data8, dlc);
+        if (write(can_sock, &frame, sizeof(frame)) != (ssize_t)sizeof(frame))
+        {
+            perror("sim: SocketCAN write");
+        }
+    }
+#endif
+    return 0;
+}
+
+/* SPI driver */
+
+void spiAcquireBus(SPIDriver *spip)
+{
+    (void)spip;
+}
+
+void spiReleaseBus(SPIDriver *spip)
+{
+    (void)spip;
+}
+
+void spiStart(SPIDriver *spip, const SPIConfig *config)
+{
+    spip->config = config;
+}
+
+void spiStop(SPIDriver *spip)
+{
+    (void)spip;
+}
+
+void spiSelect(SPIDriver *spip)
+{
+    (void)spip;
+}
+
+void spiUnselect(SPIDriver *spip)
+{
+    (void)spip;
+}
+
+/********************************************************************************
+*                                                                               *
+* FUNCTION NAME: spiReceive                                                     *
+*                                                                               *
+* PURPOSE: Reads the next recorded frame and opens an IMU sample; the run ends  *
+*           when the frames are over                                            *
+*                                                                               *
+* ARGUMENT LIST:                                                                *
+*                                                                               *
+* Argument  Type         IO     Description                                     *
+* --------- --------     --     ---------------------------------               *
+* spip      SPIDriver*   I      Driver, unused                                  *
+* n         size_t       I      Size of a frame                                 *
+* rxbuf     void*        O      Frame                                           *
+*                                                                               *
+* RETURN VALUE: void                                                            *
+*                                                                               *
+********************************************************************************/
+void spiReceive(SPIDriver *spip, size_t n, void *rxbuf)
+{
+    uint64_t t = uSim_Now();
+
+    (void)spip;
+    if ((max_samples > 0 && xSimReport.samples >= max_samples) ||
+        fread(rxbuf, 1, n, imu_file) != n)
+    {
+        vSim_Finish();
+    }
+    if (xSimReport.samples > 0)
+    {
+        vSimStat_Add(&xSimReport.period, (double)(t - sample_start) / 1000.0);
+    }
+    xSimReport.samples++;
+    sample_thread = chThdGetSelfX();
+    sample_start = t;
+    sample_open = 1;
+}
+
+/********************************************************************************
+*                                                                               *
+* FUNCTION NAME: Deserialize                                                    *
+*                                                                               *
+* PURPOSE: Stand-in of the HG1120 driver, see HG1120CM in hal.h                 *
+*                                                                               *
+* ARGUMENT LIST:                                                                *
+*                                                                               *
+* Argument  Type         IO     Description                                     *
+* --------- --------     --     ---------------------------------               *
+* frame     uint8_t*     I      Frame of spiReceive                             *
+* count     int          I      Number of samples, only 1 is supported          *
+* imu       HG1120CM*    O      Sample                                          *
+* type      uint8_t      I      Message type, unused                            *
+*                                                                               *
+* RETURN VALUE: void                                                            *
+*                                                                               *
+********************************************************************************/
+void Deserialize(const uint8_t *frame, int count, HG1120CM *imu, uint8_t type)
+{
+    float f[SIM_IMU_FLOATS];
+    unsigned int i;
+
+    (void)count;
+    (void)type;
+    for (i = 0; i < SIM_IMU_FLOATS; i++)
+    {
+        uint32_t u = (uint32_t)frame[4 * i] | (uint32_t)frame[4 * i + 1] << 8 |
+                     (uint32_t)frame[4 * i + 2] << 16 | (uint32_t)frame[4 * i + 3] << 24;
+
+        memcpy(&f[i], &u, sizeof(float));
+    }
+    memcpy(imu->AngularRate, &f[0], sizeof(imu->AngularRate));
+    memcpy(imu->LinearAcceleration, &f[3], sizeof(imu->LinearAcceleration));
+    memcpy(imu->MagField, &f[6], sizeof(imu->MagField));
+}
+
+/* UART driver */
+
+void uartAcquireBus(UARTDriver *uartp)
+{
+    (void)uartp;
+}
+
+void uartReleaseBus(UARTDriver *uartp)
+{
+    (void)uartp;
+}
+
+void uartStart(UARTDriver *uartp, const UARTConfig *config)
+{
+    uartp->config = config;
+}
+
+void uartStop(UARTDriver *uartp)
+{
+    (void)uartp;
+}
+
+/********************************************************************************
+*                                                                               *
+* FUNCTION NAME: uartStartReceiveI                                              *
+*                                                                               *
+* PURPOSE: Returns the next NMEA bytes, and a receiver without a fix once the   *
+*           recorded ones are over. The caller waits for them: every byte costs *
+*           one character time at the configured speed                         *
+*                                                                               *
+* ARGUMENT LIST:                                                                *
+*                                                                               *
+* Argument  Type         IO     Description                                     *
+* --------- --------     --     ---------------------------------               *
+* uartp     UARTDriver*  I      Started driver                                  *
+* n         size_t       I      Number of bytes                                 *
+* rxbuf     void*        O      Bytes                                           *
+*                                                                               *
+* RETURN VALUE: void                                                            *
+*                                                                               *
+********************************************************************************/
+void uartStartReceiveI(UARTDriver *uartp, size_t n, void *rxbuf)
+{
+    uint8_t *b = rxbuf;
+    size_t i;
+
+    for (i = 0; i < n; i++)
+    {
+        int c = nmea_file != NULL ? fgetc(nmea_file) : EOF;
+
+        if (c == EOF)
+        {
+            c = (uint8_t)no_fix[no_fix_pos];
+            no_fix_pos = (no_fix_pos + 1) % (sizeof(no_fix) - 1);
+        }
+        b[i] = (uint8_t)c;
+        if (c == '\r')
+        {
+            xSimReport.gps_sentences++;
+        }
+    }
+    xSimReport.gps_bytes += n;
+    if (uartp->config != NULL && uartp->config->speed > 0)
+    {
+        vSim_Charge((uint64_t)n * UART_BITS * 1000000000ULL / uartp->config->speed);
+    }
+}
+
+size_t uartStopReceiveI(UARTDriver *uartp)
+{
+    (void)uartp;
+    return 0;
+}
+
+/* PAL driver */
+
+void palSetPadMode(ioportid_t port, uint32_t pad, iomode_t mode)
+{
+    (void)port;
+    (void)pad;
+    (void)mode;
+}
+
+/* the data ready line of the IMU: a frame is always ready */
+int palReadPad(ioportid_t port, uint32_t pad)
+{
+    (void)port;
+    (void)pad;
+    return 1;
+}
@@ -0,0 +1,258 @@
+/***********************************************************************************
+* This file is part of The AHRS Project.                                           *
+*                                                                                  *
+* Copyright © 2020 By Nicola di Gruttola Giardino. All rights reserved.            *
+* @mail: nicoladgg@protonmail.com                                                  *
+*                                                                                  *
+* AHRS is free software: you can redistribute it and/or modify                     *
+* it under the terms of the GNU General Public License as published by             *
+* the Free Software Foundation, either version 3 of the License, or                *
+* (at your option) any later version.                                              *
+*                                                                                  *
+* AHRS is distributed in the hope that it will be useful,                          *
+* but WITHOUT ANY WARRANTY; without even the implied warranty of                   *
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the                    *
+* GNU General Public License for more details.                                     *
+*                                                                                  *
+* You should have received a copy of the GNU General Public License                *
+* along with The AHRS Project.  If not, see <https://www.gnu.org/licenses/>.       *
+*                                                                                  *
+* In case of use of this project, I ask you to mention me, to whom it may concern. *
+***********************************************************************************/
+
+/****************************************************************************************************
+* FILE NAME: sim_main.c                                                                             *
+*                                                                                                   *
+* PURPOSE: Software in the loop simulator of the AHRS: runs main() of main.c, with its threads,     *
+*           on recorded IMU frames and NMEA bytes, and prints throughput, latency and jitter of     *
+*           the pipeline as JSON lines when the frames are over                                     *
+*                                                                                                   *
+* FILE REFERENCES:                                                                                  *
+*                                                                                                   *
+*   Name    I/O     Description                                                                     *
+*   ----    ---     -----------                                                                     *
+*   none                                                                                            *
+*                                                                                                   *
+*                                                                                                   *
+* EXTERNAL VARIABLES:                                                                               *
+*                                                                                                   *
+* Source: <sim.h>                                                                                   *
+*                                                                                                   *
+* Name          Type          IO Description                                                        *
+* ------------- -------       -- -----------------------------                                      *
+*   xSimReport  SimReport     O  The report of the run                                              *
+*                                                                                                   *
+* STATIC VARIABLES:                                                                                 *
+*                                                                                                   *
+*   Name         Type          I/O  Description                                                     *
+*   ----         ----          ---  -----------                                                     *
+*   wall_begin   uint64_t           Wall ns at the start of the run                                 *
+*                                                                                                   *
+* EXTERNAL REFERENCES:                                                                              *
+*                                                                                                   *
+*  Name                       Description                                                           *
+*  -------------              -----------                                                           *
+*  ahrs_main                  main() of main.c                                                      *
+*                                                                                                   *
+* ABNORMAL TERMINATION CONDITIONS, ERROR AND WARNING MESSAGES:                                      *
+*    bad options or an input that cannot be opened: usage or message on stderr and exit status 1    *
+*                                                                                                   *
+* ASSUMPTIONS, CONSTRAINTS, RESTRICTIONS: none                                                      *
+*                                                                                                   *
+* NOTES: the jitter is the standard deviation of the period                                         *
+*                                                                                                   *
+* REQUIREMENTS/FUNCTIONAL SPECIFICATIONS REFERENCES:                                                *
+*                                                                                                   *
+* DEVELOPMENT HISTORY:                                                                              *
+*                                                                                                   *
+*   Date          Author            Change Id     Release     Description Of Change                 *
+*   ----          ------            ---------     ------      ----------------------                *
+*   19-10-2026    AHRS Project       1               1         Initial release                      *
+*                                                                                                   *
+****************************************************************************************************/
+
+/* Include Global Parameters */
+
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <unistd.h>
+#include "sim.h"
+
+/* Define Global Variables */
+
+SimReport xSimReport;
+
+/* Define Static Variables */
+
+static uint64_t wall_begin=0;
+
+/* Declare Prototypes */
+
+int ahrs_main(void);        /* main of main.c, renamed by the Makefile */
+
+/********************************************************************************
+*                                                                               *
+* FUNCTION NAME: vSimStat_Add                                                   *
+*                                                                               *
+* PURPOSE: Adds a value to a measure                                            *
+*                                                                               *
+* ARGUMENT LIST:                                                                *
+*                                                                               *
+* Argument  Type         IO     Description                                     *
+* --------- --------     --     ---------------------------------               *
+* s         SimStat*     IO     Measure                                         *
+* x         double       I      Value                                           *
+*                                                                               *
+* RETURN VALUE: void                                                            *
+*                                                                               *
+********************************************************************************/
+void vSimStat_Add(SimStat *s, double x)
+{
+    if (s->count == 0 || x < s->min)
+    {
+        s->min = x;
+    }
+    if (s->count == 0 || x > s->max)
+    {
+        s->max = x;
+    }
+    s->count++;
+    s->sum += x;
+    s->sumsq += x * x;
+}
+
+/********************************************************************************
+*                                                                               *
+* FUNCTION NAME: vPrintStat                                                     *
+*                                                                               *
+* PURPOSE: One JSON line of the report: count, mean, standard deviation (the    *
+*           jitter), min and max of a measure                                   *
+*                                                                               *
+* ARGUMENT LIST:                                                                *
+*                                                                               *
+* Argument  Type         IO     Description                                     *
+* --------- --------     --     ---------------------------------               *
+* name      const char*  I      Name of the measure                             *
+* s         SimStat*     I      Measure                                         *
+*                                                                               *
+* RETURN VALUE: void                                                            *
+*                                                                               *
+********************************************************************************/
+static void vPrintStat(const char *name, const SimStat *s)
+{
+    double mean = s->count > 0 ? s->sum / (double)s->count : 0.0;
+    double var = s->count > 1 ? (s->sumsq - mean * s->sum) / (double)(s->count - 1) : 0.0;
+
+    printf("{\"sim\": \"%s\", \"unit\": \"us\", \"count\": %lu, \"mean\": %.3f, "
+           "\"stddev\": %.3f, \"min\": %.3f, \"max\": %.3f}\n",
+           name, s->count, mean, var > 0.0 ? sqrt(var) : 0.0, s->min, s->max);
+}
+
+/********************************************************************************
+*                                                                               *
+* FUNCTION NAME: vSim_Finish                                                    *
+*                                                                               *
+* PURPOSE: Ends the run at the end of the recorded frames: prints the report    *
+*           on stdout and exits                                                 *
+*                                                                               *
+* ARGUMENT LIST: none                                                           *
+*                                                                               *
+* RETURN VALUE: void, never returns                                             *
+*                                                                               *
+********************************************************************************/
+void vSim_Finish(void)
+{
+    double virt = (double)uSim_Now() / 1e9;
+    double wall = (double)(uSim_Wall() - wall_begin) / 1e9;
+
+    vSim_Close();
+    printf("{\"sim\": \"run\", \"samples\": %lu, \"gps_bytes\": %lu, \"gps_sentences\": %lu, "
+           "\"can_frames\": %lu, \"virtual_s\": %.3f, \"wall_s\": %.3f, \"speedup\": %.2f, "
+           "\"samples_per_s\": %.1f}\n",
+           xSimReport.samples, xSimReport.gps_bytes, xSimReport.gps_sentences,
+           xSimReport.can_frames, virt, wall, wall > 0.0 ? virt / wall : 0.0,
+           wall > 0.0 ? (double)xSimReport.samples / wall : 0.0);
+    vPrintStat("period", &xSimReport.period);
+    vPrintStat("latency", &xSimReport.latency);
+    vPrintStat("can_age", &xSimReport.can_age);
+    fflush(stdout);
+    exit(EXIT_SUCCESS);
+}
+
+/********************************************************************************
+*                                                                               *
+* FUNCTION NAME: vUsage                                                         *
+*                                                                               *
+* PURPOSE: Prints the options on stderr                                         *
+*                                                                               *
+* ARGUMENT LIST:                                                                *
+*                                                                               *
+* Argument  Type         IO     Description                                     *
+* --------- --------     --     ---------------------------------               *
+* name      const char*  I      Name of the program                             *
+*                                                                               *
+* RETURN VALUE: void                                                            *
+*                                                                               *
+********************************************************************************/
+static void vUsage(const char *name)
+{
+    fprintf(stderr,
+            "usage: %s [-g nmea] [-l can.log] [-c canif] [-s scale] [-r] [-n samples] imu.bin\n"
+            "  imu.bin    recorded SPI frames of the IMU, see HG1120CM in sim/hal.h\n"
+            "  -g nmea    NMEA bytes of the GPS, a receiver without a fix if missing\n"
+            "  -l file    CAN frames in candump -L format, for canplayer\n"
+            "  -c canif   CAN frames also on this SocketCAN interface, e.g. vcan0\n"
+            "  -s scale   target time of the host CPU time, e.g. 20 for a slower MCU (1)\n"
+            "  -r         real time instead of as fast as possible\n"
+            "  -n samples stop after this number of IMU samples\n",
+            name);
+}
+
+int main(int argc, char **argv)
+{
+    SimOptions opt = {NULL, NULL, NULL, NULL, 1.0, 0, 0};
+    int c;
+
+    while ((c = getopt(argc, argv, "g:l:c:s:rn:h")) != -1)
+    {
+        switch (c)
+        {
+        case 'g':
+            opt.nmea = optarg;
+            break;
+        case 'l':
+            opt.can_log = optarg;
+            break;
+        case 'c':
+            opt.can_if = optarg;
+            break;
+        case 's':
+            opt.cpu_scale = atof(optarg);
+            break;
+        case 'r':
+            opt.realtime = 1;
+            break;
+        case 'n':
+            opt.max_samples = strtoul(optarg, NULL, 10);
+            break;
+        default:
+            vUsage(argv[0]);
+            return c == 'h' ? EXIT_SUCCESS : EXIT_FAILURE;
+        }
+    }
+    if (optind != argc - 1 || !(opt.cpu_scale > 0.0))
+    {
+        vUsage(argv[0]);
+        return EXIT_FAILURE;
+    }
+    opt.imu = argv[optind];
+    if (iSim_Open(&opt) != 0)
+    {
+        vSim_Close();
+        return EXIT_FAILURE;
+    }
+    vSim_SetClock(opt.cpu_scale, opt.realtime);
+    wall_begin = uSim_Wall();
+    return ahrs_main();
+}
@@ -0,0 +1,490 @@
+/***********************************************************************************
+* This file is part of The AHRS Project.                                           *
+*                                                                                  *
+* Copyright © 2020 By Nicola di Gruttola Giardino. All rights reserved.            *
+* @mail: nicoladgg@protonmail.com                                                  *
+*                                                                                  *
+* AHRS is free software: you can redistribute it and/or modify                     *
+* it under the terms of the GNU General Public License as published by             *
+* the Free Software Foundation, either version 3 of the License, or                *
+* (at your option) any later version.                                              *
+*                                                                                  *
+* AHRS is distributed in the hope that it will be useful,                          *
+* but WITHOUT ANY WARRANTY; without even the implied warranty of                   *
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the                    *
+* GNU General Public License for more details.                                     *
+*                                                                                  *
+* You should have received a copy of the GNU General Public License                *
+* along with The AHRS Project.  If not, see <https://www.gnu.org/licenses/>.       *
+*                                                                                  *
+* In case of use of this project, I ask you to mention me, to whom it may concern. *
+***********************************************************************************/
+
+/****************************************************************************************************
+* FILE NAME: sim_os.c                                                                               *
+*                                                                                                   *
+* PURPOSE: Kernel of the simulator: every ChibiOS thread is a pthread, but only the one holding     *
+*           the cpu mutex runs. A sleep gives the CPU to the thread with the earliest wake time     *
+*           and moves the virtual clock to it, so that the run is deterministic and as fast as      *
+*           the host, or paced to the wall clock                                                    *
+*                                                                                                   *
+* FILE REFERENCES:                                                                                  *
+*                                                                                                   *
+*   Name    I/O     Description                                                                     *
+*   ----    ---     -----------                                                                     *
+*   none                                                                                            *
+*                                                                                                   *
+*                                                                                                   *
+* EXTERNAL VARIABLES:                                                                               *
+*                                                                                                   *
+* Source: <ch.h>                                                                                    *
+*                                                                                                   *
+* Name          Type          IO Description                                                        *
+* ------------- -------       -- -----------------------------                                      *
+*   thread_t    SimThread        A simulated thread                                                 *
+*                                                                                                   *
+* STATIC VARIABLES:                                                                                 *
+*                                                                                                   *
+*   Name         Type          I/O  Description                                                     *
+*   ----         ----          ---  -----------                                                     *
+*   threads      SimThread[]        The threads, main first                                         *
+*   current      SimThread*         Thread holding the CPU                                          *
+*   now          uint64_t           Virtual ns of the last switch                                   *
+*   wall_in      uint64_t           Wall ns of the last switch                                      *
+*                                                                                                   *
+* EXTERNAL REFERENCES:                                                                              *
+*                                                                                                   *
+*  Name                       Description                                                           *
+*  -------------              -----------                                                           *
+*  pthread                    Threads, mutex and condition                                          *
+*                                                                                                   *
+* ABNORMAL TERMINATION CONDITIONS, ERROR AND WARNING MESSAGES:                                      *
+*    more threads than SIM_THREADS, a failed pthread_create or every thread exited: message on      *
+*    stderr and exit                                                                                *
+*                                                                                                   *
+* ASSUMPTIONS, CONSTRAINTS, RESTRICTIONS: a thread is switched only when it sleeps or exits: a      *
+*    higher priority thread that wakes up waits for the sleep of the running one, where ChibiOS     *
+*    would preempt it                                                                               *
+*                                                                                                   *
+* NOTES: the virtual clock is charged the host CPU time of the running thread times the scale of    *
+*    vSim_SetClock, plus what vSim_Charge adds                                                      *
+*                                                                                                   *
+* REQUIREMENTS/FUNCTIONAL SPECIFICATIONS REFERENCES:                                                *
+*                                                                                                   *
+* DEVELOPMENT HISTORY:                                                                              *
+*                                                                                                   *
+*   Date          Author            Change Id     Release     Description Of Change                 *
+*   ----          ------            ---------     ------      ----------------------                *
+*   19-10-2026    AHRS Project       1               1         Initial release                      *
+*                                                                                                   *
+****************************************************************************************************/
+
+/* Include Global Parameters */
+
+#include <pthread.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+#include "ch.h"
+#include "sim.h"
+
+/* Definition of Macros */
+
+#define NS_PER_TICK   (1000000000ULL / CH_CFG_ST_FREQUENCY)
+
+struct SimThread
+{
+    pthread_t   id;
+    const char* name;
+    tprio_t     prio;
+    uint64_t    wake;           /* virtual ns at which it is ready */
+    int         exited;
+    tfunc_t     pf;
+    void*       arg;
+};
+
+/* Define Static Variables */
+
+static struct SimThread  threads[SIM_THREADS];
+static unsigned int      nthreads=0;
+static struct SimThread* current=NULL;
+
+static pthread_mutex_t   cpu=PTHREAD_MUTEX_INITIALIZER;
+static pthread_cond_t    turn=PTHREAD_COND_INITIALIZER;
+
+static uint64_t          now=0;         /* virtual ns at which current got the CPU */
+static uint64_t          wall_in=0;     /* wall ns at which current got the CPU */
+static uint64_t          wall_start=0;
+static double            cpu_scale=1.0;
+static int               realtime=0;
+
+/********************************************************************************
+*                                                                               *
+* FUNCTION NAME: uSim_Wall                                                      *
+*                                                                               *
+* PURPOSE: Wall clock of the host                                               *
+*                                                                               *
+* ARGUMENT LIST: none                                                           *
+*                                                                               *
+* RETURN VALUE: uint64_t, CLOCK_MONOTONIC in ns                                 *
+*                                                                               *
+********************************************************************************/
+uint64_t uSim_Wall(void)
+{
+    struct timespec ts;
+
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000000ULL + (uint64_t)ts.tv_nsec;
+}
+
+/********************************************************************************
+*                                                                               *
+* FUNCTION NAME: vSim_SetClock                                                  *
+*                                                                               *
+* PURPOSE: Virtual clock of the run, to be set before chSysInit                 *
+*                                                                               *
+* ARGUMENT LIST:                                                                *
+*                                                                               *
+* Argument  Type         IO     Description                                     *
+* --------- --------     --     ---------------------------------               *
+* scale     double       I      Target time of one ns of host CPU time          *
+* rt        int          I      1 to pace the virtual clock to the wall clock   *
+*                                                                               *
+* RETURN VALUE: void                                                            *
+*                                                                               *
+********************************************************************************/
+void vSim_SetClock(double scale, int rt)
+{
+    cpu_scale = scale;
+    realtime = rt;
+}
+
+/********************************************************************************
+*                                                                               *
+* FUNCTION NAME: uSim_Now                                                       *
+*                                                                               *
+* PURPOSE: Virtual time: the time of the last switch, plus the CPU time of the  *
+*           running thread since then times the CPU scale                       *
+*                                                                               *
+* ARGUMENT LIST: none                                                           *
+*                                                                               *
+* RETURN VALUE: uint64_t, virtual ns since chSysInit                            *
+*                                                                               *
+********************************************************************************/
+uint64_t uSim_Now(void)
+{
+    return now + (uint64_t)((double)(uSim_Wall() - wall_in) * cpu_scale);
+}
+
+/********************************************************************************
+*                                                                               *
+* FUNCTION NAME: vSim_Charge                                                    *
+*                                                                               *
+* PURPOSE: Adds the time of a peripheral that the running thread waits for,     *
+*           e.g. one UART character, to the virtual clock                       *
+*                                                                               *
+* ARGUMENT LIST:                                                                *
+*                                                                               *
+* Argument  Type         IO     Description                                     *
+* --------- --------     --     ---------------------------------               *
+* ns        uint64_t     I      Virtual ns                                      *
+*                                                                               *
+* RETURN VALUE: void                                                            *
+*                                                                               *
+********************************************************************************/
+void vSim_Charge(uint64_t ns)
+{
+    now += ns;
+}
+
+/********************************************************************************
+*                                                                               *
+* FUNCTION NAME: vSwitch                                                        *
+*                                                                               *
+* PURPOSE: Gives the CPU to the thread with the earliest wake time, the highest *
+*           priority first among equal ones, advancing the virtual clock to it, *
+*           and waits for the CPU to come back unless self has exited           *
+*                                                                               *
+* ARGUMENT LIST:                                                                *
+*                                                                               *
+* Argument  Type         IO     Description                                     *
+* --------- --------     --     ---------------------------------               *
+* self      SimThread*   IO     Running thread, holds cpu                       *
+*                                                                               *
+* RETURN VALUE: void                                                            *
+*                                                                               *
+********************************************************************************/
+static void vSwitch(struct SimThread *self)
+{
+    struct SimThread *next = NULL;
+    unsigned int i;
+
+    now = uSim_Now();
+    for (i = 0; i < nthreads; i++)
+    {
+        struct SimThread *t = &threads[i];
+
+        if (t->exited)
+        {
+            continue;
+        }
+        if (next == NULL || t->wake < next->wake ||
+            (t->wake == next->wake && t->prio > next->prio))
+        {
+            next = t;
+        }
+    }
+    if (next == NULL)
+    {
+        fprintf(stderr, "sim: every thread has exited\n");
+        exit(EXIT_FAILURE);
+    }
+    if (next->wake > now)
+    {
+        now = next->wake;
+    }
+    if (realtime)
+    {
+        uint64_t w = uSim_Wall();
+
+        if (wall_start + now > w)
+        {
+            struct timespec ts;
+
+            ts.tv_sec = (time_t)((wall_start + now - w) / 1000000000ULL);
+            ts.tv_nsec = (long)((wall_start + now - w) % 1000000000ULL);
+            nanosleep(&ts, NULL);
+        }
+    }
+
+    current = next;
+    pthread_cond_broadcast(&turn);
+    if (self->exited)
+    {
+        return;
+    }
+    while (current != self)
+    {
+        pthread_cond_wait(&turn, &cpu);
+    }
+    wall_in = uSim_Wall();
+}
+
+/********************************************************************************
+*                                                                               *
+* FUNCTION NAME: pvTrampoline                                                   *
+*                                                                               *
+* PURPOSE: Body of the pthread of a simulated thread: waits for its first turn, *
+*           runs the thread function and exits                                  *
+*                                                                               *
+* ARGUMENT LIST:                                                                *
+*                                                                               *
+* Argument  Type         IO     Description                                     *
+* --------- --------     --     ---------------------------------               *
+* p         void*        I      Its SimThread                                   *
+*                                                                               *
+* RETURN VALUE: void*, never returns                                            *
+*                                                                               *
+********************************************************************************/
+static void *pvTrampoline(void *p)
+{
+    struct SimThread *self = p;
+
+    pthread_mutex_lock(&cpu);
+    while (current != self)
+    {
+        pthread_cond_wait(&turn, &cpu);
+    }
+    wall_in = uSim_Wall();
+    self->pf(self->arg);
+    chThdExit((msg_t)0);
+}
+
+/********************************************************************************
+*                                                                               *
+* FUNCTION NAME: chSysInit                                                      *
+*                                                                               *
+* PURPOSE: Makes the calling pthread the main thread and starts the virtual     *
+*           clock at 0                                                          *
+*                                                                               *
+* ARGUMENT LIST: none                                                           *
+*                                                                               *
+* RETURN VALUE: void                                                            *
+*                                                                               *
+********************************************************************************/
+void chSysInit(void)
+{
+    struct SimThread *self = &threads[nthreads++];
+
+    self->id = pthread_self();
+    self->name = "main";
+    self->prio = NORMALPRIO;
+    self->wake = 0;
+    self->exited = 0;
+    pthread_mutex_lock(&cpu);
+    current = self;
+    now = 0;
+    wall_start = uSim_Wall();
+    wall_in = wall_start;
+}
+
+/********************************************************************************
+*                                                                               *
+* FUNCTION NAME: chThdCreateStatic                                              *
+*                                                                               *
+* PURPOSE: Starts a thread on its own pthread; one of higher priority than the  *
+*           caller runs first, as it would preempt it                           *
+*                                                                               *
+* ARGUMENT LIST:                                                                *
+*                                                                               *
+* Argument  Type         IO     Description                                     *
+* --------- --------     --     ---------------------------------               *
+* wsp       void*        I      Working area, unused                            *
+* size      size_t       I      Its size, unused                                *
+* prio      tprio_t      I      Priority                                        *
+* pf        tfunc_t      I      Thread function                                 *
+* arg       void*        I      Its argument                                    *
+*                                                                               *
+* RETURN VALUE: thread_t*, the thread                                           *
+*                                                                               *
+********************************************************************************/
+thread_t *chThdCreateStatic(void *wsp, size_t size, tprio_t prio, tfunc_t pf, void *arg)
+{
+    struct SimThread *t;
+
+    (void)wsp;
+    (void)size;
+    if (nthreads >= SIM_THREADS)
+    {
+        fprintf(stderr, "sim: more than %d threads\n", SIM_THREADS);
+        exit(EXIT_FAILURE);
+    }
+    t = &threads[nthreads++];
+    t->name = "";
+    t->prio = prio;
+    t->wake = uSim_Now();
+    t->exited = 0;
+    t->pf = pf;
+    t->arg = arg;
+    if (pthread_create(&t->id, NULL, pvTrampoline, t) != 0 || pthread_detach(t->id) != 0)
+    {
+        fprintf(stderr, "sim: pthread_create failed\n");
+        exit(EXIT_FAILURE);
+    }
+    if (prio > current->prio)
+    {
+        current->wake = uSim_Now();
+        vSwitch(current);
+    }
+    return t;
+}
+
+/********************************************************************************
+*                                                                               *
+* FUNCTION NAME: chThdGetSelfX                                                  *
+*                                                                               *
+* PURPOSE: Running thread                                                       *
+*                                                                               *
+* ARGUMENT LIST: none                                                           *
+*                                                                               *
+* RETURN VALUE: thread_t*                                                       *
+*                                                                               *
+********************************************************************************/
+thread_t *chThdGetSelfX(void)
+{
+    return current;
+}
+
+/********************************************************************************
+*                                                                               *
+* FUNCTION NAME: chThdSleep                                                     *
+*                                                                               *
+* PURPOSE: Suspends the running thread for an interval of virtual time; it      *
+*           closes the IMU sample of the SPI thread                             *
+*                                                                               *
+* ARGUMENT LIST:                                                                *
+*                                                                               *
+* Argument  Type          IO     Description                                    *
+* --------- --------      --     ---------------------------------              *
+* time      sysinterval_t I      Interval in system ticks                       *
+*                                                                               *
+* RETURN VALUE: void                                                            *
+*                                                                               *
+********************************************************************************/
+void chThdSleep(sysinterval_t time)
+{
+    struct SimThread *self = current;
+
+    vSim_SampleEnd();
+    self->wake = uSim_Now() + (uint64_t)time * NS_PER_TICK;
+    vSwitch(self);
+}
+
+/********************************************************************************
+*                                                                               *
+* FUNCTION NAME: chThdExit                                                      *
+*                                                                               *
+* PURPOSE: Ends the running thread and gives the CPU to the next one            *
+*                                                                               *
+* ARGUMENT LIST:                                                                *
+*                                                                               *
+* Argument  Type         IO     Description                                     *
+* --------- --------     --     ---------------------------------               *
+* msg       msg_t        I      Exit code, unused                               *
+*                                                                               *
+* RETURN VALUE: void, never returns                                             *
+*                                                                               *
+********************************************************************************/
+void chThdExit(msg_t msg)
+{
+    struct SimThread *self = current;
+
+    (void)msg;
+    self->exited = 1;
+    vSwitch(self);
+    pthread_mutex_unlock(&cpu);
+    pthread_exit(NULL);
+}
+
+/********************************************************************************
+*                                                                               *
+* FUNCTION NAME: chRegSetThreadName                                             *
+*                                                                               *
+* PURPOSE: Names the running thread                                             *
+*                                                                               *
+* ARGUMENT LIST:                                                                *
+*                                                                               *
+* Argument  Type         IO     Description                                     *
+* --------- --------     --     ---------------------------------               *
+* name      const char*  I      Name                                            *
+*                                                                               *
+* RETURN VALUE: void                                                            *
+*                                                                               *
+********************************************************************************/
+void chRegSetThreadName(const char *name)
+{
+    current->name = name;
+}
+
+/********************************************************************************
+*                                                                               *
+* FUNCTION NAME: chSysHalt                                                      *
+*                                                                               *
+* PURPOSE: Stops the system on an unrecoverable error: the reason on stderr,    *
+*           the files of the run closed, exit status 1                          *
+*                                                                               *
+* ARGUMENT LIST:                                                                *
+*                                                                               *
+* Argument  Type         IO     Description                                     *
+* --------- --------     --     ---------------------------------               *
+* reason    const char*  I      Reason of the halt                              *
+*                                                                               *
+* RETURN VALUE: void, never returns                                             *
+*                                                                               *
+********************************************************************************/
+void chSysHalt(const char *reason)
+{
+    fprintf(stderr, "halted: %s\n", reason);
+    vSim_Close();
+    exit(EXIT_FAILURE);
+}
@@ -0,0 +1,209 @@
+/***********************************************************************************
+* This file is part of The AHRS Project.                                           *
+*                                                                                  *
+* Copyright © 2020 By Nicola di Gruttola Giardino. All rights reserved.            *
+* @mail: nicoladgg@protonmail.com                                                  *
+*                                                                                  *
+* AHRS is free software: you can redistribute it and/or modify                     *
+* it under the terms of the GNU General Public License as published by             *
+* the Free Software Foundation, either version 3 of the License, or                *
+* (at your option) any later version.                                              *
+*                                                                                  *
+* AHRS is distributed in the hope that it will be useful,                          *
+* but WITHOUT ANY WARRANTY; without even the implied warranty of                   *
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the                    *
+* GNU General Public License for more details.                                     *
+*                                                                                  *
+* You should have received a copy of the GNU General Public License                *
+* along with The AHRS Project.  If not, see <https://www.gnu.org/licenses/>.       *
+*                                                                                  *
+* In case of use of this project, I ask you to mention me, to whom it may concern. *
+***********************************************************************************/
+
+/****************************************************************************************************
+* FILE NAME: batch_test.c                                                                           *
+*                                                                                                   *
+* PURPOSE: Test of the structure of arrays filter: every filter of a batch, each on its own noisy   *
+*           track and with its own missing fixes, against the generic sequential filter             *
+*                                                                                                   *
+* FILE REFERENCES:                                                                                  *
+*                                                                                                   *
+*   Name    I/O     Description                                                                     *
+*   ----    ---     -----------                                                                     *
+*   none                                                                                            *
+*                                                                                                   *
+* EXTERNAL VARIABLES:                                                                               *
+*                                                                                                   *
+* Source: <unit_test.h>                                                                             *
+*                                                                                                   *
+* Name          Type          IO Description                                                        *
+* ------------- -------       -- -----------------------------                                      *
+*   none                                                                                            *
+*                                                                                                   *
+* STATIC VARIABLES:                                                                                 *
+*                                                                                                   *
+*   Name     Type       I/O      Description                                                        *
+*   ----     ----       ---      -----------                                                        *
+*   none                                                                                            *
+*                                                                                                   *
+* EXTERNAL REFERENCES:                                                                              *
+*                                                                                                   *
+*  Name                       Description                                                           *
+*  -------------              -----------                                                           *
+*  KalmanBatch.c              The functions under test                                              *
+*  Kalman.c                   Reference filter                                                      *
+*  rng.c                      Noise of the tracks                                                   *
+*                                                                                                   *
+* ABNORMAL TERMINATION CONDITIONS, ERROR AND WARNING MESSAGES:                                      *
+*    none                                                                                           *
+*                                                                                                   *
+* ASSUMPTIONS, CONSTRAINTS, RESTRICTIONS: none                                                      *
+*                                                                                                   *
+* NOTES: the batch is not a multiple of the vector width, so that the tail of the vectorised        *
+*         loops runs too                                                                            *
+*                                                                                                   *
+* REQUIREMENTS/FUNCTIONAL SPECIFICATIONS REFERENCES:                                                *
+*                                                                                                   *
+* DEVELOPMENT HISTORY:                                                                              *
+*                                                                                                   *
+*   Date          Author            Change Id     Release     Description Of Change                 *
+*   ----          ------            ---------     ------      ----------------------                *
+*   19-10-2026    AHRS Project       1               1         Initial release                      *
+*                                                                                                   *
+****************************************************************************************************/
+
+/* Include Global Parameters */
+
+#include <math.h>
+#include "unit_test.h"
+#include "KalmanBatch.h"
+#include "Kalman.h"
+#include "rng.h"
+
+/* Definition of Macros */
+
+#define BT_DT       0.01f
+#define BT_ACC      0.5f
+#define BT_FILTERS  7
+#define BT_STEPS    500
+
+/* Declare Prototypes */
+
+static void   vSetup   (kalman *);
+
+
+/********************************************************************************
+*                                                                               *
+* FUNCTION NAME: vSetup                                                         *
+*                                                                               *
+* PURPOSE: Creates the generic filter of the model of KalmanBatch, with its     *
+*           default P, Q and R                                                  *
+*                                                                               *
+* ARGUMENT LIST:                                                                *
+*                                                                               *
+* Argument  Type         IO     Description                                     *
+* --------- --------     --     ---------------------------------               *
+* k         kalman*      O      Filter                                          *
+*                                                                               *
+* RETURN VALUE: void                                                            *
+*                                                                               *
+********************************************************************************/
+static void vSetup(kalman *k)
+{
+    iKalman_Init(k, 2, 2);
+    k->vModel = NULL;
+    k->dt     = BT_DT;
+    k->A->matrix[0][0] = 1;
+    k->A->matrix[0][1] = BT_DT;
+    k->A->matrix[1][1] = 1;
+    k->B->matrix[0][0] = BT_DT * BT_DT / 2;
+    k->B->matrix[1][0] = BT_DT;
+    k->H->matrix[0][0] = 1;
+    k->H->matrix[1][1] = 1;
+    k->Q->matrix[0][0] = 1e-4f;
+    k->Q->matrix[1][1] = 1e-3f;
+    k->R->matrix[0][0] = 0.2f;
+    k->R->matrix[1][1] = 0.2f;
+    k->P->matrix[0][0] = 1;
+    k->P->matrix[1][1] = 1;
+}
+
+/********************************************************************************
+*                                                                               *
+* FUNCTION NAME: vTest_Batch                                                    *
+*                                                                               *
+* PURPOSE: Test of KalmanBatch.c                                                *
+*                                                                               *
+* ARGUMENT LIST:                                                                *
+*                                                                               *
+* Argument  Type         IO     Description                                     *
+* --------- --------     --     ---------------------------------               *
+* none                                                                          *
+*                                                                               *
+* RETURN VALUE: void                                                            *
+*                                                                               *
+********************************************************************************/
+void vTest_Batch(void)
+{
+    KalmanBatch   b;
+    kalman        k[BT_FILTERS];
+    Matrix       *z = pxCreate(2, 1);
+    float         zp[BT_FILTERS];
+    float         zv[BT_FILTERS];
+    float         u[BT_FILTERS];
+    unsigned char valid[BT_FILTERS];
+    unsigned char all[2] = {1, 1};
+    unsigned char none[2] = {0, 0};
+    float         t;
+    float         d;
+    Rng           rng;
+    int           i, j;
+
+    vRngSeed(&rng, 34, 0);
+    TEST_CHECK(iKalmanBatch_Init(&b, BT_FILTERS, BT_DT) == 0);
+    for (j = 0; j < BT_FILTERS; j++)
+    {
+        vSetup(&k[j]);
+        b.q0[j] = k[j].Q->matrix[0][0];
+        b.q1[j] = k[j].Q->matrix[1][1];
+        u[j]    = BT_ACC * (float)(j + 1);
+    }
+
+    /* constant acceleration tracks, one per filter; filter j misses a fix
+       every 3 steps, each at a different phase */
+    for (i = 0; i < BT_STEPS; i++)
+    {
+        t = (float)i * BT_DT;
+        for (j = 0; j < BT_FILTERS; j++)
+        {
+            zp[j]    = 0.5f * u[j] * t * t + 0.45f * fRngNormal(&rng);
+            zv[j]    = u[j] * t            + 0.45f * fRngNormal(&rng);
+            valid[j] = ((i + j) % 3) != 0;
+        }
+        vKalmanBatch_Predict(&b, u);
+        vKalmanBatch_Update(&b, zp, zv, valid);
+        for (j = 0; j < BT_FILTERS; j++)
+        {
+            z->matrix[0][0] = zp[j];
+            z->matrix[1][0] = zv[j];
+            vKalman_Predict(&k[j], BT_DT, u[j]);
+            iKalman_UpdateSeq(&k[j], z, valid[j] ? all : none);
+        }
+    }
+
+    d = 0;
+    for (j = 0; j < BT_FILTERS; j++)
+    {
+        /* relative errors, a sum of squares, so that a NaN is not lost */
+        d += powf((b.x0[j] - k[j].x->matrix[0][0]) / (1 + fabsf(b.x0[j])), 2);
+        d += powf((b.x1[j] - k[j].x->matrix[1][0]) / (1 + fabsf(b.x1[j])), 2);
+        d += powf((b.p00[j] - k[j].P->matrix[0][0]) / k[j].P->matrix[0][0], 2);
+        d += powf((b.p11[j] - k[j].P->matrix[1][1]) / k[j].P->matrix[1][1], 2);
+        TEST_NEAR(b.p01[j], k[j].P->matrix[0][1], 1e-4 * k[j].P->matrix[0][0]);
+        vKalman_Destroy(&k[j]);
+    }
+    TEST_NEAR(sqrtf(d), 0, 1e-4);
+
+    vDestroy(z);
+    vKalmanBatch_Destroy(&b);
+}
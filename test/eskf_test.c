@@ -0,0 +1,388 @@
+/***********************************************************************************
+* This file is part of The AHRS Project.                                           *
+*                                                                                  *
+* Copyright © 2020 By Nicola di Gruttola Giardino. All rights reserved.            *
+* @mail: nicoladgg@protonmail.com                                                  *
+*                                                                                  *
+* AHRS is free software: you can redistribute it and/or modify                     *
+* it under the terms of the GNU General Public License as published by             *
+* the Free Software Foundation, either version 3 of the License, or                *
+* (at your option) any later version.                                              *
+*                                                                                  *
+* AHRS is distributed in the hope that it will be useful,                          *
+* but WITHOUT ANY WARRANTY; without even the implied warranty of                   *
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the                    *
+* GNU General Public License for more details.                                     *
+*                                                                                  *
+* You should have received a copy of the GNU General Public License                *
+* along with The AHRS Project.  If not, see <https://www.gnu.org/licenses/>.       *
+*                                                                                  *
+* In case of use of this project, I ask you to mention me, to whom it may concern. *
+***********************************************************************************/
+
+/****************************************************************************************************
+* FILE NAME: eskf_test.c                                                                            *
+*                                                                                                   *
+* PURPOSE: Test of the 15-state error-state filter: the block sparse propagation against the        *
+*           dense F*P*F^T + Q, and at rest, from a tilted start with biased sensors and a GPS       *
+*           fix at 10 Hz, the convergence of the attitude and of the observable biases              *
+*                                                                                                   *
+* FILE REFERENCES:                                                                                  *
+*                                                                                                   *
+*   Name    I/O     Description                                                                     *
+*   ----    ---     -----------                                                                     *
+*   none                                                                                            *
+*                                                                                                   *
+* EXTERNAL VARIABLES:                                                                               *
+*                                                                                                   *
+* Source: <unit_test.h>                                                                             *
+*                                                                                                   *
+* Name          Type          IO Description                                                        *
+* ------------- -------       -- -----------------------------                                      *
+*   none                                                                                            *
+*                                                                                                   *
+* STATIC VARIABLES:                                                                                 *
+*                                                                                                   *
+*   Name     Type       I/O      Description                                                        *
+*   ----     ----       ---      -----------                                                        *
+*   f        ESKF       IO       Filter under test, too large for the stack of a test               *
+*                                                                                                   *
+* EXTERNAL REFERENCES:                                                                              *
+*                                                                                                   *
+*  Name                       Description                                                           *
+*  -------------              -----------                                                           *
+*  ESKF.c                     The functions under test                                              *
+*  rng.c                      Noise of the sensors                                                  *
+*                                                                                                   *
+* ABNORMAL TERMINATION CONDITIONS, ERROR AND WARNING MESSAGES:                                      *
+*    none                                                                                           *
+*                                                                                                   *
+* ASSUMPTIONS, CONSTRAINTS, RESTRICTIONS: none                                                      *
+*                                                                                                   *
+* NOTES: at rest the roll and pitch errors are seen by the velocity, and through them the           *
+*         horizontal gyro biases; the vertical accelerometer bias is seen by the vertical           *
+*         velocity. The horizontal accelerometer biases look like a tilt and the yaw is not         *
+*         observed, so those are left at 0                                                          *
+*                                                                                                   *
+* REQUIREMENTS/FUNCTIONAL SPECIFICATIONS REFERENCES:                                                *
+*                                                                                                   *
+* DEVELOPMENT HISTORY:                                                                              *
+*                                                                                                   *
+*   Date          Author            Change Id     Release     Description Of Change                 *
+*   ----          ------            ---------     ------      ----------------------                *
+*   19-10-2026    AHRS Project       1               1         Initial release                      *
+*                                                                                                   *
+****************************************************************************************************/
+
+/* Include Global Parameters */
+
+#include <math.h>
+#include "unit_test.h"
+#include "ESKF.h"
+#include "rng.h"
+
+/* Definition of Macros */
+
+#define ET_DT       0.005f      /* IMU at 200 Hz */
+#define ET_GPS      20          /* IMU samples per fix, 10 Hz */
+#define ET_STEPS    24000       /* 120 s */
+
+/* Declare Prototypes */
+
+static void   vRotate  (const float [4], const float [3], float [3]);
+static void   vDense   (const float [4], const float [3], float, float [ESKF_N][ESKF_N]);
+static float  fTilt    (const float [4]);
+
+/* Define Static Variables */
+
+static ESKF f;
+
+
+/********************************************************************************
+*                                                                               *
+* FUNCTION NAME: vRotate                                                        *
+*                                                                               *
+* PURPOSE: Body to navigation rotation of a vector, v = R(q)*u                  *
+*                                                                               *
+* ARGUMENT LIST:                                                                *
+*                                                                               *
+* Argument  Type         IO     Description                                     *
+* --------- --------     --     ---------------------------------               *
+* q         float[4]     I      Attitude, w, x, y, z                            *
+* u         float[3]     I      Vector, body frame                              *
+* v         float[3]     O      Vector, navigation frame                        *
+*                                                                               *
+* RETURN VALUE: void                                                            *
+*                                                                               *
+********************************************************************************/
+static void vRotate(const float q[4], const float u[3], float v[3])
+{
+    const float w = q[0], x = q[1], y = q[2], z = q[3];
+
+    v[0] = (1 - 2 * (y * y + z * z)) * u[0] + 2 * (x * y - w * z) * u[1] + 2 * (x * z + w * y) * u[2];
+    v[1] = 2 * (x * y + w * z) * u[0] + (1 - 2 * (x * x + z * z)) * u[1] + 2 * (y * z - w * x) * u[2];
+    v[2] = 2 * (x * z - w * y) * u[0] + 2 * (y * z + w * x) * u[1] + (1 - 2 * (x * x + y * y)) * u[2];
+}
+
+/********************************************************************************
+*                                                                               *
+* FUNCTION NAME: vDense                                                         *
+*                                                                               *
+* PURPOSE: Dense transition matrix of the error state, F = I + Fc*dt, from the  *
+*           attitude and the bias corrected specific force of the sample        *
+*                                                                               *
+* ARGUMENT LIST:                                                                *
+*                                                                               *
+* Argument  Type         IO     Description                                     *
+* --------- --------     --     ---------------------------------               *
+* q         float[4]     I      Attitude before the sample, w, x, y, z          *
+* a         float[3]     I      Specific force minus the bias, body frame       *
+* dt        float        I      Time step                                       *
+* F         float[][]    O      Transition matrix                               *
+*                                                                               *
+* RETURN VALUE: void                                                            *
+*                                                                               *
+********************************************************************************/
+static void vDense(const float q[4], const float a[3], float dt, float F[ESKF_N][ESKF_N])
+{
+    float R[3][3];
+    float an[3];
+    float e[3];
+    int   i, j;
+
+    for (j = 0; j < 3; j++)
+    {
+        /* the columns of R are the body axes in the navigation frame */
+        e[0] = (j == 0);
+        e[1] = (j == 1);
+        e[2] = (j == 2);
+        vRotate(q, e, an);
+        for (i = 0; i < 3; i++)
+        {
+            R[i][j] = an[i];
+        }
+    }
+    vRotate(q, a, an);
+
+    for (i = 0; i < ESKF_N; i++)
+    {
+        for (j = 0; j < ESKF_N; j++)
+        {
+            F[i][j] = (i == j);
+        }
+    }
+    for (i = 0; i < 3; i++)
+    {
+        /* dp' = dv, dv' = -[R*a]x*dtheta - R*dba, dtheta' = -R*dbg */
+        F[ESKF_POS + i][ESKF_VEL + i] = dt;
+        for (j = 0; j < 3; j++)
+        {
+            F[ESKF_VEL + i][ESKF_BA + j] = -R[i][j] * dt;
+            F[ESKF_ATT + i][ESKF_BG + j] = -R[i][j] * dt;
+        }
+    }
+    F[ESKF_VEL + 0][ESKF_ATT + 1] =  an[2] * dt;
+    F[ESKF_VEL + 0][ESKF_ATT + 2] = -an[1] * dt;
+    F[ESKF_VEL + 1][ESKF_ATT + 0] = -an[2] * dt;
+    F[ESKF_VEL + 1][ESKF_ATT + 2] =  an[0] * dt;
+    F[ESKF_VEL + 2][ESKF_ATT + 0] =  an[1] * dt;
+    F[ESKF_VEL + 2][ESKF_ATT + 1] = -an[0] * dt;
+}
+
+/********************************************************************************
+*                                                                               *
+* FUNCTION NAME: fTilt                                                          *
+*                                                                               *
+* PURPOSE: Angle between the body z axis of an attitude and the vertical        *
+*                                                                               *
+* ARGUMENT LIST:                                                                *
+*                                                                               *
+* Argument  Type         IO     Description                                     *
+* --------- --------     --     ---------------------------------               *
+* q         float[4]     I      Attitude, w, x, y, z                            *
+*                                                                               *
+* RETURN VALUE: float, rad                                                      *
+*                                                                               *
+********************************************************************************/
+static float fTilt(const float q[4])
+{
+    return acosf(fminf(1.0f, 1 - 2 * (q[1] * q[1] + q[2] * q[2])));
+}
+
+/********************************************************************************
+*                                                                               *
+* FUNCTION NAME: vTest_ESKF                                                     *
+*                                                                               *
+* PURPOSE: Test of ESKF.c                                                       *
+*                                                                               *
+* ARGUMENT LIST:                                                                *
+*                                                                               *
+* Argument  Type         IO     Description                                     *
+* --------- --------     --     ---------------------------------               *
+* none                                                                          *
+*                                                                               *
+* RETURN VALUE: void                                                            *
+*                                                                               *
+********************************************************************************/
+void vTest_ESKF(void)
+{
+    static float F[ESKF_N][ESKF_N];
+    static float P[ESKF_N][ESKF_N];
+    static float FP[ESKF_N][ESKF_N];
+    const float  q0[4]   = {0.9490f, 0.0670f, -0.0580f, 0.3020f};
+    const float  gyro[3] = {0.3f, -0.2f, 0.5f};
+    const float  acc[3]  = {1.5f, -0.8f, -9.5f};
+    const float  bg[3]   = {0.01f, -0.02f, 0.005f};
+    const float  ba[3]   = {0, 0, -0.05f};
+    float        a[3];
+    float        an[3];
+    float        q[4];
+    float        pos[3] = {0, 0, 0};
+    float        vel[3] = {0, 0, 0};
+    float        gy[3];
+    float        ac[3];
+    float        d;
+    float        s;
+    Rng          rng;
+    int          failed = 0;
+    int          i, j, l;
+
+    vRngSeed(&rng, 35, 0);
+
+    /* one predict against the dense F*P*F^T + Q, from a full P: a random
+       positive definite one, M*M^T/n + I/10 */
+    vESKF_Init(&f, q0);
+    for (i = 0; i < 3; i++)
+    {
+        f.bg[i] = bg[i];
+        f.ba[i] = 0.1f * (float)(i + 1);
+    }
+    for (i = 0; i < ESKF_N; i++)
+    {
+        for (j = 0; j < ESKF_N; j++)
+        {
+            F[i][j] = fRngNormal(&rng);
+        }
+    }
+    for (i = 0; i < ESKF_N; i++)
+    {
+        for (j = 0; j < ESKF_N; j++)
+        {
+            s = (i == j) ? 0.1f : 0;
+            for (l = 0; l < ESKF_N; l++)
+            {
+                s += F[i][l] * F[j][l] / ESKF_N;
+            }
+            f.P[i][j] = s;
+        }
+    }
+    for (i = 0; i < 4; i++)
+    {
+        q[i] = f.q[i];
+    }
+    for (i = 0; i < 3; i++)
+    {
+        a[i] = acc[i] - f.ba[i];
+    }
+    vDense(q, a, ET_DT, F);
+    for (i = 0; i < ESKF_N; i++)
+    {
+        for (j = 0; j < ESKF_N; j++)
+        {
+            s = 0;
+            for (l = 0; l < ESKF_N; l++)
+            {
+                s += F[i][l] * f.P[l][j];
+            }
+            FP[i][j] = s;
+        }
+    }
+    for (i = 0; i < ESKF_N; i++)
+    {
+        for (j = 0; j < ESKF_N; j++)
+        {
+            s = 0;
+            for (l = 0; l < ESKF_N; l++)
+            {
+                s += FP[i][l] * F[j][l];
+            }
+            P[i][j] = s;
+        }
+    }
+    for (i = 0; i < 3; i++)
+    {
+        P[ESKF_VEL + i][ESKF_VEL + i] += f.na * f.na * ET_DT;
+        P[ESKF_ATT + i][ESKF_ATT + i] += f.ng * f.ng * ET_DT;
+        P[ESKF_BA + i][ESKF_BA + i]   += f.nba * f.nba * ET_DT;
+        P[ESKF_BG + i][ESKF_BG + i]   += f.nbg * f.nbg * ET_DT;
+    }
+    vESKF_Predict(&f, gyro, acc, ET_DT);
+    d = 0;
+    for (i = 0; i < ESKF_N; i++)
+    {
+        for (j = 0; j < ESKF_N; j++)
+        {
+            d += (f.P[i][j] - P[i][j]) * (f.P[i][j] - P[i][j]);
+        }
+    }
+    TEST_NEAR(sqrtf(d), 0, 1e-5);
+
+    /* and the nominal state integrates the same specific force from rest */
+    vRotate(q, a, an);
+    an[2] += ESKF_GRAVITY;
+    for (i = 0; i < 3; i++)
+    {
+        TEST_NEAR(f.v[i], an[i] * ET_DT, 1e-6);
+        TEST_NEAR(f.p[i], 0.5f * an[i] * ET_DT * ET_DT, 1e-8);
+    }
+
+    /* at rest: the filter starts 5 deg off in roll, the gyro and the vertical
+       accelerometer are biased; the GPS holds the position and velocity at 0 */
+    vESKF_Init(&f, NULL);
+    f.q[0] = cosf(0.5f * 0.0873f);
+    f.q[1] = sinf(0.5f * 0.0873f);
+    TEST_NEAR(fTilt(f.q), 0.0873f, 1e-3);
+    for (i = 0; i < ET_STEPS; i++)
+    {
+        for (j = 0; j < 3; j++)
+        {
+            gy[j] = bg[j] + 0.002f * fRngNormal(&rng);
+            ac[j] = ba[j] + 0.02f * fRngNormal(&rng);
+        }
+        ac[2] -= ESKF_GRAVITY;
+        vESKF_Predict(&f, gy, ac, ET_DT);
+        if ((i + 1) % ET_GPS == 0)
+        {
+            for (j = 0; j < 3; j++)
+            {
+                pos[j] = 0.5f * fRngNormal(&rng);
+                vel[j] = 0.05f * fRngNormal(&rng);
+            }
+            failed += (iESKF_UpdateGPS(&f, pos, vel, 0.25f, 0.0025f) != 0);
+        }
+    }
+    TEST_CHECK(failed == 0);
+    /* a tilt and a horizontal accelerometer bias look the same at rest: the
+       tilt comes within the spread of that bias, the specific force the
+       filter puts in the horizontal plane closer */
+    TEST_CHECK(fTilt(f.q) < 0.02f);
+    for (j = 0; j < 3; j++)
+    {
+        a[j] = ba[j] - f.ba[j];
+    }
+    a[2] -= ESKF_GRAVITY;
+    vRotate(f.q, a, an);
+    TEST_NEAR(an[0], 0, 0.05);
+    TEST_NEAR(an[1], 0, 0.05);
+    TEST_NEAR(f.bg[0], bg[0], 2e-4);
+    TEST_NEAR(f.bg[1], bg[1], 2e-4);
+    TEST_NEAR(f.ba[2], ba[2], 2e-3);
+    for (i = 0; i < ESKF_N; i++)
+    {
+        TEST_CHECK(f.P[i][i] > 0 && isfinite(f.P[i][i]));
+    }
+    /* the variance of what is observed came down from vESKF_Init */
+    TEST_CHECK(f.P[ESKF_ATT][ESKF_ATT] < 0.03f / 100);
+    TEST_CHECK(f.P[ESKF_BG][ESKF_BG] < 1e-4f / 10);
+    TEST_CHECK(f.P[ESKF_BA + 2][ESKF_BA + 2] < 0.01f / 10);
+}
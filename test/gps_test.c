@@ -0,0 +1,214 @@
+/***********************************************************************************
+* This file is part of The AHRS Project.                                           *
+*                                                                                  *
+* Copyright © 2020 By Nicola di Gruttola Giardino. All rights reserved.            *
+* @mail: nicoladgg@protonmail.com                                                  *
+*                                                                                  *
+* AHRS is free software: you can redistribute it and/or modify                     *
+* it under the terms of the GNU General Public License as published by             *
+* the Free Software Foundation, either version 3 of the License, or                *
+* (at your option) any later version.                                              *
+*                                                                                  *
+* AHRS is distributed in the hope that it will be useful,                          *
+* but WITHOUT ANY WARRANTY; without even the implied warranty of                   *
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the                    *
+* GNU General Public License for more details.                                     *
+*                                                                                  *
+* You should have received a copy of the GNU General Public License                *
+* along with The AHRS Project.  If not, see <https://www.gnu.org/licenses/>.       *
+*                                                                                  *
+* In case of use of this project, I ask you to mention me, to whom it may concern. *
+***********************************************************************************/
+
+/****************************************************************************************************
+* FILE NAME: gps_test.c                                                                             *
+*                                                                                                   *
+* PURPOSE: Test of the NMEA parser of GPS_Lib: an RMC + GGA pair is parsed into time, date,         *
+*           position, altitude, satellites, speed and course, and completes only as a pair; a       *
+*           sentence with a term longer than its field is dropped                                   *
+*                                                                                                   *
+* FILE REFERENCES:                                                                                  *
+*                                                                                                   *
+*   Name    I/O     Description                                                                     *
+*   ----    ---     -----------                                                                     *
+*   none                                                                                            *
+*                                                                                                   *
+* EXTERNAL VARIABLES:                                                                               *
+*                                                                                                   *
+* Source: <unit_test.h>                                                                             *
+*                                                                                                   *
+* Name          Type          IO Description                                                        *
+* ------------- -------       -- -----------------------------                                      *
+*   none                                                                                            *
+*                                                                                                   *
+* STATIC VARIABLES:                                                                                 *
+*                                                                                                   *
+*   Name     Type       I/O      Description                                                        *
+*   ----     ----       ---      -----------                                                        *
+*   none                                                                                            *
+*                                                                                                   *
+* EXTERNAL REFERENCES:                                                                              *
+*                                                                                                   *
+*  Name                       Description                                                           *
+*  -------------              -----------                                                           *
+*  GPS_Lib.c                  The functions under test, on a GPSParser of the test                  *
+*                                                                                                   *
+* ABNORMAL TERMINATION CONDITIONS, ERROR AND WARNING MESSAGES:                                      *
+*    none                                                                                           *
+*                                                                                                   *
+* ASSUMPTIONS, CONSTRAINTS, RESTRICTIONS: none                                                      *
+*                                                                                                   *
+* NOTES: the sentences are the examples of the NMEA 0183 reference                                  *
+*                                                                                                   *
+* REQUIREMENTS/FUNCTIONAL SPECIFICATIONS REFERENCES:                                                *
+*                                                                                                   *
+* DEVELOPMENT HISTORY:                                                                              *
+*                                                                                                   *
+*   Date          Author            Change Id     Release     Description Of Change                 *
+*   ----          ------            ---------     ------      ----------------------                *
+*   19-10-2026    AHRS Project       1               1         Initial release                      *
+*   19-10-2026    AHRS Project       2               1.1       Terms longer than their field        *
+*                                                                                                   *
+****************************************************************************************************/
+
+/* Include Global Parameters */
+
+#include "unit_test.h"
+#include "GPS_Lib.h"
+
+/* Definition of Macros */
+
+#define GT_RMC  "$GPRMC,123519,A,4807.038,N,01131.000,E,022.4,084.4,230394,003.1,W*6A\r\n"
+#define GT_GGA  "$GPGGA,123519,4807.038,N,01131.000,E,1,08,0.9,545.4,M,46.9,M,,*47\r\n"
+
+/* Declare Prototypes */
+
+static int  iFeed  (GPSParser *, const char *);
+
+
+/********************************************************************************
+*                                                                               *
+* FUNCTION NAME: iFeed                                                          *
+*                                                                               *
+* PURPOSE: Feeds a string to a parser one character at a time, as the UART      *
+*           does, returning the number of completed RMC + GGA pairs             *
+*                                                                               *
+* ARGUMENT LIST:                                                                *
+*                                                                               *
+* Argument  Type         IO     Description                                     *
+* --------- --------     --     ---------------------------------               *
+* p         GPSParser*   IO     Parser                                          *
+* str       const char*  I      NMEA sentences                                  *
+*                                                                               *
+* RETURN VALUE: int                                                             *
+*                                                                               *
+********************************************************************************/
+static int iFeed(GPSParser *p, const char *str)
+{
+    int n = 0;
+
+    while (*str != '\0')
+    {
+        n += GPSParserRead(p, (uint8_t)*str++);
+    }
+
+    return n;
+}
+
+/********************************************************************************
+*                                                                               *
+* FUNCTION NAME: vTest_GPS                                                      *
+*                                                                               *
+* PURPOSE: Test of GPS_Lib.c                                                    *
+*                                                                               *
+* ARGUMENT LIST:                                                                *
+*                                                                               *
+* Argument  Type         IO     Description                                     *
+* --------- --------     --     ---------------------------------               *
+* none                                                                          *
+*                                                                               *
+* RETURN VALUE: void                                                            *
+*                                                                               *
+********************************************************************************/
+void vTest_GPS(void)
+{
+    GPSParser p;
+
+    TEST_NEAR(parse_rawDegree("4807.038"), 48.1173, 1e-4);
+    TEST_NEAR(parse_rawDegree("-01131.000"), -11.516667, 1e-4);
+
+    /* an RMC alone is not a fix, the GGA completes it */
+    GPSParserInit(&p);
+    TEST_CHECK(iFeed(&p, GT_RMC) == 0);
+    TEST_CHECK(iFeed(&p, GT_GGA) == 1);
+
+    TEST_CHECK(GPSParserHour(&p) == 12);
+    TEST_CHECK(GPSParserMinute(&p) == 35);
+    TEST_CHECK(GPSParserSecond(&p) == 19);
+    TEST_CHECK(GPSParserDay(&p) == 23);
+    TEST_CHECK(GPSParserMonth(&p) == 3);
+    TEST_CHECK(GPSParserYear(&p) == 94);
+    TEST_NEAR(GPSParserLatitude(&p), 48.1173, 1e-4);
+    TEST_NEAR(GPSParserLongitude(&p), 11.516667, 1e-4);
+    TEST_NEAR(GPSParserAltitude(&p), 545.4, 1e-3);
+    TEST_CHECK(GPSParserSatellites(&p) == 8);
+    TEST_NEAR(GPSParserSpeed(&p), 22.4 * 1.852, 1e-3);
+    TEST_NEAR(GPSParserCourse(&p), 84.4, 1e-3);
+
+    /* the pair is consumed: the next one needs both sentences again */
+    TEST_CHECK(iFeed(&p, GT_GGA) == 0);
+    TEST_CHECK(iFeed(&p, GT_RMC) == 1);
+
+    /* South and West are negative */
+    GPSParserInit(&p);
+    TEST_CHECK(iFeed(&p, "$GPRMC,000001,A,3351.000,S,15112.000,W,000.0,000.0,010126,,*00\r\n"
+                         GT_GGA) == 1);
+    TEST_NEAR(GPSParserLatitude(&p), -33.85, 1e-4);
+    TEST_NEAR(GPSParserLongitude(&p), -151.2, 1e-4);
+
+    /* other sentences are ignored */
+    GPSParserInit(&p);
+    TEST_CHECK(iFeed(&p, "$GPGSA,A,3,04,05,,09,12,,,24,,,,,2.5,1.3,2.1*39\r\n" GT_RMC) == 0);
+    TEST_CHECK(iFeed(&p, "$GPVTG,054.7,T,034.4,M,005.5,N,010.2,K*48\r\n" GT_GGA) == 1);
+
+    /* the widths of a u-blox receiver: 1 Hz, two decimals of course and
+       altitude, three of speed, seven of the minutes of arc */
+    GPSParserInit(&p);
+    TEST_CHECK(iFeed(&p, "$GPRMC,083559.00,A,4717.1143720,N,00833.9158980,E,12.345,177.52,"
+                         "091202,,,A*00\r\n"
+                         "$GPGGA,083559.00,4717.1143720,N,00833.9158980,E,1,12,0.71,1234.56,"
+                         "M,48.0,M,,*00\r\n") == 1);
+    TEST_CHECK(GPSParserHour(&p) == 8 && GPSParserMinute(&p) == 35 && GPSParserSecond(&p) == 59);
+    TEST_NEAR(GPSParserLatitude(&p), 47.285240, 1e-4);
+    TEST_NEAR(GPSParserLongitude(&p), 8.565265, 1e-4);
+    TEST_NEAR(GPSParserSpeed(&p), 12.345 * 1.852, 1e-3);
+    TEST_NEAR(GPSParserCourse(&p), 177.52, 1e-3);
+    TEST_NEAR(GPSParserAltitude(&p), 1234.56, 1e-2);
+    TEST_CHECK(GPSParserSatellites(&p) == 12);
+
+    /* a term longer than its field drops the sentence: none of its fields is
+       taken, not even those before that term, and its half of the pair is
+       incomplete again */
+    GPSParserInit(&p);
+    TEST_CHECK(iFeed(&p, GT_RMC) == 0);
+    TEST_CHECK(iFeed(&p, "$GPRMC,123520,A,3351.000,S,15112.000,W,1000000000.0,084.4,230394,,*00\r\n"
+                         GT_GGA) == 0);
+    TEST_NEAR(GPSParserLatitude(&p), 48.1173, 1e-4);
+    TEST_CHECK(GPSParserSecond(&p) == 19);
+    TEST_CHECK(iFeed(&p, "$GPGGA,123519,4807.038,N,01131.000,E,1,08,0.9,123456789012.3,M,46.9,"
+                         "M,,*00\r\n" GT_RMC) == 0);
+    TEST_CHECK(iFeed(&p, GT_GGA) == 1);
+    TEST_NEAR(GPSParserSpeed(&p), 22.4 * 1.852, 1e-3);
+    TEST_NEAR(GPSParserAltitude(&p), 545.4, 1e-3);
+
+    /* a term longer than buffer, line noise, an unknown long sentence name */
+    GPSParserInit(&p);
+    TEST_CHECK(iFeed(&p, "$GPRMC,123519,A,4807.0380000000000000000000000000000000000000000000000,N,"
+                         "01131.000,E,022.4,084.4,230394,,*00\r\n" GT_GGA) == 0);
+    TEST_CHECK(iFeed(&p, "0123456789012345678901234567890123456789\r\n"
+                         "$GPRMCGPRMCGPRMC,123519,A,4807.038,N,01131.000,E,022.4,084.4,"
+                         "230394,,*00\r\n") == 0);
+    TEST_CHECK(iFeed(&p, GT_RMC) == 1);
+    TEST_NEAR(GPSParserLatitude(&p), 48.1173, 1e-4);
+    TEST_CHECK(p.char_number < sizeof(p.buffer));
+}
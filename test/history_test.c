@@ -0,0 +1,208 @@
+/***********************************************************************************
+* This file is part of The AHRS Project.                                           *
+*                                                                                  *
+* Copyright © 2020 By Nicola di Gruttola Giardino. All rights reserved.            *
+* @mail: nicoladgg@protonmail.com                                                  *
+*                                                                                  *
+* AHRS is free software: you can redistribute it and/or modify                     *
+* it under the terms of the GNU General Public License as published by             *
+* the Free Software Foundation, either version 3 of the License, or                *
+* (at your option) any later version.                                              *
+*                                                                                  *
+* AHRS is distributed in the hope that it will be useful,                          *
+* but WITHOUT ANY WARRANTY; without even the implied warranty of                   *
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the                    *
+* GNU General Public License for more details.                                     *
+*                                                                                  *
+* You should have received a copy of the GNU General Public License                *
+* along with The AHRS Project.  If not, see <https://www.gnu.org/licenses/>.       *
+*                                                                                  *
+* In case of use of this project, I ask you to mention me, to whom it may concern. *
+***********************************************************************************/
+
+/****************************************************************************************************
+* FILE NAME: history_test.c                                                                         *
+*                                                                                                   *
+* PURPOSE: Test of the replay of late measurements: a filter whose fixes all arrive late            *
+*           through KalmanHistory against one that had them on time, and the refusal of a fix       *
+*           older than the ring                                                                     *
+*                                                                                                   *
+* FILE REFERENCES:                                                                                  *
+*                                                                                                   *
+*   Name    I/O     Description                                                                     *
+*   ----    ---     -----------                                                                     *
+*   none                                                                                            *
+*                                                                                                   *
+* EXTERNAL VARIABLES:                                                                               *
+*                                                                                                   *
+* Source: <unit_test.h>                                                                             *
+*                                                                                                   *
+* Name          Type          IO Description                                                        *
+* ------------- -------       -- -----------------------------                                      *
+*   none                                                                                            *
+*                                                                                                   *
+* STATIC VARIABLES:                                                                                 *
+*                                                                                                   *
+*   Name     Type       I/O      Description                                                        *
+*   ----     ----       ---      -----------                                                        *
+*   none                                                                                            *
+*                                                                                                   *
+* EXTERNAL REFERENCES:                                                                              *
+*                                                                                                   *
+*  Name                       Description                                                           *
+*  -------------              -----------                                                           *
+*  KalmanHistory.c            The functions under test                                              *
+*  Kalman.c                   Reference filter                                                      *
+*  rng.c                      Noise of the track                                                    *
+*                                                                                                   *
+* ABNORMAL TERMINATION CONDITIONS, ERROR AND WARNING MESSAGES:                                      *
+*    none                                                                                           *
+*                                                                                                   *
+* ASSUMPTIONS, CONSTRAINTS, RESTRICTIONS: none                                                      *
+*                                                                                                   *
+* NOTES: the filters are built by hand, without vModel, so that a replayed prediction is the        *
+*         recorded one                                                                              *
+*                                                                                                   *
+* REQUIREMENTS/FUNCTIONAL SPECIFICATIONS REFERENCES:                                                *
+*                                                                                                   *
+* DEVELOPMENT HISTORY:                                                                              *
+*                                                                                                   *
+*   Date          Author            Change Id     Release     Description Of Change                 *
+*   ----          ------            ---------     ------      ----------------------                *
+*   19-10-2026    AHRS Project       1               1         Initial release                      *
+*                                                                                                   *
+****************************************************************************************************/
+
+/* Include Global Parameters */
+
+#include <math.h>
+#include "unit_test.h"
+#include "KalmanHistory.h"
+#include "rng.h"
+
+/* Definition of Macros */
+
+#define HT_DT       0.01f
+#define HT_ACC      0.5f
+#define HT_STEPS    1000
+#define HT_EVERY    50          /* steps per fix */
+#define HT_DELAY    20          /* latency of each fix, steps */
+#define HT_CAP      64
+
+/* Declare Prototypes */
+
+static void   vSetup   (kalman *);
+
+
+/********************************************************************************
+*                                                                               *
+* FUNCTION NAME: vSetup                                                         *
+*                                                                               *
+* PURPOSE: Creates a filter of the 2 state constant acceleration model          *
+*                                                                               *
+* ARGUMENT LIST:                                                                *
+*                                                                               *
+* Argument  Type         IO     Description                                     *
+* --------- --------     --     ---------------------------------               *
+* k         kalman*      O      Filter                                          *
+*                                                                               *
+* RETURN VALUE: void                                                            *
+*                                                                               *
+********************************************************************************/
+static void vSetup(kalman *k)
+{
+    iKalman_Init(k, 2, 2);
+    k->vModel = NULL;
+    k->dt     = HT_DT;
+    k->A->matrix[0][0] = 1;
+    k->A->matrix[0][1] = HT_DT;
+    k->A->matrix[1][1] = 1;
+    k->B->matrix[0][0] = HT_DT * HT_DT / 2;
+    k->B->matrix[1][0] = HT_DT;
+    k->H->matrix[0][0] = 1;
+    k->H->matrix[1][1] = 1;
+    k->Q->matrix[0][0] = 1e-4f;
+    k->Q->matrix[1][1] = 1e-3f;
+    k->R->matrix[0][0] = 0.2f;
+    k->R->matrix[1][1] = 0.2f;
+    k->P->matrix[0][0] = 1;
+    k->P->matrix[1][1] = 1;
+}
+
+/********************************************************************************
+*                                                                               *
+* FUNCTION NAME: vTest_History                                                  *
+*                                                                               *
+* PURPOSE: Test of KalmanHistory.c                                              *
+*                                                                               *
+* ARGUMENT LIST:                                                                *
+*                                                                               *
+* Argument  Type         IO     Description                                     *
+* --------- --------     --     ---------------------------------               *
+* none                                                                          *
+*                                                                               *
+* RETURN VALUE: void                                                            *
+*                                                                               *
+********************************************************************************/
+void vTest_History(void)
+{
+    KalmanHistory h;
+    kalman        k;
+    kalman        r;
+    Matrix       *z  = pxCreate(2, 1);
+    Matrix       *zl = pxCreate(2, 1);
+    float         t;
+    float         tl;
+    float         x0;
+    Rng           rng;
+    unsigned long nu;
+    int           fails;
+    int           i;
+
+    vRngSeed(&rng, 38, 0);
+    vSetup(&k);
+    vSetup(&r);
+    TEST_CHECK(iKalmanHistory_Init(&h, &k, HT_CAP) == 0);
+
+    /* every fix reaches k HT_DELAY steps late, r has it on time */
+    tl    = -1;
+    nu    = 0;
+    fails = 0;
+    for (i = 0; i < HT_STEPS; i++)
+    {
+        t = (float)i * HT_DT;
+        vKalmanHistory_Predict(&h, t, HT_DT, HT_ACC);
+        vKalman_Predict(&r, HT_DT, HT_ACC);
+        if (i % HT_EVERY == 0)
+        {
+            z->matrix[0][0] = 0.5f * HT_ACC * t * t + 0.45f * fRngNormal(&rng);
+            z->matrix[1][0] = HT_ACC * t            + 0.45f * fRngNormal(&rng);
+            iKalman_Update(&r, z, NULL);
+            iCopy(zl, z);
+            tl = t;
+        }
+        if (i % HT_EVERY == HT_DELAY && tl >= 0)
+        {
+            fails += (iKalmanHistory_Update(&h, tl, zl, NULL) != 0);
+            nu++;
+        }
+    }
+    TEST_CHECK(fails == 0);
+    TEST_CHECK(h.replays == nu && h.replay_max == HT_DELAY);
+    TEST_NEAR(k.x->matrix[0][0], r.x->matrix[0][0], 1e-4 * (1 + fabsf(r.x->matrix[0][0])));
+    TEST_NEAR(k.x->matrix[1][0], r.x->matrix[1][0], 1e-4 * (1 + fabsf(r.x->matrix[1][0])));
+    TEST_NEAR(k.P->matrix[0][0], r.P->matrix[0][0], 1e-4 * r.P->matrix[0][0]);
+    TEST_NEAR(k.P->matrix[1][1], r.P->matrix[1][1], 1e-4 * r.P->matrix[1][1]);
+
+    /* a fix older than the ring is refused and leaves the filter alone */
+    x0 = k.x->matrix[0][0];
+    t  = (float)(HT_STEPS - 1 - HT_CAP - 10) * HT_DT;
+    TEST_CHECK(iKalmanHistory_Update(&h, t, zl, NULL) == -1);
+    TEST_CHECK(k.x->matrix[0][0] == x0 && h.replays == nu);
+
+    vDestroy(zl);
+    vDestroy(z);
+    vKalmanHistory_Destroy(&h);
+    vKalman_Destroy(&r);
+    vKalman_Destroy(&k);
+}
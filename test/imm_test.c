@@ -0,0 +1,207 @@
+/***********************************************************************************
+* This file is part of The AHRS Project.                                           *
+*                                                                                  *
+* Copyright © 2020 By Nicola di Gruttola Giardino. All rights reserved.            *
+* @mail: nicoladgg@protonmail.com                                                  *
+*                                                                                  *
+* AHRS is free software: you can redistribute it and/or modify                     *
+* it under the terms of the GNU General Public License as published by             *
+* the Free Software Foundation, either version 3 of the License, or                *
+* (at your option) any later version.                                              *
+*                                                                                  *
+* AHRS is distributed in the hope that it will be useful,                          *
+* but WITHOUT ANY WARRANTY; without even the implied warranty of                   *
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the                    *
+* GNU General Public License for more details.                                     *
+*                                                                                  *
+* You should have received a copy of the GNU General Public License                *
+* along with The AHRS Project.  If not, see <https://www.gnu.org/licenses/>.       *
+*                                                                                  *
+* In case of use of this project, I ask you to mention me, to whom it may concern. *
+***********************************************************************************/
+
+/****************************************************************************************************
+* FILE NAME: imm_test.c                                                                             *
+*                                                                                                   *
+* PURPOSE: Test of the IMM bank on a track that stops, cruises and manoeuvres in turn: the          *
+*           probabilities stay a distribution, the quiet model is ahead of the agile one when       *
+*           stopped and the agile one leads when manoeuvring, and the combined position is          *
+*           within 10% of the best of the models run alone in a KalmanBatch                         *
+*                                                                                                   *
+* FILE REFERENCES:                                                                                  *
+*                                                                                                   *
+*   Name    I/O     Description                                                                     *
+*   ----    ---     -----------                                                                     *
+*   none                                                                                            *
+*                                                                                                   *
+* EXTERNAL VARIABLES:                                                                               *
+*                                                                                                   *
+* Source: <unit_test.h>                                                                             *
+*                                                                                                   *
+* Name          Type          IO Description                                                        *
+* ------------- -------       -- -----------------------------                                      *
+*   none                                                                                            *
+*                                                                                                   *
+* STATIC VARIABLES:                                                                                 *
+*                                                                                                   *
+*   Name     Type       I/O      Description                                                        *
+*   ----     ----       ---      -----------                                                        *
+*   none                                                                                            *
+*                                                                                                   *
+* EXTERNAL REFERENCES:                                                                              *
+*                                                                                                   *
+*  Name                       Description                                                           *
+*  -------------              -----------                                                           *
+*  KalmanIMM.c                The functions under test                                              *
+*  KalmanBatch.c              The models run alone                                                  *
+*  rng.c                      Noise of the track                                                    *
+*                                                                                                   *
+* ABNORMAL TERMINATION CONDITIONS, ERROR AND WARNING MESSAGES:                                      *
+*    none                                                                                           *
+*                                                                                                   *
+* ASSUMPTIONS, CONSTRAINTS, RESTRICTIONS: none                                                      *
+*                                                                                                   *
+* NOTES: the cruising regime holds a constant speed, which all the models fit, so no model          *
+*         is required to lead there                                                                 *
+*                                                                                                   *
+* REQUIREMENTS/FUNCTIONAL SPECIFICATIONS REFERENCES:                                                *
+*                                                                                                   *
+* DEVELOPMENT HISTORY:                                                                              *
+*                                                                                                   *
+*   Date          Author            Change Id     Release     Description Of Change                 *
+*   ----          ------            ---------     ------      ----------------------                *
+*   19-10-2026    AHRS Project       1               1         Initial release                      *
+*                                                                                                   *
+****************************************************************************************************/
+
+/* Include Global Parameters */
+
+#include <math.h>
+#include "unit_test.h"
+#include "KalmanIMM.h"
+#include "KalmanBatch.h"
+#include "rng.h"
+
+/* Definition of Macros */
+
+#define MT_DT       0.01f
+#define MT_SEGMENT  1000        /* steps of each regime of the track */
+#define MT_STEPS    (9 * MT_SEGMENT)
+
+
+/********************************************************************************
+*                                                                               *
+* FUNCTION NAME: vTest_IMM                                                      *
+*                                                                               *
+* PURPOSE: Test of KalmanIMM.c                                                  *
+*                                                                               *
+* ARGUMENT LIST:                                                                *
+*                                                                               *
+* Argument  Type         IO     Description                                     *
+* --------- --------     --     ---------------------------------               *
+* none                                                                          *
+*                                                                               *
+* RETURN VALUE: void                                                            *
+*                                                                               *
+********************************************************************************/
+void vTest_IMM(void)
+{
+    KalmanIMM   m;
+    KalmanBatch b;
+    float       zp[KALMAN_IMM_MODELS];
+    float       zv[KALMAN_IMM_MODELS];
+    float       u[KALMAN_IMM_MODELS];
+    double      pos, vel, acc;
+    double      ei, es, sum;
+    double      eb[KALMAN_IMM_MODELS];
+    double      mu[3][KALMAN_IMM_MODELS] = {{0}};
+    Rng         rng;
+    int         bad;
+    int         i, j;
+
+    vRngSeed(&rng, 40, 0);
+    TEST_CHECK(iKalmanIMM_Init(&m, MT_DT, 1.5f) == -1);
+    TEST_CHECK(iKalmanIMM_Init(&m, MT_DT, 0.99f) == 0);
+    TEST_CHECK(iKalmanBatch_Init(&b, KALMAN_IMM_MODELS, MT_DT) == 0);
+
+    /* process noise of the velocity from 1e-7 (stopped) to 1e-3 (manoeuvring),
+       the same models run alone in a batch */
+    for (j = 0; j < KALMAN_IMM_MODELS; j++)
+    {
+        m.q0[j] = b.q0[j] = 1e-7f;
+        m.q1[j] = b.q1[j] = (KALMAN_IMM_MODELS == 1) ? 1e-5f :
+                  1e-7f * powf(1e4f, (float)j / (float)(KALMAN_IMM_MODELS - 1));
+        b.r0[j] = m.r0;
+        b.r1[j] = m.r1;
+        u[j]    = 0;
+        eb[j]   = 0;
+    }
+
+    /* a track that stops, cruises and manoeuvres in turn, with no input */
+    pos         = 0;
+    vel         = 0;
+    ei          = 0;
+    bad         = 0;
+    for (i = 0; i < MT_STEPS; i++)
+    {
+        switch ((i / MT_SEGMENT) % 3)
+        {
+            case 0:  acc = -10.0 * vel;                         break;
+            case 1:  acc = (vel < 2.0) ? 1.0 : 0;               break;
+            default: acc = 3.0 * sin(2.0 * (double)i * MT_DT);  break;
+        }
+        vel += acc * MT_DT;
+        pos += vel * MT_DT;
+        zp[0] = (float)pos + 0.45f * fRngNormal(&rng);
+        zv[0] = (float)vel + 0.45f * fRngNormal(&rng);
+        for (j = 1; j < KALMAN_IMM_MODELS; j++)
+        {
+            zp[j] = zp[0];
+            zv[j] = zv[0];
+        }
+
+        vKalmanIMM_Predict(&m, 0);
+        vKalmanIMM_Update(&m, zp[0], zv[0]);
+        vKalmanBatch_Predict(&b, u);
+        vKalmanBatch_Update(&b, zp, zv, NULL);
+        ei += (m.x[0] - pos) * (m.x[0] - pos);
+        for (j = 0; j < KALMAN_IMM_MODELS; j++)
+        {
+            eb[j] += (b.x0[j] - pos) * (b.x0[j] - pos);
+        }
+
+        /* the probabilities stay a distribution; their mean over the second
+           half of each regime is taken */
+        sum = 0;
+        for (j = 0; j < KALMAN_IMM_MODELS; j++)
+        {
+            sum += m.mu[j];
+            bad += !(m.mu[j] >= 0);
+        }
+        bad += !(fabs(sum - 1) < 1e-5);
+        if (i % MT_SEGMENT >= MT_SEGMENT / 2)
+        {
+            for (j = 0; j < KALMAN_IMM_MODELS; j++)
+            {
+                mu[(i / MT_SEGMENT) % 3][j] += m.mu[j];
+            }
+        }
+    }
+
+    es = INFINITY;
+    for (j = 0; j < KALMAN_IMM_MODELS; j++)
+    {
+        es = (eb[j] < es) ? eb[j] : es;
+    }
+    TEST_CHECK(isfinite(ei) && ei <= 1.1 * es);
+    TEST_CHECK(bad == 0);
+    /* stopped, the quiet model is ahead of the agile one, which leads while
+       manoeuvring */
+    TEST_CHECK(mu[0][0] > mu[0][KALMAN_IMM_MODELS - 1]);
+    for (j = 0; j < KALMAN_IMM_MODELS - 1; j++)
+    {
+        TEST_CHECK(mu[2][KALMAN_IMM_MODELS - 1] > mu[2][j]);
+    }
+
+    vKalmanBatch_Destroy(&b);
+}
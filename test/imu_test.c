@@ -0,0 +1,214 @@
+/***********************************************************************************
+* This file is part of The AHRS Project.                                           *
+*                                                                                  *
+* Copyright © 2020 By Nicola di Gruttola Giardino. All rights reserved.            *
+* @mail: nicoladgg@protonmail.com                                                  *
+*                                                                                  *
+* AHRS is free software: you can redistribute it and/or modify                     *
+* it under the terms of the GNU General Public License as published by             *
+* the Free Software Foundation, either version 3 of the License, or                *
+* (at your option) any later version.                                              *
+*                                                                                  *
+* AHRS is distributed in the hope that it will be useful,                          *
+* but WITHOUT ANY WARRANTY; without even the implied warranty of                   *
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the                    *
+* GNU General Public License for more details.                                     *
+*                                                                                  *
+* You should have received a copy of the GNU General Public License                *
+* along with The AHRS Project.  If not, see <https://www.gnu.org/licenses/>.       *
+*                                                                                  *
+* In case of use of this project, I ask you to mention me, to whom it may concern. *
+***********************************************************************************/
+
+/****************************************************************************************************
+* FILE NAME: imu_test.c                                                                             *
+*                                                                                                   *
+* PURPOSE: Test of the navigation state of IMU.c: the filter sets, the velocity of an AHRS at rest  *
+*           and after a GPS fix to the North, the conversion of a fix to metres                     *
+*                                                                                                   *
+* FILE REFERENCES:                                                                                  *
+*                                                                                                   *
+*   Name    I/O     Description                                                                     *
+*   ----    ---     -----------                                                                     *
+*   none                                                                                            *
+*                                                                                                   *
+* EXTERNAL VARIABLES:                                                                               *
+*                                                                                                   *
+* Source: <unit_test.h>                                                                             *
+*                                                                                                   *
+* Name          Type          IO Description                                                        *
+* ------------- -------       -- -----------------------------                                      *
+*   none                                                                                            *
+*                                                                                                   *
+* STATIC VARIABLES:                                                                                 *
+*                                                                                                   *
+*   Name     Type       I/O      Description                                                        *
+*   ----     ----       ---      -----------                                                        *
+*   none                                                                                            *
+*                                                                                                   *
+* EXTERNAL REFERENCES:                                                                              *
+*                                                                                                   *
+*  Name                       Description                                                           *
+*  -------------              -----------                                                           *
+*  IMU.c                      The functions under test, on an AHRSState of the test                 *
+*                                                                                                   *
+* ABNORMAL TERMINATION CONDITIONS, ERROR AND WARNING MESSAGES:                                      *
+*    none                                                                                           *
+*                                                                                                   *
+* ASSUMPTIONS, CONSTRAINTS, RESTRICTIONS: the filters predict at the IMU rate, 1 kHz                *
+*                                                                                                   *
+* NOTES:                                                                                            *
+*                                                                                                   *
+* REQUIREMENTS/FUNCTIONAL SPECIFICATIONS REFERENCES:                                                *
+*                                                                                                   *
+* DEVELOPMENT HISTORY:                                                                              *
+*                                                                                                   *
+*   Date          Author            Change Id     Release     Description Of Change                 *
+*   ----          ------            ---------     ------      ----------------------                *
+*   19-10-2026    AHRS Project       1               1         Initial release                      *
+*                                                                                                   *
+****************************************************************************************************/
+
+/* Include Global Parameters */
+
+#include <math.h>
+#include "unit_test.h"
+#include "IMU.h"
+
+/* Definition of Macros */
+
+#define IT_RATE     1000        /* IMU samples per second */
+
+
+/********************************************************************************
+*                                                                               *
+* FUNCTION NAME: vTest_IMU                                                      *
+*                                                                               *
+* PURPOSE: Test of IMU.c                                                        *
+*                                                                               *
+* ARGUMENT LIST:                                                                *
+*                                                                               *
+* Argument  Type         IO     Description                                     *
+* --------- --------     --     ---------------------------------               *
+* none                                                                          *
+*                                                                               *
+* RETURN VALUE: void                                                            *
+*                                                                               *
+********************************************************************************/
+void vTest_IMU(void)
+{
+    AHRSState    s;
+    const float  q[4] = {1, 0, 0, 0};
+    const float  qz[4] = {0.7059f, 0, 0, 0.7059f};
+    Matrix      *a = pxCreate(3, 1);
+    Matrix      *m = pxCreate(3, 3);
+    float        fix[3] = {45, 9, 100};
+    float        lla[3];
+    float        x[3];
+    float        v[3];
+    float        velocity[3];
+    float        vn;
+    int          i;
+
+    TEST_NEAR(fDegtorad(180), M_PI, 1e-6);
+    TEST_NEAR(fDegtorad(-90), -M_PI / 2, 1e-6);
+
+    /* every set starts, none past the last; the square-root and steady-state
+       forms need process noise, they refuse KALMAN_SET_CV */
+    for (i = 0; i < KALMAN_SETS; i++)
+    {
+#if defined(USE_KALMAN_SQRT) || defined(USE_KALMAN_STEADY_STATE)
+        if (i == KALMAN_SET_CV)
+        {
+            TEST_CHECK(iAHRS_Init(&s, i) == -1);
+            continue;
+        }
+#endif
+        TEST_CHECK(iAHRS_Init(&s, i) == 0);
+        TEST_NEAR(s.k[0].dt, 1.0f / IT_RATE, 1e-9);
+        TEST_CHECK(s.k[0].gate == KALMAN_GATE_DEFAULT);
+        vAHRS_Destroy(&s);
+    }
+    TEST_CHECK(iAHRS_Init(&s, KALMAN_SETS) == -1);
+
+    /* what a failed iAHRS_Init leaves: nothing runs on it */
+    a->matrix[2][0] = AHRS_GRAVITY;
+    velocity[0] = velocity[1] = velocity[2] = 1;
+    vAHRS_Velocity(&s, q, velocity, a, fix);
+    TEST_CHECK(velocity[0] == 0 && velocity[1] == 0 && velocity[2] == 0);
+    TEST_CHECK(iAHRS_Select(&s, KALMAN_SET_DEFAULT) == -1);
+
+    /* level and still: the accelerometer reads +g up, nothing moves */
+    TEST_CHECK(iAHRS_Init(&s, KALMAN_SET_DEFAULT) == 0);
+    TEST_CHECK(iAHRS_Select(&s, KALMAN_SETS) == -1);
+    a->matrix[2][0] = AHRS_GRAVITY;
+    for (i = 0; i < IT_RATE; i++)
+    {
+        vAHRS_Velocity(&s, q, velocity, a, NULL);
+    }
+    TEST_NEAR(velocity[0], 0, 1e-4);
+    TEST_NEAR(velocity[1], 0, 1e-4);
+    TEST_NEAR(velocity[2], 0, 1e-4);
+    TEST_NEAR(s.gps_dt, 1, 1e-3);
+
+    /* a yaw of 90 deg, |q| a little under 1 as invSqrt leaves it: inv is a
+       rotation, and gravity stays on the vertical axis with its length */
+    vAHRS_Velocity(&s, qz, velocity, a, NULL);
+    TEST_CHECK(iMultiply(m, s.inv, s.rotation) == 0);
+    for (i = 0; i < 9; i++)
+    {
+        TEST_NEAR(m->matrix[i / 3][i % 3], i % 4 == 0 ? 2 * 0.7059f * 0.7059f : 0, 1e-6);
+    }
+    TEST_NEAR(s.inv->matrix[0][1] * s.inv->matrix[0][1] +
+              s.inv->matrix[1][1] * s.inv->matrix[1][1], 1, 1e-6);
+    TEST_NEAR(s.acc->matrix[0][0], 0, 1e-5);
+    TEST_NEAR(s.acc->matrix[2][0], 0, 1e-5);
+    TEST_NEAR(velocity[2], 0, 1e-4);
+
+    /* a fix at 0, 0 is a receiver without a position, it is dropped */
+    lla[0] = lla[1] = lla[2] = 0;
+    vAHRS_Velocity(&s, q, velocity, a, lla);
+    TEST_CHECK(s.last_lla[0] == 0 && s.gps_dt > 1);
+
+    /* the first fix only places the origin, the second 0.0001 deg (11 m) North
+       of it 1 s later gives the velocity, and its NIS */
+    vAHRS_Velocity(&s, q, velocity, a, fix);
+    TEST_CHECK(s.last_lla[0] != 0 && s.gps_dt == 0);
+    TEST_NEAR(velocity[0], 0, 1e-3);
+    for (i = 0; i < IT_RATE - 1; i++)
+    {
+        vAHRS_Velocity(&s, q, velocity, a, NULL);
+    }
+    fix[0] += 0.0001f;
+    vAHRS_Velocity(&s, q, velocity, a, fix);
+    vn = velocity[0];
+    TEST_CHECK(vn > 5);
+    TEST_CHECK(vn < 16);
+#if defined(USE_KALMAN_STEADY_STATE)
+    /* the steady-state form starts its track at that fix, there is no NIS */
+    TEST_CHECK(s.k[0].steady && s.k[0].rejected == 0);
+#else
+    TEST_CHECK(s.k[0].nis > 0 && s.k[0].rejected == 0);
+#endif
+
+    /* 111 m in the next second is no vehicle: the gate of the build rejects it */
+    for (i = 0; i < IT_RATE - 1; i++)
+    {
+        vAHRS_Velocity(&s, q, velocity, a, NULL);
+    }
+    fix[0] += 0.001f;
+    vAHRS_Velocity(&s, q, velocity, a, fix);
+    TEST_CHECK(s.k[0].rejected == 1);
+    TEST_NEAR(velocity[0], vn, 1e-3);
+
+    /* the metres of a degree of latitude: a quarter of the pole to pole distance per 45 deg */
+    lla[0] = 45;
+    lla[1] = 0;
+    lla[2] = 0;
+    vAHRS_ComputeGPS(&s, lla, x, v);
+    TEST_NEAR(lla[0], 20004500.0f * 135 / 180, 10);
+
+    vAHRS_Destroy(&s);
+    vDestroy(a);
+    vDestroy(m);
+}
@@ -0,0 +1,231 @@
+/***********************************************************************************
+* This file is part of The AHRS Project.                                           *
+*                                                                                  *
+* Copyright © 2020 By Nicola di Gruttola Giardino. All rights reserved.            *
+* @mail: nicoladgg@protonmail.com                                                  *
+*                                                                                  *
+* AHRS is free software: you can redistribute it and/or modify                     *
+* it under the terms of the GNU General Public License as published by             *
+* the Free Software Foundation, either version 3 of the License, or                *
+* (at your option) any later version.                                              *
+*                                                                                  *
+* AHRS is distributed in the hope that it will be useful,                          *
+* but WITHOUT ANY WARRANTY; without even the implied warranty of                   *
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the                    *
+* GNU General Public License for more details.                                     *
+*                                                                                  *
+* You should have received a copy of the GNU General Public License                *
+* along with The AHRS Project.  If not, see <https://www.gnu.org/licenses/>.       *
+*                                                                                  *
+* In case of use of this project, I ask you to mention me, to whom it may concern. *
+***********************************************************************************/
+
+/****************************************************************************************************
+* FILE NAME: info_test.c                                                                            *
+*                                                                                                   *
+* PURPOSE: Test of the information filter fusing three asynchronous sensors, two positions          *
+*           and a velocity, by scalar and by whole sensor updates, against the sequential           *
+*           update of kalman; a measurement covariance that is not diagonal is refused              *
+*                                                                                                   *
+* FILE REFERENCES:                                                                                  *
+*                                                                                                   *
+*   Name    I/O     Description                                                                     *
+*   ----    ---     -----------                                                                     *
+*   none                                                                                            *
+*                                                                                                   *
+* EXTERNAL VARIABLES:                                                                               *
+*                                                                                                   *
+* Source: <unit_test.h>                                                                             *
+*                                                                                                   *
+* Name          Type          IO Description                                                        *
+* ------------- -------       -- -----------------------------                                      *
+*   none                                                                                            *
+*                                                                                                   *
+* STATIC VARIABLES:                                                                                 *
+*                                                                                                   *
+*   Name     Type       I/O      Description                                                        *
+*   ----     ----       ---      -----------                                                        *
+*   none                                                                                            *
+*                                                                                                   *
+* EXTERNAL REFERENCES:                                                                              *
+*                                                                                                   *
+*  Name                       Description                                                           *
+*  -------------              -----------                                                           *
+*  KalmanInfo.c               The functions under test                                              *
+*  Kalman.c                   Reference filter                                                      *
+*  rng.c                      Noise of the sensors                                                  *
+*                                                                                                   *
+* ABNORMAL TERMINATION CONDITIONS, ERROR AND WARNING MESSAGES:                                      *
+*    none                                                                                           *
+*                                                                                                   *
+* ASSUMPTIONS, CONSTRAINTS, RESTRICTIONS: none                                                      *
+*                                                                                                   *
+* NOTES: the scalar updates come in a different order from the rows of kalman, which the            *
+*         information form must not see                                                             *
+*         loops runs too                                                                            *
+*                                                                                                   *
+* REQUIREMENTS/FUNCTIONAL SPECIFICATIONS REFERENCES:                                                *
+*                                                                                                   *
+* DEVELOPMENT HISTORY:                                                                              *
+*                                                                                                   *
+*   Date          Author            Change Id     Release     Description Of Change                 *
+*   ----          ------            ---------     ------      ----------------------                *
+*   19-10-2026    AHRS Project       1               1         Initial release                      *
+*                                                                                                   *
+****************************************************************************************************/
+
+/* Include Global Parameters */
+
+#include <math.h>
+#include "unit_test.h"
+#include "KalmanInfo.h"
+#include "Kalman.h"
+#include "rng.h"
+
+/* Definition of Macros */
+
+#define FT_DT       0.01f
+#define FT_ACC      0.5f
+#define FT_STEPS    500
+
+/* Declare Prototypes */
+
+static void   vSetup   (kalman *);
+
+
+/********************************************************************************
+*                                                                               *
+* FUNCTION NAME: vSetup                                                         *
+*                                                                               *
+* PURPOSE: Creates the reference filter of the three sensors: two positions     *
+*           and a velocity of the 2 state constant acceleration model           *
+*                                                                               *
+* ARGUMENT LIST:                                                                *
+*                                                                               *
+* Argument  Type         IO     Description                                     *
+* --------- --------     --     ---------------------------------               *
+* k         kalman*      O      Filter                                          *
+*                                                                               *
+* RETURN VALUE: void                                                            *
+*                                                                               *
+********************************************************************************/
+static void vSetup(kalman *k)
+{
+    iKalman_Init(k, 2, 3);
+    k->vModel = NULL;
+    k->dt     = FT_DT;
+    k->A->matrix[0][0] = 1;
+    k->A->matrix[0][1] = FT_DT;
+    k->A->matrix[1][1] = 1;
+    k->B->matrix[0][0] = FT_DT * FT_DT / 2;
+    k->B->matrix[1][0] = FT_DT;
+    k->H->matrix[0][0] = 1;
+    k->H->matrix[1][0] = 1;
+    k->H->matrix[2][1] = 1;
+    k->Q->matrix[0][0] = 1e-4f;
+    k->Q->matrix[1][1] = 1e-3f;
+    k->R->matrix[0][0] = 0.2f;
+    k->R->matrix[1][1] = 0.2f;
+    k->R->matrix[2][2] = 0.2f;
+    k->P->matrix[0][0] = 1;
+    k->P->matrix[1][1] = 1;
+}
+
+/********************************************************************************
+*                                                                               *
+* FUNCTION NAME: vTest_Info                                                     *
+*                                                                               *
+* PURPOSE: Test of KalmanInfo.c                                                 *
+*                                                                               *
+* ARGUMENT LIST:                                                                *
+*                                                                               *
+* Argument  Type         IO     Description                                     *
+* --------- --------     --     ---------------------------------               *
+* none                                                                          *
+*                                                                               *
+* RETURN VALUE: void                                                            *
+*                                                                               *
+********************************************************************************/
+void vTest_Info(void)
+{
+    static const float hp[2] = {1, 0};
+    static const float hv[2] = {0, 1};
+    KalmanInfo    f;
+    kalman        k;
+    Matrix       *z = pxCreate(3, 1);
+    Matrix       *R = pxCreate(3, 3);
+    unsigned char valid[3];
+    float         t;
+    Rng           rng;
+    int           fails;
+    int           i, j;
+
+    vRngSeed(&rng, 43, 0);
+    vSetup(&k);
+    TEST_CHECK(iKalmanInfo_Init(&f, 2) == 0);
+    iCopy(f.A, k.A);
+    iCopy(f.B, k.B);
+    iCopy(f.Q, k.Q);
+    TEST_CHECK(iKalmanInfo_SetState(&f, k.x, k.P) == 0);
+
+    /* a position every step, a second one every 2 steps and a velocity every
+       3 steps: scalar updates in any order, the whole sensor set through
+       iKalmanInfo_Update when all three are there, against the sequential
+       update of kalman */
+    fails = 0;
+    for (i = 0; i < FT_STEPS; i++)
+    {
+        t = (float)i * FT_DT;
+        z->matrix[0][0] = 0.5f * FT_ACC * t * t + 0.45f * fRngNormal(&rng);
+        z->matrix[1][0] = 0.5f * FT_ACC * t * t + 0.45f * fRngNormal(&rng);
+        z->matrix[2][0] = FT_ACC * t            + 0.45f * fRngNormal(&rng);
+        valid[0] = 1;
+        valid[1] = (i % 2) == 0;
+        valid[2] = (i % 3) == 0;
+
+        if (i != 0)
+        {
+            vKalman_Predict(&k, FT_DT, FT_ACC);
+            fails += (iKalmanInfo_Predict(&f, FT_ACC) != 0);
+        }
+        iKalman_UpdateSeq(&k, z, valid);
+
+        if (valid[1] && valid[2])
+        {
+            fails += (iKalmanInfo_Update(&f, z, k.H, k.R) != 0);
+            continue;
+        }
+        if (valid[2])
+        {
+            vKalmanInfo_UpdateScalar(&f, hv, z->matrix[2][0], 0.2f);
+        }
+        if (valid[1])
+        {
+            vKalmanInfo_UpdateScalar(&f, hp, z->matrix[1][0], 0.2f);
+        }
+        vKalmanInfo_UpdateScalar(&f, hp, z->matrix[0][0], 0.2f);
+    }
+    TEST_CHECK(fails == 0);
+    TEST_CHECK(iKalmanInfo_State(&f, 1) == 0);
+    TEST_NEAR(f.x->matrix[0][0], k.x->matrix[0][0], 1e-4 * (1 + fabsf(k.x->matrix[0][0])));
+    TEST_NEAR(f.x->matrix[1][0], k.x->matrix[1][0], 1e-4 * (1 + fabsf(k.x->matrix[1][0])));
+    for (i = 0; i < 2; i++)
+    {
+        for (j = 0; j < 2; j++)
+        {
+            TEST_NEAR(f.P->matrix[i][j], k.P->matrix[i][j], 1e-4 * k.P->matrix[i][i]);
+        }
+    }
+
+    /* R must be diagonal and positive */
+    R->matrix[0][0] = 0.2f;
+    R->matrix[1][1] = 0.2f;
+    R->matrix[2][2] = 0.2f;
+    R->matrix[0][1] = 0.1f;
+    TEST_CHECK(iKalmanInfo_Update(&f, z, k.H, R) == -1);
+
+    vDestroy(R);
+    vDestroy(z);
+    vKalmanInfo_Destroy(&f);
+    vKalman_Destroy(&k);
+}
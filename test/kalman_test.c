@@ -0,0 +1,315 @@
+/***********************************************************************************
+* This file is part of The AHRS Project.                                           *
+*                                                                                  *
+* Copyright © 2020 By Nicola di Gruttola Giardino. All rights reserved.            *
+* @mail: nicoladgg@protonmail.com                                                  *
+*                                                                                  *
+* AHRS is free software: you can redistribute it and/or modify                     *
+* it under the terms of the GNU General Public License as published by             *
+* the Free Software Foundation, either version 3 of the License, or                *
+* (at your option) any later version.                                              *
+*                                                                                  *
+* AHRS is distributed in the hope that it will be useful,                          *
+* but WITHOUT ANY WARRANTY; without even the implied warranty of                   *
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the                    *
+* GNU General Public License for more details.                                     *
+*                                                                                  *
+* You should have received a copy of the GNU General Public License                *
+* along with The AHRS Project.  If not, see <https://www.gnu.org/licenses/>.       *
+*                                                                                  *
+* In case of use of this project, I ask you to mention me, to whom it may concern. *
+***********************************************************************************/
+
+/****************************************************************************************************
+* FILE NAME: kalman_test.c                                                                          *
+*                                                                                                   *
+* PURPOSE: Test of the linear Kalman filter on a 2 state constant velocity model: convergence to    *
+*           a constant measurement, the sequential, square-root and steady-state forms against      *
+*           the plain one, the innovation gate and the covariance inflation                         *
+*                                                                                                   *
+* FILE REFERENCES:                                                                                  *
+*                                                                                                   *
+*   Name    I/O     Description                                                                     *
+*   ----    ---     -----------                                                                     *
+*   none                                                                                            *
+*                                                                                                   *
+* EXTERNAL VARIABLES:                                                                               *
+*                                                                                                   *
+* Source: <unit_test.h>                                                                             *
+*                                                                                                   *
+* Name          Type          IO Description                                                        *
+* ------------- -------       -- -----------------------------                                      *
+*   none                                                                                            *
+*                                                                                                   *
+* STATIC VARIABLES:                                                                                 *
+*                                                                                                   *
+*   Name     Type       I/O      Description                                                        *
+*   ----     ----       ---      -----------                                                        *
+*   none                                                                                            *
+*                                                                                                   *
+* EXTERNAL REFERENCES:                                                                              *
+*                                                                                                   *
+*  Name                       Description                                                           *
+*  -------------              -----------                                                           *
+*  Kalman.c                   The functions under test                                              *
+*                                                                                                   *
+* ABNORMAL TERMINATION CONDITIONS, ERROR AND WARNING MESSAGES:                                      *
+*    none                                                                                           *
+*                                                                                                   *
+* ASSUMPTIONS, CONSTRAINTS, RESTRICTIONS: none                                                      *
+*                                                                                                   *
+* NOTES: the filters are built by hand, without vModel, so dt never changes                         *
+*                                                                                                   *
+* REQUIREMENTS/FUNCTIONAL SPECIFICATIONS REFERENCES:                                                *
+*                                                                                                   *
+* DEVELOPMENT HISTORY:                                                                              *
+*                                                                                                   *
+*   Date          Author            Change Id     Release     Description Of Change                 *
+*   ----          ------            ---------     ------      ----------------------                *
+*   19-10-2026    AHRS Project       1               1         Initial release                      *
+*                                                                                                   *
+****************************************************************************************************/
+
+/* Include Global Parameters */
+
+#include <math.h>
+#include "unit_test.h"
+#include "Kalman.h"
+
+/* Definition of Macros */
+
+#define KT_DT       0.1f
+#define KT_STEPS    2000
+
+/* Declare Prototypes */
+
+static void   vSetup   (kalman *);
+static void   vRun     (kalman *, Matrix *, unsigned int);
+static float  fPDiff   (const kalman *, const kalman *);
+
+
+/********************************************************************************
+*                                                                               *
+* FUNCTION NAME: vSetup                                                         *
+*                                                                               *
+* PURPOSE: Constant velocity filter, position and velocity measured,            *
+*           A = [1 dt; 0 1], Q = diag(0.01, 0.1), R = 0.2*I, P = I              *
+*                                                                               *
+* ARGUMENT LIST:                                                                *
+*                                                                               *
+* Argument  Type         IO     Description                                     *
+* --------- --------     --     ---------------------------------               *
+* k         Kalman*      O      Filter                                          *
+*                                                                               *
+* RETURN VALUE: void                                                            *
+*                                                                               *
+********************************************************************************/
+static void vSetup(kalman *k)
+{
+    iKalman_Init(k, 2, 2);
+    k->vModel = NULL;
+    k->dt     = KT_DT;
+    k->A->matrix[0][0] = 1;
+    k->A->matrix[0][1] = KT_DT;
+    k->A->matrix[1][1] = 1;
+    k->H->matrix[0][0] = 1;
+    k->H->matrix[1][1] = 1;
+    k->Q->matrix[0][0] = 0.01f;
+    k->Q->matrix[1][1] = 0.1f;
+    k->R->matrix[0][0] = 0.2f;
+    k->R->matrix[1][1] = 0.2f;
+    k->P->matrix[0][0] = 1;
+    k->P->matrix[1][1] = 1;
+}
+
+/********************************************************************************
+*                                                                               *
+* FUNCTION NAME: vRun                                                           *
+*                                                                               *
+* PURPOSE: steps predictions each followed by the update with z                 *
+*                                                                               *
+* ARGUMENT LIST:                                                                *
+*                                                                               *
+* Argument  Type         IO     Description                                     *
+* --------- --------     --     ---------------------------------               *
+* k         Kalman*      IO     Filter                                          *
+* z         Matrix*      I      Measurement, 2 x 1                              *
+* steps     unsigned int I      Number of steps                                 *
+*                                                                               *
+* RETURN VALUE: void                                                            *
+*                                                                               *
+********************************************************************************/
+static void vRun(kalman *k, Matrix *z, unsigned int steps)
+{
+    unsigned int i;
+
+    for (i = 0; i < steps; i++)
+    {
+        vKalman_Predict(k, KT_DT, 0);
+        iKalman_Update(k, z, NULL);
+    }
+}
+
+/********************************************************************************
+*                                                                               *
+* FUNCTION NAME: fPDiff                                                         *
+*                                                                               *
+* PURPOSE: Largest difference of the covariances of two filters                 *
+*                                                                               *
+* ARGUMENT LIST:                                                                *
+*                                                                               *
+* Argument  Type         IO     Description                                     *
+* --------- --------     --     ---------------------------------               *
+* a         Kalman*      I      1st filter                                      *
+* b         Kalman*      I      2nd filter                                      *
+*                                                                               *
+* RETURN VALUE: float                                                           *
+*                                                                               *
+********************************************************************************/
+static float fPDiff(const kalman *a, const kalman *b)
+{
+    float  d = 0;
+    size_t i;
+    size_t j;
+
+    for (i = 0; i < a->P->r; i++)
+    {
+        for (j = 0; j < a->P->c; j++)
+        {
+            d = fmaxf(d, fabsf(a->P->matrix[i][j] - b->P->matrix[i][j]));
+        }
+    }
+
+    return d;
+}
+
+/********************************************************************************
+*                                                                               *
+* FUNCTION NAME: vTest_Kalman                                                   *
+*                                                                               *
+* PURPOSE: Test of Kalman.c                                                     *
+*                                                                               *
+* ARGUMENT LIST:                                                                *
+*                                                                               *
+* Argument  Type         IO     Description                                     *
+* --------- --------     --     ---------------------------------               *
+* none                                                                          *
+*                                                                               *
+* RETURN VALUE: void                                                            *
+*                                                                               *
+********************************************************************************/
+void vTest_Kalman(void)
+{
+    kalman  a;
+    kalman  b;
+    Matrix *z = pxCreate(2, 1);
+    Matrix *R = pxCreate(2, 2);
+    float   p00;
+
+    /* a constant position of 5 at rest: x converges to it, P to a fixed point */
+    vSetup(&a);
+    z->matrix[0][0] = 5;
+    z->matrix[1][0] = 0;
+    vRun(&a, z, 200);
+    TEST_NEAR(a.x->matrix[0][0], 5, 1e-3);
+    TEST_NEAR(a.x->matrix[1][0], 0, 1e-3);
+    TEST_CHECK(a.P->matrix[0][0] > 0 && a.P->matrix[0][0] < 0.2f);
+    TEST_NEAR(a.P->matrix[0][1], a.P->matrix[1][0], 1e-7);
+    TEST_CHECK(iKalman_Update(&a, R, NULL) == -1);
+
+    /* one step by hand: P_p = A*P*A^T + Q, K = P_p*(P_p + R)^-1 for P = I */
+    vKalman_Destroy(&a);
+    vSetup(&a);
+    vKalman_Predict(&a, KT_DT, 0);
+    TEST_NEAR(a.P->matrix[0][0], 1 + KT_DT * KT_DT + 0.01f, 1e-6);
+    TEST_NEAR(a.P->matrix[0][1], KT_DT, 1e-6);
+    TEST_NEAR(a.P->matrix[1][1], 1.1f, 1e-6);
+
+    /* the sequential update of a diagonal R is the joint one, its NIS too */
+    vKalman_Destroy(&a);
+    vSetup(&a);
+    vSetup(&b);
+    z->matrix[0][0] = 1;
+    z->matrix[1][0] = -2;
+    vKalman_Predict(&a, KT_DT, 0);
+    vKalman_Predict(&b, KT_DT, 0);
+    TEST_CHECK(iKalman_Update(&a, z, NULL) == 0);
+    TEST_CHECK(iKalman_UpdateSeq(&b, z, NULL) == 0);
+    TEST_NEAR(a.x->matrix[0][0], b.x->matrix[0][0], 1e-5);
+    TEST_NEAR(a.x->matrix[1][0], b.x->matrix[1][0], 1e-5);
+    TEST_NEAR(fPDiff(&a, &b), 0, 1e-5);
+    TEST_CHECK(a.nis > 0 && a.accepted == 1 && b.accepted == 1);
+    TEST_NEAR(a.nis, b.nis, 1e-4 * a.nis);
+
+    /* the square-root form follows the plain one, with the NIS of its Ls */
+    vKalman_Destroy(&a);
+    vKalman_Destroy(&b);
+    vSetup(&a);
+    vSetup(&b);
+    TEST_CHECK(iKalman_SquareRoot(&b, 1) == 0 && b.sqrt == 1);
+    vRun(&a, z, 50);
+    vRun(&b, z, 50);
+    TEST_NEAR(a.x->matrix[0][0], b.x->matrix[0][0], 1e-4);
+    TEST_NEAR(fPDiff(&a, &b), 0, 1e-4);
+    TEST_NEAR(a.nis, b.nis, 1e-3 * a.nis);
+    vKalman_Predict(&a, KT_DT, 0);
+    vKalman_Predict(&b, KT_DT, 0);
+    TEST_CHECK(iKalman_UpdateSeq(&b, z, NULL) == 0 && iKalman_Update(&a, z, NULL) == 0);
+    TEST_NEAR(a.nis, b.nis, 1e-3 * a.nis);
+
+    /* steady state: the frozen gain is the converged one; a new R leaves it,
+       and the covariance is propagated from the frozen one first, so that it
+       is the full filter's, not the updated one of the last step */
+    vKalman_Destroy(&a);
+    vKalman_Destroy(&b);
+    vSetup(&a);
+    vSetup(&b);
+    TEST_CHECK(iKalman_SteadyState(&a, 10000, 1e-7f) == 0 && a.steady == 1);
+    vRun(&b, z, KT_STEPS);
+    TEST_NEAR(fPDiff(&a, &b), 0, 1e-5);
+    R->matrix[0][0] = 0.5f;
+    R->matrix[1][1] = 0.5f;
+    vKalman_Predict(&a, KT_DT, 0);
+    vKalman_Predict(&b, KT_DT, 0);
+    TEST_CHECK(iKalman_Update(&a, z, R) == 0 && a.steady == 0);
+    iKalman_Update(&b, z, R);
+    TEST_NEAR(fPDiff(&a, &b), 0, 1e-5);
+
+    /* gate: an outlier is rejected and leaves x alone, a fix in the noise passes */
+    vKalman_Destroy(&a);
+    vSetup(&a);
+    TEST_CHECK(iKalman_SetGate(&a, KALMAN_GATE_99) == 0);
+    z->matrix[0][0] = 0;
+    z->matrix[1][0] = 0;
+    vRun(&a, z, 50);
+    TEST_CHECK(a.accepted == 50 && a.rejected == 0);
+    vKalman_Predict(&a, KT_DT, 0);
+    z->matrix[0][0] = 100;
+    TEST_CHECK(iKalman_Update(&a, z, NULL) == 1);
+    TEST_CHECK(a.rejected == 1 && a.misses == 1 && a.x->matrix[0][0] == 0);
+    z->matrix[0][0] = 0.1f;
+    TEST_CHECK(iKalman_Update(&a, z, NULL) == 0 && a.misses == 0);
+    TEST_CHECK(iKalman_SetGate(&a, KALMAN_GATE_LEVELS) == -1);
+
+    /* gate off: the NIS is still computed, by both updates, and nothing is rejected */
+    TEST_CHECK(iKalman_SetGate(&a, KALMAN_GATE_OFF) == 0 && a.nis == 0 && a.accepted == 0);
+    vKalman_Predict(&a, KT_DT, 0);
+    z->matrix[0][0] = 100;
+    TEST_CHECK(iKalman_Update(&a, z, NULL) == 0);
+    TEST_CHECK(a.nis > 1000 && a.nis_mean == a.nis && a.accepted == 1 && a.rejected == 0);
+    vKalman_Predict(&a, KT_DT, 0);
+    TEST_CHECK(iKalman_UpdateSeq(&a, z, NULL) == 0);
+    TEST_CHECK(a.nis > 0 && a.accepted == 2 && a.rejected == 0);
+
+    /* inflation scales P, and L with it in the square-root form */
+    p00 = a.P->matrix[0][0];
+    TEST_CHECK(iKalman_Inflate(&a, 100) == 0);
+    TEST_NEAR(a.P->matrix[0][0], 100 * p00, 1e-4 * p00);
+    TEST_CHECK(iKalman_Inflate(&a, 0.5f) == -1);
+    TEST_CHECK(iKalman_Inflate(&b, 4) == 0);
+
+    vKalman_Destroy(&a);
+    vKalman_Destroy(&b);
+    vDestroy(z);
+    vDestroy(R);
+}
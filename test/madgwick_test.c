@@ -0,0 +1,195 @@
+/***********************************************************************************
+* This file is part of The AHRS Project.                                           *
+*                                                                                  *
+* Copyright © 2020 By Nicola di Gruttola Giardino. All rights reserved.            *
+* @mail: nicoladgg@protonmail.com                                                  *
+*                                                                                  *
+* AHRS is free software: you can redistribute it and/or modify                     *
+* it under the terms of the GNU General Public License as published by             *
+* the Free Software Foundation, either version 3 of the License, or                *
+* (at your option) any later version.                                              *
+*                                                                                  *
+* AHRS is distributed in the hope that it will be useful,                          *
+* but WITHOUT ANY WARRANTY; without even the implied warranty of                   *
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the                    *
+* GNU General Public License for more details.                                     *
+*                                                                                  *
+* You should have received a copy of the GNU General Public License                *
+* along with The AHRS Project.  If not, see <https://www.gnu.org/licenses/>.       *
+*                                                                                  *
+* In case of use of this project, I ask you to mention me, to whom it may concern. *
+***********************************************************************************/
+
+/****************************************************************************************************
+* FILE NAME: madgwick_test.c                                                                        *
+*                                                                                                   *
+* PURPOSE: Test of the Madgwick filter: at rest it keeps its attitude, a yaw rate integrates to     *
+*           the expected quaternion, a tilted gravity is converged to, the quaternion stays unit    *
+*           and a published snapshot gives the quaternion back                                      *
+*                                                                                                   *
+* FILE REFERENCES:                                                                                  *
+*                                                                                                   *
+*   Name    I/O     Description                                                                     *
+*   ----    ---     -----------                                                                     *
+*   none                                                                                            *
+*                                                                                                   *
+* EXTERNAL VARIABLES:                                                                               *
+*                                                                                                   *
+* Source: <MadgwickAHRS.h>                                                                          *
+*                                                                                                   *
+* Name          Type          IO Description                                                        *
+* ------------- -------       -- -----------------------------                                      *
+* madgwick      madgwick_t    IO filter of the functions without a madgwick_t argument              *
+*                                                                                                   *
+* STATIC VARIABLES:                                                                                 *
+*                                                                                                   *
+*   Name     Type       I/O      Description                                                        *
+*   ----     ----       ---      -----------                                                        *
+*   none                                                                                            *
+*                                                                                                   *
+* EXTERNAL REFERENCES:                                                                              *
+*                                                                                                   *
+*  Name                       Description                                                           *
+*  -------------              -----------                                                           *
+*  MadgwickAHRS.c             The functions under test                                              *
+*                                                                                                   *
+* ABNORMAL TERMINATION CONDITIONS, ERROR AND WARNING MESSAGES:                                      *
+*    none                                                                                           *
+*                                                                                                   *
+* ASSUMPTIONS, CONSTRAINTS, RESTRICTIONS: one update integrates 1/sampleFreq seconds                *
+*                                                                                                   *
+* NOTES: invSqrt is the fast approximation, the norm settles about 0.17% under 1; and the gradient  *
+*    step has a fixed size, beta/sampleFreq, so the attitude chatters about a degree around the     *
+*    one of the gravity: the tolerances are those                                                   *
+*                                                                                                   *
+* REQUIREMENTS/FUNCTIONAL SPECIFICATIONS REFERENCES:                                                *
+*                                                                                                   *
+* DEVELOPMENT HISTORY:                                                                              *
+*                                                                                                   *
+*   Date          Author            Change Id     Release     Description Of Change                 *
+*   ----          ------            ---------     ------      ----------------------                *
+*   19-10-2026    AHRS Project       1               1         Initial release                      *
+*                                                                                                   *
+****************************************************************************************************/
+
+/* Include Global Parameters */
+
+#include <math.h>
+#include "unit_test.h"
+#include "MadgwickAHRS.h"
+
+/* Definition of Macros */
+
+#define MT_NORM     2e-3        /* invSqrt error */
+#define MT_GRAVITY  3e-2        /* fixed gradient step */
+
+/* Declare Prototypes */
+
+static float  fNorm  (const madgwick_t *);
+
+
+/********************************************************************************
+*                                                                               *
+* FUNCTION NAME: fNorm                                                          *
+*                                                                               *
+* PURPOSE: Norm of the quaternion of a filter                                   *
+*                                                                               *
+* ARGUMENT LIST:                                                                *
+*                                                                               *
+* Argument  Type         IO     Description                                     *
+* --------- --------     --     ---------------------------------               *
+* m         madgwick_t*  I      Filter                                          *
+*                                                                               *
+* RETURN VALUE: float                                                           *
+*                                                                               *
+********************************************************************************/
+static float fNorm(const madgwick_t *m)
+{
+    return sqrtf(m->q0 * m->q0 + m->q1 * m->q1 + m->q2 * m->q2 + m->q3 * m->q3);
+}
+
+/********************************************************************************
+*                                                                               *
+* FUNCTION NAME: vTest_Madgwick                                                 *
+*                                                                               *
+* PURPOSE: Test of MadgwickAHRS.c                                               *
+*                                                                               *
+* ARGUMENT LIST:                                                                *
+*                                                                               *
+* Argument  Type         IO     Description                                     *
+* --------- --------     --     ---------------------------------               *
+* none                                                                          *
+*                                                                               *
+* RETURN VALUE: void                                                            *
+*                                                                               *
+********************************************************************************/
+void vTest_Madgwick(void)
+{
+    madgwick_t          m;
+    madgwick_t          n;
+    madgwick_snapshot_t s = {0};
+    float               q[4];
+    float               v[3];
+    int                 i;
+
+    MadgwickInit(&m);
+    TEST_CHECK(m.q0 == 1 && m.q1 == 0 && m.q2 == 0 && m.q3 == 0);
+    TEST_CHECK(m.beta > 0);
+
+    /* level and still: nothing moves */
+    for (i = 0; i < 100; i++)
+    {
+        MadgwickUpdateIMU(&m, 0, 0, 0, 0, 0, 1);
+    }
+    TEST_NEAR(m.q0, 1, MT_NORM);
+    TEST_NEAR(fabsf(m.q1) + fabsf(m.q2) + fabsf(m.q3), 0, 1e-6);
+
+    /* 0.1 rad/s of yaw for 1 s: the gravity agrees, q = (cos 0.05, 0, 0, sin 0.05) */
+    for (i = 0; i < (int)sampleFreq; i++)
+    {
+        MadgwickUpdateIMU(&m, 0, 0, 0.1f, 0, 0, 1);
+    }
+    TEST_NEAR(m.q0 / fNorm(&m), cosf(0.05f), 1e-4);
+    TEST_NEAR(m.q3 / fNorm(&m), sinf(0.05f), 1e-4);
+    TEST_NEAR(m.q1, 0, 1e-6);
+    TEST_NEAR(m.q2, 0, 1e-6);
+    TEST_NEAR(fNorm(&m), 1, MT_NORM);
+
+    /* no magnetometer, MadgwickUpdate is the IMU update */
+    MadgwickInit(&n);
+    n = m;
+    MadgwickUpdate(&m, 0.01f, -0.02f, 0.03f, 0.1f, 0, 1, 0, 0, 0);
+    MadgwickUpdateIMU(&n, 0.01f, -0.02f, 0.03f, 0.1f, 0, 1);
+    TEST_CHECK(m.q0 == n.q0 && m.q1 == n.q1 && m.q2 == n.q2 && m.q3 == n.q3);
+
+    /* gravity along +y: the gradient step turns the estimate to it, unit norm */
+    MadgwickInit(&m);
+    for (i = 0; i < 1000; i++)
+    {
+        MadgwickUpdateIMU(&m, 0, 0, 0, 0, 1, 0);
+    }
+    v[0] = 2 * (m.q1 * m.q3 - m.q0 * m.q2);
+    v[1] = 2 * (m.q0 * m.q1 + m.q2 * m.q3);
+    v[2] = m.q0 * m.q0 - m.q1 * m.q1 - m.q2 * m.q2 + m.q3 * m.q3;
+    TEST_NEAR(v[0], 0, MT_GRAVITY);
+    TEST_NEAR(v[1], 1, MT_GRAVITY);
+    TEST_NEAR(v[2], 0, MT_GRAVITY);
+    TEST_NEAR(fNorm(&m), 1, MT_NORM);
+
+    /* the wrappers drive the global filter */
+    MadgwickInit(&madgwick);
+    MadgwickInit(&n);
+    MadgwickAHRSupdateIMU(0, 0, 0.1f, 0, 0, 1);
+    MadgwickUpdateIMU(&n, 0, 0, 0.1f, 0, 0, 1);
+    TEST_CHECK(madgwick.q0 == n.q0 && madgwick.q3 == n.q3);
+    MadgwickInit(&madgwick);
+
+    /* snapshot: zero before the first publication, then the last one published */
+    MadgwickSnapshot(&s, q);
+    TEST_CHECK(q[0] == 0 && q[1] == 0 && q[2] == 0 && q[3] == 0);
+    MadgwickPublish(&s, &n);
+    MadgwickPublish(&s, &m);
+    MadgwickSnapshot(&s, q);
+    TEST_CHECK(q[0] == m.q0 && q[1] == m.q1 && q[2] == m.q2 && q[3] == m.q3);
+    TEST_CHECK(s.seq == 4);
+}
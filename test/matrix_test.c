@@ -0,0 +1,310 @@
+/***********************************************************************************
+* This file is part of The AHRS Project.                                           *
+*                                                                                  *
+* Copyright © 2020 By Nicola di Gruttola Giardino. All rights reserved.            *
+* @mail: nicoladgg@protonmail.com                                                  *
+*                                                                                  *
+* AHRS is free software: you can redistribute it and/or modify                     *
+* it under the terms of the GNU General Public License as published by             *
+* the Free Software Foundation, either version 3 of the License, or                *
+* (at your option) any later version.                                              *
+*                                                                                  *
+* AHRS is distributed in the hope that it will be useful,                          *
+* but WITHOUT ANY WARRANTY; without even the implied warranty of                   *
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the                    *
+* GNU General Public License for more details.                                     *
+*                                                                                  *
+* You should have received a copy of the GNU General Public License                *
+* along with The AHRS Project.  If not, see <https://www.gnu.org/licenses/>.       *
+*                                                                                  *
+* In case of use of this project, I ask you to mention me, to whom it may concern. *
+***********************************************************************************/
+
+/****************************************************************************************************
+* FILE NAME: matrix_test.c                                                                          *
+*                                                                                                   *
+* PURPOSE: Test of the matrix library: products, sums, transpose, inverse, Cholesky and the         *
+*           triangular kernels of the filters against results worked out by hand, and the size      *
+*           checks of the allocation free i* functions                                              *
+*                                                                                                   *
+* FILE REFERENCES:                                                                                  *
+*                                                                                                   *
+*   Name    I/O     Description                                                                     *
+*   ----    ---     -----------                                                                     *
+*   none                                                                                            *
+*                                                                                                   *
+* EXTERNAL VARIABLES:                                                                               *
+*                                                                                                   *
+* Source: <unit_test.h>                                                                             *
+*                                                                                                   *
+* Name          Type          IO Description                                                        *
+* ------------- -------       -- -----------------------------                                      *
+*   none                                                                                            *
+*                                                                                                   *
+* STATIC VARIABLES:                                                                                 *
+*                                                                                                   *
+*   Name     Type       I/O      Description                                                        *
+*   ----     ----       ---      -----------                                                        *
+*   none                                                                                            *
+*                                                                                                   *
+* EXTERNAL REFERENCES:                                                                              *
+*                                                                                                   *
+*  Name                       Description                                                           *
+*  -------------              -----------                                                           *
+*  matrix.c                   The functions under test                                              *
+*                                                                                                   *
+* ABNORMAL TERMINATION CONDITIONS, ERROR AND WARNING MESSAGES:                                      *
+*    none                                                                                           *
+*                                                                                                   *
+* ASSUMPTIONS, CONSTRAINTS, RESTRICTIONS: none                                                      *
+*                                                                                                   *
+* NOTES: the matrices are small enough that every product is exact in float                         *
+*                                                                                                   *
+* REQUIREMENTS/FUNCTIONAL SPECIFICATIONS REFERENCES:                                                *
+*                                                                                                   *
+* DEVELOPMENT HISTORY:                                                                              *
+*                                                                                                   *
+*   Date          Author            Change Id     Release     Description Of Change                 *
+*   ----          ------            ---------     ------      ----------------------                *
+*   19-10-2026    AHRS Project       1               1         Initial release                      *
+*                                                                                                   *
+****************************************************************************************************/
+
+/* Include Global Parameters */
+
+#include <math.h>
+#include "unit_test.h"
+#include "matrix.h"
+
+/* Definition of Macros */
+
+#define MT_N    3
+
+/* Declare Prototypes */
+
+static Matrix*  pxLoad   (unsigned int, unsigned int, const float *);
+static float    fMaxDiff (Matrix *, Matrix *);
+
+
+/********************************************************************************
+*                                                                               *
+* FUNCTION NAME: pxLoad                                                         *
+*                                                                               *
+* PURPOSE: Creates an r x c matrix from its values, row by row                  *
+*                                                                               *
+* ARGUMENT LIST:                                                                *
+*                                                                               *
+* Argument  Type         IO     Description                                     *
+* --------- --------     --     ---------------------------------               *
+* r         unsigned int I      Rows                                            *
+* c         unsigned int I      Columns                                         *
+* v         const float* I      r*c values                                      *
+*                                                                               *
+* RETURN VALUE: Matrix*                                                         *
+*                                                                               *
+********************************************************************************/
+static Matrix* pxLoad(unsigned int r, unsigned int c, const float *v)
+{
+    Matrix      *m = pxCreate(r, c);
+    unsigned int i;
+    unsigned int j;
+
+    for (i = 0; i < r; i++)
+    {
+        for (j = 0; j < c; j++)
+        {
+            m->matrix[i][j] = v[i * c + j];
+        }
+    }
+
+    return m;
+}
+
+/********************************************************************************
+*                                                                               *
+* FUNCTION NAME: fMaxDiff                                                       *
+*                                                                               *
+* PURPOSE: Largest |a - b| of two matrices of the same size, NaN if they are    *
+*           not                                                                 *
+*                                                                               *
+* ARGUMENT LIST:                                                                *
+*                                                                               *
+* Argument  Type         IO     Description                                     *
+* --------- --------     --     ---------------------------------               *
+* a         Matrix*      I      1st matrix                                      *
+* b         Matrix*      I      2nd matrix                                      *
+*                                                                               *
+* RETURN VALUE: float                                                           *
+*                                                                               *
+********************************************************************************/
+static float fMaxDiff(Matrix *a, Matrix *b)
+{
+    float  d = 0;
+    size_t i;
+    size_t j;
+
+    if (a->r != b->r || a->c != b->c)
+    {
+        return NAN;
+    }
+    for (i = 0; i < a->r; i++)
+    {
+        for (j = 0; j < a->c; j++)
+        {
+            d = fmaxf(d, fabsf(a->matrix[i][j] - b->matrix[i][j]));
+        }
+    }
+
+    return d;
+}
+
+/********************************************************************************
+*                                                                               *
+* FUNCTION NAME: vTest_Matrix                                                   *
+*                                                                               *
+* PURPOSE: Test of matrix.c                                                     *
+*                                                                               *
+* ARGUMENT LIST:                                                                *
+*                                                                               *
+* Argument  Type         IO     Description                                     *
+* --------- --------     --     ---------------------------------               *
+* none                                                                          *
+*                                                                               *
+* RETURN VALUE: void                                                            *
+*                                                                               *
+********************************************************************************/
+void vTest_Matrix(void)
+{
+    static const float va[]  = { 1, 2, 3,
+                                 4, 5, 6 };
+    static const float vb[]  = { 7,  8,
+                                 9, 10,
+                                11, 12 };
+    static const float vab[] = {  58,  64,
+                                 139, 154 };
+    /* M = L*L^T with L = [2 0 0; 1 3 0; -1 2 1] */
+    static const float vl[]  = {  2, 0, 0,
+                                  1, 3, 0,
+                                 -1, 2, 1 };
+    static const float vm[]  = {  4,  2, -2,
+                                  2, 10,  5,
+                                 -2,  5,  6 };
+    /* zero pivots: a 90 deg rotation about z, a permutation of a diagonal */
+    static const float vz[]  = {  0, -1,  0,
+                                  1,  0,  0,
+                                  0,  0,  1 };
+    static const float vp[]  = {  0,  0,  3,
+                                  2,  0,  0,
+                                  0,  4,  0 };
+    static const float vs[]  = {  1,  2,  3,
+                                  2,  4,  6,
+                                  0,  1,  1 };
+    Matrix *a   = pxLoad(2, 3, va);
+    Matrix *b   = pxLoad(3, 2, vb);
+    Matrix *ab  = pxLoad(2, 2, vab);
+    Matrix *l   = pxLoad(MT_N, MT_N, vl);
+    Matrix *m   = pxLoad(MT_N, MT_N, vm);
+    Matrix *c   = pxCreate(2, 2);
+    Matrix *t   = pxCreate(3, 2);
+    Matrix *n   = pxCreate(MT_N, MT_N);
+    Matrix *w   = pxCreate(MT_N, MT_N);
+    Matrix *inv = pxCreate(MT_N, MT_N);
+    Matrix *id  = pxIdentity(MT_N);
+    Matrix *f   = pxCreate(MT_N, 2 * MT_N);
+    Matrix *x   = pxCreate(MT_N, 1);
+    Matrix *y   = pxCreate(MT_N, 1);
+    size_t  i;
+    size_t  j;
+
+    /* products and sizes */
+    TEST_CHECK(iMultiply(c, a, b) == 0);
+    TEST_CHECK(iEquals(c, ab) == 1);
+    TEST_CHECK(iMultiply(c, a, a) == -1);
+    TEST_CHECK(iMultiply(t, a, b) == -1);
+    TEST_CHECK(iTranspose(t, a) == 0);
+    TEST_CHECK(t->matrix[2][0] == 3 && t->matrix[0][1] == 4 && t->matrix[2][1] == 6);
+    TEST_CHECK(iSum(c, ab, ab) == 0 && c->matrix[1][1] == 308);
+    TEST_CHECK(iSubtract(c, c, ab) == 0 && iEquals(c, ab) == 1);
+    TEST_CHECK(iSc_Multiply(c, ab, 0.5f) == 0 && c->matrix[0][0] == 29);
+    TEST_CHECK(iCopy(c, a) == -1);
+    TEST_CHECK(iCopy(t, b) == 0 && iEquals(t, b) == 1);
+    TEST_CHECK(iZeroMat(c) == 0 && c->matrix[1][0] == 0);
+
+    /* Cholesky, and L*L^T by iSyrk */
+    TEST_CHECK(iChol(n, m) == 0);
+    TEST_NEAR(fMaxDiff(n, l), 0, 1e-6);
+    TEST_CHECK(iSyrk(w, l, 1.0f, 0.0f, TRI_NOTRANS) == 0);
+    TEST_NEAR(fMaxDiff(w, m), 0, 1e-6);
+
+    /* inverse: iInverse reduces its input, on an identity */
+    iCopy(w, m);
+    iIdentity(inv);
+    TEST_CHECK(iInverse(inv, w) == 0);
+    TEST_CHECK(iMultiply(w, m, inv) == 0);
+    TEST_NEAR(fMaxDiff(w, id), 0, 1e-5);
+    for (i = 0; i < 3; i++)
+    {
+        const float *v = i == 0 ? vz : i == 1 ? vp : vs;
+        Matrix      *z = pxLoad(MT_N, MT_N, v);
+
+        /* a 0 on the diagonal takes the pivot from another column;
+           the singular one is refused */
+        iCopy(w, z);
+        iIdentity(inv);
+        if (v == vs)
+        {
+            TEST_CHECK(iInverse(inv, w) == -1);
+        }
+        else
+        {
+            TEST_CHECK(iInverse(inv, w) == 0);
+            iMultiply(w, z, inv);
+            TEST_NEAR(fMaxDiff(w, id), 0, 1e-6);
+        }
+        vDestroy(z);
+    }
+    TEST_CHECK(iInverse(inv, a) == -1);
+
+    /* L*y = x and L^T*y = x by iTrsm */
+    x->matrix[0][0] = 2;
+    x->matrix[1][0] = 7;
+    x->matrix[2][0] = 3;
+    TEST_CHECK(iTrsm(y, l, x, TRI_LOWER, TRI_NOTRANS) == 0);
+    TEST_NEAR(y->matrix[0][0], 1, 1e-6);
+    TEST_NEAR(y->matrix[1][0], 2, 1e-6);
+    TEST_NEAR(y->matrix[2][0], 0, 1e-6);
+    TEST_CHECK(iTrsm(y, l, x, TRI_LOWER, TRI_TRANS) == 0);
+    TEST_NEAR(2 * y->matrix[0][0] + y->matrix[1][0] - y->matrix[2][0], 2, 1e-5);
+    TEST_NEAR(3 * y->matrix[1][0] + 2 * y->matrix[2][0], 7, 1e-5);
+    TEST_NEAR(y->matrix[2][0], 3, 1e-6);
+
+    /* iTria of [L, L]: a factor of 2*M */
+    for (i = 0; i < MT_N; i++)
+    {
+        for (j = 0; j < MT_N; j++)
+        {
+            f->matrix[i][j]        = l->matrix[i][j];
+            f->matrix[i][MT_N + j] = l->matrix[i][j];
+        }
+    }
+    TEST_CHECK(iTria(n, f) == 0);
+    TEST_CHECK(n->matrix[0][1] == 0 && n->matrix[0][2] == 0 && n->matrix[1][2] == 0);
+    iSyrk(w, n, 1.0f, 0.0f, TRI_NOTRANS);
+    iSc_Multiply(inv, m, 2.0f);
+    TEST_NEAR(fMaxDiff(w, inv), 0, 1e-4);
+
+    vDestroy(a);
+    vDestroy(b);
+    vDestroy(ab);
+    vDestroy(l);
+    vDestroy(m);
+    vDestroy(c);
+    vDestroy(t);
+    vDestroy(n);
+    vDestroy(w);
+    vDestroy(inv);
+    vDestroy(id);
+    vDestroy(f);
+    vDestroy(x);
+    vDestroy(y);
+}
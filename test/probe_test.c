@@ -0,0 +1,203 @@
+/***********************************************************************************
+* This file is part of The AHRS Project.                                           *
+*                                                                                  *
+* Copyright © 2020 By Nicola di Gruttola Giardino. All rights reserved.            *
+* @mail: nicoladgg@protonmail.com                                                  *
+*                                                                                  *
+* AHRS is free software: you can redistribute it and/or modify                     *
+* it under the terms of the GNU General Public License as published by             *
+* the Free Software Foundation, either version 3 of the License, or                *
+* (at your option) any later version.                                              *
+*                                                                                  *
+* AHRS is distributed in the hope that it will be useful,                          *
+* but WITHOUT ANY WARRANTY; without even the implied warranty of                   *
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the                    *
+* GNU General Public License for more details.                                     *
+*                                                                                  *
+* You should have received a copy of the GNU General Public License                *
+* along with The AHRS Project.  If not, see <https://www.gnu.org/licenses/>.       *
+*                                                                                  *
+* In case of use of this project, I ask you to mention me, to whom it may concern. *
+***********************************************************************************/
+
+/****************************************************************************************************
+* FILE NAME: probe_test.c                                                                           *
+*                                                                                                   *
+* PURPOSE: Test of the timing probes: known durations are recorded and iProbe_Stats must give       *
+*           back their count, min, max and mean, and a p99 at the upper edge of the histogram bin   *
+*           of the 99th percentile                                                                  *
+*                                                                                                   *
+* FILE REFERENCES:                                                                                  *
+*                                                                                                   *
+*   Name    I/O     Description                                                                     *
+*   ----    ---     -----------                                                                     *
+*   none                                                                                            *
+*                                                                                                   *
+* EXTERNAL VARIABLES:                                                                               *
+*                                                                                                   *
+* Source: <unit_test.h>                                                                             *
+*                                                                                                   *
+* Name          Type          IO Description                                                        *
+* ------------- -------       -- -----------------------------                                      *
+*   none                                                                                            *
+*                                                                                                   *
+* STATIC VARIABLES:                                                                                 *
+*                                                                                                   *
+*   Name     Type       I/O      Description                                                        *
+*   ----     ----       ---      -----------                                                        *
+*   none                                                                                            *
+*                                                                                                   *
+* EXTERNAL REFERENCES:                                                                              *
+*                                                                                                   *
+*  Name                       Description                                                           *
+*  -------------              -----------                                                           *
+*  vProbe_Record              Probe.c, records one duration                                         *
+*  iProbe_Stats               Probe.c, summary of a probe                                           *
+*                                                                                                   *
+* ABNORMAL TERMINATION CONDITIONS, ERROR AND WARNING MESSAGES:                                      *
+*    none                                                                                           *
+*                                                                                                   *
+* ASSUMPTIONS, CONSTRAINTS, RESTRICTIONS: the probes are global, the test resets them               *
+*                                                                                                   *
+* NOTES: the bins are 4 per octave: 0 to 7 one value each, then 8-9, 10-11, 12-13, 14-15,           *
+*    16-19 and so on                                                                                *
+*                                                                                                   *
+* REQUIREMENTS/FUNCTIONAL SPECIFICATIONS REFERENCES:                                                *
+*                                                                                                   *
+* DEVELOPMENT HISTORY:                                                                              *
+*                                                                                                   *
+*   Date          Author            Change Id     Release     Description Of Change                 *
+*   ----          ------            ---------     ------      ----------------------                *
+*   19-10-2026    AHRS Project       1               1         Initial release                      *
+*                                                                                                   *
+****************************************************************************************************/
+
+/* Include Global Parameters */
+
+#include "unit_test.h"
+#include "Probe.h"
+
+/* Declare Prototypes */
+
+static uint32_t  uP99   (uint32_t);
+
+
+/********************************************************************************
+*                                                                               *
+* FUNCTION NAME: uP99                                                           *
+*                                                                               *
+* PURPOSE: p99 of 99 durations v and one far longer, i.e. the upper edge of     *
+*           the bin of v                                                        *
+*                                                                               *
+* ARGUMENT LIST:                                                                *
+*                                                                               *
+* Argument  Type         IO     Description                                     *
+* --------- --------     --     ---------------------------------               *
+* v         uint32_t     I      Duration                                        *
+*                                                                               *
+* RETURN VALUE: uint32_t                                                        *
+*                                                                               *
+********************************************************************************/
+static uint32_t uP99(uint32_t v)
+{
+    ProbeStats s;
+    int        i;
+
+    vProbe_Reset();
+    for (i = 0; i < 99; i++)
+    {
+        vProbe_Record(PROBE_SAMPLE, v);
+    }
+    vProbe_Record(PROBE_SAMPLE, 0x80000000UL);
+    iProbe_Stats(PROBE_SAMPLE, &s);
+
+    return s.p99;
+}
+
+/********************************************************************************
+*                                                                               *
+* FUNCTION NAME: vTest_Probe                                                    *
+*                                                                               *
+* PURPOSE: Test of Probe.c                                                      *
+*                                                                               *
+* ARGUMENT LIST:                                                                *
+*                                                                               *
+* Argument  Type         IO     Description                                     *
+* --------- --------     --     ---------------------------------               *
+* none                                                                          *
+*                                                                               *
+* RETURN VALUE: void                                                            *
+*                                                                               *
+********************************************************************************/
+void vTest_Probe(void)
+{
+    static const uint32_t edges[][2] =
+    {
+        /* duration, upper edge of its bin */
+        {  0,  0 }, {  7,  7 }, {  8,  9 }, {  9,  9 }, { 10, 11 }, { 15, 15 },
+        { 16, 19 }, { 19, 19 }, { 20, 23 }, { 31, 31 }, { 32, 39 }, { 1000, 1023 },
+        { 1024, 1279 }, { 0x7FFFFFFFUL, 0x7FFFFFFFUL }
+    };
+    ProbeStats s;
+    uint32_t   p;
+    size_t     i;
+    int        j;
+
+    vProbe_Init();
+
+    /* out of range, and a probe without samples */
+    TEST_CHECK(iProbe_Stats(PROBES, &s) == -1);
+    TEST_CHECK(iProbe_Stats(PROBE_SAMPLE, NULL) == -1);
+    TEST_CHECK(iProbe_Stats(PROBE_SAMPLE, &s) == 0);
+    TEST_CHECK(s.count == 0 && s.min == 0 && s.mean == 0 && s.max == 0 && s.p99 == 0);
+    vProbe_Record(PROBES, 5);
+    iProbe_Stats(PROBE_SAMPLE, &s);
+    TEST_CHECK(s.count == 0);
+
+    /* 990 samples of 10 and 10 of 5000: the 99th percentile is in the 10-11 bin */
+    for (j = 0; j < 990; j++)
+    {
+        vProbe_Record(PROBE_SAMPLE, 10);
+    }
+    for (j = 0; j < 10; j++)
+    {
+        vProbe_Record(PROBE_SAMPLE, 5000);
+    }
+    TEST_CHECK(iProbe_Stats(PROBE_SAMPLE, &s) == 0);
+    TEST_CHECK(s.count == 1000);
+    TEST_CHECK(s.min == 10);
+    TEST_CHECK(s.max == 5000);
+    TEST_CHECK(s.mean == (990 * 10 + 10 * 5000) / 1000);
+    TEST_CHECK(s.p99 == 11);
+
+    /* one more of 5000 and the 99th percentile moves to its bin, capped at max */
+    vProbe_Record(PROBE_SAMPLE, 5000);
+    iProbe_Stats(PROBE_SAMPLE, &s);
+    TEST_CHECK(s.count == 1001 && s.p99 == 5000);
+
+    /* 1 to 100: the 99th is 99, in the 96-111 bin, capped at max */
+    vProbe_Reset();
+    for (j = 1; j <= 100; j++)
+    {
+        vProbe_Record(PROBE_MADGWICK, (uint32_t)j);
+    }
+    iProbe_Stats(PROBE_MADGWICK, &s);
+    TEST_CHECK(s.count == 100 && s.min == 1 && s.max == 100 && s.mean == 50);
+    TEST_CHECK(s.p99 == 100);
+    iProbe_Stats(PROBE_SAMPLE, &s);
+    TEST_CHECK(s.count == 0);
+
+    /* the bin edges, and every edge is within 25% of the bin's first duration */
+    for (i = 0; i < sizeof(edges) / sizeof(edges[0]); i++)
+    {
+        p = uP99(edges[i][0]);
+        TEST_CHECK(p == edges[i][1]);
+        TEST_CHECK(p >= edges[i][0] && (uint64_t)p * 4 <= (uint64_t)edges[i][0] * 5 + 4);
+        if (edges[i][1] < 0x7FFFFFFFUL)
+        {
+            TEST_CHECK(uP99(edges[i][1] + 1) > edges[i][1]);
+        }
+    }
+
+    vProbe_Reset();
+}
@@ -0,0 +1,324 @@
+/***********************************************************************************
+* This file is part of The AHRS Project.                                           *
+*                                                                                  *
+* Copyright © 2020 By Nicola di Gruttola Giardino. All rights reserved.            *
+* @mail: nicoladgg@protonmail.com                                                  *
+*                                                                                  *
+* AHRS is free software: you can redistribute it and/or modify                     *
+* it under the terms of the GNU General Public License as published by             *
+* the Free Software Foundation, either version 3 of the License, or                *
+* (at your option) any later version.                                              *
+*                                                                                  *
+* AHRS is distributed in the hope that it will be useful,                          *
+* but WITHOUT ANY WARRANTY; without even the implied warranty of                   *
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the                    *
+* GNU General Public License for more details.                                     *
+*                                                                                  *
+* You should have received a copy of the GNU General Public License                *
+* along with The AHRS Project.  If not, see <https://www.gnu.org/licenses/>.       *
+*                                                                                  *
+* In case of use of this project, I ask you to mention me, to whom it may concern. *
+***********************************************************************************/
+
+/****************************************************************************************************
+* FILE NAME: smoother_test.c                                                                        *
+*                                                                                                   *
+* PURPOSE: Test of the fixed-lag smoother: every epoch comes out once, in order, equal to a         *
+*           reference RTS pass in double over the epochs up to its lag, and closer to the track     *
+*           than the filter                                                                         *
+*                                                                                                   *
+* FILE REFERENCES:                                                                                  *
+*                                                                                                   *
+*   Name    I/O     Description                                                                     *
+*   ----    ---     -----------                                                                     *
+*   none                                                                                            *
+*                                                                                                   *
+* EXTERNAL VARIABLES:                                                                               *
+*                                                                                                   *
+* Source: <unit_test.h>                                                                             *
+*                                                                                                   *
+* Name          Type          IO Description                                                        *
+* ------------- -------       -- -----------------------------                                      *
+*   none                                                                                            *
+*                                                                                                   *
+* STATIC VARIABLES:                                                                                 *
+*                                                                                                   *
+*   Name     Type       I/O      Description                                                        *
+*   ----     ----       ---      -----------                                                        *
+*   xp, Pp   double[]              Predicted state and covariance of each epoch                     *
+*   xf, Pf   double[]              Filtered state and covariance of each epoch                      *
+*                                                                                                   *
+* EXTERNAL REFERENCES:                                                                              *
+*                                                                                                   *
+*  Name                       Description                                                           *
+*  -------------              -----------                                                           *
+*  KalmanSmoother.c           The functions under test                                              *
+*  rng.c                      Noise of the track                                                    *
+*                                                                                                   *
+* ABNORMAL TERMINATION CONDITIONS, ERROR AND WARNING MESSAGES:                                      *
+*    none                                                                                           *
+*                                                                                                   *
+* ASSUMPTIONS, CONSTRAINTS, RESTRICTIONS: none                                                      *
+*                                                                                                   *
+* NOTES: the flush smooths the last epochs with fewer than ST_LAG epochs after them                 *
+*                                                                                                   *
+* REQUIREMENTS/FUNCTIONAL SPECIFICATIONS REFERENCES:                                                *
+*                                                                                                   *
+* DEVELOPMENT HISTORY:                                                                              *
+*                                                                                                   *
+*   Date          Author            Change Id     Release     Description Of Change                 *
+*   ----          ------            ---------     ------      ----------------------                *
+*   19-10-2026    AHRS Project       1               1         Initial release                      *
+*                                                                                                   *
+****************************************************************************************************/
+
+/* Include Global Parameters */
+
+#include <math.h>
+#include "unit_test.h"
+#include "KalmanSmoother.h"
+#include "rng.h"
+
+/* Definition of Macros */
+
+#define ST_DT       0.01f
+#define ST_ACC      0.5f
+#define ST_STEPS    400
+#define ST_LAG      20
+
+/* Declare Prototypes */
+
+static void   vSetup   (kalman *);
+static void   vRts     (const kalman *, int, int, double [2], double *);
+
+/* Define Static Variables */
+
+static double xp[ST_STEPS][2];
+static double Pp[ST_STEPS][2][2];
+static double xf[ST_STEPS][2];
+static double Pf[ST_STEPS][2][2];
+
+
+/********************************************************************************
+*                                                                               *
+* FUNCTION NAME: vSetup                                                         *
+*                                                                               *
+* PURPOSE: Creates a filter of the 2 state constant acceleration model          *
+*                                                                               *
+* ARGUMENT LIST:                                                                *
+*                                                                               *
+* Argument  Type         IO     Description                                     *
+* --------- --------     --     ---------------------------------               *
+* k         kalman*      O      Filter                                          *
+*                                                                               *
+* RETURN VALUE: void                                                            *
+*                                                                               *
+********************************************************************************/
+static void vSetup(kalman *k)
+{
+    iKalman_Init(k, 2, 2);
+    k->vModel = NULL;
+    k->dt     = ST_DT;
+    k->A->matrix[0][0] = 1;
+    k->A->matrix[0][1] = ST_DT;
+    k->A->matrix[1][1] = 1;
+    k->B->matrix[0][0] = ST_DT * ST_DT / 2;
+    k->B->matrix[1][0] = ST_DT;
+    k->H->matrix[0][0] = 1;
+    k->H->matrix[1][1] = 1;
+    k->Q->matrix[0][0] = 1e-4f;
+    k->Q->matrix[1][1] = 1e-3f;
+    k->R->matrix[0][0] = 0.2f;
+    k->R->matrix[1][1] = 0.2f;
+    k->P->matrix[0][0] = 1;
+    k->P->matrix[1][1] = 1;
+}
+
+/********************************************************************************
+*                                                                               *
+* FUNCTION NAME: vRts                                                           *
+*                                                                               *
+* PURPOSE: Reference smoothing of epoch e with the epochs up to last, backward  *
+*           RTS pass in double over the recorded xp, Pp, xf, Pf:                *
+*           C = Pf*A^T*Pp+1^-1, xs = xf + C*(xs+1 - xp+1),                      *
+*           Ps = Pf + C*(Ps+1 - Pp+1)*C^T                                       *
+*                                                                               *
+* ARGUMENT LIST:                                                                *
+*                                                                               *
+* Argument  Type         IO     Description                                     *
+* --------- --------     --     ---------------------------------               *
+* k         kalman*      I      Filter, for A                                   *
+* e         int          I      Epoch to smooth                                 *
+* last      int          I      Newest epoch of the window                      *
+* xs        double[2]    O      Smoothed state                                  *
+* ps        double*      O      Smoothed variance of the position               *
+*                                                                               *
+* RETURN VALUE: void                                                            *
+*                                                                               *
+********************************************************************************/
+static void vRts(const kalman *k, int e, int last, double xs[2], double *ps)
+{
+    const double a = k->A->matrix[0][1];
+    double       P[2][2];
+    double       D[2][2];
+    double       T[2][2];
+    double       C[2][2];
+    double       W[2][2];
+    double       dx[2];
+    double       det;
+    int          j, r, c;
+
+    xs[0] = xf[last][0];
+    xs[1] = xf[last][1];
+    for (r = 0; r < 2; r++)
+    {
+        for (c = 0; c < 2; c++)
+        {
+            P[r][c] = Pf[last][r][c];
+        }
+    }
+    for (j = last - 1; j >= e; j--)
+    {
+        /* T = Pf*A^T, A = [1 a; 0 1] */
+        for (r = 0; r < 2; r++)
+        {
+            T[r][0] = Pf[j][r][0] + a * Pf[j][r][1];
+            T[r][1] = Pf[j][r][1];
+        }
+        det     = Pp[j + 1][0][0] * Pp[j + 1][1][1] - Pp[j + 1][0][1] * Pp[j + 1][1][0];
+        W[0][0] =  Pp[j + 1][1][1] / det;
+        W[0][1] = -Pp[j + 1][0][1] / det;
+        W[1][0] = -Pp[j + 1][1][0] / det;
+        W[1][1] =  Pp[j + 1][0][0] / det;
+        for (r = 0; r < 2; r++)
+        {
+            for (c = 0; c < 2; c++)
+            {
+                C[r][c] = T[r][0] * W[0][c] + T[r][1] * W[1][c];
+                D[r][c] = P[r][c] - Pp[j + 1][r][c];
+            }
+            dx[r] = xs[r] - xp[j + 1][r];
+        }
+        xs[0] = xf[j][0] + C[0][0] * dx[0] + C[0][1] * dx[1];
+        xs[1] = xf[j][1] + C[1][0] * dx[0] + C[1][1] * dx[1];
+        for (r = 0; r < 2; r++)
+        {
+            for (c = 0; c < 2; c++)
+            {
+                T[r][c] = C[r][0] * D[0][c] + C[r][1] * D[1][c];
+            }
+        }
+        for (r = 0; r < 2; r++)
+        {
+            for (c = 0; c < 2; c++)
+            {
+                P[r][c] = Pf[j][r][c] + T[r][0] * C[c][0] + T[r][1] * C[c][1];
+            }
+        }
+    }
+    *ps = P[0][0];
+}
+
+/********************************************************************************
+*                                                                               *
+* FUNCTION NAME: vTest_Smoother                                                 *
+*                                                                               *
+* PURPOSE: Test of KalmanSmoother.c                                             *
+*                                                                               *
+* ARGUMENT LIST:                                                                *
+*                                                                               *
+* Argument  Type         IO     Description                                     *
+* --------- --------     --     ---------------------------------               *
+* none                                                                          *
+*                                                                               *
+* RETURN VALUE: void                                                            *
+*                                                                               *
+********************************************************************************/
+void vTest_Smoother(void)
+{
+    KalmanSmoother s;
+    kalman         k;
+    Matrix        *z = pxCreate(2, 1);
+    double         xs[2];
+    double         ps;
+    double         d;
+    double         ef;
+    double         es;
+    float          t;
+    float          e;
+    Rng            rng;
+    int            fails;
+    int            no;
+    int            ret;
+    int            i, j, r, c;
+
+    vRngSeed(&rng, 39, 0);
+    vSetup(&k);
+    TEST_CHECK(iKalmanSmoother_Init(&s, &k, ST_LAG) == 0);
+
+    /* every epoch leaves the window once, smoothed with the ST_LAG epochs after
+       it, or with those left at the end by the flush */
+    fails = 0;
+    no    = 0;
+    d     = 0;
+    ef    = 0;
+    es    = 0;
+    for (i = 0; i < ST_STEPS + ST_LAG; i++)
+    {
+        if (i < ST_STEPS)
+        {
+            t = (float)i * ST_DT;
+            z->matrix[0][0] = 0.5f * ST_ACC * t * t + 0.45f * fRngNormal(&rng);
+            z->matrix[1][0] = ST_ACC * t            + 0.45f * fRngNormal(&rng);
+            if (i != 0 && iKalmanSmoother_Predict(&s, ST_DT, ST_ACC) != 0)
+            {
+                fails++;
+            }
+            for (r = 0; r < 2; r++)
+            {
+                xp[i][r] = k.x->matrix[r][0];
+                for (c = 0; c < 2; c++)
+                {
+                    Pp[i][r][c] = k.P->matrix[r][c];
+                }
+            }
+            iKalman_Update(&k, z, NULL);
+            for (r = 0; r < 2; r++)
+            {
+                xf[i][r] = k.x->matrix[r][0];
+                for (c = 0; c < 2; c++)
+                {
+                    Pf[i][r][c] = k.P->matrix[r][c];
+                }
+            }
+            e   = k.x->matrix[0][0] - 0.5f * ST_ACC * t * t;
+            ef += (double)e * e;
+            ret = iKalmanSmoother_Push(&s, t);
+        }
+        else
+        {
+            ret = iKalmanSmoother_Flush(&s);
+        }
+        if (ret == 1)
+        {
+            j  = (int)lroundf(s.t_s / ST_DT);
+            fails += (j != no);
+            vRts(&k, no, (i < ST_STEPS) ? i : ST_STEPS - 1, xs, &ps);
+            /* a sum of squares, so that a NaN is not lost */
+            d += pow((s.xs->matrix[0][0] - xs[0]) / (1 + fabs(xs[0])), 2);
+            d += pow((s.xs->matrix[1][0] - xs[1]) / (1 + fabs(xs[1])), 2);
+            d += pow((s.Ps->matrix[0][0] - ps) / ps, 2);
+            e   = s.xs->matrix[0][0] - 0.5f * ST_ACC * s.t_s * s.t_s;
+            es += (double)e * e;
+            no++;
+        }
+    }
+    TEST_CHECK(fails == 0 && no == ST_STEPS);
+    TEST_CHECK(iKalmanSmoother_Flush(&s) == 0);
+    TEST_NEAR(sqrt(d / ST_STEPS), 0, 1e-5);
+    TEST_CHECK(es < ef);
+
+    vDestroy(z);
+    vKalmanSmoother_Destroy(&s);
+    vKalman_Destroy(&k);
+}
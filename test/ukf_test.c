@@ -0,0 +1,274 @@
+/***********************************************************************************
+* This file is part of The AHRS Project.                                           *
+*                                                                                  *
+* Copyright © 2020 By Nicola di Gruttola Giardino. All rights reserved.            *
+* @mail: nicoladgg@protonmail.com                                                  *
+*                                                                                  *
+* AHRS is free software: you can redistribute it and/or modify                     *
+* it under the terms of the GNU General Public License as published by             *
+* the Free Software Foundation, either version 3 of the License, or                *
+* (at your option) any later version.                                              *
+*                                                                                  *
+* AHRS is distributed in the hope that it will be useful,                          *
+* but WITHOUT ANY WARRANTY; without even the implied warranty of                   *
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the                    *
+* GNU General Public License for more details.                                     *
+*                                                                                  *
+* You should have received a copy of the GNU General Public License                *
+* along with The AHRS Project.  If not, see <https://www.gnu.org/licenses/>.       *
+*                                                                                  *
+* In case of use of this project, I ask you to mention me, to whom it may concern. *
+***********************************************************************************/
+
+/****************************************************************************************************
+* FILE NAME: ukf_test.c                                                                             *
+*                                                                                                   *
+* PURPOSE: Test of the unscented filter in its standard and square-root forms: on a linear model    *
+*           both must follow the linear Kalman filter, state and covariance, and a prior that is    *
+*           not positive definite is refused                                                        *
+*                                                                                                   *
+* FILE REFERENCES:                                                                                  *
+*                                                                                                   *
+*   Name    I/O     Description                                                                     *
+*   ----    ---     -----------                                                                     *
+*   none                                                                                            *
+*                                                                                                   *
+* EXTERNAL VARIABLES:                                                                               *
+*                                                                                                   *
+* Source: <unit_test.h>                                                                             *
+*                                                                                                   *
+* Name          Type          IO Description                                                        *
+* ------------- -------       -- -----------------------------                                      *
+*   none                                                                                            *
+*                                                                                                   *
+* STATIC VARIABLES:                                                                                 *
+*                                                                                                   *
+*   Name     Type       I/O      Description                                                        *
+*   ----     ----       ---      -----------                                                        *
+*   none                                                                                            *
+*                                                                                                   *
+* EXTERNAL REFERENCES:                                                                              *
+*                                                                                                   *
+*  Name                       Description                                                           *
+*  -------------              -----------                                                           *
+*  UKF.c                      The functions under test                                              *
+*  Kalman.c                   Reference filter                                                      *
+*  rng.c                      Noise of the track                                                    *
+*                                                                                                   *
+* ABNORMAL TERMINATION CONDITIONS, ERROR AND WARNING MESSAGES:                                      *
+*    none                                                                                           *
+*                                                                                                   *
+* ASSUMPTIONS, CONSTRAINTS, RESTRICTIONS: none                                                      *
+*                                                                                                   *
+* NOTES: the process and measurement callbacks take A, B and H from the reference kalman in ctx     *
+*                                                                                                   *
+* REQUIREMENTS/FUNCTIONAL SPECIFICATIONS REFERENCES:                                                *
+*                                                                                                   *
+* DEVELOPMENT HISTORY:                                                                              *
+*                                                                                                   *
+*   Date          Author            Change Id     Release     Description Of Change                 *
+*   ----          ------            ---------     ------      ----------------------                *
+*   19-10-2026    AHRS Project       1               1         Initial release                      *
+*                                                                                                   *
+****************************************************************************************************/
+
+/* Include Global Parameters */
+
+#include <math.h>
+#include "unit_test.h"
+#include "UKF.h"
+#include "Kalman.h"
+#include "rng.h"
+
+/* Definition of Macros */
+
+#define UT_DT       0.01f
+#define UT_ACC      0.5f
+#define UT_STEPS    300
+
+/* Declare Prototypes */
+
+static void   vSetup     (kalman *);
+static int    iProcess   (UKF *, Matrix *, Matrix *, float);
+static int    iMeasure   (UKF *, Matrix *, Matrix *);
+
+
+/********************************************************************************
+*                                                                               *
+* FUNCTION NAME: vSetup                                                         *
+*                                                                               *
+* PURPOSE: Creates the reference filter, 2 state constant acceleration model    *
+*                                                                               *
+* ARGUMENT LIST:                                                                *
+*                                                                               *
+* Argument  Type         IO     Description                                     *
+* --------- --------     --     ---------------------------------               *
+* k         kalman*      O      Filter                                          *
+*                                                                               *
+* RETURN VALUE: void                                                            *
+*                                                                               *
+********************************************************************************/
+static void vSetup(kalman *k)
+{
+    iKalman_Init(k, 2, 2);
+    k->vModel = NULL;
+    k->dt     = UT_DT;
+    k->A->matrix[0][0] = 1;
+    k->A->matrix[0][1] = UT_DT;
+    k->A->matrix[1][1] = 1;
+    k->B->matrix[0][0] = UT_DT * UT_DT / 2;
+    k->B->matrix[1][0] = UT_DT;
+    k->H->matrix[0][0] = 1;
+    k->H->matrix[1][1] = 1;
+    k->Q->matrix[0][0] = 1e-4f;
+    k->Q->matrix[1][1] = 1e-3f;
+    k->R->matrix[0][0] = 0.2f;
+    k->R->matrix[1][1] = 0.2f;
+    k->P->matrix[0][0] = 1;
+    k->P->matrix[1][1] = 1;
+}
+
+/********************************************************************************
+*                                                                               *
+* FUNCTION NAME: iProcess                                                       *
+*                                                                               *
+* PURPOSE: Process model, Y = A*X + B*u for all the sigma points                *
+*                                                                               *
+* ARGUMENT LIST:                                                                *
+*                                                                               *
+* Argument  Type         IO     Description                                     *
+* --------- --------     --     ---------------------------------               *
+* u         UKF*         I      UKF, ctx is the reference kalman                *
+* Y         Matrix*      O      Propagated sigma points                         *
+* X         Matrix*      I      Sigma points                                    *
+* dt        float        I      Time step, A is built for UT_DT                 *
+*                                                                               *
+* RETURN VALUE: int                                                             *
+*                                                                               *
+********************************************************************************/
+static int iProcess(UKF *u, Matrix *Y, Matrix *X, float dt)
+{
+    kalman      *k = (kalman *)u->ctx;
+    unsigned int i;
+    unsigned int j;
+
+    (void)dt;
+    if (iMultiply(Y, k->A, X) != 0)
+    {
+        return -1;
+    }
+    for (i = 0; i < Y->r; i++)
+    {
+        for (j = 0; j < Y->c; j++)
+            Y->matrix[i][j] += k->B->matrix[i][0] * UT_ACC;
+    }
+
+    return 0;
+}
+
+/********************************************************************************
+*                                                                               *
+* FUNCTION NAME: iMeasure                                                       *
+*                                                                               *
+* PURPOSE: Measurement model, Z = H*X                                           *
+*                                                                               *
+* ARGUMENT LIST:                                                                *
+*                                                                               *
+* Argument  Type         IO     Description                                     *
+* --------- --------     --     ---------------------------------               *
+* u         UKF*         I      UKF, ctx is the reference kalman                *
+* Z         Matrix*      O      Measured sigma points                           *
+* X         Matrix*      I      Sigma points                                    *
+*                                                                               *
+* RETURN VALUE: int                                                             *
+*                                                                               *
+********************************************************************************/
+static int iMeasure(UKF *u, Matrix *Z, Matrix *X)
+{
+    return iMultiply(Z, ((kalman *)u->ctx)->H, X);
+}
+
+/********************************************************************************
+*                                                                               *
+* FUNCTION NAME: vTest_UKF                                                      *
+*                                                                               *
+* PURPOSE: Test of UKF.c                                                        *
+*                                                                               *
+* ARGUMENT LIST:                                                                *
+*                                                                               *
+* Argument  Type         IO     Description                                     *
+* --------- --------     --     ---------------------------------               *
+* none                                                                          *
+*                                                                               *
+* RETURN VALUE: void                                                            *
+*                                                                               *
+********************************************************************************/
+void vTest_UKF(void)
+{
+    UKF     u;
+    kalman  k;
+    Matrix *z = pxCreate(2, 1);
+    Matrix *P = pxCreate(2, 2);
+    float   t;
+    float   p;
+    Rng     rng;
+    int     mode;
+    int     fails;
+    int     i, j, l;
+
+    for (mode = UKF_STANDARD; mode <= UKF_SQRT; mode++)
+    {
+        /* the model is linear: the sigma points give back the Kalman filter */
+        vRngSeed(&rng, 36, 0);
+        vSetup(&k);
+        TEST_CHECK(iUKF_Init(&u, 2, 2, mode, 1.0f, 2.0f, 0.0f) == 0);
+        TEST_CHECK(iUKF_SetState(&u, k.x, k.P) == 0 && iUKF_SetNoise(&u, k.Q, k.R) == 0);
+        u.iProcess = iProcess;
+        u.iMeasure = iMeasure;
+        u.ctx      = &k;
+
+        fails = 0;
+        for (i = 0; i < UT_STEPS; i++)
+        {
+            t = (float)i * UT_DT;
+            z->matrix[0][0] = 0.5f * UT_ACC * t * t + 0.45f * fRngNormal(&rng);
+            z->matrix[1][0] = UT_ACC * t            + 0.45f * fRngNormal(&rng);
+            fails += (iUKF_Predict(&u, UT_DT) != 0) + (iUKF_Update(&u, z) != 0);
+            vKalman_Filter(&k, UT_ACC, z);
+        }
+        TEST_CHECK(fails == 0);
+        TEST_NEAR(u.x->matrix[0][0], k.x->matrix[0][0], 1e-4 * (1 + fabsf(k.x->matrix[0][0])));
+        TEST_NEAR(u.x->matrix[1][0], k.x->matrix[1][0], 1e-4 * (1 + fabsf(k.x->matrix[1][0])));
+
+        /* the covariance: P, or S*S^T in square-root form, where P is not kept */
+        for (i = 0; i < 2; i++)
+        {
+            for (j = 0; j < 2; j++)
+            {
+                p = u.P->matrix[i][j];
+                if (mode == UKF_SQRT)
+                {
+                    p = 0;
+                    for (l = 0; l < 2; l++)
+                    {
+                        p += u.S->matrix[i][l] * u.S->matrix[j][l];
+                    }
+                }
+                TEST_NEAR(p, k.P->matrix[i][j], 1e-4 * k.P->matrix[i][i]);
+            }
+        }
+
+        /* a prior that is not positive definite */
+        P->matrix[0][0] = 1;
+        P->matrix[0][1] = 2;
+        P->matrix[1][0] = 2;
+        P->matrix[1][1] = 1;
+        TEST_CHECK(iUKF_SetState(&u, NULL, P) == -1);
+
+        vUKF_Destroy(&u);
+        vKalman_Destroy(&k);
+    }
+
+    vDestroy(P);
+    vDestroy(z);
+}
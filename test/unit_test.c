@@ -0,0 +1,230 @@
+/***********************************************************************************
+* This file is part of The AHRS Project.                                           *
+*                                                                                  *
+* Copyright © 2020 By Nicola di Gruttola Giardino. All rights reserved.            *
+* @mail: nicoladgg@protonmail.com                                                  *
+*                                                                                  *
+* AHRS is free software: you can redistribute it and/or modify                     *
+* it under the terms of the GNU General Public License as published by             *
+* the Free Software Foundation, either version 3 of the License, or                *
+* (at your option) any later version.                                              *
+*                                                                                  *
+* AHRS is distributed in the hope that it will be useful,                          *
+* but WITHOUT ANY WARRANTY; without even the implied warranty of                   *
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the                    *
+* GNU General Public License for more details.                                     *
+*                                                                                  *
+* You should have received a copy of the GNU General Public License                *
+* along with The AHRS Project.  If not, see <https://www.gnu.org/licenses/>.       *
+*                                                                                  *
+* In case of use of this project, I ask you to mention me, to whom it may concern. *
+***********************************************************************************/
+
+/****************************************************************************************************
+* FILE NAME: unit_test.c                                                                            *
+*                                                                                                   *
+* PURPOSE: Host unit tests of the user libraries: runs the test of every module, or of the          *
+*           modules named on the command line, and counts the failed checks                         *
+*                                                                                                   *
+* FILE REFERENCES:                                                                                  *
+*                                                                                                   *
+*   Name    I/O     Description                                                                     *
+*   ----    ---     -----------                                                                     *
+*   stdout  O       One line per module and per failed check                                        *
+*                                                                                                   *
+* EXTERNAL VARIABLES:                                                                               *
+*                                                                                                   *
+* Source: <unit_test.h>                                                                             *
+*                                                                                                   *
+* Name          Type          IO Description                                                        *
+* ------------- -------       -- -----------------------------                                      *
+*   none                                                                                            *
+*                                                                                                   *
+* STATIC VARIABLES:                                                                                 *
+*                                                                                                   *
+*   Name     Type       I/O      Description                                                        *
+*   ----     ----       ---      -----------                                                        *
+*   tests    TestModule I        The modules, name and test                                         *
+*   checks   uint       IO       Checks run by the current module                                   *
+*   failed   uint       IO       Checks failed by the current module                                *
+*                                                                                                   *
+* EXTERNAL REFERENCES:                                                                              *
+*                                                                                                   *
+*  Name                       Description                                                           *
+*  -------------              -----------                                                           *
+*  vTest_<Module>             <module>_test.c, test of one module                                   *
+*                                                                                                   *
+* ABNORMAL TERMINATION CONDITIONS, ERROR AND WARNING MESSAGES:                                      *
+*    exit status 1 if a check failed or a module is unknown                                         *
+*                                                                                                   *
+* ASSUMPTIONS, CONSTRAINTS, RESTRICTIONS: the modules run one after the other in one process,       *
+*    a test must not rely on the state another one leaves                                           *
+*                                                                                                   *
+* NOTES: see test/Makefile                                                                          *
+*                                                                                                   *
+* REQUIREMENTS/FUNCTIONAL SPECIFICATIONS REFERENCES:                                                *
+*                                                                                                   *
+* DEVELOPMENT HISTORY:                                                                              *
+*                                                                                                   *
+*   Date          Author            Change Id     Release     Description Of Change                 *
+*   ----          ------            ---------     ------      ----------------------                *
+*   19-10-2026    AHRS Project       1               1         Initial release                      *
+*   19-10-2026    AHRS Project       2               1.1       matrix, kalman, madgwick, imu and    *
+*                                                               gps modules                         *
+*   19-10-2026    AHRS Project       3               1.2       eskf, batch, ukf, history,           *
+*                                                               smoother, imm and info modules      *
+*                                                                                                   *
+****************************************************************************************************/
+
+/* Include Global Parameters */
+
+#include <math.h>
+#include <string.h>
+#include "unit_test.h"
+
+/*
+* TestModule Object:
+*       name of a module on the command line and its test
+*/
+
+typedef struct TestModule
+{
+    const char* name;
+    void      (*vTest)(void);
+}TestModule;
+
+/* Define Static Variables */
+
+static const TestModule tests[] =
+{
+    { "matrix",   vTest_Matrix },
+    { "kalman",   vTest_Kalman },
+    { "madgwick", vTest_Madgwick },
+    { "imu",      vTest_IMU },
+    { "gps",      vTest_GPS },
+    { "probe",    vTest_Probe },
+    { "eskf",     vTest_ESKF },
+    { "batch",    vTest_Batch },
+    { "ukf",      vTest_UKF },
+    { "history",  vTest_History },
+    { "smoother", vTest_Smoother },
+    { "imm",      vTest_IMM },
+    { "info",     vTest_Info },
+};
+
+static unsigned int checks;
+static unsigned int failed;
+
+
+/********************************************************************************
+*                                                                               *
+* FUNCTION NAME: vTest_Check                                                    *
+*                                                                               *
+* PURPOSE: Counts a check of the current module, printing it if it failed       *
+*                                                                               *
+* ARGUMENT LIST:                                                                *
+*                                                                               *
+* Argument  Type         IO     Description                                     *
+* --------- --------     --     ---------------------------------               *
+* ok        int          I      0 if the check failed                           *
+* what      const char*  I      Checked expression                              *
+* file      const char*  I      Source file of the check                        *
+* line      int          I      Its line                                        *
+*                                                                               *
+* RETURN VALUE: void                                                            *
+*                                                                               *
+********************************************************************************/
+void vTest_Check(int ok, const char *what, const char *file, int line)
+{
+    checks++;
+    if (!ok)
+    {
+        failed++;
+        printf("FAIL %s:%d: %s\n", file, line, what);
+    }
+}
+
+/********************************************************************************
+*                                                                               *
+* FUNCTION NAME: vTest_Near                                                     *
+*                                                                               *
+* PURPOSE: Counts a check that a is within tol of b, printing both if not; a    *
+*           NaN fails                                                           *
+*                                                                               *
+* ARGUMENT LIST:                                                                *
+*                                                                               *
+* Argument  Type         IO     Description                                     *
+* --------- --------     --     ---------------------------------               *
+* a         double       I      Value                                           *
+* b         double       I      Expected value                                  *
+* tol       double       I      Largest allowed |a - b|                         *
+* what      const char*  I      Checked expressions                             *
+* file      const char*  I      Source file of the check                        *
+* line      int          I      Its line                                        *
+*                                                                               *
+* RETURN VALUE: void                                                            *
+*                                                                               *
+********************************************************************************/
+void vTest_Near(double a, double b, double tol, const char *what, const char *file, int line)
+{
+    checks++;
+    if (!(fabs(a - b) <= tol))
+    {
+        failed++;
+        printf("FAIL %s:%d: %s, %.9g vs %.9g (tolerance %.3g)\n", file, line, what, a, b, tol);
+    }
+}
+
+/*
+ *=============================================================================*
+ *                               HOST EXECUTABLE                               *
+ *=============================================================================*
+ */
+
+int main(int argc, char **argv)
+{
+    const size_t n = sizeof(tests) / sizeof(tests[0]);
+    unsigned int total  = 0;
+    unsigned int broken = 0;
+    int          bad    = 0;
+    size_t       i;
+    int          j;
+
+    for (j = 1; j < argc; j++)
+    {
+        for (i = 0; i < n && strcmp(argv[j], tests[i].name) != 0; i++)
+        {
+        }
+        if (i == n)
+        {
+            fprintf(stderr, "usage: %s [module...]\n  modules:", argv[0]);
+            for (i = 0; i < n; i++)
+            {
+                fprintf(stderr, " %s", tests[i].name);
+            }
+            fprintf(stderr, " (all of them)\n");
+            return 1;
+        }
+    }
+
+    for (i = 0; i < n; i++)
+    {
+        for (j = 1; j < argc && strcmp(argv[j], tests[i].name) != 0; j++)
+        {
+        }
+        if (argc > 1 && j == argc)
+        {
+            continue;
+        }
+        checks = 0;
+        failed = 0;
+        tests[i].vTest();
+        printf("%-9s %4u checks, %u failed\n", tests[i].name, checks, failed);
+        total  += checks;
+        broken += failed;
+        bad    |= (failed != 0 || checks == 0);
+    }
+    printf("%u checks, %u failed\n", total, broken);
+
+    return bad;
+}
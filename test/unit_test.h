@@ -0,0 +1,85 @@
+/***********************************************************************************
+* This file is part of The AHRS Project.                                           *
+*                                                                                  *
+* Copyright © 2020 By Nicola di Gruttola Giardino. All rights reserved.            *
+* @mail: nicoladgg@protonmail.com                                                  *
+*                                                                                  *
+* AHRS is free software: you can redistribute it and/or modify                     *
+* it under the terms of the GNU General Public License as published by             *
+* the Free Software Foundation, either version 3 of the License, or                *
+* (at your option) any later version.                                              *
+*                                                                                  *
+* AHRS is distributed in the hope that it will be useful,                          *
+* but WITHOUT ANY WARRANTY; without even the implied warranty of                   *
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the                    *
+* GNU General Public License for more details.                                     *
+*                                                                                  *
+* You should have received a copy of the GNU General Public License                *
+* along with The AHRS Project.  If not, see <https://www.gnu.org/licenses/>.       *
+*                                                                                  *
+* In case of use of this project, I ask you to mention me, to whom it may concern. *
+***********************************************************************************/
+
+/***************************************************************************************************
+*   FILENAME:  unit_test.h                                                                         *
+*                                                                                                  *
+*                                                                                                  *
+*   PURPOSE:   Checks of the host unit tests and the test of every module, run by ahrs_test        *
+*                                                                                                  *
+*                                                                                                  *
+*                                                                                                  *
+*   GLOBAL VARIABLES:                                                                              *
+*                                                                                                  *
+*                                                                                                  *
+*   Variable        Type        Description                                                        *
+*   --------        ----        -------------------                                                *
+*   TEST_CHECK      macro       Fails the test if the condition is false                           *
+*   TEST_NEAR       macro       Fails the test if two values differ by more than a tolerance       *
+*                                                                                                  *
+*   DEVELOPMENT HISTORY :                                                                          *
+*                                                                                                  *
+*                                                                                                  *
+*   Date          Author            Change Id     Release     Description Of Change                *
+*   ----          ------            -------- -    ------      ----------------------               *
+*   19-10-2026    AHRS Project       1               1         Initial release                     *
+*   19-10-2026    AHRS Project       2               1.1       matrix, kalman, madgwick, imu and   *
+*                                                               gps modules                        *
+*   19-10-2026    AHRS Project       3               1.2       eskf, batch, ukf, history,          *
+*                                                               smoother, imm and info modules     *
+*                                                                                                  *
+***************************************************************************************************/
+
+#ifndef UNIT_TEST_h
+#define UNIT_TEST_h
+
+/* Include Global Parameters */
+
+#include <stdio.h>
+
+/* Definition of Macros */
+
+#define TEST_CHECK(c)           vTest_Check((c) != 0, #c, __FILE__, __LINE__)
+#define TEST_NEAR(a, b, tol)    vTest_Near((double)(a), (double)(b), (double)(tol), \
+                                           #a " ~ " #b, __FILE__, __LINE__)
+
+/* Declare Prototypes */
+
+void  vTest_Check     (int, const char *, const char *, int);
+void  vTest_Near      (double, double, double, const char *, const char *, int);
+
+/* the modules, in the order ahrs_test runs them */
+void  vTest_Matrix    (void);
+void  vTest_Kalman    (void);
+void  vTest_Madgwick  (void);
+void  vTest_IMU       (void);
+void  vTest_GPS       (void);
+void  vTest_Probe     (void);
+void  vTest_ESKF      (void);
+void  vTest_Batch     (void);
+void  vTest_UKF       (void);
+void  vTest_History   (void);
+void  vTest_Smoother  (void);
+void  vTest_IMM       (void);
+void  vTest_Info      (void);
+
+#endif /* UNIT_TEST_h */
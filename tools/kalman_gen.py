@@ -0,0 +1,363 @@
+#!/usr/bin/env python3
+###################################################################################
+# This file is part of The AHRS Project.                                          #
+#                                                                                 #
+# Copyright (c) 2020 By Nicola di Gruttola Giardino. All rights reserved.         #
+# @mail: nicoladgg@protonmail.com                                                 #
+#                                                                                 #
+# AHRS is free software: you can redistribute it and/or modify                    #
+# it under the terms of the GNU General Public License as published by            #
+# the Free Software Foundation, either version 3 of the License, or               #
+# (at your option) any later version.                                             #
+#                                                                                 #
+# AHRS is distributed in the hope that it will be useful,                         #
+# but WITHOUT ANY WARRANTY; without even the implied warranty of                  #
+# MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the                   #
+# GNU General Public License for more details.                                    #
+#                                                                                 #
+# You should have received a copy of the GNU General Public License               #
+# along with The AHRS Project.  If not, see <https://www.gnu.org/licenses/>.      #
+###################################################################################
+"""Generates a straight-line Kalman filter for one fixed linear model.
+
+The model is a JSON file (see tools/cv2.json):
+
+    name   suffix of the generated type and functions, e.g. "CV2"
+    n, m   number of states and of measurements
+    A      n x n strings, "0", "1" or a C expression of dt
+    B      n strings, same rules, the control input is one scalar u
+    H      m x n strings, same rules
+
+Q and R are always diagonal and stay run-time fields of the generated
+struct, as does dt. Every entry that is exactly 0 or 1 is folded away,
+every other product and sum is computed once (common subexpression
+elimination) and P is kept symmetric, computing only its upper triangle.
+The measurement update is sequential, one scalar component at a time,
+so it needs one division per component and no factorization.
+
+usage: kalman_gen.py model.json out_dir
+"""
+
+import json
+import os
+import re
+import sys
+
+
+class Emitter:
+    """Straight-line code with constant folding and CSE on expression text."""
+
+    def __init__(self):
+        self.lines = []
+        self.seen = {}
+        self.count = 0
+
+    def temp(self, expr):
+        if expr in ("0", "1") or expr.isidentifier():
+            return expr
+        if expr not in self.seen:
+            name = "t%d" % self.count
+            self.count += 1
+            self.seen[expr] = name
+            self.lines.append("    const float %s = %s;" % (name, expr))
+        return self.seen[expr]
+
+    def mul(self, a, b):
+        if a == "0" or b == "0":
+            return "0"
+        if a == "1":
+            return b
+        if b == "1":
+            return a
+        a, b = sorted((a, b))
+        return self.temp("%s * %s" % (a, b))
+
+    def add(self, terms):
+        terms = [t for t in terms if t != "0"]
+        if not terms:
+            return "0"
+        if len(terms) == 1:
+            return terms[0]
+        return self.temp(" + ".join(sorted(terms)))
+
+
+def prune(lines):
+    """Drops the const temporaries nothing reads, e.g. the entries of A*P
+    only multiplied by a 0 of A^T, until every one left is used."""
+    decl = re.compile(r"^\s*const float (\w+) = ")
+    while True:
+        text = "\n".join(lines)
+        dead = set()
+        for line in lines:
+            d = decl.match(line)
+            if d and len(re.findall(r"\b%s\b" % d.group(1), text)) == 1:
+                dead.add(line)
+        if not dead:
+            return lines
+        lines = [line for line in lines if line not in dead]
+
+
+def generate(model):
+    name = model["name"]
+    n = model["n"]
+    m = model["m"]
+    ctype = "KalmanGen_%s" % name
+
+    def sym(i, j):
+        return (i, j) if i <= j else (j, i)
+
+    # ------------------------------------------------------------- predict
+    e = Emitter()
+    A = [[e.temp(v) if v not in ("0", "1") else v for v in row] for row in model["A"]]
+    B = [e.temp(v) if v not in ("0", "1") else v for v in model["B"]]
+    x = ["x%d" % i for i in range(n)]
+    P = {}
+    for i in range(n):
+        for j in range(i, n):
+            P[(i, j)] = "p%d%d" % (i, j)
+
+    pre = []
+    for i in range(n):
+        pre.append("    const float x%d = k->x[%d];" % (i, i))
+    for (i, j) in sorted(P):
+        pre.append("    const float p%d%d = k->P[%d][%d];" % (i, j, i, j))
+
+    xn = []
+    for i in range(n):
+        xn.append(e.add([e.mul(A[i][l], x[l]) for l in range(n)] + [e.mul(B[i], "u")]))
+    AP = [[e.add([e.mul(A[i][l], P[sym(l, j)]) for l in range(n)]) for j in range(n)] for i in range(n)]
+    Pn = {}
+    for i in range(n):
+        for j in range(i, n):
+            terms = [e.mul(AP[i][l], A[j][l]) for l in range(n)]
+            if i == j:
+                terms.append("k->q[%d]" % i)
+            Pn[(i, j)] = e.add(terms)
+
+    post = []
+    for i in range(n):
+        post.append("    k->x[%d] = %s;" % (i, xn[i]))
+    for (i, j) in sorted(Pn):
+        post.append("    k->P[%d][%d] = %s;" % (i, j, Pn[(i, j)]))
+        if i != j:
+            post.append("    k->P[%d][%d] = %s;" % (j, i, Pn[(i, j)]))
+    predict = prune(pre + e.lines + post)
+    if all(b == "0" for b in B):
+        predict = ["    (void)u;", ""] + predict
+    if any(re.search(r"\bdt\b", line) for line in predict):
+        predict = ["    const float dt = k->dt;", ""] + predict
+
+    # -------------------------------------------------------------- update
+    e = Emitter()
+    H = [[e.temp(v) if v not in ("0", "1") else v for v in row] for row in model["H"]]
+    x = ["x%d" % i for i in range(n)]
+    P = {}
+    for i in range(n):
+        for j in range(i, n):
+            P[(i, j)] = "p%d%d" % (i, j)
+    update = list(e.lines)
+    for i in range(n):
+        update.append("    float x%d = k->x[%d];" % (i, i))
+    for (i, j) in sorted(P):
+        update.append("    float p%d%d = k->P[%d][%d];" % (i, j, i, j))
+    update.append("")
+
+    for c in range(m):
+        e.lines = []
+        e.seen = {}
+        ph = [e.add([e.mul(P[sym(j, l)], H[c][l]) for l in range(n)]) for j in range(n)]
+        # P is updated in place below: P*h^T must be a snapshot, not the p names
+        for j in range(n):
+            if ph[j] != "0":
+                e.lines.append("    const float h%d_%d = %s;" % (c, j, ph[j]))
+                ph[j] = "h%d_%d" % (c, j)
+        s = [e.mul(H[c][j], ph[j]) for j in range(n)]
+        s = " + ".join([t for t in s if t != "0"] + ["k->r[%d]" % c])
+        hx = e.add([e.mul(H[c][j], x[j]) for j in range(n)])
+        body = ["    /* component %d */" % c,
+                "    if (valid == NULL || valid[%d])" % c,
+                "    {"]
+        body += ["    " + line for line in e.lines]
+        body.append("        const float s%d = %s;" % (c, s))
+        body.append("        const float i%d = 1.0f / s%d;" % (c, c))
+        body.append("        const float e%d = z[%d] - %s;" % (c, c, hx))
+        gains = []
+        for j in range(n):
+            if ph[j] == "0":
+                gains.append("0")
+                continue
+            body.append("        const float g%d_%d = %s * i%d;" % (c, j, ph[j], c))
+            gains.append("g%d_%d" % (c, j))
+        for j in range(n):
+            if gains[j] != "0":
+                body.append("        x%d += g%d_%d * e%d;" % (j, c, j, c))
+        for (j, l) in sorted(P):
+            if gains[j] != "0" and ph[l] != "0":
+                body.append("        p%d%d -= g%d_%d * %s;" % (j, l, c, j, ph[l]))
+        body.append("        k->y[%d] = e%d;" % (c, c))
+        body.append("    }")
+        body.append("")
+        update += body
+
+    for i in range(n):
+        update.append("    k->x[%d] = x%d;" % (i, i))
+    for (i, j) in sorted(P):
+        update.append("    k->P[%d][%d] = p%d%d;" % (i, j, i, j))
+        if i != j:
+            update.append("    k->P[%d][%d] = p%d%d;" % (j, i, i, j))
+
+    update = prune(update)
+    if any(re.search(r"\bdt\b", line) for line in update):
+        update = ["    const float dt = k->dt;", ""] + update
+
+    return ctype, predict, update
+
+
+HEADER = """\
+/***********************************************************************************
+* This file is part of The AHRS Project.                                           *
+*                                                                                  *
+* Copyright © 2020 By Nicola di Gruttola Giardino. All rights reserved.            *
+* @mail: nicoladgg@protonmail.com                                                  *
+*                                                                                  *
+* AHRS is free software: you can redistribute it and/or modify                     *
+* it under the terms of the GNU General Public License as published by             *
+* the Free Software Foundation, either version 3 of the License, or                *
+* (at your option) any later version.                                              *
+*                                                                                  *
+* AHRS is distributed in the hope that it will be useful,                          *
+* but WITHOUT ANY WARRANTY; without even the implied warranty of                   *
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the                    *
+* GNU General Public License for more details.                                     *
+*                                                                                  *
+* You should have received a copy of the GNU General Public License                *
+* along with The AHRS Project.  If not, see <https://www.gnu.org/licenses/>.       *
+*                                                                                  *
+* In case of use of this project, I ask you to mention me, to whom it may concern. *
+***********************************************************************************/
+
+/*
+* GENERATED by tools/kalman_gen.py from tools/%(src)s, do not edit:
+* change the model and run  python3 tools/kalman_gen.py tools/%(src)s usrlib
+*/
+"""
+
+
+def box(lines):
+    """Function doc block of the repo, 81 columns wide."""
+    out = ["/" + "*" * 80]
+    for line in lines:
+        out.append(("* " + line).ljust(80) + "*")
+    out.append("*" * 80 + "/")
+    return "\n".join(out)
+
+
+def write(model, src, out_dir):
+    ctype, predict, update = generate(model)
+    name = model["name"]
+    n = model["n"]
+    m = model["m"]
+    base = "KalmanGen_%s" % name
+    guard = "%s_h" % base
+
+    h = HEADER % {"src": src}
+    h += """
+#ifndef %(guard)s
+#define %(guard)s
+
+/* Include Global Parameters */
+
+#include <stddef.h>
+
+/*
+* %(ctype)s Object:
+*       x the state, P its covariance, q and r the diagonals of Q and R,
+*       y the innovation of the last update, dt the sampling period
+*/
+
+typedef struct %(ctype)s
+{
+    float dt;
+    float x[%(n)d];
+    float P[%(n)d][%(n)d];
+    float q[%(n)d];
+    float r[%(m)d];
+    float y[%(m)d];
+}%(ctype)s;
+
+/* Declare Prototypes */
+
+void  v%(ctype)s_Predict  (%(ctype)s *, float);
+void  v%(ctype)s_Update   (%(ctype)s *, const float *, const unsigned char *);
+
+#endif /* %(guard)s */
+""" % {"guard": guard, "ctype": ctype, "n": n, "m": m}
+
+    c = HEADER % {"src": src}
+    c += """
+/* Include Global Parameters */
+
+#include "%(base)s.h"
+
+%(doc_predict)s
+void v%(ctype)s_Predict(%(ctype)s *k, float u)
+{
+%(predict)s
+}
+
+%(doc_update)s
+void v%(ctype)s_Update(%(ctype)s *k, const float *z, const unsigned char *valid)
+{
+%(update)s
+}
+""" % {"base": base, "ctype": ctype, "m": m,
+       "doc_predict": box(["",
+                           "FUNCTION NAME: v%s_Predict" % ctype,
+                           "",
+                           "PURPOSE: x=A*x + B*u, P=A*P*A^T + Q",
+                           "",
+                           "ARGUMENT LIST:",
+                           "",
+                           "Argument  Type         IO     Description",
+                           "--------- --------     --     ---------------------------------",
+                           "k         KalmanGen*   IO     Filter %s" % name,
+                           "u         float        I      Control input",
+                           "",
+                           "RETURN VALUE: void",
+                           ""]),
+       "doc_update": box(["",
+                          "FUNCTION NAME: v%s_Update" % ctype,
+                          "",
+                          "PURPOSE: Sequential scalar measurement update, components whose valid",
+                          "          flag is 0 are skipped",
+                          "",
+                          "ARGUMENT LIST:",
+                          "",
+                          "Argument  Type         IO     Description",
+                          "--------- --------     --     ---------------------------------",
+                          "k         KalmanGen*   IO     Filter %s" % name,
+                          "z         const float* I      Measurement, %d components" % m,
+                          "valid     uchar*       I      %d flags, 0 to skip one, NULL for all" % m,
+                          "",
+                          "RETURN VALUE: void",
+                          ""]),
+       "predict": "\n".join(predict), "update": "\n".join(update)}
+
+    with open(os.path.join(out_dir, base + ".h"), "w") as f:
+        f.write(h)
+    with open(os.path.join(out_dir, base + ".c"), "w") as f:
+        f.write(c)
+
+
+def main(argv):
+    if len(argv) != 3:
+        sys.stderr.write("usage: %s model.json out_dir\n" % argv[0])
+        return 2
+    with open(argv[1]) as f:
+        model = json.load(f)
+    write(model, os.path.basename(argv[1]), argv[2])
+    return 0
+
+
+if __name__ == "__main__":
+    sys.exit(main(sys.argv))
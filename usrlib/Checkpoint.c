@@ -0,0 +1,450 @@
+/***********************************************************************************
+* This file is part of The AHRS Project.                                           *
+*                                                                                  *
+* Copyright © 2020 By Nicola di Gruttola Giardino. All rights reserved.            *
+* @mail: nicoladgg@protonmail.com                                                  *
+*                                                                                  *
+* AHRS is free software: you can redistribute it and/or modify                     *
+* it under the terms of the GNU General Public License as published by             *
+* the Free Software Foundation, either version 3 of the License, or                *
+* (at your option) any later version.                                              *
+*                                                                                  *
+* AHRS is distributed in the hope that it will be useful,                          *
+* but WITHOUT ANY WARRANTY; without even the implied warranty of                   *
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the                    *
+* GNU General Public License for more details.                                     *
+*                                                                                  *
+* You should have received a copy of the GNU General Public License                *
+* along with The AHRS Project.  If not, see <https://www.gnu.org/licenses/>.       *
+*                                                                                  *
+* In case of use of this project, I ask you to mention me, to whom it may concern. *
+***********************************************************************************/
+
+/****************************************************************************************************
+* FILE NAME: Checkpoint.c                                                                           *
+*                                                                                                   *
+* PURPOSE: Saves and restores the checkpoint record. The store holds CHECKPOINT_SLOTS records,      *
+*           written in turn; the restore takes the valid record with the highest sequence number,   *
+*           a record is valid if magic, version, size and CRC-32 match                              *
+*                                                                                                   *
+* FILE REFERENCES:                                                                                  *
+*                                                                                                   *
+*   Name    I/O     Description                                                                     *
+*   ----    ---     -----------                                                                     *
+*   path    IO      Checkpoint file of the host backend                                             *
+*                                                                                                   *
+*                                                                                                   *
+* EXTERNAL VARIABLES:                                                                               *
+*                                                                                                   *
+* Source: <Checkpoint.h>                                                                            *
+*                                                                                                   *
+* Name          Type              IO Description                                                    *
+* ------------- -------           -- -----------------------------                                  *
+*   r           CheckpointRecord     Record                                                         *
+*   s           CheckpointStore      Backend                                                        *
+*                                                                                                   *
+* STATIC VARIABLES:                                                                                 *
+*                                                                                                   *
+*   Name     Type       I/O      Description                                                        *
+*   ----     ----       ---      -----------                                                        *
+*   crc_tab  uint32_t[]          CRC-32 of each nibble, 64 bytes of flash                           *
+*                                                                                                   *
+* EXTERNAL REFERENCES:                                                                              *
+*                                                                                                   *
+*  Name                       Description                                                           *
+*  -------------              -----------                                                           *
+*  none                                                                                             *
+*                                                                                                   *
+* ABNORMAL TERMINATION CONDITIONS, ERROR AND WARNING MESSAGES:                                      *
+*    iCheckpoint_Load fails if no slot holds a valid record of this version, the caller then        *
+*    keeps its defaults                                                                             *
+*                                                                                                   *
+* ASSUMPTIONS, CONSTRAINTS, RESTRICTIONS: the record is stored in the byte order and float format   *
+*    of the writer, it is read back by the same firmware                                            *
+*                                                                                                   *
+* NOTES: CRC-32 is the IEEE 802.3 polynomial (reflected 0xEDB88320), computed a nibble at a time    *
+*                                                                                                   *
+* REQUIREMENTS/FUNCTIONAL SPECIFICATIONS REFERENCES:                                                *
+*                                                                                                   *
+* DEVELOPMENT HISTORY:                                                                              *
+*                                                                                                   *
+*   Date          Author            Change Id     Release     Description Of Change                 *
+*   ----          ------            ---------     ------      ----------------------                *
+*   19-10-2026    AHRS Project       1               1         Initial release                      *
+*                                                                                                   *
+****************************************************************************************************/
+
+/* Include Global Parameters */
+
+#include <string.h>
+#include "Checkpoint.h"
+
+#if !defined(__ARM_ARCH_7EM__)
+#include <stdio.h>
+#endif
+
+/* Static variables */
+
+static const uint32_t crc_tab[16] =
+{
+    0x00000000UL, 0x1DB71064UL, 0x3B6E20C8UL, 0x26D930ACUL,
+    0x76DC4190UL, 0x6B6B51F4UL, 0x4DB26158UL, 0x5005713CUL,
+    0xEDB88320UL, 0xF00F9344UL, 0xD6D6A3E8UL, 0xCB61B38CUL,
+    0x9B64C2B0UL, 0x86D3D2D4UL, 0xA00AE278UL, 0xBDBDF21CUL
+};
+
+/* Declare Prototypes */
+
+static int  iValid    (const CheckpointRecord *);
+static int  iMemRead  (void *, size_t, void *, size_t);
+static int  iMemWrite (void *, size_t, const void *, size_t);
+#if !defined(__ARM_ARCH_7EM__)
+static int  iFileRead (void *, size_t, void *, size_t);
+static int  iFileWrite(void *, size_t, const void *, size_t);
+#endif
+
+
+/********************************************************************************
+*                                                                               *
+* FUNCTION NAME: uCheckpoint_Crc32                                              *
+*                                                                               *
+* PURPOSE: CRC-32 (IEEE 802.3) of len bytes                                     *
+*                                                                               *
+* ARGUMENT LIST:                                                                *
+*                                                                               *
+* Argument  Type         IO     Description                                     *
+* --------- --------     --     ---------------------------------               *
+* buf       const void*  I      Data                                            *
+* len       size_t       I      Number of bytes                                 *
+*                                                                               *
+* RETURN VALUE: uint32_t                                                        *
+*                                                                               *
+********************************************************************************/
+uint32_t uCheckpoint_Crc32(const void *buf, size_t len)
+{
+    const uint8_t *p   = (const uint8_t *)buf;
+    uint32_t       crc = 0xFFFFFFFFUL;
+
+    while (len--)
+    {
+        crc ^= *p++;
+        crc  = (crc >> 4) ^ crc_tab[crc & 0x0F];
+        crc  = (crc >> 4) ^ crc_tab[crc & 0x0F];
+    }
+
+    return crc ^ 0xFFFFFFFFUL;
+}
+
+/********************************************************************************
+*                                                                               *
+* FUNCTION NAME: iValid                                                         *
+*                                                                               *
+* PURPOSE: Checks the header and the CRC of a record read back                  *
+*           returning 1 if valid, 0 if not                                      *
+*                                                                               *
+* ARGUMENT LIST:                                                                *
+*                                                                               *
+* Argument  Type         IO     Description                                     *
+* --------- --------     --     ---------------------------------               *
+* r         CheckpointRec* I    Record                                          *
+*                                                                               *
+* RETURN VALUE: int                                                             *
+********************************************************************************/
+static int iValid(const CheckpointRecord *r)
+{
+    return r->magic   == CHECKPOINT_MAGIC &&
+           r->version == CHECKPOINT_VERSION &&
+           r->size    == sizeof(CheckpointRecord) &&
+           r->crc     == uCheckpoint_Crc32(r, offsetof(CheckpointRecord, crc));
+}
+
+/********************************************************************************
+*                                                                               *
+* FUNCTION NAME: iCheckpoint_Save                                               *
+*                                                                               *
+* PURPOSE: Fills in the header and the CRC of r and writes it to the slot after *
+*           the last one written                                                *
+*           returning -1 if failed, 0 if successfull                            *
+*                                                                               *
+* ARGUMENT LIST:                                                                *
+*                                                                               *
+* Argument  Type         IO     Description                                     *
+* --------- --------     --     ---------------------------------               *
+* s         CheckpointSt* IO    Store                                           *
+* r         CheckpointRec* IO   Record, the payload filled in by the caller     *
+*                                                                               *
+* RETURN VALUE: int                                                             *
+*                                                                               *
+********************************************************************************/
+int iCheckpoint_Save(CheckpointStore *s, CheckpointRecord *r)
+{
+    if (s == NULL || r == NULL || s->iWrite == NULL)
+    {
+        return -1;
+    }
+
+    r->magic   = CHECKPOINT_MAGIC;
+    r->version = CHECKPOINT_VERSION;
+    r->size    = sizeof(CheckpointRecord);
+    r->seq     = s->seq + 1;
+    r->crc     = uCheckpoint_Crc32(r, offsetof(CheckpointRecord, crc));
+
+    if (s->iWrite(s->ctx, (r->seq % CHECKPOINT_SLOTS) * sizeof(CheckpointRecord),
+                  r, sizeof(CheckpointRecord)) != 0)
+    {
+        return -1;
+    }
+    s->seq = r->seq;
+
+    return 0;
+}
+
+/********************************************************************************
+*                                                                               *
+* FUNCTION NAME: iCheckpoint_Load                                               *
+*                                                                               *
+* PURPOSE: Reads every slot and keeps the valid record with the highest         *
+*           sequence number, which the next save follows                        *
+*           returning -1 if no slot is valid, 0 if successfull                  *
+*                                                                               *
+* ARGUMENT LIST:                                                                *
+*                                                                               *
+* Argument  Type         IO     Description                                     *
+* --------- --------     --     ---------------------------------               *
+* s         CheckpointSt* IO    Store                                           *
+* r         CheckpointRec* O    Record, untouched if failed                     *
+*                                                                               *
+* RETURN VALUE: int                                                             *
+*                                                                               *
+********************************************************************************/
+int iCheckpoint_Load(CheckpointStore *s, CheckpointRecord *r)
+{
+    CheckpointRecord tmp;
+    unsigned int     i;
+    int              found = 0;
+
+    if (s == NULL || r == NULL || s->iRead == NULL)
+    {
+        return -1;
+    }
+
+    for (i = 0; i < CHECKPOINT_SLOTS; i++)
+    {
+        if (s->iRead(s->ctx, i * sizeof(CheckpointRecord), &tmp, sizeof(tmp)) != 0 ||
+            !iValid(&tmp))
+        {
+            continue;
+        }
+        /* wrap-safe: tmp is newer if it is less than 2^31 ahead */
+        if (!found || (int32_t)(tmp.seq - r->seq) > 0)
+        {
+            *r    = tmp;
+            found = 1;
+        }
+    }
+    if (!found)
+    {
+        return -1;
+    }
+    s->seq = r->seq;
+
+    return 0;
+}
+
+/********************************************************************************
+*                                                                               *
+* FUNCTION NAME: iMemRead                                                       *
+*                                                                               *
+* PURPOSE: Read of the memory backend                                           *
+*           returning -1 if out of the region, 0 if successfull                 *
+*                                                                               *
+* ARGUMENT LIST:                                                                *
+*                                                                               *
+* Argument  Type         IO     Description                                     *
+* --------- --------     --     ---------------------------------               *
+* ctx       void*        I      CheckpointMem                                   *
+* off       size_t       I      Byte offset in the region                       *
+* buf       void*        O      Destination                                     *
+* len       size_t       I      Number of bytes                                 *
+*                                                                               *
+* RETURN VALUE: int                                                             *
+********************************************************************************/
+static int iMemRead(void *ctx, size_t off, void *buf, size_t len)
+{
+    CheckpointMem *m = (CheckpointMem *)ctx;
+    uint8_t       *d = (uint8_t *)buf;
+    size_t         i;
+
+    if (off + len > m->size)
+    {
+        return -1;
+    }
+    for (i = 0; i < len; i++)
+    {
+        d[i] = m->base[off + i];
+    }
+
+    return 0;
+}
+
+/********************************************************************************
+*                                                                               *
+* FUNCTION NAME: iMemWrite                                                      *
+*                                                                               *
+* PURPOSE: Write of the memory backend                                          *
+*           returning -1 if out of the region, 0 if successfull                 *
+*                                                                               *
+* ARGUMENT LIST:                                                                *
+*                                                                               *
+* Argument  Type         IO     Description                                     *
+* --------- --------     --     ---------------------------------               *
+* ctx       void*        I      CheckpointMem                                   *
+* off       size_t       I      Byte offset in the region                       *
+* buf       const void*  I      Source                                          *
+* len       size_t       I      Number of bytes                                 *
+*                                                                               *
+* RETURN VALUE: int                                                             *
+********************************************************************************/
+static int iMemWrite(void *ctx, size_t off, const void *buf, size_t len)
+{
+    CheckpointMem *m = (CheckpointMem *)ctx;
+    const uint8_t *d = (const uint8_t *)buf;
+    size_t         i;
+
+    if (off + len > m->size)
+    {
+        return -1;
+    }
+    for (i = 0; i < len; i++)
+    {
+        m->base[off + i] = d[i];
+    }
+
+    return 0;
+}
+
+/********************************************************************************
+*                                                                               *
+* FUNCTION NAME: vCheckpoint_MemStore                                           *
+*                                                                               *
+* PURPOSE: Store on a memory region that survives a reset, e.g. the backup      *
+*           SRAM, which the caller powers and unlocks beforehand                *
+*                                                                               *
+* ARGUMENT LIST:                                                                *
+*                                                                               *
+* Argument  Type         IO     Description                                     *
+* --------- --------     --     ---------------------------------               *
+* s         CheckpointSt* O     Store                                           *
+* m         CheckpointMem* I    Region, CHECKPOINT_SLOTS records at least       *
+*                                                                               *
+* RETURN VALUE: void                                                            *
+*                                                                               *
+********************************************************************************/
+void vCheckpoint_MemStore(CheckpointStore *s, CheckpointMem *m)
+{
+    s->iRead  = iMemRead;
+    s->iWrite = iMemWrite;
+    s->ctx    = m;
+    s->seq    = 0;
+}
+
+#if !defined(__ARM_ARCH_7EM__)
+
+/********************************************************************************
+*                                                                               *
+* FUNCTION NAME: iFileRead                                                      *
+*                                                                               *
+* PURPOSE: Read of the file backend                                             *
+*           returning -1 if failed, 0 if successfull                            *
+*                                                                               *
+* ARGUMENT LIST:                                                                *
+*                                                                               *
+* Argument  Type         IO     Description                                     *
+* --------- --------     --     ---------------------------------               *
+* ctx       void*        I      Path of the file                                *
+* off       size_t       I      Byte offset in the file                         *
+* buf       void*        O      Destination                                     *
+* len       size_t       I      Number of bytes                                 *
+*                                                                               *
+* RETURN VALUE: int                                                             *
+********************************************************************************/
+static int iFileRead(void *ctx, size_t off, void *buf, size_t len)
+{
+    FILE *f = fopen((const char *)ctx, "rb");
+    int   ret;
+
+    if (f == NULL)
+    {
+        return -1;
+    }
+    ret = (fseek(f, (long)off, SEEK_SET) == 0 && fread(buf, 1, len, f) == len) ? 0 : -1;
+    fclose(f);
+
+    return ret;
+}
+
+/********************************************************************************
+*                                                                               *
+* FUNCTION NAME: iFileWrite                                                     *
+*                                                                               *
+* PURPOSE: Write of the file backend, the file is created if missing            *
+*           returning -1 if failed, 0 if successfull                            *
+*                                                                               *
+* ARGUMENT LIST:                                                                *
+*                                                                               *
+* Argument  Type         IO     Description                                     *
+* --------- --------     --     ---------------------------------               *
+* ctx       void*        I      Path of the file                                *
+* off       size_t       I      Byte offset in the file                         *
+* buf       const void*  I      Source                                          *
+* len       size_t       I      Number of bytes                                 *
+*                                                                               *
+* RETURN VALUE: int                                                             *
+********************************************************************************/
+static int iFileWrite(void *ctx, size_t off, const void *buf, size_t len)
+{
+    FILE *f = fopen((const char *)ctx, "r+b");
+    int   ret;
+
+    if (f == NULL)
+    {
+        f = fopen((const char *)ctx, "w+b");
+    }
+    if (f == NULL)
+    {
+        return -1;
+    }
+    ret = (fseek(f, (long)off, SEEK_SET) == 0 && fwrite(buf, 1, len, f) == len) ? 0 : -1;
+    if (fclose(f) != 0)
+    {
+        ret = -1;
+    }
+
+    return ret;
+}
+
+/********************************************************************************
+*                                                                               *
+* FUNCTION NAME: vCheckpoint_FileStore                                          *
+*                                                                               *
+* PURPOSE: Store on a file of the host, for the simulator and the replay tools  *
+*                                                                               *
+* ARGUMENT LIST:                                                                *
+*                                                                               *
+* Argument  Type         IO     Description                                     *
+* --------- --------     --     ---------------------------------               *
+* s         CheckpointSt* O     Store                                           *
+* path      const char*  I      File, must outlive the store                    *
+*                                                                               *
+* RETURN VALUE: void                                                            *
+*                                                                               *
+********************************************************************************/
+void vCheckpoint_FileStore(CheckpointStore *s, const char *path)
+{
+    s->iRead  = iFileRead;
+    s->iWrite = iFileWrite;
+    s->ctx    = (void *)path;
+    s->seq    = 0;
+}
+
+#endif
@@ -0,0 +1,124 @@
+/***********************************************************************************
+* This file is part of The AHRS Project.                                           *
+*                                                                                  *
+* Copyright © 2020 By Nicola di Gruttola Giardino. All rights reserved.            *
+* @mail: nicoladgg@protonmail.com                                                  *
+*                                                                                  *
+* AHRS is free software: you can redistribute it and/or modify                     *
+* it under the terms of the GNU General Public License as published by             *
+* the Free Software Foundation, either version 3 of the License, or                *
+* (at your option) any later version.                                              *
+*                                                                                  *
+* AHRS is distributed in the hope that it will be useful,                          *
+* but WITHOUT ANY WARRANTY; without even the implied warranty of                   *
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the                    *
+* GNU General Public License for more details.                                     *
+*                                                                                  *
+* You should have received a copy of the GNU General Public License                *
+* along with The AHRS Project.  If not, see <https://www.gnu.org/licenses/>.       *
+*                                                                                  *
+* In case of use of this project, I ask you to mention me, to whom it may concern. *
+***********************************************************************************/
+
+/***************************************************************************************************
+*   FILENAME:  Checkpoint.h                                                                        *
+*                                                                                                  *
+*                                                                                                  *
+*   PURPOSE:   Library that defines the checkpoint record of the attitude and of the filters and   *
+*               the abstract store it is saved to, so that a warm boot restarts from the last      *
+*               estimate instead of the defaults                                                   *
+*                                                                                                  *
+*                                                                                                  *
+*   GLOBAL VARIABLES:                                                                              *
+*                                                                                                  *
+*                                                                                                  *
+*   Variable          Type              Description                                                *
+*   --------          ----              -------------------                                        *
+*   CheckpointRecord  CheckpointRecord  Versioned record, protected by a CRC-32                    *
+*   CheckpointStore   CheckpointStore   Backend: backup SRAM or flash on target, a file on host    *
+*                                                                                                  *
+*   DEVELOPMENT HISTORY :                                                                          *
+*                                                                                                  *
+*                                                                                                  *
+*   Date          Author            Change Id     Release     Description Of Change                *
+*   ----          ------            -------- -    ------      ----------------------               *
+*   19-10-2026    AHRS Project       1               1         Initial release                     *
+*                                                                                                  *
+***************************************************************************************************/
+
+#ifndef Checkpoint_h
+#define Checkpoint_h
+
+/* Include Global Parameters */
+
+#include <stddef.h>
+#include <stdint.h>
+
+/* Definition of Macros */
+
+#define CHECKPOINT_MAGIC     0x50434841UL   /* "AHCP" */
+#define CHECKPOINT_VERSION   1              /* bump when the record changes */
+#define CHECKPOINT_SLOTS     2              /* written in turn, a torn write loses one only */
+
+/*
+* CheckpointRecord Object:
+*       q the Madgwick quaternion, x and P position-velocity state and upper
+*       triangle (p00, p01, p11) of the covariance of the North, East and
+*       Down filters, gyro and accelerometer biases; the header and the CRC
+*       are filled in by iCheckpoint_Save
+*/
+
+typedef struct CheckpointRecord
+{
+    uint32_t magic;
+    uint16_t version;
+    uint16_t size;
+    uint32_t seq;
+
+    float    q[4];
+    float    x[3][2];
+    float    P[3][3];
+    float    gyro_bias[3];
+    float    acc_bias[3];
+
+    uint32_t crc;            /* CRC-32 of everything above */
+}CheckpointRecord;
+
+/*
+* CheckpointStore Object:
+*       iRead and iWrite move len bytes at byte offset off of the backend,
+*       returning 0 if successfull; ctx is passed back to them. seq is the
+*       sequence number of the last record read or written
+*/
+
+typedef struct CheckpointStore
+{
+    int    (*iRead) (void *, size_t, void *, size_t);
+    int    (*iWrite)(void *, size_t, const void *, size_t);
+    void*    ctx;
+    uint32_t seq;
+}CheckpointStore;
+
+/*
+* CheckpointMem Object:
+*       context of the memory backend, a region of size bytes at base, e.g.
+*       the backup SRAM of the STM32F7
+*/
+
+typedef struct CheckpointMem
+{
+    volatile uint8_t* base;
+    size_t            size;
+}CheckpointMem;
+
+/* Declare Prototypes */
+
+uint32_t  uCheckpoint_Crc32       (const void *, size_t);
+int       iCheckpoint_Save        (CheckpointStore *, CheckpointRecord *);
+int       iCheckpoint_Load        (CheckpointStore *, CheckpointRecord *);
+void      vCheckpoint_MemStore    (CheckpointStore *, CheckpointMem *);
+#if !defined(__ARM_ARCH_7EM__)
+void      vCheckpoint_FileStore   (CheckpointStore *, const char *);
+#endif
+
+#endif /* Checkpoint_h */
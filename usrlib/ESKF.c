@@ -0,0 +1,537 @@
+/***********************************************************************************
+* This file is part of The AHRS Project.                                           *
+*                                                                                  *
+* Copyright © 2020 By Nicola di Gruttola Giardino. All rights reserved.            *
+* @mail: nicoladgg@protonmail.com                                                  *
+*                                                                                  *
+* AHRS is free software: you can redistribute it and/or modify                     *
+* it under the terms of the GNU General Public License as published by             *
+* the Free Software Foundation, either version 3 of the License, or                *
+* (at your option) any later version.                                              *
+*                                                                                  *
+* AHRS is distributed in the hope that it will be useful,                          *
+* but WITHOUT ANY WARRANTY; without even the implied warranty of                   *
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the                    *
+* GNU General Public License for more details.                                     *
+*                                                                                  *
+* You should have received a copy of the GNU General Public License                *
+* along with The AHRS Project.  If not, see <https://www.gnu.org/licenses/>.       *
+*                                                                                  *
+* In case of use of this project, I ask you to mention me, to whom it may concern. *
+***********************************************************************************/
+
+/****************************************************************************************************
+* FILE NAME: ESKF.c                                                                                 *
+*                                                                                                   *
+* PURPOSE: 15-state error-state extended Kalman filter: the nominal position, velocity, attitude    *
+*           and biases are integrated from the IMU at its own rate, the covariance of their         *
+*           errors is propagated exploiting the 3x3 block sparsity of the transition matrix and     *
+*           GPS position and velocity are applied as sequential scalar updates, so that GPS         *
+*           also corrects attitude and sensor biases through the cross covariances                  *
+*                                                                                                   *
+* FILE REFERENCES:                                                                                  *
+*                                                                                                   *
+*   Name    I/O     Description                                                                     *
+*   ----    ---     -----------                                                                     *
+*   none                                                                                            *
+*                                                                                                   *
+*                                                                                                   *
+* EXTERNAL VARIABLES:                                                                               *
+*                                                                                                   *
+* Source: <ESKF.h>                                                                                  *
+*                                                                                                   *
+* Name          Type    IO Description                                                              *
+* ------------- ------- -- -----------------------------                                            *
+*   f           ESKF       Filter object                                                            *
+*                                                                                                   *
+* STATIC VARIABLES:                                                                                 *
+*                                                                                                   *
+*   Name     Type       I/O      Description                                                        *
+*   ----     ----       ---      -----------                                                        *
+*   none                                                                                            *
+*                                                                                                   *
+* EXTERNAL REFERENCES:                                                                              *
+*                                                                                                   *
+*  Name                       Description                                                           *
+*  -------------              -----------                                                           *
+*  none                                                                                             *
+*                                                                                                   *
+* ABNORMAL TERMINATION CONDITIONS, ERROR AND WARNING MESSAGES:                                      *
+*    none, compliant with the standard ISO9899:1999                                                 *
+*                                                                                                   *
+* ASSUMPTIONS, CONSTRAINTS, RESTRICTIONS: local NED frame, flat non rotating earth, the attitude     *
+*    error is expressed in the navigation frame: R_true = (I + [dtheta]x) * R                       *
+*                                                                                                   *
+* NOTES: with F = I + Fc*dt the only non identity blocks are                                        *
+*         F(pos,vel) = I*dt, F(vel,att) = -[R*a]x*dt, F(vel,ba) = -R*dt, F(att,bg) = -R*dt          *
+*         so F*P*F^T costs a few hundred multiply-adds instead of two 15x15 products; no heap       *
+*                                                                                                   *
+* REQUIREMENTS/FUNCTIONAL SPECIFICATIONS REFERENCES:                                                *
+*                                                                                                   *
+* DEVELOPMENT HISTORY:                                                                              *
+*                                                                                                   *
+*   Date          Author            Change Id     Release     Description Of Change                 *
+*   ----          ------            ---------     ------      ----------------------                *
+*   19-10-2026    AHRS Project       1               1         Initial release                      *
+*                                                                                                   *
+****************************************************************************************************/
+
+/* Include Global Parameters */
+
+#include "ESKF.h"
+
+/* Declare Prototypes */
+
+static void  vRotation   (const float *, float [3][3]);
+static void  vRowsMulL   (float [ESKF_N][ESKF_N], int, const float [3][3], float [ESKF_N][ESKF_N], int);
+static void  vColsMulR   (float [ESKF_N][ESKF_N], int, float [ESKF_N][ESKF_N], int, const float [3][3], int);
+static void  vNormalize  (float *);
+static void  vInject     (ESKF *, const float *);
+static int   iScalar     (ESKF *, float *, int, float, float);
+
+
+/********************************************************************************
+*                                                                               *
+* FUNCTION NAME: vRotation                                                      *
+*                                                                               *
+* PURPOSE: Body to navigation rotation matrix of a unit quaternion              *
+*                                                                               *
+* ARGUMENT LIST:                                                                *
+*                                                                               *
+* Argument  Type         IO     Description                                     *
+* --------- --------     --     ---------------------------------               *
+* q         const float* I      Quaternion w, x, y, z                           *
+* R         float[3][3]  O      Rotation matrix                                 *
+*                                                                               *
+* RETURN VALUE: void                                                            *
+********************************************************************************/
+static void vRotation(const float *q, float R[3][3])
+{
+    const float w = q[0], x = q[1], y = q[2], z = q[3];
+
+    R[0][0] = 1 - 2 * (y * y + z * z);
+    R[0][1] = 2 * (x * y - w * z);
+    R[0][2] = 2 * (x * z + w * y);
+    R[1][0] = 2 * (x * y + w * z);
+    R[1][1] = 1 - 2 * (x * x + z * z);
+    R[1][2] = 2 * (y * z - w * x);
+    R[2][0] = 2 * (x * z - w * y);
+    R[2][1] = 2 * (y * z + w * x);
+    R[2][2] = 1 - 2 * (x * x + y * y);
+}
+
+/********************************************************************************
+*                                                                               *
+* FUNCTION NAME: vRowsMulL                                                      *
+*                                                                               *
+* PURPOSE: D[d..d+2][:] += M * S[s..s+2][:], a 3x3 block times a block row      *
+*                                                                               *
+* ARGUMENT LIST:                                                                *
+*                                                                               *
+* Argument  Type         IO     Description                                     *
+* --------- --------     --     ---------------------------------               *
+* D         float[][]    IO     Destination                                     *
+* d         int          I      First row of the destination block row          *
+* M         float[3][3]  I      Block                                           *
+* S         float[][]    I      Source                                          *
+* s         int          I      First row of the source block row               *
+*                                                                               *
+* RETURN VALUE: void                                                            *
+********************************************************************************/
+static void vRowsMulL(float D[ESKF_N][ESKF_N], int d, const float M[3][3], float S[ESKF_N][ESKF_N], int s)
+{
+    int i, j;
+
+    for (j = 0; j < ESKF_N; j++)
+    {
+        const float s0 = S[s][j], s1 = S[s + 1][j], s2 = S[s + 2][j];
+
+        for (i = 0; i < 3; i++)
+        {
+            D[d + i][j] += M[i][0] * s0 + M[i][1] * s1 + M[i][2] * s2;
+        }
+    }
+}
+
+/********************************************************************************
+*                                                                               *
+* FUNCTION NAME: vColsMulR                                                      *
+*                                                                               *
+* PURPOSE: D[0..rows-1][d..d+2] += S[0..rows-1][s..s+2] * M^T, a block column   *
+*           times a transposed 3x3 block                                        *
+*                                                                               *
+* ARGUMENT LIST:                                                                *
+*                                                                               *
+* Argument  Type         IO     Description                                     *
+* --------- --------     --     ---------------------------------               *
+* D         float[][]    IO     Destination                                     *
+* d         int          I      First column of the destination block column    *
+* S         float[][]    I      Source                                          *
+* s         int          I      First column of the source block column         *
+* M         float[3][3]  I      Block                                           *
+* rows      int          I      Number of rows, the upper triangle only         *
+*                                                                               *
+* RETURN VALUE: void                                                            *
+********************************************************************************/
+static void vColsMulR(float D[ESKF_N][ESKF_N], int d, float S[ESKF_N][ESKF_N], int s,
+                      const float M[3][3], int rows)
+{
+    int i, j;
+
+    for (i = 0; i < rows; i++)
+    {
+        const float s0 = S[i][s], s1 = S[i][s + 1], s2 = S[i][s + 2];
+
+        for (j = 0; j < 3; j++)
+        {
+            D[i][d + j] += s0 * M[j][0] + s1 * M[j][1] + s2 * M[j][2];
+        }
+    }
+}
+
+/********************************************************************************
+*                                                                               *
+* FUNCTION NAME: vNormalize                                                     *
+*                                                                               *
+* PURPOSE: Normalizes a quaternion                                              *
+*                                                                               *
+* ARGUMENT LIST:                                                                *
+*                                                                               *
+* Argument  Type         IO     Description                                     *
+* --------- --------     --     ---------------------------------               *
+* q         float*       IO     Quaternion                                      *
+*                                                                               *
+* RETURN VALUE: void                                                            *
+********************************************************************************/
+static void vNormalize(float *q)
+{
+    const float n = 1.0f / sqrtf(q[0] * q[0] + q[1] * q[1] + q[2] * q[2] + q[3] * q[3]);
+
+    q[0] *= n;
+    q[1] *= n;
+    q[2] *= n;
+    q[3] *= n;
+}
+
+/********************************************************************************
+*                                                                               *
+* FUNCTION NAME: vESKF_Init                                                     *
+*                                                                               *
+* PURPOSE: Sets the filter at rest at the origin with the given attitude, zero  *
+*           biases, a diagonal covariance and default noise densities           *
+*                                                                               *
+* ARGUMENT LIST:                                                                *
+*                                                                               *
+* Argument  Type         IO     Description                                     *
+* --------- --------     --     ---------------------------------               *
+* f         ESKF*        O      Filter object                                   *
+* q         const float* I      Initial attitude w, x, y, z, NULL for level     *
+*                                                                               *
+* RETURN VALUE: void                                                            *
+*                                                                               *
+********************************************************************************/
+void vESKF_Init(ESKF *f, const float *q)
+{
+    int i, j;
+
+    for (i = 0; i < 3; i++)
+    {
+        f->p[i]  = 0;
+        f->v[i]  = 0;
+        f->bg[i] = 0;
+        f->ba[i] = 0;
+    }
+    for (i = 0; i < 4; i++)
+    {
+        f->q[i] = (q != NULL) ? q[i] : (i == 0);
+    }
+    vNormalize(f->q);
+
+    for (i = 0; i < ESKF_N; i++)
+    {
+        for (j = 0; j < ESKF_N; j++)
+        {
+            f->P[i][j] = 0;
+        }
+    }
+    for (i = 0; i < 3; i++)
+    {
+        f->P[ESKF_POS + i][ESKF_POS + i] = 10.0f;        /* (3 m)^2 */
+        f->P[ESKF_VEL + i][ESKF_VEL + i] = 1.0f;
+        f->P[ESKF_ATT + i][ESKF_ATT + i] = 0.03f;        /* (10 deg)^2 */
+        f->P[ESKF_BG + i][ESKF_BG + i]   = 1e-4f;        /* (0.6 deg/s)^2 */
+        f->P[ESKF_BA + i][ESKF_BA + i]   = 0.01f;        /* (0.1 m/s^2)^2 */
+    }
+
+    f->na  = 0.02f;       /* m/s^2/sqrt(Hz) */
+    f->ng  = 0.002f;      /* rad/s/sqrt(Hz) */
+    f->nba = 1e-4f;       /* m/s^3/sqrt(Hz) */
+    f->nbg = 1e-5f;       /* rad/s^2/sqrt(Hz) */
+}
+
+/********************************************************************************
+*                                                                               *
+* FUNCTION NAME: vESKF_Predict                                                  *
+*                                                                               *
+* PURPOSE: Integrates the nominal state with one IMU sample and propagates the  *
+*           error covariance, P=F*P*F^T + Q with the block sparse F             *
+*                                                                               *
+* ARGUMENT LIST:                                                                *
+*                                                                               *
+* Argument  Type         IO     Description                                     *
+* --------- --------     --     ---------------------------------               *
+* f         ESKF*        IO     Filter object                                   *
+* gyro      const float* I      Angular rate, body frame, rad/s                 *
+* acc       const float* I      Specific force, body frame, m/s^2               *
+* dt        float        I      Time since the previous sample, s               *
+*                                                                               *
+* RETURN VALUE: void                                                            *
+*                                                                               *
+********************************************************************************/
+void vESKF_Predict(ESKF *f, const float *gyro, const float *acc, float dt)
+{
+    float R[3][3];
+    float A[3][3];
+    float B[3][3];
+    float w[3], a[3], an[3], dq[4], q[4];
+    float th, s;
+    int   i, j;
+
+    vRotation(f->q, R);
+    for (i = 0; i < 3; i++)
+    {
+        w[i] = gyro[i] - f->bg[i];
+        a[i] = acc[i] - f->ba[i];
+    }
+    for (i = 0; i < 3; i++)
+    {
+        an[i] = R[i][0] * a[0] + R[i][1] * a[1] + R[i][2] * a[2];
+    }
+
+    /* error transition blocks: A = -[R*a]x*dt, B = -R*dt, used for ba and bg */
+    A[0][0] = 0;             A[0][1] =  an[2] * dt;   A[0][2] = -an[1] * dt;
+    A[1][0] = -an[2] * dt;   A[1][1] = 0;             A[1][2] =  an[0] * dt;
+    A[2][0] =  an[1] * dt;   A[2][1] = -an[0] * dt;   A[2][2] = 0;
+    for (i = 0; i < 3; i++)
+    {
+        for (j = 0; j < 3; j++)
+        {
+            B[i][j] = -R[i][j] * dt;
+        }
+    }
+
+    /* nominal state, NED with gravity down */
+    an[2] += ESKF_GRAVITY;
+    for (i = 0; i < 3; i++)
+    {
+        f->p[i] += f->v[i] * dt + 0.5f * an[i] * dt * dt;
+        f->v[i] += an[i] * dt;
+    }
+    th = 0.5f * dt * sqrtf(w[0] * w[0] + w[1] * w[1] + w[2] * w[2]);
+    s  = (th > 1e-6f) ? sinf(th) / th * 0.5f * dt : 0.5f * dt;
+    dq[0] = cosf(th);
+    dq[1] = w[0] * s;
+    dq[2] = w[1] * s;
+    dq[3] = w[2] * s;
+    q[0] = f->q[0] * dq[0] - f->q[1] * dq[1] - f->q[2] * dq[2] - f->q[3] * dq[3];
+    q[1] = f->q[0] * dq[1] + f->q[1] * dq[0] + f->q[2] * dq[3] - f->q[3] * dq[2];
+    q[2] = f->q[0] * dq[2] - f->q[1] * dq[3] + f->q[2] * dq[0] + f->q[3] * dq[1];
+    q[3] = f->q[0] * dq[3] + f->q[1] * dq[2] - f->q[2] * dq[1] + f->q[3] * dq[0];
+    for (i = 0; i < 4; i++)
+    {
+        f->q[i] = q[i];
+    }
+    vNormalize(f->q);
+
+    /* FP = F*P by block rows */
+    for (i = 0; i < ESKF_N; i++)
+    {
+        for (j = 0; j < ESKF_N; j++)
+        {
+            f->FP[i][j] = f->P[i][j];
+        }
+    }
+    for (i = 0; i < 3; i++)
+    {
+        for (j = 0; j < ESKF_N; j++)
+        {
+            f->FP[ESKF_POS + i][j] += dt * f->P[ESKF_VEL + i][j];
+        }
+    }
+    vRowsMulL(f->FP, ESKF_VEL, A, f->P, ESKF_ATT);
+    vRowsMulL(f->FP, ESKF_VEL, B, f->P, ESKF_BA);
+    vRowsMulL(f->FP, ESKF_ATT, B, f->P, ESKF_BG);
+
+    /* P = FP*F^T by block columns, upper triangle only */
+    for (i = 0; i < ESKF_N; i++)
+    {
+        for (j = i; j < ESKF_N; j++)
+        {
+            f->P[i][j] = f->FP[i][j];
+        }
+    }
+    for (i = 0; i < ESKF_POS + 3; i++)
+    {
+        for (j = 0; j < 3; j++)
+        {
+            f->P[i][ESKF_POS + j] += dt * f->FP[i][ESKF_VEL + j];
+        }
+    }
+    vColsMulR(f->P, ESKF_VEL, f->FP, ESKF_ATT, A, ESKF_VEL + 3);
+    vColsMulR(f->P, ESKF_VEL, f->FP, ESKF_BA, B, ESKF_VEL + 3);
+    vColsMulR(f->P, ESKF_ATT, f->FP, ESKF_BG, B, ESKF_ATT + 3);
+
+    /* + Q, then mirror the upper triangle */
+    for (i = 0; i < 3; i++)
+    {
+        f->P[ESKF_VEL + i][ESKF_VEL + i] += f->na * f->na * dt;
+        f->P[ESKF_ATT + i][ESKF_ATT + i] += f->ng * f->ng * dt;
+        f->P[ESKF_BA + i][ESKF_BA + i]   += f->nba * f->nba * dt;
+        f->P[ESKF_BG + i][ESKF_BG + i]   += f->nbg * f->nbg * dt;
+    }
+    for (i = 1; i < ESKF_N; i++)
+    {
+        for (j = 0; j < i; j++)
+        {
+            f->P[i][j] = f->P[j][i];
+        }
+    }
+}
+
+/********************************************************************************
+*                                                                               *
+* FUNCTION NAME: iScalar                                                        *
+*                                                                               *
+* PURPOSE: Scalar update of the error state dx with a direct measurement of     *
+*           error state idx, H = e_idx, so S is P[idx][idx] + r                 *
+*           returning -1 if failed, 0 if successfull                            *
+*                                                                               *
+* ARGUMENT LIST:                                                                *
+*                                                                               *
+* Argument  Type         IO     Description                                     *
+* --------- --------     --     ---------------------------------               *
+* f         ESKF*        IO     Filter object                                   *
+* dx        float*       IO     Error state accumulated by this update          *
+* idx       int          I      Measured error state                            *
+* e         float        I      Measurement minus nominal prediction            *
+* r         float        I      Measurement variance                            *
+*                                                                               *
+* RETURN VALUE: int                                                             *
+********************************************************************************/
+static int iScalar(ESKF *f, float *dx, int idx, float e, float r)
+{
+    float ph[ESKF_N];
+    float s, k;
+    int   i, j;
+
+    s = f->P[idx][idx] + r;
+    if (!(s > 0))
+    {
+        return -1;
+    }
+    s = 1.0f / s;
+    e -= dx[idx];
+
+    for (j = 0; j < ESKF_N; j++)
+    {
+        ph[j] = f->P[idx][j];
+    }
+    for (i = 0; i < ESKF_N; i++)
+    {
+        k = ph[i] * s;
+        dx[i] += k * e;
+        for (j = 0; j < ESKF_N; j++)
+        {
+            f->P[i][j] -= k * ph[j];
+        }
+    }
+
+    return 0;
+}
+
+/********************************************************************************
+*                                                                               *
+* FUNCTION NAME: vInject                                                        *
+*                                                                               *
+* PURPOSE: Adds the estimated error to the nominal state, the error is then     *
+*           zero again                                                          *
+*                                                                               *
+* ARGUMENT LIST:                                                                *
+*                                                                               *
+* Argument  Type         IO     Description                                     *
+* --------- --------     --     ---------------------------------               *
+* f         ESKF*        IO     Filter object                                   *
+* dx        const float* I      Error state                                     *
+*                                                                               *
+* RETURN VALUE: void                                                            *
+********************************************************************************/
+static void vInject(ESKF *f, const float *dx)
+{
+    const float *dt = dx + ESKF_ATT;
+    float q[4];
+    int   i;
+
+    for (i = 0; i < 3; i++)
+    {
+        f->p[i]  += dx[ESKF_POS + i];
+        f->v[i]  += dx[ESKF_VEL + i];
+        f->bg[i] += dx[ESKF_BG + i];
+        f->ba[i] += dx[ESKF_BA + i];
+    }
+
+    /* q = [1, dtheta/2] * q, the error is in the navigation frame */
+    q[0] = f->q[0] - 0.5f * (dt[0] * f->q[1] + dt[1] * f->q[2] + dt[2] * f->q[3]);
+    q[1] = f->q[1] + 0.5f * (dt[0] * f->q[0] + dt[1] * f->q[3] - dt[2] * f->q[2]);
+    q[2] = f->q[2] + 0.5f * (dt[1] * f->q[0] + dt[2] * f->q[1] - dt[0] * f->q[3]);
+    q[3] = f->q[3] + 0.5f * (dt[2] * f->q[0] + dt[0] * f->q[2] - dt[1] * f->q[1]);
+    for (i = 0; i < 4; i++)
+    {
+        f->q[i] = q[i];
+    }
+    vNormalize(f->q);
+}
+
+/********************************************************************************
+*                                                                               *
+* FUNCTION NAME: iESKF_UpdateGPS                                                *
+*                                                                               *
+* PURPOSE: Applies a GPS fix as six scalar updates and injects the error into   *
+*           the nominal state; either measurement may be NULL                   *
+*           returning -1 if failed, 0 if successfull                            *
+*                                                                               *
+* ARGUMENT LIST:                                                                *
+*                                                                               *
+* Argument  Type         IO     Description                                     *
+* --------- --------     --     ---------------------------------               *
+* f         ESKF*        IO     Filter object                                   *
+* pos       const float* I      NED position, m, or NULL                        *
+* vel       const float* I      NED velocity, m/s, or NULL                      *
+* rp        float        I      Position variance, m^2                          *
+* rv        float        I      Velocity variance, m^2/s^2                      *
+*                                                                               *
+* RETURN VALUE: int                                                             *
+*                                                                               *
+********************************************************************************/
+int iESKF_UpdateGPS(ESKF *f, const float *pos, const float *vel, float rp, float rv)
+{
+    float dx[ESKF_N] = {0};
+    int   i;
+
+    for (i = 0; i < 3; i++)
+    {
+        if (pos != NULL && iScalar(f, dx, ESKF_POS + i, pos[i] - f->p[i], rp) != 0)
+        {
+            return -1;
+        }
+    }
+    for (i = 0; i < 3; i++)
+    {
+        if (vel != NULL && iScalar(f, dx, ESKF_VEL + i, vel[i] - f->v[i], rv) != 0)
+        {
+            return -1;
+        }
+    }
+    vInject(f, dx);
+
+    return 0;
+}
@@ -0,0 +1,97 @@
+/***********************************************************************************
+* This file is part of The AHRS Project.                                           *
+*                                                                                  *
+* Copyright © 2020 By Nicola di Gruttola Giardino. All rights reserved.            *
+* @mail: nicoladgg@protonmail.com                                                  *
+*                                                                                  *
+* AHRS is free software: you can redistribute it and/or modify                     *
+* it under the terms of the GNU General Public License as published by             *
+* the Free Software Foundation, either version 3 of the License, or                *
+* (at your option) any later version.                                              *
+*                                                                                  *
+* AHRS is distributed in the hope that it will be useful,                          *
+* but WITHOUT ANY WARRANTY; without even the implied warranty of                   *
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the                    *
+* GNU General Public License for more details.                                     *
+*                                                                                  *
+* You should have received a copy of the GNU General Public License                *
+* along with The AHRS Project.  If not, see <https://www.gnu.org/licenses/>.       *
+*                                                                                  *
+* In case of use of this project, I ask you to mention me, to whom it may concern. *
+***********************************************************************************/
+
+/***************************************************************************************************
+*   FILENAME:  ESKF.h                                                                              *
+*                                                                                                  *
+*                                                                                                  *
+*   PURPOSE:   Library that defines the object ESKF, a 15-state error-state extended Kalman        *
+*               filter (INS) fusing the IMU at its own rate with GPS position and velocity         *
+*                                                                                                  *
+*                                                                                                  *
+*   GLOBAL VARIABLES:                                                                              *
+*                                                                                                  *
+*                                                                                                  *
+*   Variable        Type        Description                                                        *
+*   --------        ----        -------------------                                                *
+*   ESKF            ESKF        Filter object, nominal state, error covariance and workspace       *
+*                                                                                                  *
+*   DEVELOPMENT HISTORY :                                                                          *
+*                                                                                                  *
+*                                                                                                  *
+*   Date          Author            Change Id     Release     Description Of Change                *
+*   ----          ------            -------- -    ------      ----------------------               *
+*   19-10-2026    AHRS Project       1               1         Initial release                     *
+*                                                                                                  *
+***************************************************************************************************/
+
+#ifndef ESKF_h
+#define ESKF_h
+
+/* Include Global Parameters */
+
+#include <math.h>
+#include <stddef.h>
+
+/* Definition of Macros */
+
+#define ESKF_N          15          /* error state size */
+
+#define ESKF_POS        0           /* position error, NED, m */
+#define ESKF_VEL        3           /* velocity error, NED, m/s */
+#define ESKF_ATT        6           /* attitude error, navigation frame, rad */
+#define ESKF_BG         9           /* gyro bias error, rad/s */
+#define ESKF_BA         12          /* accelerometer bias error, m/s^2 */
+
+#define ESKF_GRAVITY    9.80665f
+
+/*
+* ESKF Object:
+*       p, v the NED position and velocity, q the body to NED quaternion
+*       (w, x, y, z), bg and ba the gyro and accelerometer biases.
+*       P is the covariance of the 15 error states in the ESKF_* order,
+*       FP a workspace of the same size. na, ng are the accelerometer and
+*       gyro noise densities, nba, nbg the bias random walks
+*/
+
+typedef struct ESKF
+{
+    float p[3];
+    float v[3];
+    float q[4];
+    float bg[3];
+    float ba[3];
+    float P[ESKF_N][ESKF_N];
+    float FP[ESKF_N][ESKF_N];
+    float na;
+    float ng;
+    float nba;
+    float nbg;
+}ESKF;
+
+/* Declare Prototypes */
+
+void  vESKF_Init       (ESKF *, const float *);
+void  vESKF_Predict    (ESKF *, const float *, const float *, float);
+int   iESKF_UpdateGPS  (ESKF *, const float *, const float *, float, float);
+
+#endif /* ESKF_h */
@@ -3,139 +3,180 @@
 
 #include "GPS_Lib.h"
 
+/* the parser of the functions without a GPSParser argument */
+static GPSParser gps;
 
-void stringcpy(char *str1, char *str2, int dir)
+
+void GPSParserInit(GPSParser *p)
 {
-  uint8_t chr = 0;
-  do {
-    str2[chr + dir] = str1[chr];
-  } while(str1[chr++] != '\0');
+  memset(p, 0, sizeof(*p));
 }
 
 
-int GPSRead(uint8_t c)
+int stringcpy(const char *str1, char *str2, int dir, size_t size)
+{
+  size_t len = strlen(str1);
+
+  // the term and its '\0' must fit from str2[dir] on, else nothing is copied
+  if(len + dir >= size)
+    return -1;
+  memcpy(str2 + dir, str1, len + 1);
+  return 0;
+}
+
+// A term longer than its field or than buffer drops the sentence: its fields
+// in next are never accepted, and its half of the pair is incomplete again
+static void drop(GPSParser *p)
+{
+  if(p->SentenceType == _GPRMC_)
+    p->GPRMC_ok = 0;
+  if(p->SentenceType == _GPGGA_)
+    p->GPGGA_ok = 0;
+  p->SentenceType = _OTHER_;
+}
+
+
+int GPSParserRead(GPSParser *p, uint8_t c)
 {
 
   switch(c) {
-    case '\r':  // sentence end
-      if(SentenceType == _GPRMC_)
-        GPRMC_ok = 1;
-      if(SentenceType == _GPGGA_)
-        GPGGA_ok = 1;
-      if(GPRMC_ok && GPGGA_ok) {
-        GPRMC_ok = GPGGA_ok = 0;
+    case '\r':  // sentence end, its fields are accepted
+      if(p->SentenceType == _GPRMC_)
+        p->GPRMC_ok = 1;
+      if(p->SentenceType == _GPGGA_)
+        p->GPGGA_ok = 1;
+      if(p->SentenceType == _GPRMC_ || p->SentenceType == _GPGGA_)
+        p->terms = p->next;
+      p->SentenceType = _OTHER_;
+      if(p->GPRMC_ok && p->GPGGA_ok) {
+        p->GPRMC_ok = p->GPGGA_ok = 0;
         return 1;
       }
       break;
 
-    case '$': // sentence start
-      Term = char_number = 0;
+    case '$': // sentence start, of no type until its first term
+      p->Term = p->char_number = 0;
+      p->SentenceType = _OTHER_;
+      p->next = p->terms;
       break;
 
     case ',':  // term end (new term start)
-      buffer[char_number] = '\0';
-      if(Term == 0) {
-        stringcpy(buffer, sentence,0);
-        if(strcmp(sentence, "GPRMC") == 0)
-          SentenceType = _GPRMC_;
-        else if(strcmp(sentence, "GPGGA") == 0)
-               SentenceType = _GPGGA_;
+      p->buffer[p->char_number] = '\0';
+      if(p->Term == 0) {
+        if(stringcpy(p->buffer, p->sentence, 0, sizeof(p->sentence)) != 0)
+          p->SentenceType = _OTHER_;
+        else if(strcmp(p->sentence, "GPRMC") == 0)
+          p->SentenceType = _GPRMC_;
+        else if(strcmp(p->sentence, "GPGGA") == 0)
+               p->SentenceType = _GPGGA_;
              else
-               SentenceType = _OTHER_;
+               p->SentenceType = _OTHER_;
       }
 
       // Time
-      if(Term == 1 && SentenceType == _GPRMC_) {
-        stringcpy(buffer, rawTime,0);
+      if(p->Term == 1 && p->SentenceType == _GPRMC_) {
+        if(stringcpy(p->buffer, p->next.rawTime, 0, sizeof(p->next.rawTime)) != 0)
+          drop(p);
       }
 
       // Latitude
-      if((Term == 3) && (SentenceType == _GPRMC_)) {
-        stringcpy(buffer, rawLatitude, 1);
+      if((p->Term == 3) && (p->SentenceType == _GPRMC_)) {
+        if(stringcpy(p->buffer, p->next.rawLatitude, 1, sizeof(p->next.rawLatitude)) != 0)
+          drop(p);
       }
       // Latitude N/S
-      if((Term == 4) && (SentenceType == _GPRMC_)) {
-        if(buffer[0] == 'N')
-          rawLatitude[0] = '0';
+      if((p->Term == 4) && (p->SentenceType == _GPRMC_)) {
+        if(p->buffer[0] == 'N')
+          p->next.rawLatitude[0] = '0';
         else
-          rawLatitude[0] = '-';
+          p->next.rawLatitude[0] = '-';
       }
 
       // Longitude
-      if((Term == 5) && (SentenceType == _GPRMC_)) {
-        stringcpy(buffer, rawLongitude, 1);
+      if((p->Term == 5) && (p->SentenceType == _GPRMC_)) {
+        if(stringcpy(p->buffer, p->next.rawLongitude, 1, sizeof(p->next.rawLongitude)) != 0)
+          drop(p);
       }
       // Longitude E/W
-      if((Term == 6) && (SentenceType == _GPRMC_)) {
-        if(buffer[0] == 'E')
-          rawLongitude[0] = '0';
+      if((p->Term == 6) && (p->SentenceType == _GPRMC_)) {
+        if(p->buffer[0] == 'E')
+          p->next.rawLongitude[0] = '0';
         else
-          rawLongitude[0] = '-';
+          p->next.rawLongitude[0] = '-';
       }
 
       // Speed
-      if((Term == 7) && (SentenceType == _GPRMC_)) {
-        stringcpy(buffer, rawSpeed,0);
+      if((p->Term == 7) && (p->SentenceType == _GPRMC_)) {
+        if(stringcpy(p->buffer, p->next.rawSpeed, 0, sizeof(p->next.rawSpeed)) != 0)
+          drop(p);
       }
 
       // Course
-      if((Term == 8) && (SentenceType == _GPRMC_)) {
-        stringcpy(buffer, rawCourse,0);
+      if((p->Term == 8) && (p->SentenceType == _GPRMC_)) {
+        if(stringcpy(p->buffer, p->next.rawCourse, 0, sizeof(p->next.rawCourse)) != 0)
+          drop(p);
       }
 
       // Date
-      if(Term == 9 && SentenceType == _GPRMC_) {
-        stringcpy(buffer, rawDate,0);
+      if(p->Term == 9 && p->SentenceType == _GPRMC_) {
+        if(stringcpy(p->buffer, p->next.rawDate, 0, sizeof(p->next.rawDate)) != 0)
+          drop(p);
       }
 
       // Satellites
-      if((Term == 7) && (SentenceType == _GPGGA_)) {
-        stringcpy(buffer, rawSatellites,0);
+      if((p->Term == 7) && (p->SentenceType == _GPGGA_)) {
+        if(stringcpy(p->buffer, p->next.rawSatellites, 0, sizeof(p->next.rawSatellites)) != 0)
+          drop(p);
       }
 
       // Altitude
-      if((Term == 9) && (SentenceType == _GPGGA_)) {
-        stringcpy(buffer, rawAltitude,0);
+      if((p->Term == 9) && (p->SentenceType == _GPGGA_)) {
+        if(stringcpy(p->buffer, p->next.rawAltitude, 0, sizeof(p->next.rawAltitude)) != 0)
+          drop(p);
       }
-      Term++;
-      char_number = 0;
+      if(p->Term < UINT8_MAX)
+        p->Term++;
+      p->char_number = 0;
       break;
 
     default:
-      buffer[char_number++] = c;
+      if(p->char_number < sizeof(p->buffer) - 1)
+        p->buffer[p->char_number++] = c;
+      else
+        drop(p);
       break;
   }
 
   return 0;
 }
 
-uint8_t GPSSecond() 
+uint8_t GPSParserSecond(const GPSParser *p)
 {
-  return ((rawTime[4] - '0') * 10 + (rawTime[5] - '0'));
+  return ((p->terms.rawTime[4] - '0') * 10 + (p->terms.rawTime[5] - '0'));
 }
-uint8_t GPSMinute()
+uint8_t GPSParserMinute(const GPSParser *p)
 {
-  return ((rawTime[2] - '0') * 10 + (rawTime[3] - '0'));
+  return ((p->terms.rawTime[2] - '0') * 10 + (p->terms.rawTime[3] - '0'));
 }
-uint8_t GPSHour() 
+uint8_t GPSParserHour(const GPSParser *p)
 {
-  return ((rawTime[0] - '0') * 10 + (rawTime[1] - '0'));
+  return ((p->terms.rawTime[0] - '0') * 10 + (p->terms.rawTime[1] - '0'));
 }
 
-uint8_t GPSDay() 
+uint8_t GPSParserDay(const GPSParser *p)
 {
-  return ((rawDate[0] - '0') * 10 + (rawDate[1] - '0'));
+  return ((p->terms.rawDate[0] - '0') * 10 + (p->terms.rawDate[1] - '0'));
 }
-uint8_t GPSMonth() 
+uint8_t GPSParserMonth(const GPSParser *p)
 {
-  return ((rawDate[2] - '0') * 10 + (rawDate[3] - '0'));
+  return ((p->terms.rawDate[2] - '0') * 10 + (p->terms.rawDate[3] - '0'));
 }
-uint8_t GPSyear() 
+uint8_t GPSParserYear(const GPSParser *p)
 {
-  return ((rawDate[4] - '0') * 10 + (rawDate[5] - '0'));
+  return ((p->terms.rawDate[4] - '0') * 10 + (p->terms.rawDate[5] - '0'));
 }
 
-float parse_rawDegree(char *term_)
+float parse_rawDegree(const char *term_)
 {
   float term_value = atof(term_)/100;
   int16_t term_dec = term_value;
@@ -144,33 +185,88 @@ float parse_rawDegree(char *term_)
   return term_value;
 }
 
-float Latitude() 
+float GPSParserLatitude(const GPSParser *p)
 {
-  return parse_rawDegree(rawLatitude);
+  return parse_rawDegree(p->terms.rawLatitude);
 }
 
-float Longitude()
+float GPSParserLongitude(const GPSParser *p)
 {
-  return parse_rawDegree(rawLongitude);
+  return parse_rawDegree(p->terms.rawLongitude);
 }
 
-float Altitude()
+float GPSParserAltitude(const GPSParser *p)
 {
-  return atof(rawAltitude);
+  return atof(p->terms.rawAltitude);
 }
 
-uint8_t Satellites() 
+uint8_t GPSParserSatellites(const GPSParser *p)
 {
-  return atoi(rawSatellites);
+  return atoi(p->terms.rawSatellites);
 }
 
-float Speed() 
+float GPSParserSpeed(const GPSParser *p)
 {
-  return (atof(rawSpeed) * 1.852);
+  return (atof(p->terms.rawSpeed) * 1.852);
 }
 
-float Course() 
+float GPSParserCourse(const GPSParser *p)
 {
-  return atof(rawCourse);
+  return atof(p->terms.rawCourse);
 }
 
+
+/* the same, on the parser of the functions without a GPSParser argument */
+
+int GPSRead(uint8_t c)
+{
+  return GPSParserRead(&gps, c);
+}
+uint8_t GPSSecond()
+{
+  return GPSParserSecond(&gps);
+}
+uint8_t GPSMinute()
+{
+  return GPSParserMinute(&gps);
+}
+uint8_t GPSHour()
+{
+  return GPSParserHour(&gps);
+}
+uint8_t GPSDay()
+{
+  return GPSParserDay(&gps);
+}
+uint8_t GPSMonth()
+{
+  return GPSParserMonth(&gps);
+}
+uint8_t GPSyear()
+{
+  return GPSParserYear(&gps);
+}
+float Latitude()
+{
+  return GPSParserLatitude(&gps);
+}
+float Longitude()
+{
+  return GPSParserLongitude(&gps);
+}
+float Altitude()
+{
+  return GPSParserAltitude(&gps);
+}
+uint8_t Satellites()
+{
+  return GPSParserSatellites(&gps);
+}
+float Speed()
+{
+  return GPSParserSpeed(&gps);
+}
+float Course()
+{
+  return GPSParserCourse(&gps);
+}
@@ -25,9 +25,21 @@
 *   04-07-2020    N.di Gruttola                      1.2       Added comments, code satisfies      *
 *                  Giardino                                     iso9899:1999, as requested per     *
 *                                                               MISRA-C:2004                       *
+*   19-10-2026    AHRS Project                       1.3       Include guard, the parser state is  *
+*                                                               a GPSParser object, the functions  *
+*                                                               without one use a default parser   *
+*   19-10-2026    AHRS Project                       1.4       Terms bounded by their field, a     *
+*                                                               sentence with a longer term is     *
+*                                                               dropped                            *
+*   19-10-2026    AHRS Project                       1.5       Fields sized for u-blox, parsed in  *
+*                                                               GPSTerms that are accepted at the  *
+*                                                               end of their sentence              *
 *                                                                                                  *
 ***************************************************************************************************/
 
+#ifndef GPS_Lib_h
+#define GPS_Lib_h
+
 /* Include Global Parameters */
 
 #include <stdint.h>
@@ -40,36 +52,80 @@
 #define _OTHER_  3
 
 
-int     GPRMC_ok     = 0;
-int     GPGGA_ok     = 0;
-uint8_t char_number  = 0;
-uint8_t SentenceType = 0;
-uint8_t Term;
-char    sentence[6];
-char    rawTime[11];
-char    rawDate[7];
-char    rawSpeed[6];
-char    rawCourse[6];
-char    rawSatellites[3];
-char    rawLatitude[13];
-char    rawLongitude[13];
-char    rawAltitude[7];
-char    buffer[12];
+/*
+* GPSTerms Object:
+*       raw fields of a GPRMC and a GPGGA, as the receiver sends them: room
+*       for the widths of u-blox and the like, e.g. a course of 177.52 or a
+*       latitude of 4807.0380000; the latitude and the longitude have their
+*       sign in front
+*/
+
+typedef struct GPSTerms
+{
+    char    rawTime[11];
+    char    rawDate[7];
+    char    rawSpeed[12];
+    char    rawCourse[12];
+    char    rawSatellites[3];
+    char    rawLatitude[17];
+    char    rawLongitude[17];
+    char    rawAltitude[12];
+}GPSTerms;
+
+/*
+* GPSParser Object:
+*       state of one NMEA parser: the sentence being read, its fields parsed
+*       over a copy of the last ones, and the fields of the last GPRMC and
+*       GPGGA accepted, for as many receivers or logs as needed
+*/
+
+typedef struct GPSParser
+{
+    int      GPRMC_ok;
+    int      GPGGA_ok;
+    uint8_t  char_number;
+    uint8_t  SentenceType;
+    uint8_t  Term;
+    char     sentence[6];
+    char     buffer[16];
+    GPSTerms next;          /* fields of the sentence being read */
+    GPSTerms terms;         /* of the last sentences accepted, next at their end */
+}GPSParser;
 
 /* Declare Prototypes */
 
-void    stringcpy        (char *str1, char *str2, int dir);
-int     GPSRead          (uint8_t c);
-uint8_t GPSSecond        (void);
-uint8_t GPSMinute        (void);
-uint8_t GPSHour          (void);
-uint8_t GPSDay           (void);
-uint8_t GPSMonth         (void);
-uint8_t GPSyear          (void);
-float   parse_rawDegree  (char *term_);
-float   Latitude         (void);
-float   Longitude        (void);
-float   Altitude         (void);
-uint8_t Satellites       (void);
-float   Speed            (void);
-float   Course           (void);
+int     stringcpy            (const char *str1, char *str2, int dir, size_t size);
+float   parse_rawDegree      (const char *term_);
+
+/* one parser */
+void    GPSParserInit        (GPSParser *p);
+int     GPSParserRead        (GPSParser *p, uint8_t c);
+uint8_t GPSParserSecond      (const GPSParser *p);
+uint8_t GPSParserMinute      (const GPSParser *p);
+uint8_t GPSParserHour        (const GPSParser *p);
+uint8_t GPSParserDay         (const GPSParser *p);
+uint8_t GPSParserMonth       (const GPSParser *p);
+uint8_t GPSParserYear        (const GPSParser *p);
+float   GPSParserLatitude    (const GPSParser *p);
+float   GPSParserLongitude   (const GPSParser *p);
+float   GPSParserAltitude    (const GPSParser *p);
+uint8_t GPSParserSatellites  (const GPSParser *p);
+float   GPSParserSpeed       (const GPSParser *p);
+float   GPSParserCourse      (const GPSParser *p);
+
+/* the default parser, of the receiver of the board */
+int     GPSRead              (uint8_t c);
+uint8_t GPSSecond            (void);
+uint8_t GPSMinute            (void);
+uint8_t GPSHour              (void);
+uint8_t GPSDay               (void);
+uint8_t GPSMonth             (void);
+uint8_t GPSyear              (void);
+float   Latitude             (void);
+float   Longitude            (void);
+float   Altitude             (void);
+uint8_t Satellites           (void);
+float   Speed                (void);
+float   Course               (void);
+
+#endif /* GPS_Lib_h */
@@ -53,11 +53,7 @@
 *                                                                                                   *
 *   Name       Type       I/O      Description                                                      *
 *   ----       ----       ---      -----------                                                      *
-*   k          Kalman[3]  IO       Kalman structure                                                 *
-*   gravity    float[3]   IO                                                                        *
-*   euler      float[3]   I                                                                         *
-*   last_lla   float[3]   I        Previous long-lat-alt GPS data                                   *
-*   timesexec  int        I                                                                         *
+*   ahrs       AHRSState  IO       Navigation state of the board, see AHRSState in IMU.h            *
 *                                                                                                   *
 * EXTERNAL REFERENCES:                                                                              *
 *                                                                                                   *
@@ -85,22 +81,36 @@
 *   04-07-2020    N.di Gruttola                      1.2       Added comments, code satisfies       *
 *                  Giardino                                     iso9899:1999, as requested per      *
 *                                                               MISRA-C:2004                        *
-*                                                                                                   *
-*                                                                                                   *
+*   19-10-2026    AHRS Project                       1.3       Predict at the IMU rate, update      *
+*                                                               only on a new GPS fix, optional     *
+*                                                               steady-state gain, optional         *
+*                                                               square-root form, filters set up    *
+*                                                               from const tables, checkpoint       *
+*                                                               capture and restore, gated GPS      *
+*                                                               fixes and NIS telemetry, timing     *
+*                                                               probes, iCalc_acc_vec fixed so that *
+*                                                               the file builds on the host, the    *
+*                                                               globals are an AHRSState instance,  *
+*                                                               no allocation per sample, the       *
+*                                                               quaternion of the default madgwick  *
+*                                                               filter instead of its globals,      *
+*                                                               gravity removed before the filters  *
 *                                                                                                   *
 ****************************************************************************************************/
 
+#include <string.h>
 #include "IMU.h"
 
 /* Global variables */
 
-kalman k[3];
-float  gravity[3];
-float  euler[3];
-float  last_lla[3] ={0,0,0}; //latitude longitude altitude
-float  lla[3];
-int    timesexec   =0;
+static AHRSState ahrs;      //the AHRS of the board, see iSetup_Kalman
+
+/* Declare Prototypes */
 
+static int iAHRS_Modes(AHRSState *);
+#if defined(USE_KALMAN_STEADY_STATE)
+static int iAHRS_Steady(kalman *);
+#endif
 
 /********************************************************************************
 *                                                                               *
@@ -148,111 +158,310 @@ float fLowPassFilter(float prev, float measured, float alpha)
 
 /********************************************************************************
 *                                                                               *
-* FUNCTION NAME: setKalman                                                      *
+* FUNCTION NAME: vModel_CV                                                      *
 *                                                                               *
-* PURPOSE: set all constant Kalman values (still to add R and Q, R may be a     *
-* diagonal matrix with 0.2 as coefficient                                       *
+* PURPOSE: Rebuilds the constant velocity model of one axis for a new dt,       *
+*           called by vKalman_Predict                                           *
 *                                                                               *
 * ARGUMENT LIST:                                                                *
 *                                                                               *
 * Argument  Type         IO     Description                                     *
 * --------- --------     --     ---------------------------------               *
+* k         Kalman*      IO     Kalman structure                                *
 *                                                                               *
 * RETURN VALUE: void                                                            *
 *                                                                               *
 ********************************************************************************/
-void vSetup_Kalman()
+static void vModel_CV(kalman *k)
+{
+    k->A->matrix[0][1] = k->dt;
+    k->B->matrix[0][0] = k->dt * k->dt / 2;
+    k->B->matrix[1][0] = k->dt;
+}
+
+/*
+* Filter configurations, one table per axis (North, East, Down), constant so
+* that they stay in flash; iSetup_Kalman binds the filters to one set, the
+* other sets can be selected at run time with iSelect_Kalman. R is that of
+* the receiver (see vAHRS_ComputeGPS): the position from the first fix has
+* the variance s^2 of one fix, the velocity from the previous fix that of
+* the difference of two over the period T, 2*s^2/T^2, and both share the
+* newest fix, s^2/T. The velocity at power on is unknown up to AHRS_SPEED_MAX
+*/
+
+#define KALMAN_R_POS(s)     ((s) * (s))
+#define KALMAN_R_POSVEL(s)  ((s) * (s) / AHRS_GPS_PERIOD)
+#define KALMAN_R_VEL(s)     (2 * (s) * (s) / (AHRS_GPS_PERIOD * AHRS_GPS_PERIOD))
+
+#define KALMAN_AXIS(nm, q0, q1, sigma)                                        \
+    {                                                                         \
+        .name   = nm,                                                         \
+        .n      = 2,                                                          \
+        .m      = 2,                                                          \
+        .dt     = 0.001f,                                                     \
+        .A      = {{1, 0.001f}, {0, 1}},                                      \
+        .B      = {0.001f * 0.001f / 2, 0.001f},                              \
+        .H      = {{1, 0}, {0, 1}},                                           \
+        .Q      = {{q0, 0}, {0, q1}},                                         \
+        .R      = {{KALMAN_R_POS(sigma),    KALMAN_R_POSVEL(sigma)},          \
+                   {KALMAN_R_POSVEL(sigma), KALMAN_R_VEL(sigma)}},            \
+        .x0     = {0, 0},                                                     \
+        .P0     = {{KALMAN_R_POS(sigma), 0},                                  \
+                   {0, AHRS_SPEED_MAX * AHRS_SPEED_MAX}},                     \
+        .vModel = vModel_CV,                                                  \
+    }
+
+static const KalmanConfig kalman_sets[KALMAN_SETS][3] =
+{
+    /* KALMAN_SET_CV: no process noise */
+    { KALMAN_AXIS("north", 0, 0, AHRS_GPS_SIGMA_H),
+      KALMAN_AXIS("east",  0, 0, AHRS_GPS_SIGMA_H),
+      KALMAN_AXIS("down",  0, 0, AHRS_GPS_SIGMA_V) },
+    /* KALMAN_SET_TUNED: the acceleration error of the AHRS, 4 m/s^2 white
+       over a sample: in a coordinated turn Madgwick sees no bank and its
+       heading lags, the centripetal acceleration is lost or reversed */
+    { KALMAN_AXIS("north", 1e-6f, 1.6e-2f, AHRS_GPS_SIGMA_H),
+      KALMAN_AXIS("east",  1e-6f, 1.6e-2f, AHRS_GPS_SIGMA_H),
+      KALMAN_AXIS("down",  1e-6f, 1.6e-2f, AHRS_GPS_SIGMA_V) },
+};
+
+/********************************************************************************
+*                                                                               *
+* FUNCTION NAME: iAHRS_Init                                                     *
+*                                                                               *
+* PURPOSE: Creates the filter of each axis from the tables of a set, and the    *
+*           workspace of an AHRS, returning -1 if failed (see iAHRS_Modes),     *
+*           0 if successfull                                                    *
+*                                                                               *
+* ARGUMENT LIST:                                                                *
+*                                                                               *
+* Argument  Type         IO     Description                                     *
+* --------- --------     --     ---------------------------------               *
+* s         AHRSState*   O      AHRS, released with vAHRS_Destroy               *
+* set       unsigned int I      KALMAN_SET_CV, KALMAN_SET_TUNED                 *
+*                                                                               *
+* RETURN VALUE: int                                                             *
+*                                                                               *
+********************************************************************************/
+int iAHRS_Init(AHRSState *s, unsigned int set)
+{
+    int ret = 0;
+
+    if (set >= KALMAN_SETS)
+    {
+        return -1;
+    }
+    memset(s, 0, sizeof(*s));
+
+    //one 2-state (position, velocity) filter per axis, workspace included
+    for (int i = 0; i < 3; i++)
+    {
+        ret |= iKalman_InitConfig(&s->k[i], &kalman_sets[set][i]);
+    }
+    s->z        = pxCreate(2, 1);
+    s->acc      = pxCreate(3, 1);
+    s->rotation = pxCreate(3, 3);
+    s->inv      = pxCreate(3, 3);
+    if (ret != 0 || s->z == NULL || s->acc == NULL || s->rotation == NULL || s->inv == NULL)
+    {
+        vAHRS_Destroy(s);
+        return -1;
+    }
+
+    //chi-square gate on the GPS innovation, also stops the fixes of a receiver
+    //that has no position yet
+    for (int i = 0; i < 3; i++)
+    {
+        iKalman_SetGate(&s->k[i], KALMAN_GATE_DEFAULT);
+    }
+
+    if (iAHRS_Modes(s) != 0)
+    {
+        vAHRS_Destroy(s);
+        return -1;
+    }
+
+    return 0;
+}
+
+#if defined(USE_KALMAN_STEADY_STATE)
+/********************************************************************************
+*                                                                               *
+* FUNCTION NAME: iAHRS_Steady                                                   *
+*                                                                               *
+* PURPOSE: Freezes the gain of one axis filter for the GPS fixes: the gain is   *
+*           taken once per fix, not once per sample, so the Riccati equation    *
+*           is solved over the fix period, with the Q of its n samples, sum of  *
+*           A^j*Q*A^j^T; A and Q of the sample are then restored, the frozen    *
+*           gain is kept. Returning -1 if failed, 0 if successfull              *
+*                                                                               *
+* ARGUMENT LIST:                                                                *
+*                                                                               *
+* Argument  Type         IO     Description                                     *
+* --------- --------     --     ---------------------------------               *
+* k         Kalman*      IO     Axis filter, Q diagonal and positive            *
+*                                                                               *
+* RETURN VALUE: int                                                             *
+*                                                                               *
+********************************************************************************/
+static int iAHRS_Steady(kalman *k)
+{
+    int   ret;
+    float dt = k->dt;
+    float q0 = k->Q->matrix[0][0];
+    float q1 = k->Q->matrix[1][1];
+    float n  = roundf(AHRS_GPS_PERIOD / dt);
+
+    if (!(q0 > 0) || !(q1 > 0))
+    {
+        return -1;
+    }
+
+    k->Q->matrix[0][0] = n * q0 + dt * dt * q1 * (n - 1) * n * (2 * n - 1) / 6;
+    k->Q->matrix[0][1] = dt * q1 * (n - 1) * n / 2;
+    k->Q->matrix[1][0] = k->Q->matrix[0][1];
+    k->Q->matrix[1][1] = n * q1;
+    k->dt = AHRS_GPS_PERIOD;
+    k->vModel(k);
+    ret = iKalman_SteadyState(k, 10000, 1e-6f);
+
+    k->Q->matrix[0][0] = q0;
+    k->Q->matrix[0][1] = 0;
+    k->Q->matrix[1][0] = 0;
+    k->Q->matrix[1][1] = q1;
+    k->dt = dt;
+    k->vModel(k);
+
+    return ret;
+}
+#endif
+
+/********************************************************************************
+*                                                                               *
+* FUNCTION NAME: iAHRS_Modes                                                    *
+*                                                                               *
+* PURPOSE: Puts the axis filters in the square-root and steady-state forms      *
+*           of the build, returning -1 if the set cannot run in them: both      *
+*           need process noise, chol(Q) fails on Q = 0 and the steady gain of   *
+*           a filter without it is zero, it would never take a GPS fix          *
+*                                                                               *
+* ARGUMENT LIST:                                                                *
+*                                                                               *
+* Argument  Type         IO     Description                                     *
+* --------- --------     --     ---------------------------------               *
+* s         AHRSState*   IO     AHRS, filters loaded from a set                 *
+*                                                                               *
+* RETURN VALUE: int                                                             *
+*                                                                               *
+********************************************************************************/
+static int iAHRS_Modes(AHRSState *s)
 {
-    k->P = pxCreate(2, 2);
-    k->K = pxCreate(2, 2);
-    k->H = pxCreate(2, 2);
-    k->R = pxCreate(2, 2);
-    k->Q = pxCreate(2, 2);
-    k->A = pxCreate(2, 2);
-    k->S = pxCreate(2, 2);
-
-    k->x = pxCreate(2, 1);
-    k->y = pxCreate(2, 1);
-    k->B = pxCreate(2, 1);
-
-    //setting the North Kalman
-    //set Dt
-    k[0].dt=0.001;
-    //set x0                                                                                        
-    k[0].x->matrix[0][0]=0;
-    k[0].x->matrix[1][0] = 0;
-    //set A
-    k[0].A->matrix[0][0] = 1;
-    k[0].A->matrix[0][1] = k[0]dt;
-    k[0].A->matrix[1][0] = 0;
-    k[0].A->matrix[1][1] = 1;
-    //set B
-    k[0].B->matrix[0][0] = k[0].dt * k[0].dt / 2;
-    k[0].B->matrix[1][0] = k[0].dt;
-    //values either 1 or 0.1, to be decided
-    k[0].P->matrix[0][0] = 1;
-    k[0].P->matrix[0][1] = 0;
-    k[0].P->matrix[1][0] = 0;
-    k[0].P->matrix[1][1] = 1;
-    //set H
-    k[0].H->matrix[0][0] = 1;
-    k[0].H->matrix[0][1] = 0;
-    k[0].H->matrix[1][0] = 0;
-    k[0].H->matrix[1][1] = 1; 
-    //set R
-    k[0].R->matrix[0][0] = 0.2;
-    k[0].R->matrix[0][1] = 0;
-    k[0].R->matrix[1][0] = 0;
-    k[0].R->matrix[1][1] = 0.2;
-
-    //setting the South Kalman
-    k[1].dt=0.001;                                                                                                  
-    k[1].x->matrix[0][0]=0;      k[1].x.matrix[0][1]=0;                                                           
-    k[1].A->matrix[0][0] = 1;
-    k[1].A->matrix[0][1] = k[1].dt;
-    k[1].A->matrix[1][0] = 0;
-    k[1].A->matrix[1][1] = 1;                                                                                 
-    k[1].A->matrix[0][0] = 1;
-    k[1].A->matrix[0][1] = k[1].dt;
-    k[1].A->matrix[1][0] = 0;
-    k[1].A->matrix[1][1] = 1;                                                                                     
-    k[1].B->matrix[0][0] = k[1].dt * k[1].dt / 2;
-    k[1].B->matrix[0][1] = k[1].dt;                                                                       
-    k[1].P->matrix[0][0] = 1;
-    k[1].P->matrix[0][1] = 0;
-    k[1].P->matrix[1][0] = 0;
-    k[1].P->matrix[1][1] = 1;                                                                                  
-    k[1].H->matrix[0][0] = 1;
-    k[1].H->matrix[0][1] = 0;
-    k[1].H->matrix[1][0] = 0;
-    k[1].H->matrix[1][1] = 1;                                                                               
-    k[1].R->matrix[0][0] = 0.2;
-    k[1].R->matrix[0][1] = 0;
-    k[1].R->matrix[1][0] = 0;
-    k[1].R->matrix[1][1] = 0.2; //set R
-
-    //setting the Down Kalman
-    k[2].dt=0.001;                                                                                               
-    k[2].x->matrix[0][0] = 0;
-    k[2].x->matrix[0][1] = 0;                                                                                  
-    k[2].A->matrix[0][0] = 1;
-    k[2].A->matrix[0][1] = k[2].dt;
-    k[2].A->matrix[1][0] = 0;
-    k[2].A->matrix[1][1] = 1;                                                                                   
-    k[2].B->matrix[0][0] = k[2].dt * k[2].dt / 2;
-    k[2].B->matrix[0][1] = k[2].dt;                                                                   
-    k[2].P->matrix[0][0] = 1;
-    k[2].P->matrix[0][1] = 0;
-    k[2].P->matrix[1][0] = 0;
-    k[2].P->matrix[1][1] = 1;                                                                                  
-    k[2].H->matrix[0][0] = 1;
-    k[2].H->matrix[0][1] = 0;
-    k[2].H->matrix[1][0] = 0;
-    k[2].H->matrix[1][1] = 1;                                                                                 
-    k[2].R->matrix[0][0] = 0.2;
-    k[2].R->matrix[0][1] = 0;
-    k[2].R->matrix[1][0] = 0;
-    k[2].R->matrix[1][1] = 0.2; //set R
+    int ret = 0;
+
+    (void)s;
+#if defined(USE_KALMAN_SQRT)
+    //propagate chol(P) instead of P: P stays symmetric positive definite in float
+    for (int i = 0; i < 3; i++)
+    {
+        ret |= iKalman_SquareRoot(&s->k[i], 1);
+    }
+#endif
+
+#if defined(USE_KALMAN_STEADY_STATE)
+    //A, B, H, Q and R are constant: solve the Riccati equation once, then each
+    //sample is x=A*x+B*u and each fix x+=K*(z-H*x); a new R passed to
+    //iKalman_Update reverts that axis to the full filter
+    for (int i = 0; i < 3 && ret == 0; i++)
+    {
+        ret = iAHRS_Steady(&s->k[i]);
+    }
+#endif
+
+    return ret;
+}
+
+/********************************************************************************
+*                                                                               *
+* FUNCTION NAME: iSetup_Kalman                                                  *
+*                                                                               *
+* PURPOSE: Creates the filter of each axis from the tables of set               *
+*           KALMAN_SET_DEFAULT, for the AHRS of the board                       *
+*           returning -1 if failed, the AHRS is then left empty and the         *
+*           functions on it do nothing, 0 if successfull                        *
+*                                                                               *
+* ARGUMENT LIST:                                                                *
+*                                                                               *
+* Argument  Type         IO     Description                                     *
+* --------- --------     --     ---------------------------------               *
+*                                                                               *
+* RETURN VALUE: int                                                             *
+*                                                                               *
+********************************************************************************/
+int iSetup_Kalman(void)
+{
+    return iAHRS_Init(&ahrs, KALMAN_SET_DEFAULT);
+}
+
+/********************************************************************************
+*                                                                               *
+* FUNCTION NAME: iSelect_Kalman                                                 *
+*                                                                               *
+* PURPOSE: Switches the filters created by iSetup_Kalman to another set of      *
+*           tables, without allocating; the state restarts from x0 and P0       *
+*           returning -1 if failed (also if the set has no process noise and    *
+*           the build uses the square-root or steady-state form), 0 if          *
+*           successfull                                                         *
+*                                                                               *
+* ARGUMENT LIST:                                                                *
+*                                                                               *
+* Argument  Type         IO     Description                                     *
+* --------- --------     --     ---------------------------------               *
+* set       unsigned int I      KALMAN_SET_CV, KALMAN_SET_TUNED                 *
+*                                                                               *
+* RETURN VALUE: int                                                             *
+*                                                                               *
+********************************************************************************/
+int iSelect_Kalman(unsigned int set)
+{
+    return iAHRS_Select(&ahrs, set);
+}
+
+/********************************************************************************
+*                                                                               *
+* FUNCTION NAME: iAHRS_Select                                                   *
+*                                                                               *
+* PURPOSE: iSelect_Kalman of one AHRS                                           *
+*                                                                               *
+* ARGUMENT LIST:                                                                *
+*                                                                               *
+* Argument  Type         IO     Description                                     *
+* --------- --------     --     ---------------------------------               *
+* s         AHRSState*   IO     AHRS                                            *
+* set       unsigned int I      KALMAN_SET_CV, KALMAN_SET_TUNED                 *
+*                                                                               *
+* RETURN VALUE: int                                                             *
+*                                                                               *
+********************************************************************************/
+int iAHRS_Select(AHRSState *s, unsigned int set)
+{
+    int ret = 0;
+
+    //s->z is NULL if iAHRS_Init failed, or before it
+    if (set >= KALMAN_SETS || s->z == NULL)
+    {
+        return -1;
+    }
+    for (int i = 0; i < 3; i++)
+    {
+        ret |= iKalman_LoadConfig(&s->k[i], &kalman_sets[set][i]);
+    }
+    if (ret == 0)
+    {
+        //iKalman_LoadConfig leaves the steady-state form
+        ret = iAHRS_Modes(s);
+    }
+
+    return ret;
 }
 
 /********************************************************************************
@@ -273,22 +482,46 @@ void vSetup_Kalman()
 ********************************************************************************/
 void vCalculateYPR(float *q, float *ypr)
 {
+    vAHRS_YPR(&ahrs, q, ypr);
+}
+
+/********************************************************************************
+*                                                                               *
+* FUNCTION NAME: vAHRS_YPR                                                      *
+*                                                                               *
+* PURPOSE: vCalculateYPR of one AHRS, gravity and Euler angles kept in it       *
+*                                                                               *
+* ARGUMENT LIST:                                                                *
+*                                                                               *
+* Argument  Type         IO     Description                                     *
+* --------- --------     --     ---------------------------------               *
+* s         AHRSState*   IO     AHRS                                            *
+* q         const float* I      Quaternion                                      *
+* ypr       float*       O      Yaw Pitch and Roll                              *
+*                                                                               *
+* RETURN VALUE: void                                                            *
+*                                                                               *
+********************************************************************************/
+void vAHRS_YPR(AHRSState *s, const float q[4], float *ypr)
+{
+    float *gravity = s->gravity;
+
     // calculate gravity vector
-    gravity[0] = 2 * (q1*q3 - q0*q2);
-    gravity[1] = 2 * (q0*q1 + q2*q3);
-    gravity[2] = q0*q0 - q1*q1 - q2*q2 + q3*q3;
+    gravity[0] = 2 * (q[1]*q[3] - q[0]*q[2]);
+    gravity[1] = 2 * (q[0]*q[1] + q[2]*q[3]);
+    gravity[2] = q[0]*q[0] - q[1]*q[1] - q[2]*q[2] + q[3]*q[3];
 
 
     // calculate yaw/pitch/roll angles
-    ypr[0] = atan2(2*q1*q2 - 2*q0*3, 2*q0*q0 + 2*q1*q1 - 1);
+    ypr[0] = atan2(2*q[1]*q[2] - 2*q[0]*3, 2*q[0]*q[0] + 2*q[1]*q[1] - 1);
     ypr[1] = atan(gravity[0] / sqrt(gravity[1]*gravity[1] + gravity[2]*gravity[2]));
     ypr[2] = atan(gravity[1] / sqrt(gravity[0]*gravity[0] + gravity[2]*gravity[2]));
 
 
     // calculate Euler angles (they're also yaw, pitch and roll, differences tbd, Wikipedia uses those ones)
-    euler[0] = atan2(2*q[1]*q[2] - 2*q[0]*q[3], 2*q[0]*q[0] + 2*q[1]*q[1] - 1);
-    euler[1] = -asin(2*q[1]*q[3] + 2*q[0]*q[2]);
-    euler[2] = atan2(2*q[2]*q[3] - 2*q[0]*q[1], 2*q[0]*q[0] + 2*q[3]*q[3] - 1);
+    s->euler[0] = atan2(2*q[1]*q[2] - 2*q[0]*q[3], 2*q[0]*q[0] + 2*q[1]*q[1] - 1);
+    s->euler[1] = -asin(2*q[1]*q[3] + 2*q[0]*q[2]);
+    s->euler[2] = atan2(2*q[2]*q[3] - 2*q[0]*q[1], 2*q[0]*q[0] + 2*q[3]*q[3] - 1);
 }
 
 /********************************************************************************
@@ -311,6 +544,7 @@ void vCalculateYPR(float *q, float *ypr)
 ********************************************************************************/
 Matrix *pxCalc_acc_vec(Matrix *a, const float offsetx, const float offsety)
 {
+    const float q0 = madgwick.q0, q1 = madgwick.q1, q2 = madgwick.q2, q3 = madgwick.q3;
     Matrix *acc = pxCreate(3, 1);
     Matrix *rotation = pxCreate(3, 3);
 
@@ -330,7 +564,7 @@ Matrix *pxCalc_acc_vec(Matrix *a, const float offsetx, const float offsety)
     rotation->matrix[2][0] = 2 * (q1 * q3 + q0 * q2);
     rotation->matrix[0][1] = 2 * (q1 * q2 + q0 * q3);
     rotation->matrix[1][1] = q0 * q0 - q1 * q1 + q2 * q2 - q3 * q3;
-    rotation->matrix[2][1] = 2 * (q1 * q3 - q0 * q1);
+    rotation->matrix[2][1] = 2 * (q2 * q3 - q0 * q1);
     rotation->matrix[0][2] = 2 * (q1 * q3 - q0 * q2);
     rotation->matrix[1][2] = 2 * (q2 * q3 + q0 * q1);
     rotation->matrix[2][2] = q0 * q0 - q1 * q1 - q2 * q2 + q3 * q3;
@@ -346,20 +580,47 @@ Matrix *pxCalc_acc_vec(Matrix *a, const float offsetx, const float offsety)
     vDestroy(rotation);
 
     //rotating vector to get accN and accE
-    acc->matrix[0]-=offsetx;
-    acc->matrix[1]-=offsety;
+    acc->matrix[0][0]-=offsetx;
+    acc->matrix[1][0]-=offsety;
 
     return acc;
 }
 
+/********************************************************************************
+*                                                                               *
+* FUNCTION NAME: iCalc_acc_vec                                                  *
+*                                                                               *
+* PURPOSE: pxCalc_acc_vec into a matrix of the caller                           *
+*           returning -1 if failed, 0 if successfull                            *
+*                                                                               *
+* ARGUMENT LIST:                                                                *
+*                                                                               *
+* Argument  Type         IO     Description                                     *
+* --------- --------     --     ---------------------------------               *
+* acc       Matrix*      O      Acceleration North, East and Down, 3 x 1        *
+* a         Matrix*      I      Accelerometer data                              *
+* offsetx   const float  I      x axis offset                                   *
+* offsety   const float  I      y axis offset                                   *
+*                                                                               *
+* RETURN VALUE: int                                                             *
+*                                                                               *
+********************************************************************************/
 int iCalc_acc_vec(Matrix* acc, Matrix *a, const float offsetx, const float offsety)
 {
-    if(acc != NULL)
+    Matrix *app;
+
+    if(acc == NULL || a == NULL)
     {
         return -1;
     }
 
-    acc = pxCalc_acc_vec(acc, a, offsetx, offsety);
+    app = pxCalc_acc_vec(a, offsetx, offsety);
+    if(app == NULL || iCopy(acc, app) != 0)
+    {
+        vDestroy(app);
+        return -1;
+    }
+    vDestroy(app);
 
     return 0;
 }
@@ -384,9 +645,42 @@ int iCalc_acc_vec(Matrix* acc, Matrix *a, const float offsetx, const float offse
 ********************************************************************************/
 void vCompute_GPS(float lla[3], float x[3], float v[3])
 {
+    vAHRS_ComputeGPS(&ahrs, lla, x, v);
+}
+
+/********************************************************************************
+*                                                                               *
+* FUNCTION NAME: vAHRS_ComputeGPS                                               *
+*                                                                               *
+* PURPOSE: vCompute_GPS of one AHRS: the position from its first fix, the       *
+*           velocity from its previous one                                      *
+*                                                                               *
+* ARGUMENT LIST:                                                                *
+*                                                                               *
+* Argument  Type         IO     Description                                     *
+* --------- --------     --     ---------------------------------               *
+* s         AHRSState*   IO     AHRS                                            *
+* lla       float[3]     IO     Lat-lon-alt, in metres on return                *
+* x         float[3]     O      position from the first fix                     *
+* v         float[3]     O      velocity                                        *
+*                                                                               *
+* RETURN VALUE: void                                                            *
+*                                                                               *
+********************************************************************************/
+void vAHRS_ComputeGPS(AHRSState *s, float lla[3], float x[3], float v[3])
+{
+    float *last_lla = s->last_lla;
     float d_poles = 20004500;
     float r_earth = 6378388;
 
+    //the parallel of the first fix for every fix: with that of each fix, the
+    //noise and the motion in latitude would move East too
+    int first = (last_lla[0]==0 && last_lla[1]==0 && last_lla[2]==0);
+    if (first)
+    {
+        s->parallel = 2 * M_PI * r_earth * cosf(fDegtorad(lla[0]));
+    }
+
     //conversion to radians
     lla[0] += 90;
     lla[1] += 180;
@@ -396,13 +690,13 @@ void vCompute_GPS(float lla[3], float x[3], float v[3])
     rad = fDegtorad(lla[1]);
     lla[1] = rad;
 
-    //convertion to meters
+    //convertion to meters, on the surface: scaled by the altitude the noise
+    //of the altitude would move North and East too
     float meters_lat;
-    meters_lat = lla[0] / M_PI * (d_poles + M_PI * lla[2]);
-    float C;
-    C = 2 * M_PI * (r_earth + lla[2]) * cosf(lla[0]);
+    meters_lat = lla[0] / M_PI * d_poles;
     float meters_lon;
-    meters_lon = lla[1] / (2 * M_PI) * C;
+    //to the West, as the second axis of the acceleration
+    meters_lon = -lla[1] / (2 * M_PI) * s->parallel;
     lla[0] = meters_lat;
     lla[1] = meters_lon;
 
@@ -417,18 +711,22 @@ void vCompute_GPS(float lla[3], float x[3], float v[3])
     v = k.x0[1] + (x - k.x0[0])/k.dt;
     ========================================================================*/
     
-    if (last_lla[0]==0 && last_lla[1]==0 && last_lla[2]==0) 
+    if (first)
     {
-        //only the first time
-        last_lla[0] = lla[0];
-        last_lla[1] = lla[1];
-        last_lla[2] = lla[2];
+        //only the first time: the positions start where the filters are
+        for (int i = 0; i < 3; i++)
+        {
+            last_lla[i]  = lla[i];
+            s->origin[i] = lla[i] - s->k[i].x->matrix[0][0];
+        }
     }
 
+    //the position from the first fix has the error of one fix, the velocity
+    //from the previous one that of two over gps_dt, see kalman_sets
     for (int i = 0; i < 3; i++)
     {
-        x[i] = k[i].x.matrix[0][0] + (lla[i] - last_lla[i]);
-        v[i] = k[i].x.matrix[1][0] + (x[i] - k[i].x.matrix[0][0]) / k[i].dt;
+        x[i] = lla[i] - s->origin[i];
+        v[i] = (lla[i] - last_lla[i]) / s->gps_dt;
     }
 
     last_lla[0] = lla[0];
@@ -441,25 +739,71 @@ void vCompute_GPS(float lla[3], float x[3], float v[3])
 * FUNCTION NAME: vCompute_GPS                                                   *
 *                                                                               *
 * PURPOSE: Using acceleration vector and latlongalt to calculate the velocity   *
-*               passing through the Kalman Filter                               *
+*               passing through the Kalman Filter: predicts at every call,      *
+*               updates only when a new GPS fix is ready                        *
+*                                                                               *
+* ARGUMENT LIST:                                                                *
+*                                                                               *
+* Argument  Type         IO     Description                                     *
+* --------- --------     --     ---------------------------------               *
+* velocity  float*       O      velocity                                        *
+* a         Matrix*      I      Accelerometer data, 3 x 1                       *
+* gps       int          I      GPSREADY or GPSNOTREADY                         *
+*                                                                               *
+* RETURN VALUE: void                                                            *
+*                                                                               *
+********************************************************************************/
+void vCalculate_velocity(float* velocity, Matrix *a, int gps)
+{
+    float q[4] = {madgwick.q0, madgwick.q1, madgwick.q2, madgwick.q3};
+    float fix[3];
+
+    if(gps == GPSREADY)
+    {
+        fix[0] = Latitude();
+        fix[1] = Longitude();
+        fix[2] = Altitude();
+    }
+    vAHRS_Velocity(&ahrs, q, velocity, a, gps == GPSREADY ? fix : NULL);
+}
+
+/********************************************************************************
+*                                                                               *
+* FUNCTION NAME: vAHRS_Velocity                                                 *
+*                                                                               *
+* PURPOSE: vCalculate_velocity of one AHRS; the rotation is computed in the     *
+*           workspace of the AHRS, nothing is allocated                         *
 *                                                                               *
 * ARGUMENT LIST:                                                                *
 *                                                                               *
 * Argument  Type         IO     Description                                     *
 * --------- --------     --     ---------------------------------               *
-* lla       float*       O      velocity                                        *
-* x         float3]      I       lat/long/alt                                   *
+* s         AHRSState*   IO     AHRS                                            *
+* q         const float* I      Quaternion                                      *
+* velocity  float*       O      velocity                                        *
+* a         Matrix*      I      Accelerometer data, 3 x 1                       *
+* fix       const float* I      New lat-lon-alt of the GPS, NULL if none        *
 *                                                                               *
 * RETURN VALUE: void                                                            *
 *                                                                               *
 ********************************************************************************/
-void vCalculate_velocity(float* velocity, int a)
+void vAHRS_Velocity(AHRSState *s, const float q[4], float* velocity, Matrix *a, const float *fix)
 { 
+    PROBE_BEGIN(PROBE_VELOCITY);
+    kalman *k = s->k;
+    Matrix *acc = s->acc;
+    Matrix *rotation = s->rotation;
     float x[3];
     float v[3];
+    float n;
 
-    Matrix *acc = pxCreate(3, 1);
-    Matrix *rotation = pxCreate(3, 3);
+    //an AHRS that iAHRS_Init failed to create has no filters to run
+    if (s->z == NULL)
+    {
+        velocity[0] = velocity[1] = velocity[2] = 0;
+        PROBE_END(PROBE_VELOCITY);
+        return;
+    }
 
     /*normalize the quaternion
        float n;
@@ -472,68 +816,324 @@ void vCalculate_velocity(float* velocity, int a)
 
 
     //calculating rotation matrix
-    rotation->matrix[0][0] = q0 * q0 + q1 * q1 - q2 * q2 - q3 * q3;
-    rotation->matrix[1][0] = 2 * (q1 * q2 - q0 * q3);
-    rotation->matrix[2][0] = 2 * (q1 * q3 + q0 * q2);
-    rotation->matrix[0][1] = 2 * (q1 * q2 + q0 * q3);
-    rotation->matrix[1][1] = q0 * q0 - q1 * q1 + q2 * q2 - q3 * q3;
-    rotation->matrix[2][1] = 2 * (q1 * q3 - q0 * q1);
-    rotation->matrix[0][2] = 2 * (q1 * q3 - q0 * q2);
-    rotation->matrix[1][2] = 2 * (q2 * q3 + q0 * q1);
-    rotation->matrix[2][2] = q0 * q0 - q1 * q1 - q2 * q2 + q3 * q3;
+    rotation->matrix[0][0] = q[0] * q[0] + q[1] * q[1] - q[2] * q[2] - q[3] * q[3];
+    rotation->matrix[1][0] = 2 * (q[1] * q[2] - q[0] * q[3]);
+    rotation->matrix[2][0] = 2 * (q[1] * q[3] + q[0] * q[2]);
+    rotation->matrix[0][1] = 2 * (q[1] * q[2] + q[0] * q[3]);
+    rotation->matrix[1][1] = q[0] * q[0] - q[1] * q[1] + q[2] * q[2] - q[3] * q[3];
+    rotation->matrix[2][1] = 2 * (q[2] * q[3] - q[0] * q[1]);
+    rotation->matrix[0][2] = 2 * (q[1] * q[3] - q[0] * q[2]);
+    rotation->matrix[1][2] = 2 * (q[2] * q[3] + q[0] * q[1]);
+    rotation->matrix[2][2] = q[0] * q[0] - q[1] * q[1] - q[2] * q[2] + q[3] * q[3];
 
     //calculating acceleration vector
     //rotation*g=acc;       inverse rotation;       invrot*acc=a;
-    Matrix* app;
-    app = pxInverse(rotation);
-    iMultiply(acc, app, a);
-    vDestroy(app);
+    //rotation is |q|^2 times the rotation of q/|q|, whose inverse is its
+    //transpose: invSqrt leaves |q| a little under 1, and the specific force
+    //must keep its length for gravity to cancel
+    n = q[0] * q[0] + q[1] * q[1] + q[2] * q[2] + q[3] * q[3];
+    iTranspose(s->inv, rotation);
+    iSc_Multiply(s->inv, s->inv, 1.0f / n);
+    iMultiply(acc, s->inv, a);
+    //the specific force has +g on the vertical axis, the filters want the motion
+    acc->matrix[2][0] -= AHRS_GRAVITY;
 
+    //predict at the IMU rate (1 kHz), the accelerometer is the control input
     for (int i = 0; i < 3; i++)
     {
-        x[i] = k[i].x->matrix[0][0];
-        v[i] = k[i].x->matrix[0][1];
+        vKalman_Predict(&k[i], k[i].dt, acc->matrix[i][0]);
     }
-    Matrix *GPS = pxCreate(1, 1);
+    s->gps_dt += k[0].dt;
 
-    //this piece of code works while the GPS retrieves data (the IMU works at 1800Hz, while the GPS works at 1 to 5Hz)
-    if(!a)
-    {//can also be else if(lla[0]==lastlla[0] &&...&&...)
-        for (int i=0; i<3; i++) 
-        {
-            x[i] += acc->matrix[0][i] * sampleFreq * sampleFreq;
-            v[i] += acc->matrix[0][i] * sampleFreq;
-        }
+    //update only when GPSRead completed a new RMC + GGA pair (1 to 5 Hz),
+    //position and velocity together, they share the newest fix and R is not
+    //diagonal, iKalman_UpdateSeq cannot take it. Before the receiver has a
+    //position the RMC fields are empty and parse as 0, 0: such a fix is
+    //dropped before vAHRS_ComputeGPS, so that it never becomes last_lla
+    if(fix != NULL)
+    {
+        s->lla[0] = fix[0];
+        s->lla[1] = fix[1];
+        s->lla[2] = fix[2];
     }
-    //this is the code that computes GPS data into position and velocity
-    else
+    if(fix != NULL && (s->lla[0] != 0 || s->lla[1] != 0) && isfinite(s->lla[0]) && isfinite(s->lla[1]))
     {
-        vCompute_GPS(lla, x, v);
+        //the first fix only places the origin, there is no velocity before it
+        int first = (s->last_lla[0] == 0 && s->last_lla[1] == 0 && s->last_lla[2] == 0);
+
+        PROBE_BEGIN(PROBE_GPS_UPDATE);
+        vAHRS_ComputeGPS(s, s->lla, x, v);
+        for (int i = 0; i < 3 && !first; i++)
+        {
+            int ret;
+
+            s->z->matrix[0][0] = x[i];
+            s->z->matrix[1][0] = v[i];
+            //the steady-state form has no P0 to take the unknown velocity at
+            //power on with, its P is the converged one: the track starts here
+            if (s->fixes == 1 && k[i].steady)
+            {
+                iCopy(k[i].x, s->z);
+                continue;
+            }
+            ret = iKalman_Update(&k[i], s->z, NULL);
+            //rejected KALMAN_GATE_MISSES times in a row the track is lost, e.g.
+            //after an outage or a warm start far away: take this fix ungated,
+            //with P inflated so that it moves x to it
+            if (ret == 1 && k[i].misses >= KALMAN_GATE_MISSES)
+            {
+                int gate = k[i].gate;
+
+                iKalman_Inflate(&k[i], KALMAN_GATE_INFLATE);
+                k[i].gate = KALMAN_GATE_OFF;
+                iKalman_Update(&k[i], s->z, NULL);
+                k[i].gate   = gate;
+                k[i].misses = 0;
+            }
+#if defined(USE_KALMAN_STEADY_STATE)
+            //the frozen P is that of a filter taking every fix: after a
+            //rejected one the full filter runs, its P grows over the missed
+            //period, and the axis returns to the frozen gain at the next fix
+            //it takes
+            if (ret == 1 && k[i].steady)
+            {
+                iKalman_Inflate(&k[i], 1.0f);
+            }
+            else if (ret == 0 && !k[i].steady)
+            {
+                iAHRS_Steady(&k[i]);
+            }
+#endif
+        }
+        s->gps_dt = 0;
+        if (s->fixes < 2)
+        {
+            s->fixes++;
+        }
+        PROBE_END(PROBE_GPS_UPDATE);
     }
+
     for (int i = 0; i < 3; i++)
     {
-        GPS.matrix[0][0] = lla[i];
-        vKalman_Filter(&k[i], acc->matrix[0][i], GPS);
         velocity[i] = k[i].x->matrix[1][0];
     }
 
-    vDestroy(GPS);
-    vDestroy(acc);
-    vDestroy(rotation);
+    PROBE_END(PROBE_VELOCITY);
+}
+
+/********************************************************************************
+*                                                                               *
+* FUNCTION NAME: vGet_NIS                                                       *
+*                                                                               *
+* PURPOSE: Telemetry of the GPS gate: running mean of the normalised            *
+*           innovation squared of the accepted fixes of each axis, about 2      *
+*           (position and velocity) when R and Q are right, higher if the       *
+*           filter is overconfident, and the number of rejected fixes           *
+*                                                                               *
+* ARGUMENT LIST:                                                                *
+*                                                                               *
+* Argument  Type         IO     Description                                     *
+* --------- --------     --     ---------------------------------               *
+* nis       float[3]     O      Mean NIS per axis                               *
+* rejected  ulong[3]     O      Fixes rejected per axis                         *
+*                                                                               *
+* RETURN VALUE: void                                                            *
+*                                                                               *
+********************************************************************************/
+void vGet_NIS(float nis[3], unsigned long rejected[3])
+{
+    vAHRS_GetNIS(&ahrs, nis, rejected);
+}
+
+/********************************************************************************
+*                                                                               *
+* FUNCTION NAME: vAHRS_GetNIS                                                   *
+*                                                                               *
+* PURPOSE: vGet_NIS of one AHRS                                                 *
+*                                                                               *
+* ARGUMENT LIST:                                                                *
+*                                                                               *
+* Argument  Type         IO     Description                                     *
+* --------- --------     --     ---------------------------------               *
+* s         AHRSState*   I      AHRS                                            *
+* nis       float[3]     O      Mean NIS per axis                               *
+* rejected  ulong[3]     O      Fixes rejected per axis                         *
+*                                                                               *
+* RETURN VALUE: void                                                            *
+*                                                                               *
+********************************************************************************/
+void vAHRS_GetNIS(const AHRSState *s, float nis[3], unsigned long rejected[3])
+{
+    for (int i = 0; i < 3; i++)
+    {
+        nis[i]      = s->k[i].nis_mean;
+        rejected[i] = s->k[i].rejected;
+    }
 }
 
 void vDelete_Kalman()
 {
+    vAHRS_Destroy(&ahrs);
+}
+
+/********************************************************************************
+*                                                                               *
+* FUNCTION NAME: vAHRS_Destroy                                                  *
+*                                                                               *
+* PURPOSE: Releases the filters and the workspace of an AHRS                    *
+*                                                                               *
+* ARGUMENT LIST:                                                                *
+*                                                                               *
+* Argument  Type         IO     Description                                     *
+* --------- --------     --     ---------------------------------               *
+* s         AHRSState*   IO     AHRS                                            *
+*                                                                               *
+* RETURN VALUE: void                                                            *
+*                                                                               *
+********************************************************************************/
+void vAHRS_Destroy(AHRSState *s)
+{
+    for (int i = 0; i < 3; i++)
+    {
+        vKalman_Destroy(&s->k[i]);
+    }
+    vDestroy(s->z);
+    vDestroy(s->acc);
+    vDestroy(s->rotation);
+    vDestroy(s->inv);
+    memset(s, 0, sizeof(*s));
+}
+
+/********************************************************************************
+*                                                                               *
+* FUNCTION NAME: vCapture_Checkpoint                                            *
+*                                                                               *
+* PURPOSE: Copies the Madgwick quaternion and x and P of the three axis         *
+*           filters into a checkpoint record; this AHRS estimates no bias,      *
+*           the bias fields are zero                                            *
+*                                                                               *
+* ARGUMENT LIST:                                                                *
+*                                                                               *
+* Argument  Type         IO     Description                                     *
+* --------- --------     --     ---------------------------------               *
+* r         CheckpointRec* O    Record, header and CRC left to iCheckpoint_Save *
+*                                                                               *
+* RETURN VALUE: void                                                            *
+*                                                                               *
+********************************************************************************/
+void vCapture_Checkpoint(CheckpointRecord *r)
+{
+    float q[4] = {madgwick.q0, madgwick.q1, madgwick.q2, madgwick.q3};
 
-    vDestroy(k->x);
-    vDestroy(k->P);
-    vDestroy(k->y);
-    vDestroy(k->B);
-    vDestroy(k->K);
-    vDestroy(k->H);
-    vDestroy(k->R);
-    vDestroy(k->Q);
-    vDestroy(k->A);
-    vDestroy(k->S);
-
-}
\ No newline at end of file
+    vAHRS_Capture(&ahrs, q, r);
+}
+
+/********************************************************************************
+*                                                                               *
+* FUNCTION NAME: vAHRS_Capture                                                  *
+*                                                                               *
+* PURPOSE: vCapture_Checkpoint of one AHRS                                      *
+*                                                                               *
+* ARGUMENT LIST:                                                                *
+*                                                                               *
+* Argument  Type         IO     Description                                     *
+* --------- --------     --     ---------------------------------               *
+* s         AHRSState*   I      AHRS                                            *
+* q         const float* I      Quaternion                                      *
+* r         CheckpointRec* O    Record, header and CRC left to iCheckpoint_Save *
+*                                                                               *
+* RETURN VALUE: void                                                            *
+*                                                                               *
+********************************************************************************/
+void vAHRS_Capture(const AHRSState *s, const float q[4], CheckpointRecord *r)
+{
+    const kalman *k = s->k;
+
+    r->q[0] = q[0];
+    r->q[1] = q[1];
+    r->q[2] = q[2];
+    r->q[3] = q[3];
+    for (int i = 0; i < 3 && s->z != NULL; i++)
+    {
+        r->x[i][0]      = k[i].x->matrix[0][0];
+        r->x[i][1]      = k[i].x->matrix[1][0];
+        r->P[i][0]      = k[i].P->matrix[0][0];
+        r->P[i][1]      = k[i].P->matrix[0][1];
+        r->P[i][2]      = k[i].P->matrix[1][1];
+        r->gyro_bias[i] = 0;
+        r->acc_bias[i]  = 0;
+    }
+}
+
+/********************************************************************************
+*                                                                               *
+* FUNCTION NAME: vRestore_Checkpoint                                            *
+*                                                                               *
+* PURPOSE: Restarts the Madgwick quaternion and the axis filters from a         *
+*           record read by iCheckpoint_Load, after iSetup_Kalman; the frozen    *
+*           P of a steady-state filter is kept, the factor of a square-root     *
+*           filter is recomputed                                                *
+*                                                                               *
+* ARGUMENT LIST:                                                                *
+*                                                                               *
+* Argument  Type         IO     Description                                     *
+* --------- --------     --     ---------------------------------               *
+* r         CheckpointRec* I    Record                                          *
+*                                                                               *
+* RETURN VALUE: void                                                            *
+*                                                                               *
+********************************************************************************/
+void vRestore_Checkpoint(const CheckpointRecord *r)
+{
+    float q[4];
+
+    vAHRS_Restore(&ahrs, q, r);
+    madgwick.q0 = q[0];
+    madgwick.q1 = q[1];
+    madgwick.q2 = q[2];
+    madgwick.q3 = q[3];
+}
+
+/********************************************************************************
+*                                                                               *
+* FUNCTION NAME: vAHRS_Restore                                                  *
+*                                                                               *
+* PURPOSE: vRestore_Checkpoint of one AHRS, after iAHRS_Init                    *
+*                                                                               *
+* ARGUMENT LIST:                                                                *
+*                                                                               *
+* Argument  Type         IO     Description                                     *
+* --------- --------     --     ---------------------------------               *
+* s         AHRSState*   IO     AHRS                                            *
+* q         float*       O      Quaternion                                      *
+* r         CheckpointRec* I    Record                                          *
+*                                                                               *
+* RETURN VALUE: void                                                            *
+*                                                                               *
+********************************************************************************/
+void vAHRS_Restore(AHRSState *s, float q[4], const CheckpointRecord *r)
+{
+    kalman *k = s->k;
+
+    q[0] = r->q[0];
+    q[1] = r->q[1];
+    q[2] = r->q[2];
+    q[3] = r->q[3];
+    for (int i = 0; i < 3 && s->z != NULL; i++)
+    {
+        k[i].x->matrix[0][0] = r->x[i][0];
+        k[i].x->matrix[1][0] = r->x[i][1];
+        if (k[i].steady)
+        {
+            continue;
+        }
+        k[i].P->matrix[0][0] = r->P[i][0];
+        k[i].P->matrix[0][1] = r->P[i][1];
+        k[i].P->matrix[1][0] = r->P[i][1];
+        k[i].P->matrix[1][1] = r->P[i][2];
+        if (k[i].sqrt)
+        {
+            iKalman_SquareRoot(&k[i], 1);
+        }
+    }
+}
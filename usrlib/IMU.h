@@ -47,6 +47,11 @@
 *   04-07-2020    N.di Gruttola                      1.2       Added comments, code satisfies      *
 *                  Giardino                                     iso9899:1999, as requested per     *
 *                                                               MISRA-C:2004                       *
+*   19-10-2026    AHRS Project                       1.3       GPSREADY, GPSNOTREADY, filter       *
+*                                                               configuration sets, checkpoint     *
+*                                                               capture and restore, GPS gate,     *
+*                                                               timing probes, builds on the host, *
+*                                                               AHRSState instances, AHRS_GRAVITY  *
 *                                                                                                  *
 ***************************************************************************************************/
 
@@ -60,8 +65,75 @@
 #include <math.h>
 #include "MadgwickAHRS.h"
 #include "Kalman.h"
-#include "GPS_Library.h"
+#include "GPS_Lib.h"
+#include "Checkpoint.h"
+#include "Probe.h"
 
+/* Definition of Macros */
+
+#define GPSNOTREADY  0      /* no new GPS fix, predict only */
+#define GPSREADY     1      /* GPSRead returned a new RMC + GGA pair */
+
+#define KALMAN_SET_CV       0   /* no process noise */
+#define KALMAN_SET_TUNED    1   /* process noise of the acceleration error of the AHRS */
+#define KALMAN_SETS         2
+
+/* the square-root and steady-state forms need process noise, see iAHRS_Init,
+   and without it the gate rejects the fixes of every turn */
+#ifndef KALMAN_SET_DEFAULT
+#define KALMAN_SET_DEFAULT  KALMAN_SET_TUNED
+#endif
+#if (defined(USE_KALMAN_SQRT) || defined(USE_KALMAN_STEADY_STATE)) && KALMAN_SET_DEFAULT == KALMAN_SET_CV
+#error "USE_KALMAN_SQRT and USE_KALMAN_STEADY_STATE need a KALMAN_SET_DEFAULT with process noise"
+#endif
+
+/* error of the GPS receiver, 1 sigma in m, and its fix period in s, from
+   which the sets take R; ahrs_gen of replay/ simulates this receiver */
+#ifndef AHRS_GPS_SIGMA_H
+#define AHRS_GPS_SIGMA_H    2.0f
+#endif
+#ifndef AHRS_GPS_SIGMA_V
+#define AHRS_GPS_SIGMA_V    4.0f
+#endif
+#ifndef AHRS_GPS_PERIOD
+#define AHRS_GPS_PERIOD     1.0f
+#endif
+#define AHRS_SPEED_MAX      30.0f       /* m/s at power on, sets the velocity P0 of the sets */
+
+/* innovation gate of the GPS fixes, see iKalman_SetGate */
+#ifndef KALMAN_GATE_DEFAULT
+#define KALMAN_GATE_DEFAULT KALMAN_GATE_99
+#endif
+#define KALMAN_GATE_MISSES  10      /* consecutive rejected fixes before one is taken ungated */
+#define KALMAN_GATE_INFLATE 100.0f  /* P times this before that fix, see iKalman_Inflate */
+
+#define AHRS_GRAVITY        9.80665f    /* m/s^2, the accelerometer reads +g up at rest */
+
+/*
+* AHRSState Object:
+*       navigation state of one AHRS: the axis filters (North, East, Down) and
+*       their GPS measurement, the workspace of the acceleration rotation, the
+*       last gravity and Euler angles, the last GPS fix in metres and the time
+*       since it; the functions without an AHRSState argument use the one of
+*       the board
+*/
+
+typedef struct AHRSState
+{
+    kalman  k[3];
+    Matrix* z;              /* GPS measurement of one axis, position and velocity */
+    Matrix* acc;            /* acceleration North, East, Down */
+    Matrix* rotation;       /* rotation of the quaternion */
+    Matrix* inv;            /* inverse of the rotation of q/|q|, the transpose over |q|^2 */
+    float   gravity[3];
+    float   euler[3];
+    float   last_lla[3];    /* previous fix, latitude longitude altitude */
+    float   origin[3];      /* first fix in metres, where the positions start */
+    float   parallel;       /* length of the parallel of the first fix, m */
+    float   lla[3];
+    float   gps_dt;         /* time since the previous GPS fix */
+    unsigned int fixes;     /* GPS fixes taken, counted up to 2 */
+}AHRSState;
 
 /* Declare Prototypes */
 
@@ -72,11 +144,30 @@ void   vCalculateYPR   (float *, float *);
 /* the following are to use in this order */
 
 Matrix* pxCalc_acc_vec      (Matrix *, const float , const float );
-int 	iCalc_acc_vec		(Matrix *, const float, const float);
-void    vSetup_Kalman			();
+int 	iCalc_acc_vec		(Matrix *, Matrix *, const float, const float);
+int     iSetup_Kalman			(void);
+int     iSelect_Kalman		(unsigned int);
 void    vCompute_GPS		(float [3], float [3], float [3]);
-void    vCalculate_velocity (float *, Matrix *);
+void    vCalculate_velocity (float *, Matrix *, int);
 void 	vDelete_Kalman		();
+void    vGet_NIS            (float [3], unsigned long [3]);
+
+/* warm start, see Checkpoint.h */
+
+void    vCapture_Checkpoint	(CheckpointRecord *);
+void    vRestore_Checkpoint	(const CheckpointRecord *);
+
+/* one AHRS, q is its Madgwick quaternion */
+
+int     iAHRS_Init          (AHRSState *, unsigned int);
+int     iAHRS_Select        (AHRSState *, unsigned int);
+void    vAHRS_YPR           (AHRSState *, const float [4], float *);
+void    vAHRS_ComputeGPS    (AHRSState *, float [3], float [3], float [3]);
+void    vAHRS_Velocity      (AHRSState *, const float [4], float *, Matrix *, const float *);
+void    vAHRS_GetNIS        (const AHRSState *, float [3], unsigned long [3]);
+void    vAHRS_Capture       (const AHRSState *, const float [4], CheckpointRecord *);
+void    vAHRS_Restore       (AHRSState *, float [4], const CheckpointRecord *);
+void    vAHRS_Destroy       (AHRSState *);
 
 
 #endif /* IMU_h */
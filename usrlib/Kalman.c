@@ -81,6 +81,15 @@
 *   04-07-2020    N.di Gruttola                      1.2       Added comments, code satisfies       *
 *                  Giardino                                     iso9899:1999, as requested per      *
 *                                                               MISRA-C:2004                        *
+*   19-10-2026    AHRS Project                       1.3       Workspace allocated once, phases     *
+*                                                               are allocation free, separate       *
+*                                                               predict and update entry points,    *
+*                                                               steady-state gain mode, sequential  *
+*                                                               scalar updates, square-root mode,   *
+*                                                               const configuration tables,         *
+*                                                               innovation gate, NIS telemetry,     *
+*                                                               timing probes of the phases,        *
+*                                                               covariance inflation                *
 *                                                                                                   *
 *                                                                                                   *
 *                                                                                                   *
@@ -89,7 +98,746 @@
 /* Include Global Parameters */
 
 #include "Kalman.h"
+#include "Probe.h"
 
+/* Declare Prototypes */
+
+static void  vPropagate      (kalman *);
+static int   iGain           (kalman *);
+static void  vInnovationCov  (kalman *);
+static int   iGainSolve      (kalman *);
+static int   iGate           (kalman *, Matrix *, const unsigned char *);
+static int   iNis            (kalman *, float, size_t);
+static void  vCorrect        (kalman *);
+static void  vPredictState   (kalman *, float);
+static int   iCholesky       (Matrix *, Matrix *);
+static void  vPropagateSqrt  (kalman *);
+static void  vLeaveSteady    (kalman *);
+static int   iArrayUpdate    (kalman *, Matrix *, int);
+
+/* Define Static Variables */
+
+/* chi-square quantiles of the gate levels by degrees of freedom, 1 to KALMAN_GATE_DOF */
+static const float chi2_gate[KALMAN_GATE_LEVELS][KALMAN_GATE_DOF] =
+{
+    {  0.000f,  0.000f,  0.000f,  0.000f,  0.000f,  0.000f },   /* KALMAN_GATE_OFF, unused */
+    {  3.841f,  5.991f,  7.815f,  9.488f, 11.070f, 12.592f },   /* KALMAN_GATE_95 */
+    {  6.635f,  9.210f, 11.345f, 13.277f, 15.086f, 16.812f },   /* KALMAN_GATE_99 */
+    { 10.828f, 13.816f, 16.266f, 18.467f, 20.515f, 22.458f }    /* KALMAN_GATE_999 */
+};
+
+/********************************************************************************
+*                                                                               *
+* FUNCTION NAME: iKalman_Init                                                   *
+*                                                                               *
+* PURPOSE: Creates all the matrices of the filter and its workspace, so that    *
+*           the three phases never allocate; all values are zero but the        *
+*           identity, the model must be filled in by the caller                 *
+*           returning -1 if failed, 0 if successfull                            *
+*                                                                               *
+* ARGUMENT LIST:                                                                *
+*                                                                               *
+* Argument  Type         IO     Description                                     *
+* --------- --------     --     ---------------------------------               *
+* k         Kalman*      O      Kalman structure                                *
+* n         unsigned int I      Number of states                                *
+* m         unsigned int I      Number of measurements                          *
+*                                                                               *
+* RETURN VALUE: int                                                             *
+*                                                                               *
+********************************************************************************/
+int iKalman_Init(kalman *k, unsigned int n, unsigned int m)
+{
+    if (k == NULL || n == 0 || m == 0)
+    {
+        return -1;
+    }
+
+    k->x = pxCreate(n, 1);
+    k->y = pxCreate(m, 1);
+    k->P = pxCreate(n, n);
+    k->B = pxCreate(n, 1);
+    k->K = pxCreate(n, m);
+    k->H = pxCreate(m, n);
+    k->R = pxCreate(m, m);
+    k->Q = pxCreate(n, n);
+    k->A = pxCreate(n, n);
+    k->S = pxCreate(m, m);
+
+    k->vModel = NULL;
+    k->steady = 0;
+    k->Rss    = pxCreate(m, m);
+    k->Kp     = pxCreate(n, m);
+
+    k->sqrt = 0;
+    k->L    = pxCreate(n, n);
+    k->Lq   = pxCreate(n, n);
+    k->Lr   = pxCreate(m, m);
+
+    k->gate     = KALMAN_GATE_OFF;
+    k->nis      = 0;
+    k->nis_mean = 0;
+    k->accepted = 0;
+    k->rejected = 0;
+    k->misses   = 0;
+
+    k->I    = pxIdentity(n);
+    k->At   = pxCreate(n, n);
+    k->Ht   = pxCreate(n, m);
+    k->Ls   = pxCreate(m, m);
+    k->Wnn  = pxCreate(n, n);
+    k->Wnn2 = pxCreate(n, n);
+    k->Wmn  = pxCreate(m, n);
+    k->Wn1  = pxCreate(n, 1);
+    k->Wm1  = pxCreate(m, 1);
+    k->Wpre = pxCreate(n, 2 * n);
+    k->Wupd = pxCreate(m + n, m + n);
+    k->Tupd = pxCreate(m + n, m + n);
+    k->Wseq = pxCreate(1 + n, 1 + n);
+    k->Tseq = pxCreate(1 + n, 1 + n);
+
+    return 0;
+}
+
+/********************************************************************************
+*                                                                               *
+* FUNCTION NAME: iKalman_InitConfig                                             *
+*                                                                               *
+* PURPOSE: iKalman_Init for the size of a configuration table, then             *
+*           iKalman_LoadConfig                                                  *
+*           returning -1 if failed, 0 if successfull                            *
+*                                                                               *
+* ARGUMENT LIST:                                                                *
+*                                                                               *
+* Argument  Type         IO     Description                                     *
+* --------- --------     --     ---------------------------------               *
+* k         Kalman*      O      Kalman structure                                *
+* c         KalmanConfig*I      Configuration, usually a const table            *
+*                                                                               *
+* RETURN VALUE: int                                                             *
+*                                                                               *
+********************************************************************************/
+int iKalman_InitConfig(kalman *k, const KalmanConfig *c)
+{
+    if (c == NULL || c->n > KALMAN_CFG_N || c->m > KALMAN_CFG_M)
+    {
+        return -1;
+    }
+    if (iKalman_Init(k, c->n, c->m) != 0)
+    {
+        return -1;
+    }
+
+    return iKalman_LoadConfig(k, c);
+}
+
+/********************************************************************************
+*                                                                               *
+* FUNCTION NAME: iKalman_LoadConfig                                             *
+*                                                                               *
+* PURPOSE: Copies dt, A, B, H, Q, R, x0 and P0 of a configuration table into    *
+*           a filter of the same size in one pass, so that a running filter     *
+*           can switch to another table; the steady-state gain is dropped and   *
+*           the square-root mode refactors P, Q and R                           *
+*           returning -1 if failed, 0 if successfull                            *
+*                                                                               *
+* ARGUMENT LIST:                                                                *
+*                                                                               *
+* Argument  Type         IO     Description                                     *
+* --------- --------     --     ---------------------------------               *
+* k         Kalman*      IO     Kalman structure, created by iKalman_Init       *
+* c         KalmanConfig*I      Configuration, usually a const table            *
+*                                                                               *
+* RETURN VALUE: int                                                             *
+*                                                                               *
+********************************************************************************/
+int iKalman_LoadConfig(kalman *k, const KalmanConfig *c)
+{
+    size_t i;
+    size_t j;
+
+    if (k == NULL || c == NULL || k->x->r != c->n || k->y->r != c->m)
+    {
+        return -1;
+    }
+
+    k->dt = c->dt;
+    for (i = 0; i < c->n; i++)
+    {
+        k->x->matrix[i][0] = c->x0[i];
+        k->B->matrix[i][0] = c->B[i];
+        for (j = 0; j < c->n; j++)
+        {
+            k->A->matrix[i][j] = c->A[i][j];
+            k->Q->matrix[i][j] = c->Q[i][j];
+            k->P->matrix[i][j] = c->P0[i][j];
+        }
+    }
+    for (i = 0; i < c->m; i++)
+    {
+        for (j = 0; j < c->n; j++)
+        {
+            k->H->matrix[i][j] = c->H[i][j];
+        }
+        for (j = 0; j < c->m; j++)
+        {
+            k->R->matrix[i][j] = c->R[i][j];
+        }
+    }
+
+    k->vModel = c->vModel;
+    k->steady = 0;
+    if (k->sqrt)
+    {
+        return iKalman_SquareRoot(k, 1);
+    }
+
+    return 0;
+}
+
+/********************************************************************************
+*                                                                               *
+* FUNCTION NAME: vKalman_Destroy                                                *
+*                                                                               *
+* PURPOSE: Destroys all the matrices created by iKalman_Init                    *
+*                                                                               *
+* ARGUMENT LIST:                                                                *
+*                                                                               *
+* Argument  Type         IO     Description                                     *
+* --------- --------     --     ---------------------------------               *
+* k         Kalman*      IO     Kalman structure                                *
+*                                                                               *
+* RETURN VALUE: void                                                            *
+*                                                                               *
+********************************************************************************/
+void vKalman_Destroy(kalman *k)
+{
+    if (k == NULL)
+    {
+        return;
+    }
+
+    vDestroy(k->x);
+    vDestroy(k->y);
+    vDestroy(k->P);
+    vDestroy(k->B);
+    vDestroy(k->K);
+    vDestroy(k->H);
+    vDestroy(k->R);
+    vDestroy(k->Q);
+    vDestroy(k->A);
+    vDestroy(k->S);
+
+    vDestroy(k->I);
+    vDestroy(k->At);
+    vDestroy(k->Ht);
+    vDestroy(k->Ls);
+    vDestroy(k->Wnn);
+    vDestroy(k->Wnn2);
+    vDestroy(k->Wmn);
+    vDestroy(k->Wn1);
+    vDestroy(k->Wm1);
+    vDestroy(k->Rss);
+    vDestroy(k->Kp);
+    vDestroy(k->L);
+    vDestroy(k->Lq);
+    vDestroy(k->Lr);
+    vDestroy(k->Wpre);
+    vDestroy(k->Wupd);
+    vDestroy(k->Tupd);
+    vDestroy(k->Wseq);
+    vDestroy(k->Tseq);
+}
+
+/********************************************************************************
+*                                                                               *
+* FUNCTION NAME: vPropagate                                                     *
+*                                                                               *
+* PURPOSE: Covariance part of phase 1, P_p=A*P_n-1*A^T + Q                      *
+*                                                                               *
+* ARGUMENT LIST:                                                                *
+*                                                                               *
+* Argument  Type         IO     Description                                     *
+* --------- --------     --     ---------------------------------               *
+* k         Kalman*      IO     Kalman structure                                *
+*                                                                               *
+* RETURN VALUE: void                                                            *
+*                                                                               *
+********************************************************************************/
+static void vPropagate(kalman *k)
+{
+    iTranspose(k->At, k->A);
+    iMultiply(k->Wnn, k->A, k->P);
+    iMultiply(k->P, k->Wnn, k->At);
+    iSum(k->P, k->P, k->Q);
+}
+
+/********************************************************************************
+*                                                                               *
+* FUNCTION NAME: iGain                                                          *
+*                                                                               *
+* PURPOSE: Gain part of phase 2, S=H*P_p*H^T + R and K=P_p*H^T*S^-1, as         *
+*           K^T = S^-1*(H*P_p) with S = Ls*Ls^T, no inverse                     *
+*           returning -1 if S is singular, 0 if successfull                     *
+*                                                                               *
+* ARGUMENT LIST:                                                                *
+*                                                                               *
+* Argument  Type         IO     Description                                     *
+* --------- --------     --     ---------------------------------               *
+* k         Kalman*      IO     Kalman structure                                *
+*                                                                               *
+* RETURN VALUE: int                                                             *
+*                                                                               *
+********************************************************************************/
+static int iGain(kalman *k)
+{
+    vInnovationCov(k);
+    iChol(k->Ls, k->S);
+
+    return iGainSolve(k);
+}
+
+/********************************************************************************
+*                                                                               *
+* FUNCTION NAME: vInnovationCov                                                 *
+*                                                                               *
+* PURPOSE: First half of iGain, Wmn=H*P_p and S=H*P_p*H^T + R                   *
+*                                                                               *
+* ARGUMENT LIST:                                                                *
+*                                                                               *
+* Argument  Type         IO     Description                                     *
+* --------- --------     --     ---------------------------------               *
+* k         Kalman*      IO     Kalman structure                                *
+*                                                                               *
+* RETURN VALUE: void                                                            *
+*                                                                               *
+********************************************************************************/
+static void vInnovationCov(kalman *k)
+{
+    iTranspose(k->Ht, k->H);
+    iMultiply(k->Wmn, k->H, k->P);
+    iMultiply(k->S, k->Wmn, k->Ht);
+    iSum(k->S, k->S, k->R);
+}
+
+/********************************************************************************
+*                                                                               *
+* FUNCTION NAME: iGainSolve                                                     *
+*                                                                               *
+* PURPOSE: Second half of iGain, K^T = S^-1*(H*P_p) from Wmn and Ls = chol(S)   *
+*           returning -1 if S is singular, 0 if successfull                     *
+*                                                                               *
+* ARGUMENT LIST:                                                                *
+*                                                                               *
+* Argument  Type         IO     Description                                     *
+* --------- --------     --     ---------------------------------               *
+* k         Kalman*      IO     Kalman structure                                *
+*                                                                               *
+* RETURN VALUE: int                                                             *
+*                                                                               *
+********************************************************************************/
+static int iGainSolve(kalman *k)
+{
+    if (iTrsm(k->Wmn, k->Ls, k->Wmn, TRI_LOWER, TRI_NOTRANS) != 0 ||
+        iTrsm(k->Wmn, k->Ls, k->Wmn, TRI_LOWER, TRI_TRANS) != 0)
+    {
+        return -1;
+    }
+    iTranspose(k->K, k->Wmn);
+
+    return 0;
+}
+
+/********************************************************************************
+*                                                                               *
+* FUNCTION NAME: iGate                                                          *
+*                                                                               *
+* PURPOSE: Mahalanobis gate: y=z - H*x, S and Ls = chol(S), then                *
+*           d2 = |Ls^-1*y|^2 = y^T*S^-1*y against the chi-square quantile of    *
+*           the gate level for the number of valid components; one              *
+*           triangular solve more than the update itself. Skipped components    *
+*           are taken out of S as identity rows. In steady-state mode S and     *
+*           Ls are those of the frozen gain. Updates the NIS telemetry, see     *
+*           iNis; with the gate off z always passes                             *
+*           returning 1 if z is rejected, -1 if S is not positive definite,     *
+*           0 if z passed                                                       *
+*                                                                               *
+* ARGUMENT LIST:                                                                *
+*                                                                               *
+* Argument  Type         IO     Description                                     *
+* --------- --------     --     ---------------------------------               *
+* k         Kalman*      IO     Kalman structure, y, S, Ls, Wmn written         *
+* z         Matrix*      I      Measurement, m x 1                              *
+* valid     uchar*       I      m flags, 0 to skip a component, NULL for all    *
+*                                                                               *
+* RETURN VALUE: int                                                             *
+*                                                                               *
+********************************************************************************/
+static int iGate(kalman *k, Matrix *z, const unsigned char *valid)
+{
+    size_t i;
+    size_t j;
+    size_t dof = 0;
+    float  d2  = 0;
+
+    /* y=z_n - H*x_p */
+    iMultiply(k->Wm1, k->H, k->x);
+    iSubtract(k->y, z, k->Wm1);
+
+    if (!k->steady || valid != NULL)
+    {
+        vInnovationCov(k);
+        for (i = 0; valid != NULL && i < k->S->r; i++)
+        {
+            if (!valid[i])
+            {
+                for (j = 0; j < k->S->c; j++)
+                {
+                    k->S->matrix[i][j] = 0;
+                    k->S->matrix[j][i] = 0;
+                }
+                k->S->matrix[i][i] = 1;
+                k->y->matrix[i][0] = 0;
+            }
+        }
+        if (iCholesky(k->Ls, k->S) != 0)
+        {
+            return -1;
+        }
+    }
+
+    iTrsm(k->Wm1, k->Ls, k->y, TRI_LOWER, TRI_NOTRANS);
+    for (i = 0; i < k->Wm1->r; i++)
+    {
+        d2  += k->Wm1->matrix[i][0] * k->Wm1->matrix[i][0];
+        dof += (valid == NULL || valid[i]) ? 1 : 0;
+    }
+
+    return (dof == 0) ? 0 : iNis(k, d2, dof);
+}
+
+/********************************************************************************
+*                                                                               *
+* FUNCTION NAME: iNis                                                           *
+*                                                                               *
+* PURPOSE: NIS telemetry of one measurement and the decision of the gate on     *
+*           it. With the gate off the updates take d2 from their own factors    *
+*           of S, and z always passes                                           *
+*           returning 1 if z is rejected, 0 if z passed                         *
+*                                                                               *
+* ARGUMENT LIST:                                                                *
+*                                                                               *
+* Argument  Type         IO     Description                                     *
+* --------- --------     --     ---------------------------------               *
+* k         Kalman*      IO     Kalman structure                                *
+* d2        float        I      y^T*S^-1*y of the measurement                   *
+* dof       size_t       I      Number of valid components, at least 1          *
+*                                                                               *
+* RETURN VALUE: int                                                             *
+*                                                                               *
+********************************************************************************/
+static int iNis(kalman *k, float d2, size_t dof)
+{
+    k->nis = d2;
+
+    /* NaN fails the comparison: a non finite measurement is rejected too */
+    if (k->gate != KALMAN_GATE_OFF && !(d2 <= chi2_gate[k->gate][dof - 1]))
+    {
+        k->rejected++;
+        k->misses++;
+        return 1;
+    }
+
+    k->nis_mean = (k->accepted == 0) ? d2 : k->nis_mean + KALMAN_NIS_ALPHA * (d2 - k->nis_mean);
+    k->accepted++;
+    k->misses = 0;
+
+    return 0;
+}
+
+/********************************************************************************
+*                                                                               *
+* FUNCTION NAME: vCorrect                                                       *
+*                                                                               *
+* PURPOSE: Covariance part of phase 3, P=(I-K*H)*P_p                            *
+*                                                                               *
+* ARGUMENT LIST:                                                                *
+*                                                                               *
+* Argument  Type         IO     Description                                     *
+* --------- --------     --     ---------------------------------               *
+* k         Kalman*      IO     Kalman structure                                *
+*                                                                               *
+* RETURN VALUE: void                                                            *
+*                                                                               *
+********************************************************************************/
+static void vCorrect(kalman *k)
+{
+    iMultiply(k->Wnn, k->K, k->H);
+    iSubtract(k->Wnn, k->I, k->Wnn);
+    iMultiply(k->Wnn2, k->Wnn, k->P);
+    iCopy(k->P, k->Wnn2);
+}
+
+/********************************************************************************
+*                                                                               *
+* FUNCTION NAME: vPredictState                                                  *
+*                                                                               *
+* PURPOSE: State part of phase 1, x_p=A*x_n-1 + B*u                             *
+*                                                                               *
+* ARGUMENT LIST:                                                                *
+*                                                                               *
+* Argument  Type         IO     Description                                     *
+* --------- --------     --     ---------------------------------               *
+* k         Kalman*      IO     Kalman structure                                *
+* u         float        I      IMU acceleration data computed                  *
+*                                                                               *
+* RETURN VALUE: void                                                            *
+*                                                                               *
+********************************************************************************/
+static void vPredictState(kalman *k, float u)
+{
+    iMultiply(k->Wn1, k->A, k->x);
+    iSc_Multiply(k->x, k->B, u);
+    iSum(k->x, k->Wn1, k->x);
+}
+
+/********************************************************************************
+*                                                                               *
+* FUNCTION NAME: iCholesky                                                      *
+*                                                                               *
+* PURPOSE: L = chol(M), failing if M is not positive definite, which iChol      *
+*           does not detect                                                     *
+*           returning -1 if failed, 0 if successfull                            *
+*                                                                               *
+* ARGUMENT LIST:                                                                *
+*                                                                               *
+* Argument  Type         IO     Description                                     *
+* --------- --------     --     ---------------------------------               *
+* L         Matrix*      O      Lower triangular factor                         *
+* M         Matrix*      I      Symmetric matrix                                *
+*                                                                               *
+* RETURN VALUE: int                                                             *
+*                                                                               *
+********************************************************************************/
+static int iCholesky(Matrix *L, Matrix *M)
+{
+    size_t i;
+
+    if (iChol(L, M) != 0)
+    {
+        return -1;
+    }
+    for (i = 0; i < L->r; i++)
+    {
+        if (!(L->matrix[i][i] > 0) || !isfinite(L->matrix[i][i]))
+        {
+            return -1;
+        }
+    }
+
+    return 0;
+}
+
+/********************************************************************************
+*                                                                               *
+* FUNCTION NAME: vPropagateSqrt                                                 *
+*                                                                               *
+* PURPOSE: Covariance part of phase 1 in square-root mode: L_p is the           *
+*           triangular factor of the pre-array [A*L_n-1, Lq], so that           *
+*           L_p*L_p^T = A*P*A^T + Q without forming either product              *
+*                                                                               *
+* ARGUMENT LIST:                                                                *
+*                                                                               *
+* Argument  Type         IO     Description                                     *
+* --------- --------     --     ---------------------------------               *
+* k         Kalman*      IO     Kalman structure                                *
+*                                                                               *
+* RETURN VALUE: void                                                            *
+*                                                                               *
+********************************************************************************/
+static void vPropagateSqrt(kalman *k)
+{
+    size_t i;
+    size_t j;
+    size_t n = k->L->r;
+
+    iMultiply(k->Wnn, k->A, k->L);
+    for (i = 0; i < n; i++)
+    {
+        for (j = 0; j < n; j++)
+        {
+            k->Wpre->matrix[i][j]     = k->Wnn->matrix[i][j];
+            k->Wpre->matrix[i][n + j] = k->Lq->matrix[i][j];
+        }
+    }
+    iTria(k->L, k->Wpre);
+    iSyrk(k->P, k->L, 1.0f, 0.0f, TRI_NOTRANS);
+}
+
+/********************************************************************************
+*                                                                               *
+* FUNCTION NAME: vLeaveSteady                                                   *
+*                                                                               *
+* PURPOSE: Back to the full filter from steady-state mode at update time: the   *
+*           frozen P is the posterior, so it is propagated once to give the     *
+*           predicted covariance the next full update expects                   *
+*                                                                               *
+* ARGUMENT LIST:                                                                *
+*                                                                               *
+* Argument  Type         IO     Description                                     *
+* --------- --------     --     ---------------------------------               *
+* k         Kalman*      IO     Kalman structure                                *
+*                                                                               *
+* RETURN VALUE: void                                                            *
+*                                                                               *
+********************************************************************************/
+static void vLeaveSteady(kalman *k)
+{
+    if (!k->steady)
+    {
+        return;
+    }
+    k->steady = 0;
+    if (k->sqrt)
+    {
+        vPropagateSqrt(k);
+    }
+    else
+    {
+        vPropagate(k);
+    }
+}
+
+/********************************************************************************
+*                                                                               *
+* FUNCTION NAME: iArrayUpdate                                                   *
+*                                                                               *
+* PURPOSE: Measurement update in square-root mode, by triangularization of the  *
+*           pre-array  [Lr  H*L]     [Ls  0  ]                                  *
+*                      [0   L  ]  -> [Kb  L_n]  with K = Kb*Ls^-1,              *
+*           Ls*Ls^T = S; all the m components (row < 0) or only component row,  *
+*           for which Lr is sqrt(R_row,row). P is not refreshed here            *
+*           returning -1 if failed, 0 if successfull                            *
+*                                                                               *
+* ARGUMENT LIST:                                                                *
+*                                                                               *
+* Argument  Type         IO     Description                                     *
+* --------- --------     --     ---------------------------------               *
+* k         Kalman*      IO     Kalman structure                                *
+* z         Matrix*      I      Measurement, m x 1                              *
+* row       int          I      Component to apply, < 0 for all of them         *
+*                                                                               *
+* RETURN VALUE: int                                                             *
+*                                                                               *
+********************************************************************************/
+static int iArrayUpdate(kalman *k, Matrix *z, int row)
+{
+    Matrix *W  = (row < 0) ? k->Wupd : k->Wseq;
+    Matrix *T  = (row < 0) ? k->Tupd : k->Tseq;
+    size_t  mm = (row < 0) ? k->H->r : 1;
+    size_t  n  = k->L->r;
+    size_t  i;
+    size_t  j;
+    size_t  l;
+    float   acc;
+
+    iZeroMat(W);
+    for (i = 0; i < mm; i++)
+    {
+        const size_t c = (row < 0) ? i : (size_t)row;
+        const float *h = k->H->matrix[c];
+
+        /* innovation e_i=z_i - h*x, before x changes */
+        acc = z->matrix[c][0];
+        for (j = 0; j < n; j++)
+        {
+            acc -= h[j] * k->x->matrix[j][0];
+        }
+        k->y->matrix[c][0]   = acc;
+        k->Wm1->matrix[i][0] = acc;
+
+        if (row < 0)
+        {
+            for (j = 0; j <= i; j++)
+            {
+                W->matrix[i][j] = k->Lr->matrix[i][j];
+            }
+        }
+        else
+        {
+            W->matrix[0][0] = sqrtf(k->R->matrix[c][c]);
+        }
+        for (j = 0; j < n; j++)
+        {
+            acc = 0;
+            for (l = j; l < n; l++)
+            {
+                acc += h[l] * k->L->matrix[l][j];
+            }
+            W->matrix[i][mm + j] = acc;
+        }
+    }
+    for (i = 0; i < n; i++)
+    {
+        for (j = 0; j <= i; j++)
+        {
+            W->matrix[mm + i][mm + j] = k->L->matrix[i][j];
+        }
+    }
+
+    if (iTria(T, W) != 0)
+    {
+        return -1;
+    }
+    for (i = 0; i < mm; i++)
+    {
+        if (T->matrix[i][i] == 0)
+        {
+            return -1;
+        }
+    }
+
+    /* K solves K*Ls = Kb row by row, x=x+K*e */
+    for (i = 0; i < n; i++)
+    {
+        const float *kb = T->matrix[mm + i];
+
+        for (j = mm; j-- > 0;)
+        {
+            acc = kb[j];
+            for (l = j + 1; l < mm; l++)
+            {
+                acc -= k->K->matrix[i][(row < 0) ? l : (size_t)row] * T->matrix[l][j];
+            }
+            k->K->matrix[i][(row < 0) ? j : (size_t)row] = acc / T->matrix[j][j];
+        }
+        for (j = 0; j < mm; j++)
+        {
+            k->x->matrix[i][0] += k->K->matrix[i][(row < 0) ? j : (size_t)row] * k->Wm1->matrix[j][0];
+        }
+    }
+
+    for (i = 0; i < n; i++)
+    {
+        for (j = 0; j < n; j++)
+        {
+            k->L->matrix[i][j] = T->matrix[mm + i][mm + j];
+        }
+    }
+    if (row < 0)
+    {
+        for (i = 0; i < mm; i++)
+        {
+            for (j = 0; j < mm; j++)
+            {
+                k->Ls->matrix[i][j] = T->matrix[i][j];
+            }
+        }
+        iSyrk(k->S, k->Ls, 1.0f, 0.0f, TRI_NOTRANS);
+    }
+
+    return 0;
+}
 
 /********************************************************************************
 *                                                                               *
@@ -110,34 +858,23 @@
 ********************************************************************************/
 void vPredict(kalman *k, float u)
 {
-    Matrix *app;
-    Matrix *app2;
-
-    /* x_p=A*x(n-1) + u_k*b */
-    app = pxMultiply(k->A, k->x);
-    app2 = pxSc_Multiply(k->B, u);
-    iSum(k->x, app, app2);
-    vDestroy(app);
-    vDestroy(app2);
+    PROBE_BEGIN(PROBE_PREDICT);
 
-    /* P_p=A*P_n-1*A^T + Q */
-    app = pxMultiply(k->A, k->P);
-    app2 = transpose(k->A);
-    iMultiply(k->P, app, app2);
-    vDestroy(app);
-    vDestroy(app2);
+    vPredictState(k, u);
+    vPropagate(k);
 
-    app = pxCopy(k->P);
-    iSum(k->P, app, k->Q);
-    vDestroy(app);
+    PROBE_END(PROBE_PREDICT);
 }
 
 /********************************************************************************
 *                                                                               *
-* FUNCTION NAME: vInnovation                                                    *
+* FUNCTION NAME: iInnovation                                                    *
 *                                                                               *
 * PURPOSE: Phase 2 of Kalman Filter, innovates the current                      *
-                state                                                           *
+                state and updates the NIS telemetry; with the gate on, a        *
+*           rejected measurement stops here, before K, and vUpdate must not     *
+*           follow                                                              *
+*           returning 1 if z is rejected, -1 if failed, 0 if successfull        *
 *                                                                               *
 * ARGUMENT LIST:                                                                *
 *                                                                               *
@@ -146,44 +883,21 @@ void vPredict(kalman *k, float u)
 * k         Kalman       IO     Kalman structure                                *
 * u         Matrix*      I      GPS data computed                               *
 *                                                                               *
-* RETURN VALUE: void                                                            *
+* RETURN VALUE: int                                                             *
 *                                                                               *
 ********************************************************************************/
-void vInnovation(kalman *k, Matrix *z)
+int iInnovation(kalman *k, Matrix *z)
 {
+    int ret;
 
-    Matrix *app;
-    Matrix *app2;
-
-    /* y=z_n - H*x_p */
-    iMultiply(k->y , k->H, k->x);
-    app = pxCopy(k->y);
-    iSubtract(k->y, z, app);
-    vDestroy(app);
-
-    /* S=H*P_p*H_T + R */
-    iMultiply(k->S, k->H, k->P);
-
-    app = pxCopy(k->S);
-    app2 = transpose(k->H);
-    iMultiply(k->S, app, app2);
-    vDestroy(app);
-    vDestroy(app2);
+    PROBE_BEGIN(PROBE_INNOVATION);
 
-    app=pxCopy(k->S);
-    iSum(k->S, app, k->R);
-    vDestroy(app);
+    ret = iGate(k, z, NULL);
+    ret = (ret != 0) ? ret : iGainSolve(k);
 
-    /* K=P_p*H_T*S^-1 */
-    app = transpose(k->H);
-    iMultiply(k->K, k->P, app);
-    vDestroy(app);
+    PROBE_END(PROBE_INNOVATION);
 
-    app = pxCopy(k->K);
-    app2 = pxInverse(k->S);
-    iMultiply(k->K, app, app2);
-    vDestroy(app);
-    vDestroy(app2);
+    return ret;
 }
 
 /********************************************************************************
@@ -204,30 +918,495 @@ void vInnovation(kalman *k, Matrix *z)
 ********************************************************************************/
 void vUpdate(kalman *k)
 {
-    Matrix *I = pxIdentity(2);
-    Matrix *app;
-    Matrix *app2;
+    PROBE_BEGIN(PROBE_UPDATE);
 
     /* x_n=x_p+Ky */
-    app = pxCopy(k->x);
-    app2 = pxMultiply(k->K, k->y);
-    iSum(k->x, app, app2);
-    vDestroy(app);
-    vDestroy(app2);
+    iMultiply(k->Wn1, k->K, k->y);
+    iSum(k->x, k->x, k->Wn1);
+
+    vCorrect(k);
+
+    PROBE_END(PROBE_UPDATE);
+}
+
+/********************************************************************************
+*                                                                               *
+* FUNCTION NAME: vKalman_Predict                                                *
+*                                                                               *
+* PURPOSE: Time update only, to be called at the IMU rate; if dt changed the    *
+*           model is rebuilt through vModel before predicting                   *
+*                                                                               *
+* ARGUMENT LIST:                                                                *
+*                                                                               *
+* Argument  Type         IO     Description                                     *
+* --------- --------     --     ---------------------------------               *
+* k         Kalman*      IO     Kalman structure                                *
+* dt        float        I      Time since the previous prediction              *
+* u         float        I      IMU acceleration data computed                  *
+*                                                                               *
+* RETURN VALUE: void                                                            *
+*                                                                               *
+********************************************************************************/
+void vKalman_Predict(kalman *k, float dt, float u)
+{
+    if (dt != k->dt)
+    {
+        k->dt = dt;
+        if (k->vModel != NULL)
+        {
+            k->vModel(k);
+        }
+        /* the frozen gain was solved for the old A */
+        k->steady = 0;
+        if (k->sqrt && iCholesky(k->Lq, k->Q) != 0)
+        {
+            k->sqrt = 0;
+        }
+    }
+
+    if (k->steady)
+    {
+        /* P is constant */
+        vPredictState(k, u);
+        return;
+    }
+    if (k->sqrt)
+    {
+        vPredictState(k, u);
+        vPropagateSqrt(k);
+        return;
+    }
+
+    vPredict(k, u);
+}
+
+/********************************************************************************
+*                                                                               *
+* FUNCTION NAME: iKalman_Update                                                 *
+*                                                                               *
+* PURPOSE: Measurement update only, to be called when a new measurement is      *
+*           available; R replaces the measurement covariance unless NULL. A     *
+*           measurement rejected by the gate leaves x and P untouched           *
+*           returning 1 if z is rejected, -1 if failed, 0 if successfull        *
+*                                                                               *
+* ARGUMENT LIST:                                                                *
+*                                                                               *
+* Argument  Type         IO     Description                                     *
+* --------- --------     --     ---------------------------------               *
+* k         Kalman*      IO     Kalman structure                                *
+* z         Matrix*      I      Measurement, m x 1                              *
+* R         Matrix*      I      Measurement covariance, m x m, or NULL          *
+*                                                                               *
+* RETURN VALUE: int                                                             *
+*                                                                               *
+********************************************************************************/
+int iKalman_Update(kalman *k, Matrix *z, Matrix *R)
+{
+    size_t i;
+    float  d2 = 0;
+    int    ret;
+
+    if (k == NULL || z == NULL || z->r != k->y->r || z->c != 1)
+    {
+        return -1;
+    }
+    if (R != NULL && R != k->R)
+    {
+        if (iCopy(k->R, R) != 0)
+        {
+            return -1;
+        }
+    }
+
+    if (k->steady && iEquals(k->R, k->Rss) != 1)
+    {
+        /* R changed, e.g. fewer satellites: back to the full filter */
+        vLeaveSteady(k);
+    }
+
+    if (k->steady)
+    {
+        /* x_n=x_p+K_inf*(z_n - H*x_p) */
+        if ((ret = iGate(k, z, NULL)) != 0)
+        {
+            return ret;
+        }
+        iMultiply(k->Wn1, k->K, k->y);
+        iSum(k->x, k->x, k->Wn1);
+        return 0;
+    }
+
+    if (k->sqrt)
+    {
+        /* S from the copy of P, the array update refactors it; with the gate
+           off the NIS is taken from the Ls of the array update */
+        if (k->gate != KALMAN_GATE_OFF && (ret = iGate(k, z, NULL)) != 0)
+        {
+            return ret;
+        }
+        if ((R != NULL && iCholesky(k->Lr, k->R) != 0) || iArrayUpdate(k, z, -1) != 0)
+        {
+            return -1;
+        }
+        iSyrk(k->P, k->L, 1.0f, 0.0f, TRI_NOTRANS);
+        if (k->gate == KALMAN_GATE_OFF)
+        {
+            iTrsm(k->Wm1, k->Ls, k->y, TRI_LOWER, TRI_NOTRANS);
+            for (i = 0; i < k->Wm1->r; i++)
+            {
+                d2 += k->Wm1->matrix[i][0] * k->Wm1->matrix[i][0];
+            }
+            iNis(k, d2, k->Wm1->r);
+        }
+        return 0;
+    }
+
+    ret = iInnovation(k, z);
+    if (ret != 0)
+    {
+        return ret;
+    }
+    vUpdate(k);
+
+    return 0;
+}
+
+/********************************************************************************
+*                                                                               *
+* FUNCTION NAME: iKalman_UpdateSeq                                              *
+*                                                                               *
+* PURPOSE: Measurement update one component at a time, valid for a diagonal R:  *
+*           each component is a scalar update, S^-1 becomes a division and no   *
+*           factorization is needed; components whose valid flag is 0 are       *
+*           skipped, so a partial fix needs no other H. The gate tests the      *
+*           valid components together, before the first scalar update           *
+*           returning 1 if z is rejected, -1 if failed, 0 if successfull        *
+*                                                                               *
+* ARGUMENT LIST:                                                                *
+*                                                                               *
+* Argument  Type         IO     Description                                     *
+* --------- --------     --     ---------------------------------               *
+* k         Kalman*      IO     Kalman structure, R must be diagonal            *
+* z         Matrix*      I      Measurement, m x 1                              *
+* valid     uchar*       I      m flags, 0 to skip a component, NULL for all    *
+*                                                                               *
+* RETURN VALUE: int                                                             *
+*                                                                               *
+********************************************************************************/
+int iKalman_UpdateSeq(kalman *k, Matrix *z, const unsigned char *valid)
+{
+    size_t i;
+    size_t j;
+    size_t l;
+    size_t dof = 0;
+    float  s;
+    float  e;
+    float  ph;
+    float  d2  = 0;
+    int    ret;
+
+    if (k == NULL || z == NULL || z->r != k->y->r || z->c != 1)
+    {
+        return -1;
+    }
+    for (i = 0; i < k->R->r; i++)
+    {
+        for (j = 0; j < k->R->c; j++)
+        {
+            if (i != j && k->R->matrix[i][j] != 0)
+            {
+                return -1;
+            }
+        }
+    }
+    /* the frozen gain assumes every component is applied together */
+    vLeaveSteady(k);
+    /* with the gate off the NIS is the sum of e^2/s of the scalar updates,
+       the same y^T*S^-1*y for a diagonal R, without S */
+    if (k->gate != KALMAN_GATE_OFF && (ret = iGate(k, z, valid)) != 0)
+    {
+        return ret;
+    }
+
+    iZeroMat(k->K);
+
+    if (k->sqrt)
+    {
+        for (i = 0; i < k->H->r; i++)
+        {
+            if (valid != NULL && !valid[i])
+            {
+                k->y->matrix[i][0] = 0;
+                continue;
+            }
+            if (iArrayUpdate(k, z, (int)i) != 0)
+            {
+                return -1;
+            }
+            /* the array update leaves sqrt(s) in Tseq */
+            e    = k->y->matrix[i][0] / k->Tseq->matrix[0][0];
+            d2  += e * e;
+            dof++;
+        }
+        iSyrk(k->P, k->L, 1.0f, 0.0f, TRI_NOTRANS);
+        if (k->gate == KALMAN_GATE_OFF && dof > 0)
+        {
+            iNis(k, d2, dof);
+        }
+        return 0;
+    }
+
+    for (i = 0; i < k->H->r; i++)
+    {
+        if (valid != NULL && !valid[i])
+        {
+            k->y->matrix[i][0] = 0;
+            continue;
+        }
+
+        /* Ph=P*h^T, s=h*P*h^T + r_ii, e=z_i - h*x */
+        s = k->R->matrix[i][i];
+        e = z->matrix[i][0];
+        for (j = 0; j < k->P->r; j++)
+        {
+            ph = 0;
+            for (l = 0; l < k->P->c; l++)
+            {
+                ph += k->P->matrix[j][l] * k->H->matrix[i][l];
+            }
+            k->Wn1->matrix[j][0] = ph;
+            s += k->H->matrix[i][j] * ph;
+            e -= k->H->matrix[i][j] * k->x->matrix[j][0];
+        }
+        if (s <= 0)
+        {
+            return -1;
+        }
+        k->y->matrix[i][0] = e;
+        d2 += e * e / s;
+        dof++;
+
+        /* k_i=Ph/s, x=x+k_i*e, P=P-k_i*Ph^T */
+        for (j = 0; j < k->P->r; j++)
+        {
+            k->K->matrix[j][i]  = k->Wn1->matrix[j][0] / s;
+            k->x->matrix[j][0] += k->K->matrix[j][i] * e;
+        }
+        for (j = 0; j < k->P->r; j++)
+        {
+            for (l = 0; l < k->P->c; l++)
+            {
+                k->P->matrix[j][l] -= k->K->matrix[j][i] * k->Wn1->matrix[l][0];
+            }
+        }
+    }
+    if (k->gate == KALMAN_GATE_OFF && dof > 0)
+    {
+        iNis(k, d2, dof);
+    }
+
+    return 0;
+}
+
+/********************************************************************************
+*                                                                               *
+* FUNCTION NAME: iKalman_SetGate                                                *
+*                                                                               *
+* PURPOSE: Sets the level of the innovation gate of iKalman_Update and          *
+*           iKalman_UpdateSeq and clears the NIS telemetry; with the gate on,   *
+*           a measurement whose d2 = y^T*S^-1*y exceeds the chi-square quantile *
+*           is rejected before the gain is computed                             *
+*           returning -1 if failed, 0 if successfull                            *
+*                                                                               *
+* ARGUMENT LIST:                                                                *
+*                                                                               *
+* Argument  Type         IO     Description                                     *
+* --------- --------     --     ---------------------------------               *
+* k         Kalman*      IO     Kalman structure                                *
+* level     int          I      KALMAN_GATE_OFF, KALMAN_GATE_95, _99, _999      *
+*                                                                               *
+* RETURN VALUE: int                                                             *
+*                                                                               *
+********************************************************************************/
+int iKalman_SetGate(kalman *k, int level)
+{
+    if (k == NULL || level < KALMAN_GATE_OFF || level >= KALMAN_GATE_LEVELS ||
+        (level != KALMAN_GATE_OFF && k->y->r > KALMAN_GATE_DOF))
+    {
+        return -1;
+    }
 
-    /* P=(I-K*H)*P_p */
-    app = pxMultiply(k->K, k->H);
-    app2 = pxSubtract(I, app);
-    vDestroy(app);
-    iMultiply(k->P, app2, k->P);
-    vDestroy(app2);
+    k->gate     = level;
+    k->nis      = 0;
+    k->nis_mean = 0;
+    k->accepted = 0;
+    k->rejected = 0;
+    k->misses   = 0;
+
+    return 0;
+}
+
+/********************************************************************************
+*                                                                               *
+* FUNCTION NAME: iKalman_Inflate                                                *
+*                                                                               *
+* PURPOSE: P = f*P ahead of a measurement the filter must trust, e.g. the one   *
+*           taken ungated to re-acquire a track the gate has lost: with the     *
+*           collapsed P of the lost track it would barely move x. Leaves        *
+*           steady-state mode, the inflated P is not the frozen one             *
+*           returning -1 if failed, 0 if successfull                            *
+*                                                                               *
+* ARGUMENT LIST:                                                                *
+*                                                                               *
+* Argument  Type         IO     Description                                     *
+* --------- --------     --     ---------------------------------               *
+* k         Kalman*      IO     Kalman structure, predicted                     *
+* f         float        I      Factor, at least 1                              *
+*                                                                               *
+* RETURN VALUE: int                                                             *
+*                                                                               *
+********************************************************************************/
+int iKalman_Inflate(kalman *k, float f)
+{
+    if (k == NULL || !(f >= 1) || !isfinite(f))
+    {
+        return -1;
+    }
+
+    vLeaveSteady(k);
+    iSc_Multiply(k->P, k->P, f);
+    if (k->sqrt)
+    {
+        iSc_Multiply(k->L, k->L, sqrtf(f));
+    }
+
+    return 0;
+}
+
+/********************************************************************************
+*                                                                               *
+* FUNCTION NAME: iKalman_SteadyState                                            *
+*                                                                               *
+* PURPOSE: Solves the discrete algebraic Riccati equation by iterating the      *
+*           covariance recursion until the gain converges, then freezes K and   *
+*           P: predict and update only touch x until R or dt change             *
+*           returning -1 if it did not converge, 0 if successfull               *
+*                                                                               *
+* ARGUMENT LIST:                                                                *
+*                                                                               *
+* Argument  Type         IO     Description                                     *
+* --------- --------     --     ---------------------------------               *
+* k         Kalman*      IO     Kalman structure, A, B, H, Q, R and P set       *
+* max_iter  unsigned int I      Maximum number of Riccati iterations            *
+* tol       float        I      Largest change of any gain element to stop      *
+*                                                                               *
+* RETURN VALUE: int                                                             *
+*                                                                               *
+********************************************************************************/
+int iKalman_SteadyState(kalman *k, unsigned int max_iter, float tol)
+{
+    unsigned int it;
+    size_t i;
+    size_t j;
+    float  d;
+    float  dmax;
+
+    if (k == NULL)
+    {
+        return -1;
+    }
+
+    k->steady = 0;
+    iZeroMat(k->Kp);
+    for (it = 0; it < max_iter; it++)
+    {
+        vPropagate(k);
+        if (iGain(k) != 0)
+        {
+            return -1;
+        }
+        vCorrect(k);
+
+        dmax = 0;
+        for (i = 0; i < k->K->r; i++)
+        {
+            for (j = 0; j < k->K->c; j++)
+            {
+                d = fabsf(k->K->matrix[i][j] - k->Kp->matrix[i][j]);
+                dmax = (d > dmax) ? d : dmax;
+            }
+        }
+        if (dmax != dmax)
+        {
+            return -1;
+        }
+        if (it > 0 && dmax < tol)
+        {
+            iCopy(k->Rss, k->R);
+            k->steady = 1;
+            /* the factor must match P when the full filter resumes */
+            if (k->sqrt && iCholesky(k->L, k->P) != 0)
+            {
+                k->sqrt = 0;
+            }
+            return 0;
+        }
+        iCopy(k->Kp, k->K);
+    }
+
+    return -1;
+}
+
+/********************************************************************************
+*                                                                               *
+* FUNCTION NAME: iKalman_SquareRoot                                             *
+*                                                                               *
+* PURPOSE: Switches the square-root mode on or off. In square-root mode the     *
+*           lower Cholesky factor L of P is propagated instead of P, by         *
+*           triangularization of pre-arrays (iTria): P = L*L^T is positive      *
+*           semidefinite and symmetric by construction, which keeps the float   *
+*           filter well conditioned when A*P*A^T + Q is dominated by P (small   *
+*           dt). P is kept as a copy for the readers. Q and R must be positive  *
+*           definite and change only through vModel or the R of iKalman_Update  *
+*           returning -1 if P, Q or R cannot be factored, 0 if successfull      *
+*                                                                               *
+* ARGUMENT LIST:                                                                *
+*                                                                               *
+* Argument  Type         IO     Description                                     *
+* --------- --------     --     ---------------------------------               *
+* k         Kalman*      IO     Kalman structure, P, Q and R set                *
+* on        int          I      1 to propagate the factor, 0 for P              *
+*                                                                               *
+* RETURN VALUE: int                                                             *
+*                                                                               *
+********************************************************************************/
+int iKalman_SquareRoot(kalman *k, int on)
+{
+    if (k == NULL)
+    {
+        return -1;
+    }
+
+    k->sqrt = 0;
+    if (!on)
+    {
+        return 0;
+    }
+    if (iCholesky(k->L, k->P) != 0 || iCholesky(k->Lq, k->Q) != 0 || iCholesky(k->Lr, k->R) != 0)
+    {
+        return -1;
+    }
+    k->sqrt = 1;
+
+    return 0;
 }
 
 /********************************************************************************
 *                                                                               *
 * FUNCTION NAME: Kalman_Filter                                                  *
 *                                                                               *
-* PURPOSE: Main function of the Kalman Filter, calls the 3 functions            *
+* PURPOSE: Main function of the Kalman Filter, predicts with the filter dt      *
+*           and updates with the measurement                                    *
 *                                                                               *
 * ARGUMENT LIST:                                                                *
 *                                                                               *
@@ -242,7 +1421,6 @@ void vUpdate(kalman *k)
 ********************************************************************************/
 void vKalman_Filter(kalman *k, float a, Matrix *GPS)
 {
-    vPredict(k, a);
-    vInnovation(k, GPS);
-    vUpdate(k);
+    vKalman_Predict(k, k->dt, a);
+    iKalman_Update(k, GPS, NULL);
 }
@@ -48,6 +48,14 @@
 *   04-07-2020    N.di Gruttola                      1.2       Added comments, code satisfies      *
 *                  Giardino                                     iso9899:1999, as requested per     *
 *                                                               MISRA-C:2004                       *
+*   19-10-2026    AHRS Project                       1.3       Workspace allocated once, phases    *
+*                                                               are allocation free, separate      *
+*                                                               predict and update entry points,   *
+*                                                               steady-state gain mode, sequential *
+*                                                               scalar updates, square-root mode,  *
+*                                                               const configuration tables,        *
+*                                                               innovation gate, NIS telemetry,    *
+*                                                               covariance inflation               *
 *                                                                                                  *
 ***************************************************************************************************/
 
@@ -75,21 +83,136 @@ typedef struct Kalman
     Matrix* Q;           /* estimated process error covariance */
     Matrix* A;               /* state transition matrix */
     Matrix* S;               /* innovation covariance */
+
+    /* rebuilds A, B and Q for a new dt, NULL if the model does not depend on dt */
+    void (*vModel)(struct Kalman *);
+
+    /* steady-state mode, K and P frozen at the DARE solution for Rss */
+    int     steady;          /* 1 while the gain is frozen */
+    Matrix* Rss;             /* R the steady-state gain was solved for, m x m */
+    Matrix* Kp;              /* gain of the previous Riccati iteration, n x m */
+
+    /* square-root mode, the covariance is propagated as its factor P = L*L^T */
+    int     sqrt;            /* 1 while L is propagated, P = L*L^T is kept as a copy */
+    Matrix* L;               /* lower Cholesky factor of P, n x n */
+    Matrix* Lq;              /* chol(Q), n x n */
+    Matrix* Lr;              /* chol(R), m x m */
+
+    /* innovation gate, d2 = y^T*S^-1*y against a chi-square quantile */
+    int           gate;      /* KALMAN_GATE_OFF, KALMAN_GATE_95, _99, _999 */
+    float         nis;       /* d2 of the last measurement, computed with the gate off too */
+    float         nis_mean;  /* running mean of d2 of the accepted ones, about m if S is right */
+    unsigned long accepted;  /* measurements that passed the gate */
+    unsigned long rejected;  /* measurements rejected by the gate */
+    unsigned int  misses;    /* consecutive rejections */
+
+    /* workspace, allocated once by iKalman_Init, no phase touches the heap */
+    Matrix* I;               /* identity, n x n */
+    Matrix* At;              /* A^T, n x n */
+    Matrix* Ht;              /* H^T, n x m */
+    Matrix* Ls;              /* Cholesky factor of S, m x m */
+    Matrix* Wnn;             /* scratch, n x n */
+    Matrix* Wnn2;            /* scratch, n x n */
+    Matrix* Wmn;             /* scratch, m x n */
+    Matrix* Wn1;             /* scratch, n x 1 */
+    Matrix* Wm1;             /* scratch, m x 1 */
+    Matrix* Wpre;            /* predict pre-array [A*L, Lq], n x 2n */
+    Matrix* Wupd;            /* update pre-array, (m + n) x (m + n) */
+    Matrix* Tupd;            /* its triangular factor */
+    Matrix* Wseq;            /* scalar update pre-array, (1 + n) x (1 + n) */
+    Matrix* Tseq;            /* its triangular factor */
 }kalman;
 
+/* Definition of Macros */
+
+/* largest model a configuration table can describe */
+#ifndef KALMAN_CFG_N
+#define KALMAN_CFG_N   3
+#endif
+#ifndef KALMAN_CFG_M
+#define KALMAN_CFG_M   3
+#endif
+
+/*
+* KalmanConfig Object:
+*       constant description of one filter, to be declared const so that it
+*       stays in flash: only the leading n x n, n x 1, m x n and m x m
+*       blocks of the arrays are read. vModel is copied into the filter
+*/
+
+typedef struct KalmanConfig
+{
+    const char*  name;
+    unsigned int n;
+    unsigned int m;
+    float        dt;
+    float        A[KALMAN_CFG_N][KALMAN_CFG_N];
+    float        B[KALMAN_CFG_N];
+    float        H[KALMAN_CFG_M][KALMAN_CFG_N];
+    float        Q[KALMAN_CFG_N][KALMAN_CFG_N];
+    float        R[KALMAN_CFG_M][KALMAN_CFG_M];
+    float        x0[KALMAN_CFG_N];
+    float        P0[KALMAN_CFG_N][KALMAN_CFG_N];
+    void       (*vModel)(kalman *);
+}KalmanConfig;
+
+/* innovation gate levels, probability that a consistent measurement passes */
+#define KALMAN_GATE_OFF     0
+#define KALMAN_GATE_95      1
+#define KALMAN_GATE_99      2
+#define KALMAN_GATE_999     3
+#define KALMAN_GATE_LEVELS  4
+#define KALMAN_GATE_DOF     6       /* largest m the chi-square table covers */
+
+/* weight of the newest accepted d2 in nis_mean */
+#ifndef KALMAN_NIS_ALPHA
+#define KALMAN_NIS_ALPHA    0.05f
+#endif
+
 //int sat;            //number of satellites
 //float sigma(int satellites){if(satellites<3)  return 10000; else return (1+pow(satellites,-0.5));}  //possible error, tbd
 
 
 /* Declare Prototypes */
 
+/*============================================*/
+/* Kalman object functions prototypes         */
+/*============================================*/
+int   iKalman_Init       (kalman *, unsigned int, unsigned int);
+int   iKalman_InitConfig (kalman *, const KalmanConfig *);
+int   iKalman_LoadConfig (kalman *, const KalmanConfig *);
+void  vKalman_Destroy    (kalman *);
+
 /*============================================*/
 /* Kalman state functions prototypes          */
 /*============================================*/
 void  vPredict     (kalman *, float);
-void  vInnovation  (kalman *, Matrix *);
+int   iInnovation  (kalman *, Matrix *);
 void  vUpdate      (kalman *);
 
+/*============================================*/
+/* Kalman multi-rate entry points prototypes  */
+/*============================================*/
+void  vKalman_Predict  (kalman *, float, float);
+int   iKalman_Update   (kalman *, Matrix *, Matrix *);
+int   iKalman_UpdateSeq(kalman *, Matrix *, const unsigned char *);
+
+/*============================================*/
+/* Kalman innovation gate prototypes          */
+/*============================================*/
+int   iKalman_SetGate      (kalman *, int);
+int   iKalman_Inflate      (kalman *, float);
+
+/*============================================*/
+/* Kalman steady-state mode prototypes        */
+/*============================================*/
+int   iKalman_SteadyState  (kalman *, unsigned int, float);
+
+/*============================================*/
+/* Kalman square-root mode prototypes         */
+/*============================================*/
+int   iKalman_SquareRoot   (kalman *, int);
+
 
 /*============================================*/
 /* Kalman main function prototype             */
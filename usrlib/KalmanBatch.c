@@ -0,0 +1,376 @@
+/***********************************************************************************
+* This file is part of The AHRS Project.                                           *
+*                                                                                  *
+* Copyright © 2020 By Nicola di Gruttola Giardino. All rights reserved.            *
+* @mail: nicoladgg@protonmail.com                                                  *
+*                                                                                  *
+* AHRS is free software: you can redistribute it and/or modify                     *
+* it under the terms of the GNU General Public License as published by             *
+* the Free Software Foundation, either version 3 of the License, or                *
+* (at your option) any later version.                                              *
+*                                                                                  *
+* AHRS is distributed in the hope that it will be useful,                          *
+* but WITHOUT ANY WARRANTY; without even the implied warranty of                   *
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the                    *
+* GNU General Public License for more details.                                     *
+*                                                                                  *
+* You should have received a copy of the GNU General Public License                *
+* along with The AHRS Project.  If not, see <https://www.gnu.org/licenses/>.       *
+*                                                                                  *
+* In case of use of this project, I ask you to mention me, to whom it may concern. *
+***********************************************************************************/
+
+/****************************************************************************************************
+* FILE NAME: KalmanBatch.c                                                                          *
+*                                                                                                   *
+* PURPOSE: This library runs N identical 2-state constant velocity Kalman filters, e.g. the         *
+*           North, East and Down axes of IMU.c or hundreds of filters of a batch study, with        *
+*           every state and covariance element in its own contiguous array, so that each line       *
+*           of predict and update is one loop over the filters the compiler can vectorise           *
+*                                                                                                   *
+* FILE REFERENCES:                                                                                  *
+*                                                                                                   *
+*   Name    I/O     Description                                                                     *
+*   ----    ---     -----------                                                                     *
+*   none                                                                                            *
+*                                                                                                   *
+*                                                                                                   *
+* EXTERNAL VARIABLES:                                                                               *
+*                                                                                                   *
+* Source: <KalmanBatch.h>                                                                           *
+*                                                                                                   *
+* Name          Type        IO Description                                                          *
+* ------------- -------     -- -----------------------------                                        *
+*   b           KalmanBatch    Batch object                                                         *
+*                                                                                                   *
+* STATIC VARIABLES:                                                                                 *
+*                                                                                                   *
+*   Name     Type       I/O      Description                                                        *
+*   ----     ----       ---      -----------                                                        *
+*   none                                                                                            *
+*                                                                                                   *
+* EXTERNAL REFERENCES:                                                                              *
+*                                                                                                   *
+*  Name                       Description                                                           *
+*  -------------              -----------                                                           *
+*  none                                                                                             *
+*                                                                                                   *
+* ABNORMAL TERMINATION CONDITIONS, ERROR AND WARNING MESSAGES:                                      *
+*    none, compliant with the standard ISO9899:1999                                                 *
+*                                                                                                   *
+* ASSUMPTIONS, CONSTRAINTS, RESTRICTIONS: R is diagonal, the update is sequential (position         *
+*    then velocity), the same as iKalman_UpdateSeq                                                  *
+*                                                                                                   *
+* NOTES: the loops have no branches and take restrict arrays, a filter without a fix gets a         *
+*         zero gain and a zero innovation, whatever its measurement holds                           *
+*                                                                                                   *
+* REQUIREMENTS/FUNCTIONAL SPECIFICATIONS REFERENCES:                                                *
+*                                                                                                   *
+* DEVELOPMENT HISTORY:                                                                              *
+*                                                                                                   *
+*   Date          Author            Change Id     Release     Description Of Change                 *
+*   ----          ------            ---------     ------      ----------------------                *
+*   19-10-2026    AHRS Project       1               1         Initial release                      *
+*                                                                                                   *
+****************************************************************************************************/
+
+/* Include Global Parameters */
+
+#include <stdint.h>
+#include <string.h>
+#include "KalmanBatch.h"
+
+/* Definition of Macros */
+
+#define KB_ARRAYS   10      /* x0, x1, p00, p01, p11, q0, q1, r0, r1, fix */
+
+/* Declare Prototypes */
+
+static void  vPredict_Soa  (float * restrict, float * restrict, float * restrict,
+                            float * restrict, float * restrict, const float * restrict,
+                            const float * restrict, const float * restrict, float, unsigned int);
+static void  vUpdate_Soa   (float * restrict, float * restrict, float * restrict,
+                            float * restrict, float * restrict, const float * restrict,
+                            const float * restrict, const float * restrict,
+                            const float * restrict, const float * restrict, unsigned int);
+static float fSelect       (float, float);
+
+
+/********************************************************************************
+*                                                                               *
+* FUNCTION NAME: iKalmanBatch_Init                                              *
+*                                                                               *
+* PURPOSE: Allocates the arrays of n filters in one block; states are zero,     *
+*           P is the identity, Q is zero and R is 0.2*I as in iSetup_Kalman     *
+*           returning -1 if failed, 0 if successfull                            *
+*                                                                               *
+* ARGUMENT LIST:                                                                *
+*                                                                               *
+* Argument  Type         IO     Description                                     *
+* --------- --------     --     ---------------------------------               *
+* b         KalmanBatch* O      Batch object                                    *
+* n         unsigned int I      Number of filters                               *
+* dt        float        I      Sampling period                                 *
+*                                                                               *
+* RETURN VALUE: int                                                             *
+*                                                                               *
+********************************************************************************/
+int iKalmanBatch_Init(KalmanBatch *b, unsigned int n, float dt)
+{
+    float *block;
+    unsigned int i;
+
+    if (b == NULL || n == 0)
+    {
+        return -1;
+    }
+
+    block = (float *)malloc(KB_ARRAYS * n * sizeof(float));
+    if (block == NULL)
+    {
+        return -1;
+    }
+
+    b->n   = n;
+    b->dt  = dt;
+    b->x0  = block;
+    b->x1  = block + 1 * n;
+    b->p00 = block + 2 * n;
+    b->p01 = block + 3 * n;
+    b->p11 = block + 4 * n;
+    b->q0  = block + 5 * n;
+    b->q1  = block + 6 * n;
+    b->r0  = block + 7 * n;
+    b->r1  = block + 8 * n;
+    b->fix = block + 9 * n;
+
+    for (i = 0; i < n; i++)
+    {
+        b->x0[i]  = 0;
+        b->x1[i]  = 0;
+        b->p00[i] = 1;
+        b->p01[i] = 0;
+        b->p11[i] = 1;
+        b->q0[i]  = 0;
+        b->q1[i]  = 0;
+        b->r0[i]  = 0.2f;
+        b->r1[i]  = 0.2f;
+        b->fix[i] = 0;
+    }
+
+    return 0;
+}
+
+/********************************************************************************
+*                                                                               *
+* FUNCTION NAME: vKalmanBatch_Destroy                                           *
+*                                                                               *
+* PURPOSE: Frees the block allocated by iKalmanBatch_Init                       *
+*                                                                               *
+* ARGUMENT LIST:                                                                *
+*                                                                               *
+* Argument  Type         IO     Description                                     *
+* --------- --------     --     ---------------------------------               *
+* b         KalmanBatch* IO     Batch object                                    *
+*                                                                               *
+* RETURN VALUE: void                                                            *
+*                                                                               *
+********************************************************************************/
+void vKalmanBatch_Destroy(KalmanBatch *b)
+{
+    if (b == NULL)
+    {
+        return;
+    }
+
+    free(b->x0);
+    b->x0 = NULL;
+    b->n  = 0;
+}
+
+/********************************************************************************
+*                                                                               *
+* FUNCTION NAME: vKalmanBatch_Predict                                           *
+*                                                                               *
+* PURPOSE: x=A*x + B*u, P=A*P*A^T + Q for all the filters                       *
+*                                                                               *
+* ARGUMENT LIST:                                                                *
+*                                                                               *
+* Argument  Type         IO     Description                                     *
+* --------- --------     --     ---------------------------------               *
+* b         KalmanBatch* IO     Batch object                                    *
+* u         const float* I      n accelerations, one per filter                 *
+*                                                                               *
+* RETURN VALUE: void                                                            *
+*                                                                               *
+********************************************************************************/
+void vKalmanBatch_Predict(KalmanBatch *b, const float *u)
+{
+    vPredict_Soa(b->x0, b->x1, b->p00, b->p01, b->p11, b->q0, b->q1, u, b->dt, b->n);
+}
+
+/********************************************************************************
+*                                                                               *
+* FUNCTION NAME: vKalmanBatch_Update                                            *
+*                                                                               *
+* PURPOSE: Sequential update with position then velocity for all the filters,  *
+*           a filter whose valid flag is 0 is left untouched                    *
+*                                                                               *
+* ARGUMENT LIST:                                                                *
+*                                                                               *
+* Argument  Type         IO     Description                                     *
+* --------- --------     --     ---------------------------------               *
+* b         KalmanBatch* IO     Batch object                                    *
+* zp        const float* I      n measured positions                            *
+* zv        const float* I      n measured velocities                           *
+* valid     uchar*       I      n flags, 0 to skip a filter, NULL for all       *
+*                                                                               *
+* RETURN VALUE: void                                                            *
+*                                                                               *
+********************************************************************************/
+void vKalmanBatch_Update(KalmanBatch *b, const float *zp, const float *zv, const unsigned char *valid)
+{
+    unsigned int i;
+
+    for (i = 0; i < b->n; i++)
+    {
+        b->fix[i] = (valid == NULL || valid[i]) ? 1.0f : 0.0f;
+    }
+
+    vUpdate_Soa(b->x0, b->x1, b->p00, b->p01, b->p11, b->r0, b->r1, zp, zv, b->fix, b->n);
+}
+
+/********************************************************************************
+*                                                                               *
+* FUNCTION NAME: vPredict_Soa                                                   *
+*                                                                               *
+* PURPOSE: Predict loop, the arrays are restrict parameters so that the         *
+*           compiler can vectorise it                                           *
+*                                                                               *
+* ARGUMENT LIST:                                                                *
+*                                                                               *
+* Argument  Type         IO     Description                                     *
+* --------- --------     --     ---------------------------------               *
+* x0..p11   float*       IO     State and covariance arrays                     *
+* q0, q1    const float* I      Diagonal of Q                                   *
+* u         const float* I      Accelerations                                   *
+* dt        float        I      Sampling period                                 *
+* n         unsigned int I      Number of filters                               *
+*                                                                               *
+* RETURN VALUE: void                                                            *
+*                                                                               *
+********************************************************************************/
+static void vPredict_Soa(float * restrict x0, float * restrict x1, float * restrict p00,
+                         float * restrict p01, float * restrict p11, const float * restrict q0,
+                         const float * restrict q1, const float * restrict u, float dt,
+                         unsigned int n)
+{
+    const float dt2 = 0.5f * dt * dt;
+    unsigned int i;
+
+    for (i = 0; i < n; i++)
+    {
+        /* P_p=A*P*A^T + Q, A=[1 dt; 0 1] */
+        const float a = p01[i] + dt * p11[i];
+
+        x0[i]  += dt * x1[i] + dt2 * u[i];
+        x1[i]  += dt * u[i];
+        p00[i] += dt * (p01[i] + a) + q0[i];
+        p01[i]  = a;
+        p11[i] += q1[i];
+    }
+}
+
+/********************************************************************************
+*                                                                               *
+* FUNCTION NAME: fSelect                                                        *
+*                                                                               *
+* PURPOSE: Returns d if f is not 0, else 0, by masking the bits of d: a stale   *
+*           NaN or Inf measurement of a filter without a fix would survive the  *
+*           zero gain (0*NaN is NaN), and a ?: is a branch that stops the       *
+*           vectoriser unless traps are off                                     *
+*                                                                               *
+* ARGUMENT LIST:                                                                *
+*                                                                               *
+* Argument  Type         IO     Description                                     *
+* --------- --------     --     ---------------------------------               *
+* d         float        I      Value to select                                 *
+* f         float        I      Selector, the fix flag of the filter            *
+*                                                                               *
+* RETURN VALUE: float                                                           *
+*                                                                               *
+********************************************************************************/
+static float fSelect(float d, float f)
+{
+    uint32_t a;
+    uint32_t m;
+
+    memcpy(&a, &d, sizeof(a));
+    memcpy(&m, &f, sizeof(m));
+    a &= 0u - (uint32_t)(m != 0);
+    memcpy(&d, &a, sizeof(d));
+
+    return d;
+}
+
+/********************************************************************************
+*                                                                               *
+* FUNCTION NAME: vUpdate_Soa                                                    *
+*                                                                               *
+* PURPOSE: Update loop, a filter without a fix gets a zero gain and a zero     *
+*           innovation (fSelect) instead of a branch so that the compiler can   *
+*           vectorise it                                                        *
+*                                                                               *
+* ARGUMENT LIST:                                                                *
+*                                                                               *
+* Argument  Type         IO     Description                                     *
+* --------- --------     --     ---------------------------------               *
+* x0..p11   float*       IO     State and covariance arrays                     *
+* r0, r1    const float* I      Diagonal of R                                   *
+* zp, zv    const float* I      Measured positions and velocities               *
+* fix       const float* I      1 to apply the measurement, 0 to skip it        *
+* n         unsigned int I      Number of filters                               *
+*                                                                               *
+* RETURN VALUE: void                                                            *
+*                                                                               *
+********************************************************************************/
+static void vUpdate_Soa(float * restrict x0, float * restrict x1, float * restrict p00,
+                        float * restrict p01, float * restrict p11, const float * restrict r0,
+                        const float * restrict r1, const float * restrict zp,
+                        const float * restrict zv, const float * restrict fix, unsigned int n)
+{
+    unsigned int i;
+
+    for (i = 0; i < n; i++)
+    {
+        float h0, h1, g0, g1, d, e, is;
+
+        /* position: h=[1 0], Ph=[p00 p01] */
+        h0 = p00[i];
+        h1 = p01[i];
+        is = fix[i] / (h0 + r0[i]);
+        g0 = h0 * is;
+        g1 = h1 * is;
+        d  = zp[i] - x0[i];
+        e  = fSelect(d, fix[i]);
+        x0[i]  += g0 * e;
+        x1[i]  += g1 * e;
+        p00[i] -= g0 * h0;
+        p01[i] -= g0 * h1;
+        p11[i] -= g1 * h1;
+
+        /* velocity: h=[0 1], Ph=[p01 p11] */
+        h0 = p01[i];
+        h1 = p11[i];
+        is = fix[i] / (h1 + r1[i]);
+        g0 = h0 * is;
+        g1 = h1 * is;
+        d  = zv[i] - x1[i];
+        e  = fSelect(d, fix[i]);
+        x0[i]  += g0 * e;
+        x1[i]  += g1 * e;
+        p00[i] -= g0 * h0;
+        p01[i] -= g0 * h1;
+        p11[i] -= g1 * h1;
+    }
+}
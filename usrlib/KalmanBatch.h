@@ -0,0 +1,86 @@
+/***********************************************************************************
+* This file is part of The AHRS Project.                                           *
+*                                                                                  *
+* Copyright © 2020 By Nicola di Gruttola Giardino. All rights reserved.            *
+* @mail: nicoladgg@protonmail.com                                                  *
+*                                                                                  *
+* AHRS is free software: you can redistribute it and/or modify                     *
+* it under the terms of the GNU General Public License as published by             *
+* the Free Software Foundation, either version 3 of the License, or                *
+* (at your option) any later version.                                              *
+*                                                                                  *
+* AHRS is distributed in the hope that it will be useful,                          *
+* but WITHOUT ANY WARRANTY; without even the implied warranty of                   *
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the                    *
+* GNU General Public License for more details.                                     *
+*                                                                                  *
+* You should have received a copy of the GNU General Public License                *
+* along with The AHRS Project.  If not, see <https://www.gnu.org/licenses/>.       *
+*                                                                                  *
+* In case of use of this project, I ask you to mention me, to whom it may concern. *
+***********************************************************************************/
+
+/***************************************************************************************************
+*   FILENAME:  KalmanBatch.h                                                                       *
+*                                                                                                  *
+*                                                                                                  *
+*   PURPOSE:   Library that defines the object KalmanBatch, N identical 2-state constant           *
+*               velocity filters stored as structure of arrays and run in one pass                 *
+*                                                                                                  *
+*                                                                                                  *
+*   GLOBAL VARIABLES:                                                                              *
+*                                                                                                  *
+*                                                                                                  *
+*   Variable        Type        Description                                                        *
+*   --------        ----        -------------------                                                *
+*   KalmanBatch     KalmanBatch Batch object, one array per state and covariance element           *
+*                                                                                                  *
+*   DEVELOPMENT HISTORY :                                                                          *
+*                                                                                                  *
+*                                                                                                  *
+*   Date          Author            Change Id     Release     Description Of Change                *
+*   ----          ------            -------- -    ------      ----------------------               *
+*   19-10-2026    AHRS Project       1               1         Initial release                     *
+*                                                                                                  *
+***************************************************************************************************/
+
+#ifndef KalmanBatch_h
+#define KalmanBatch_h
+
+/* Include Global Parameters */
+
+#include <stdlib.h>
+
+/*
+* KalmanBatch Object:
+*       n filters sharing dt, A=[1 dt; 0 1], B=[dt^2/2; dt] and H=I.
+*       Filter i has position x0[i], velocity x1[i], covariance
+*       [p00[i] p01[i]; p01[i] p11[i]], diagonal Q q0[i], q1[i] and
+*       diagonal R r0[i], r1[i], fix[i] 1 if filter i had a fix at the last
+*       update; all the arrays live in one block
+*/
+
+typedef struct KalmanBatch
+{
+    unsigned int n;
+    float  dt;
+    float* x0;
+    float* x1;
+    float* p00;
+    float* p01;
+    float* p11;
+    float* q0;
+    float* q1;
+    float* r0;
+    float* r1;
+    float* fix;
+}KalmanBatch;
+
+/* Declare Prototypes */
+
+int   iKalmanBatch_Init     (KalmanBatch *, unsigned int, float);
+void  vKalmanBatch_Destroy  (KalmanBatch *);
+void  vKalmanBatch_Predict  (KalmanBatch *, const float *);
+void  vKalmanBatch_Update   (KalmanBatch *, const float *, const float *, const unsigned char *);
+
+#endif /* KalmanBatch_h */
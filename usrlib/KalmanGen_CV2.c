@@ -0,0 +1,146 @@
+/***********************************************************************************
+* This file is part of The AHRS Project.                                           *
+*                                                                                  *
+* Copyright © 2020 By Nicola di Gruttola Giardino. All rights reserved.            *
+* @mail: nicoladgg@protonmail.com                                                  *
+*                                                                                  *
+* AHRS is free software: you can redistribute it and/or modify                     *
+* it under the terms of the GNU General Public License as published by             *
+* the Free Software Foundation, either version 3 of the License, or                *
+* (at your option) any later version.                                              *
+*                                                                                  *
+* AHRS is distributed in the hope that it will be useful,                          *
+* but WITHOUT ANY WARRANTY; without even the implied warranty of                   *
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the                    *
+* GNU General Public License for more details.                                     *
+*                                                                                  *
+* You should have received a copy of the GNU General Public License                *
+* along with The AHRS Project.  If not, see <https://www.gnu.org/licenses/>.       *
+*                                                                                  *
+* In case of use of this project, I ask you to mention me, to whom it may concern. *
+***********************************************************************************/
+
+/*
+* GENERATED by tools/kalman_gen.py from tools/cv2.json, do not edit:
+* change the model and run  python3 tools/kalman_gen.py tools/cv2.json usrlib
+*/
+
+/* Include Global Parameters */
+
+#include "KalmanGen_CV2.h"
+
+/********************************************************************************
+*                                                                               *
+* FUNCTION NAME: vKalmanGen_CV2_Predict                                         *
+*                                                                               *
+* PURPOSE: x=A*x + B*u, P=A*P*A^T + Q                                           *
+*                                                                               *
+* ARGUMENT LIST:                                                                *
+*                                                                               *
+* Argument  Type         IO     Description                                     *
+* --------- --------     --     ---------------------------------               *
+* k         KalmanGen*   IO     Filter CV2                                      *
+* u         float        I      Control input                                   *
+*                                                                               *
+* RETURN VALUE: void                                                            *
+*                                                                               *
+********************************************************************************/
+void vKalmanGen_CV2_Predict(KalmanGen_CV2 *k, float u)
+{
+    const float dt = k->dt;
+
+    const float x0 = k->x[0];
+    const float x1 = k->x[1];
+    const float p00 = k->P[0][0];
+    const float p01 = k->P[0][1];
+    const float p11 = k->P[1][1];
+    const float t0 = 0.5f * dt * dt;
+    const float t1 = dt * x1;
+    const float t2 = t0 * u;
+    const float t3 = t1 + t2 + x0;
+    const float t4 = dt * u;
+    const float t5 = t4 + x1;
+    const float t6 = dt * p01;
+    const float t7 = p00 + t6;
+    const float t8 = dt * p11;
+    const float t9 = p01 + t8;
+    const float t10 = dt * t9;
+    const float t11 = k->q[0] + t10 + t7;
+    const float t12 = k->q[1] + p11;
+    k->x[0] = t3;
+    k->x[1] = t5;
+    k->P[0][0] = t11;
+    k->P[0][1] = t9;
+    k->P[1][0] = t9;
+    k->P[1][1] = t12;
+}
+
+/********************************************************************************
+*                                                                               *
+* FUNCTION NAME: vKalmanGen_CV2_Update                                          *
+*                                                                               *
+* PURPOSE: Sequential scalar measurement update, components whose valid         *
+*           flag is 0 are skipped                                               *
+*                                                                               *
+* ARGUMENT LIST:                                                                *
+*                                                                               *
+* Argument  Type         IO     Description                                     *
+* --------- --------     --     ---------------------------------               *
+* k         KalmanGen*   IO     Filter CV2                                      *
+* z         const float* I      Measurement, 2 components                       *
+* valid     uchar*       I      2 flags, 0 to skip one, NULL for all            *
+*                                                                               *
+* RETURN VALUE: void                                                            *
+*                                                                               *
+********************************************************************************/
+void vKalmanGen_CV2_Update(KalmanGen_CV2 *k, const float *z, const unsigned char *valid)
+{
+    float x0 = k->x[0];
+    float x1 = k->x[1];
+    float p00 = k->P[0][0];
+    float p01 = k->P[0][1];
+    float p11 = k->P[1][1];
+
+    /* component 0 */
+    if (valid == NULL || valid[0])
+    {
+        const float h0_0 = p00;
+        const float h0_1 = p01;
+        const float s0 = h0_0 + k->r[0];
+        const float i0 = 1.0f / s0;
+        const float e0 = z[0] - x0;
+        const float g0_0 = h0_0 * i0;
+        const float g0_1 = h0_1 * i0;
+        x0 += g0_0 * e0;
+        x1 += g0_1 * e0;
+        p00 -= g0_0 * h0_0;
+        p01 -= g0_0 * h0_1;
+        p11 -= g0_1 * h0_1;
+        k->y[0] = e0;
+    }
+
+    /* component 1 */
+    if (valid == NULL || valid[1])
+    {
+        const float h1_0 = p01;
+        const float h1_1 = p11;
+        const float s1 = h1_1 + k->r[1];
+        const float i1 = 1.0f / s1;
+        const float e1 = z[1] - x1;
+        const float g1_0 = h1_0 * i1;
+        const float g1_1 = h1_1 * i1;
+        x0 += g1_0 * e1;
+        x1 += g1_1 * e1;
+        p00 -= g1_0 * h1_0;
+        p01 -= g1_0 * h1_1;
+        p11 -= g1_1 * h1_1;
+        k->y[1] = e1;
+    }
+
+    k->x[0] = x0;
+    k->x[1] = x1;
+    k->P[0][0] = p00;
+    k->P[0][1] = p01;
+    k->P[1][0] = p01;
+    k->P[1][1] = p11;
+}
@@ -0,0 +1,56 @@
+/***********************************************************************************
+* This file is part of The AHRS Project.                                           *
+*                                                                                  *
+* Copyright © 2020 By Nicola di Gruttola Giardino. All rights reserved.            *
+* @mail: nicoladgg@protonmail.com                                                  *
+*                                                                                  *
+* AHRS is free software: you can redistribute it and/or modify                     *
+* it under the terms of the GNU General Public License as published by             *
+* the Free Software Foundation, either version 3 of the License, or                *
+* (at your option) any later version.                                              *
+*                                                                                  *
+* AHRS is distributed in the hope that it will be useful,                          *
+* but WITHOUT ANY WARRANTY; without even the implied warranty of                   *
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the                    *
+* GNU General Public License for more details.                                     *
+*                                                                                  *
+* You should have received a copy of the GNU General Public License                *
+* along with The AHRS Project.  If not, see <https://www.gnu.org/licenses/>.       *
+*                                                                                  *
+* In case of use of this project, I ask you to mention me, to whom it may concern. *
+***********************************************************************************/
+
+/*
+* GENERATED by tools/kalman_gen.py from tools/cv2.json, do not edit:
+* change the model and run  python3 tools/kalman_gen.py tools/cv2.json usrlib
+*/
+
+#ifndef KalmanGen_CV2_h
+#define KalmanGen_CV2_h
+
+/* Include Global Parameters */
+
+#include <stddef.h>
+
+/*
+* KalmanGen_CV2 Object:
+*       x the state, P its covariance, q and r the diagonals of Q and R,
+*       y the innovation of the last update, dt the sampling period
+*/
+
+typedef struct KalmanGen_CV2
+{
+    float dt;
+    float x[2];
+    float P[2][2];
+    float q[2];
+    float r[2];
+    float y[2];
+}KalmanGen_CV2;
+
+/* Declare Prototypes */
+
+void  vKalmanGen_CV2_Predict  (KalmanGen_CV2 *, float);
+void  vKalmanGen_CV2_Update   (KalmanGen_CV2 *, const float *, const unsigned char *);
+
+#endif /* KalmanGen_CV2_h */
@@ -0,0 +1,360 @@
+/***********************************************************************************
+* This file is part of The AHRS Project.                                           *
+*                                                                                  *
+* Copyright © 2020 By Nicola di Gruttola Giardino. All rights reserved.            *
+* @mail: nicoladgg@protonmail.com                                                  *
+*                                                                                  *
+* AHRS is free software: you can redistribute it and/or modify                     *
+* it under the terms of the GNU General Public License as published by             *
+* the Free Software Foundation, either version 3 of the License, or                *
+* (at your option) any later version.                                              *
+*                                                                                  *
+* AHRS is distributed in the hope that it will be useful,                          *
+* but WITHOUT ANY WARRANTY; without even the implied warranty of                   *
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the                    *
+* GNU General Public License for more details.                                     *
+*                                                                                  *
+* You should have received a copy of the GNU General Public License                *
+* along with The AHRS Project.  If not, see <https://www.gnu.org/licenses/>.       *
+*                                                                                  *
+* In case of use of this project, I ask you to mention me, to whom it may concern. *
+***********************************************************************************/
+
+/****************************************************************************************************
+* FILE NAME: KalmanHistory.c                                                                        *
+*                                                                                                   *
+* PURPOSE: Delayed measurements. Every prediction of the filter is recorded with its epoch, step    *
+*           and input in a ring allocated once. A measurement of an older epoch restores the        *
+*           state predicted for that epoch, is applied there, and the recorded predictions that     *
+*           followed are replayed with their own dt and u, predict only                             *
+*                                                                                                   *
+* FILE REFERENCES:                                                                                  *
+*                                                                                                   *
+*   Name    I/O     Description                                                                     *
+*   ----    ---     -----------                                                                     *
+*   none                                                                                            *
+*                                                                                                   *
+*                                                                                                   *
+* EXTERNAL VARIABLES:                                                                               *
+*                                                                                                   *
+* Source: <KalmanHistory.h>                                                                         *
+*                                                                                                   *
+* Name          Type          IO Description                                                        *
+* ------------- -------       -- -----------------------------                                      *
+*   h           KalmanHistory    History object                                                     *
+*                                                                                                   *
+* STATIC VARIABLES:                                                                                 *
+*                                                                                                   *
+*   Name     Type       I/O      Description                                                        *
+*   ----     ----       ---      -----------                                                        *
+*   none                                                                                            *
+*                                                                                                   *
+* EXTERNAL REFERENCES:                                                                              *
+*                                                                                                   *
+*  Name                       Description                                                           *
+*  -------------              -----------                                                           *
+*  vKalman_Predict            Kalman.c, time update                                                 *
+*  iKalman_Update             Kalman.c, measurement update                                          *
+*  uProbe_Now, vProbe_Clock   Probe.h, Probe.c, clock of the replay statistics                      *
+*                                                                                                   *
+* ABNORMAL TERMINATION CONDITIONS, ERROR AND WARNING MESSAGES:                                      *
+*    a measurement older than the oldest recorded epoch is rejected                                 *
+*                                                                                                   *
+* ASSUMPTIONS, CONSTRAINTS, RESTRICTIONS: measurements arrive in epoch order: a replay starts       *
+*    from the recorded prediction, so an earlier update applied after that epoch is lost            *
+*                                                                                                   *
+* NOTES: the replay of one update is at most cap - 1 predictions, cap is the latency budget,        *
+*         e.g. 512 slots cover 300 ms of GPS latency at 1 kHz                                       *
+*                                                                                                   *
+* REQUIREMENTS/FUNCTIONAL SPECIFICATIONS REFERENCES:                                                *
+*                                                                                                   *
+* DEVELOPMENT HISTORY:                                                                              *
+*                                                                                                   *
+*   Date          Author            Change Id     Release     Description Of Change                 *
+*   ----          ------            ---------     ------      ----------------------                *
+*   19-10-2026    AHRS Project       1               1         Initial release                      *
+*                                                                                                   *
+****************************************************************************************************/
+
+/* Include Global Parameters */
+
+#include "KalmanHistory.h"
+
+/* Declare Prototypes */
+
+static void      vSave    (KalmanHistory *, unsigned int);
+static void      vRestore (KalmanHistory *, unsigned int);
+
+
+/********************************************************************************
+*                                                                               *
+* FUNCTION NAME: iKalmanHistory_Init                                            *
+*                                                                               *
+* PURPOSE: Allocates the ring of cap predictions of filter k in one block and   *
+*           starts the clock of the replay statistics (vProbe_Clock)            *
+*           returning -1 if failed, 0 if successfull                            *
+*                                                                               *
+* ARGUMENT LIST:                                                                *
+*                                                                               *
+* Argument  Type         IO     Description                                     *
+* --------- --------     --     ---------------------------------               *
+* h         KalmanHist*  O      History object                                  *
+* k         kalman*      I      Filter, created by iKalman_Init                 *
+* cap       unsigned int I      Number of predictions kept                      *
+*                                                                               *
+* RETURN VALUE: int                                                             *
+*                                                                               *
+********************************************************************************/
+int iKalmanHistory_Init(KalmanHistory *h, kalman *k, unsigned int cap)
+{
+    unsigned int n;
+    float       *block;
+
+    if (h == NULL || k == NULL || cap < 2)
+    {
+        return -1;
+    }
+
+    n     = k->x->r;
+    block = (float *)malloc((size_t)cap * (3 + n + n * n) * sizeof(float));
+    if (block == NULL)
+    {
+        return -1;
+    }
+
+    h->k     = k;
+    h->cap   = cap;
+    h->head  = 0;
+    h->count = 0;
+    h->t     = block;
+    h->dt    = block + cap;
+    h->u     = block + 2 * cap;
+    h->x     = block + 3 * cap;
+    h->P     = block + (3 + n) * cap;
+
+    h->replays    = 0;
+    h->replay_max = 0;
+    h->cycles_max = 0;
+
+    vProbe_Clock();
+
+    return 0;
+}
+
+/********************************************************************************
+*                                                                               *
+* FUNCTION NAME: vKalmanHistory_Destroy                                         *
+*                                                                               *
+* PURPOSE: Frees the ring, the filter is not touched                            *
+*                                                                               *
+* ARGUMENT LIST:                                                                *
+*                                                                               *
+* Argument  Type         IO     Description                                     *
+* --------- --------     --     ---------------------------------               *
+* h         KalmanHist*  IO     History object                                  *
+*                                                                               *
+* RETURN VALUE: void                                                            *
+*                                                                               *
+********************************************************************************/
+void vKalmanHistory_Destroy(KalmanHistory *h)
+{
+    if (h == NULL)
+    {
+        return;
+    }
+
+    free(h->t);
+    h->t     = NULL;
+    h->count = 0;
+}
+
+/********************************************************************************
+*                                                                               *
+* FUNCTION NAME: vSave                                                          *
+*                                                                               *
+* PURPOSE: Copies x and P of the filter into slot s                             *
+*                                                                               *
+* ARGUMENT LIST:                                                                *
+*                                                                               *
+* Argument  Type         IO     Description                                     *
+* --------- --------     --     ---------------------------------               *
+* h         KalmanHist*  IO     History object                                  *
+* s         unsigned int I      Slot                                            *
+*                                                                               *
+* RETURN VALUE: void                                                            *
+********************************************************************************/
+static void vSave(KalmanHistory *h, unsigned int s)
+{
+    const unsigned int n = h->k->x->r;
+    float       *x = h->x + (size_t)s * n;
+    float       *P = h->P + (size_t)s * n * n;
+    unsigned int i;
+    unsigned int j;
+
+    for (i = 0; i < n; i++)
+    {
+        x[i] = h->k->x->matrix[i][0];
+        for (j = 0; j < n; j++)
+        {
+            P[i * n + j] = h->k->P->matrix[i][j];
+        }
+    }
+}
+
+/********************************************************************************
+*                                                                               *
+* FUNCTION NAME: vRestore                                                       *
+*                                                                               *
+* PURPOSE: Copies x and P of slot s back into the filter, refactoring P in      *
+*           square-root mode                                                    *
+*                                                                               *
+* ARGUMENT LIST:                                                                *
+*                                                                               *
+* Argument  Type         IO     Description                                     *
+* --------- --------     --     ---------------------------------               *
+* h         KalmanHist*  IO     History object                                  *
+* s         unsigned int I      Slot                                            *
+*                                                                               *
+* RETURN VALUE: void                                                            *
+********************************************************************************/
+static void vRestore(KalmanHistory *h, unsigned int s)
+{
+    const unsigned int n = h->k->x->r;
+    const float *x = h->x + (size_t)s * n;
+    const float *P = h->P + (size_t)s * n * n;
+    unsigned int i;
+    unsigned int j;
+
+    for (i = 0; i < n; i++)
+    {
+        h->k->x->matrix[i][0] = x[i];
+        for (j = 0; j < n; j++)
+        {
+            h->k->P->matrix[i][j] = P[i * n + j];
+        }
+    }
+    if (h->k->sqrt)
+    {
+        iKalman_SquareRoot(h->k, 1);
+    }
+}
+
+/********************************************************************************
+*                                                                               *
+* FUNCTION NAME: vKalmanHistory_Predict                                         *
+*                                                                               *
+* PURPOSE: vKalman_Predict, then records the prediction for epoch t,            *
+*           overwriting the oldest one when the ring is full                    *
+*                                                                               *
+* ARGUMENT LIST:                                                                *
+*                                                                               *
+* Argument  Type         IO     Description                                     *
+* --------- --------     --     ---------------------------------               *
+* h         KalmanHist*  IO     History object                                  *
+* t         float        I      Epoch of the prediction, s                      *
+* dt        float        I      Time since the previous prediction              *
+* u         float        I      IMU acceleration data computed                  *
+*                                                                               *
+* RETURN VALUE: void                                                            *
+*                                                                               *
+********************************************************************************/
+void vKalmanHistory_Predict(KalmanHistory *h, float t, float dt, float u)
+{
+    vKalman_Predict(h->k, dt, u);
+
+    h->t[h->head]  = t;
+    h->dt[h->head] = dt;
+    h->u[h->head]  = u;
+    vSave(h, h->head);
+
+    h->head = (h->head + 1) % h->cap;
+    if (h->count < h->cap)
+    {
+        h->count++;
+    }
+}
+
+/********************************************************************************
+*                                                                               *
+* FUNCTION NAME: iKalmanHistory_Update                                          *
+*                                                                               *
+* PURPOSE: Applies a measurement of epoch t: at the newest prediction it is a   *
+*           plain iKalman_Update, otherwise the prediction for t is restored,   *
+*           updated and the later predictions are replayed and re-recorded; a   *
+*           fix the gate of the filter rejects needs no replay                  *
+*           returning -1 if t is older than the ring or failed, 1 if the gate   *
+*           rejected z, 0 if successfull                                        *
+*                                                                               *
+* ARGUMENT LIST:                                                                *
+*                                                                               *
+* Argument  Type         IO     Description                                     *
+* --------- --------     --     ---------------------------------               *
+* h         KalmanHist*  IO     History object                                  *
+* t         float        I      Epoch the measurement describes, s              *
+* z         Matrix*      I      Measurement, m x 1                              *
+* R         Matrix*      I      Measurement covariance, m x m, or NULL          *
+*                                                                               *
+* RETURN VALUE: int                                                             *
+*                                                                               *
+********************************************************************************/
+int iKalmanHistory_Update(KalmanHistory *h, float t, Matrix *z, Matrix *R)
+{
+    unsigned int back;
+    unsigned int s;
+    uint32_t     t0;
+    uint32_t     cycles;
+    int          ret;
+
+    if (h == NULL || h->count == 0)
+    {
+        return -1;
+    }
+
+    /* newest prediction not later than t, half a step of tolerance */
+    for (back = 0; back < h->count; back++)
+    {
+        s = (h->head + h->cap - 1 - back) % h->cap;
+        if (h->t[s] <= t + 0.5f * h->dt[s])
+        {
+            break;
+        }
+    }
+    if (back == h->count)
+    {
+        return -1;
+    }
+    if (back == 0)
+    {
+        ret = iKalman_Update(h->k, z, R);
+        if (ret != 0)
+        {
+            return ret;
+        }
+        vSave(h, s);
+        return 0;
+    }
+
+    t0 = uProbe_Now();
+    vRestore(h, s);
+    ret = iKalman_Update(h->k, z, R);
+    if (ret != 0)
+    {
+        /* leave the filter at the newest prediction */
+        vRestore(h, (h->head + h->cap - 1) % h->cap);
+        return ret;
+    }
+    vSave(h, s);
+
+    while (s = (s + 1) % h->cap, s != h->head)
+    {
+        vKalman_Predict(h->k, h->dt[s], h->u[s]);
+        vSave(h, s);
+    }
+    cycles = uProbe_Now() - t0;
+
+    h->replays++;
+    h->replay_max = (back > h->replay_max) ? back : h->replay_max;
+    h->cycles_max = (cycles > h->cycles_max) ? cycles : h->cycles_max;
+
+    return 0;
+}
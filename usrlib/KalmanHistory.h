@@ -0,0 +1,95 @@
+/***********************************************************************************
+* This file is part of The AHRS Project.                                           *
+*                                                                                  *
+* Copyright © 2020 By Nicola di Gruttola Giardino. All rights reserved.            *
+* @mail: nicoladgg@protonmail.com                                                  *
+*                                                                                  *
+* AHRS is free software: you can redistribute it and/or modify                     *
+* it under the terms of the GNU General Public License as published by             *
+* the Free Software Foundation, either version 3 of the License, or                *
+* (at your option) any later version.                                              *
+*                                                                                  *
+* AHRS is distributed in the hope that it will be useful,                          *
+* but WITHOUT ANY WARRANTY; without even the implied warranty of                   *
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the                    *
+* GNU General Public License for more details.                                     *
+*                                                                                  *
+* You should have received a copy of the GNU General Public License                *
+* along with The AHRS Project.  If not, see <https://www.gnu.org/licenses/>.       *
+*                                                                                  *
+* In case of use of this project, I ask you to mention me, to whom it may concern. *
+***********************************************************************************/
+
+/***************************************************************************************************
+*   FILENAME:  KalmanHistory.h                                                                     *
+*                                                                                                  *
+*                                                                                                  *
+*   PURPOSE:   Library that defines the object KalmanHistory, a fixed capacity ring of the         *
+*               predicted states of a Kalman filter, used to apply a delayed measurement at its    *
+*               own epoch and replay the predictions that followed it                              *
+*                                                                                                  *
+*                                                                                                  *
+*   GLOBAL VARIABLES:                                                                              *
+*                                                                                                  *
+*                                                                                                  *
+*   Variable        Type           Description                                                     *
+*   --------        ----           -------------------                                             *
+*   KalmanHistory   KalmanHistory  Ring of (t, dt, u, x, P) of one filter                          *
+*                                                                                                  *
+*   DEVELOPMENT HISTORY :                                                                          *
+*                                                                                                  *
+*                                                                                                  *
+*   Date          Author            Change Id     Release     Description Of Change                *
+*   ----          ------            -------- -    ------      ----------------------               *
+*   19-10-2026    AHRS Project       1               1         Initial release                     *
+*                                                                                                  *
+***************************************************************************************************/
+
+#ifndef KalmanHistory_h
+#define KalmanHistory_h
+
+/* Include Global Parameters */
+
+#include <stdint.h>
+#include "Kalman.h"
+#include "Probe.h"
+
+/* Definition of Macros */
+
+/* clock of the replay statistics, uProbe_Now: DWT on the target, ns on the host */
+#define KALMAN_HISTORY_UNIT   PROBE_UNIT
+
+/*
+* KalmanHistory Object:
+*       the last cap predictions of filter k: epoch t, step dt, input u and
+*       the predicted x (n values) and P (n x n values) of each, oldest at
+*       (head - count) mod cap. replays, replay_max and cycles_max are the
+*       number of delayed updates, the most predictions replayed by one of
+*       them and the longest one in KALMAN_HISTORY_UNIT
+*/
+
+typedef struct KalmanHistory
+{
+    kalman*      k;
+    unsigned int cap;
+    unsigned int head;       /* next slot to write */
+    unsigned int count;      /* valid slots */
+    float*       t;
+    float*       dt;
+    float*       u;
+    float*       x;          /* cap x n */
+    float*       P;          /* cap x n x n */
+
+    unsigned long replays;
+    unsigned int  replay_max;
+    uint32_t      cycles_max;
+}KalmanHistory;
+
+/* Declare Prototypes */
+
+int   iKalmanHistory_Init     (KalmanHistory *, kalman *, unsigned int);
+void  vKalmanHistory_Destroy  (KalmanHistory *);
+void  vKalmanHistory_Predict  (KalmanHistory *, float, float, float);
+int   iKalmanHistory_Update   (KalmanHistory *, float, Matrix *, Matrix *);
+
+#endif /* KalmanHistory_h */
@@ -0,0 +1,370 @@
+/***********************************************************************************
+* This file is part of The AHRS Project.                                           *
+*                                                                                  *
+* Copyright © 2020 By Nicola di Gruttola Giardino. All rights reserved.            *
+* @mail: nicoladgg@protonmail.com                                                  *
+*                                                                                  *
+* AHRS is free software: you can redistribute it and/or modify                     *
+* it under the terms of the GNU General Public License as published by             *
+* the Free Software Foundation, either version 3 of the License, or                *
+* (at your option) any later version.                                              *
+*                                                                                  *
+* AHRS is distributed in the hope that it will be useful,                          *
+* but WITHOUT ANY WARRANTY; without even the implied warranty of                   *
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the                    *
+* GNU General Public License for more details.                                     *
+*                                                                                  *
+* You should have received a copy of the GNU General Public License                *
+* along with The AHRS Project.  If not, see <https://www.gnu.org/licenses/>.       *
+*                                                                                  *
+* In case of use of this project, I ask you to mention me, to whom it may concern. *
+***********************************************************************************/
+
+/****************************************************************************************************
+* FILE NAME: KalmanIMM.c                                                                            *
+*                                                                                                   *
+* PURPOSE: Interacting multiple model estimator on the 2-state model of IMU.c. Each step mixes the  *
+*           model states with the switching probabilities, predicts and updates every model in     *
+*           one loop over the models, reweights the models by the likelihood of their innovation   *
+*           and combines them into one estimate                                                     *
+*                                                                                                   *
+* FILE REFERENCES:                                                                                  *
+*                                                                                                   *
+*   Name    I/O     Description                                                                     *
+*   ----    ---     -----------                                                                     *
+*   none                                                                                            *
+*                                                                                                   *
+*                                                                                                   *
+* EXTERNAL VARIABLES:                                                                               *
+*                                                                                                   *
+* Source: <KalmanIMM.h>                                                                             *
+*                                                                                                   *
+* Name          Type          IO Description                                                        *
+* ------------- -------       -- -----------------------------                                      *
+*   m           KalmanIMM        Bank object                                                        *
+*                                                                                                   *
+* STATIC VARIABLES:                                                                                 *
+*                                                                                                   *
+*   Name     Type       I/O      Description                                                        *
+*   ----     ----       ---      -----------                                                        *
+*   none                                                                                            *
+*                                                                                                   *
+* EXTERNAL REFERENCES:                                                                              *
+*                                                                                                   *
+*  Name                       Description                                                           *
+*  -------------              -----------                                                           *
+*  none                                                                                             *
+*                                                                                                   *
+* ABNORMAL TERMINATION CONDITIONS, ERROR AND WARNING MESSAGES:                                      *
+*    none                                                                                           *
+*                                                                                                   *
+* ASSUMPTIONS, CONSTRAINTS, RESTRICTIONS: the measurement is position and velocity, as in IMU.c     *
+*                                                                                                   *
+* NOTES: every loop runs over KALMAN_IMM_MODELS, a constant, on arrays of the object, so the        *
+*         compiler can unroll and vectorise it; the likelihoods are kept as logarithms and          *
+*         shifted by their maximum before the exponential, so that a model far from the data        *
+*         does not underflow all the others to zero                                                 *
+*                                                                                                   *
+* REQUIREMENTS/FUNCTIONAL SPECIFICATIONS REFERENCES:                                                *
+*                                                                                                   *
+* DEVELOPMENT HISTORY:                                                                              *
+*                                                                                                   *
+*   Date          Author            Change Id     Release     Description Of Change                 *
+*   ----          ------            ---------     ------      ----------------------                *
+*   19-10-2026    AHRS Project       1               1         Initial release                      *
+*                                                                                                   *
+****************************************************************************************************/
+
+/* Include Global Parameters */
+
+#include <math.h>
+#include "KalmanIMM.h"
+
+/* Definition of Macros */
+
+#define M   KALMAN_IMM_MODELS
+
+/* Declare Prototypes */
+
+static void  vMix      (KalmanIMM *);
+static void  vCombine  (KalmanIMM *);
+
+
+/********************************************************************************
+*                                                                               *
+* FUNCTION NAME: iKalmanIMM_Init                                                *
+*                                                                               *
+* PURPOSE: Zero state, unit covariance and equal probabilities for every        *
+*           model, staying in the same model with probability stay; the         *
+*           caller then sets q0, q1, r0, r1 and, if needed, Pi                  *
+*           returning -1 if failed, 0 if successfull                            *
+*                                                                               *
+* ARGUMENT LIST:                                                                *
+*                                                                               *
+* Argument  Type         IO     Description                                     *
+* --------- --------     --     ---------------------------------               *
+* m         KalmanIMM*   O      Bank object                                     *
+* dt        float        I      Sampling period                                 *
+* stay      float        I      Diagonal of Pi, in (0, 1]                       *
+*                                                                               *
+* RETURN VALUE: int                                                             *
+*                                                                               *
+********************************************************************************/
+int iKalmanIMM_Init(KalmanIMM *m, float dt, float stay)
+{
+    unsigned int i;
+    unsigned int j;
+
+    if (m == NULL || !(stay > 0) || stay > 1)
+    {
+        return -1;
+    }
+
+    m->dt = dt;
+    m->r0 = 0.2f;
+    m->r1 = 0.2f;
+
+    for (i = 0; i < M; i++)
+    {
+        for (j = 0; j < M; j++)
+        {
+            m->Pi[i][j] = (M == 1) ? 1.0f : (i == j) ? stay : (1.0f - stay) / (float)(M - 1);
+        }
+        m->x0[i]  = 0;
+        m->x1[i]  = 0;
+        m->p00[i] = 1;
+        m->p01[i] = 0;
+        m->p11[i] = 1;
+        m->q0[i]  = 0;
+        m->q1[i]  = 0;
+        m->mu[i]  = 1.0f / (float)M;
+        m->c[i]   = m->mu[i];
+        m->ll[i]  = 0;
+    }
+    vCombine(m);
+
+    return 0;
+}
+
+/********************************************************************************
+*                                                                               *
+* FUNCTION NAME: vMix                                                           *
+*                                                                               *
+* PURPOSE: Interaction: c_j = sum_i Pi_ij mu_i, each model restarts from        *
+*           the average of all models weighted by mu_i|j = Pi_ij mu_i / c_j,    *
+*           with the spread of the means added to its covariance                *
+*                                                                               *
+* ARGUMENT LIST:                                                                *
+*                                                                               *
+* Argument  Type         IO     Description                                     *
+* --------- --------     --     ---------------------------------               *
+* m         KalmanIMM*   IO     Bank object                                     *
+*                                                                               *
+* RETURN VALUE: void                                                            *
+********************************************************************************/
+static void vMix(KalmanIMM *m)
+{
+    float x0[M], x1[M], p00[M], p01[M], p11[M];
+    unsigned int i;
+    unsigned int j;
+
+    for (j = 0; j < M; j++)
+    {
+        float c = 0;
+
+        for (i = 0; i < M; i++)
+        {
+            c += m->Pi[i][j] * m->mu[i];
+        }
+        m->c[j] = c;
+    }
+
+    for (j = 0; j < M; j++)
+    {
+        const float ic = (m->c[j] > 0) ? 1.0f / m->c[j] : 0;
+        float a0 = 0, a1 = 0;
+
+        for (i = 0; i < M; i++)
+        {
+            const float w = m->Pi[i][j] * m->mu[i] * ic;
+
+            a0 += w * m->x0[i];
+            a1 += w * m->x1[i];
+        }
+        x0[j]  = a0;
+        x1[j]  = a1;
+        p00[j] = p01[j] = p11[j] = 0;
+        for (i = 0; i < M; i++)
+        {
+            const float w  = m->Pi[i][j] * m->mu[i] * ic;
+            const float d0 = m->x0[i] - a0;
+            const float d1 = m->x1[i] - a1;
+
+            p00[j] += w * (m->p00[i] + d0 * d0);
+            p01[j] += w * (m->p01[i] + d0 * d1);
+            p11[j] += w * (m->p11[i] + d1 * d1);
+        }
+    }
+
+    for (j = 0; j < M; j++)
+    {
+        m->x0[j]  = x0[j];
+        m->x1[j]  = x1[j];
+        m->p00[j] = p00[j];
+        m->p01[j] = p01[j];
+        m->p11[j] = p11[j];
+    }
+}
+
+/********************************************************************************
+*                                                                               *
+* FUNCTION NAME: vCombine                                                       *
+*                                                                               *
+* PURPOSE: x = sum_j mu_j x_j, P = sum_j mu_j (P_j + (x_j - x)(x_j - x)^T)      *
+*                                                                               *
+* ARGUMENT LIST:                                                                *
+*                                                                               *
+* Argument  Type         IO     Description                                     *
+* --------- --------     --     ---------------------------------               *
+* m         KalmanIMM*   IO     Bank object                                     *
+*                                                                               *
+* RETURN VALUE: void                                                            *
+********************************************************************************/
+static void vCombine(KalmanIMM *m)
+{
+    float a0 = 0, a1 = 0, b00 = 0, b01 = 0, b11 = 0;
+    unsigned int j;
+
+    for (j = 0; j < M; j++)
+    {
+        a0 += m->mu[j] * m->x0[j];
+        a1 += m->mu[j] * m->x1[j];
+    }
+    for (j = 0; j < M; j++)
+    {
+        const float d0 = m->x0[j] - a0;
+        const float d1 = m->x1[j] - a1;
+
+        b00 += m->mu[j] * (m->p00[j] + d0 * d0);
+        b01 += m->mu[j] * (m->p01[j] + d0 * d1);
+        b11 += m->mu[j] * (m->p11[j] + d1 * d1);
+    }
+
+    m->x[0]    = a0;
+    m->x[1]    = a1;
+    m->P[0][0] = b00;
+    m->P[0][1] = b01;
+    m->P[1][0] = b01;
+    m->P[1][1] = b11;
+}
+
+/********************************************************************************
+*                                                                               *
+* FUNCTION NAME: vKalmanIMM_Predict                                             *
+*                                                                               *
+* PURPOSE: Mixing, then the time update of every model; the probabilities       *
+*           become the predicted ones, which stand if no update follows         *
+*                                                                               *
+* ARGUMENT LIST:                                                                *
+*                                                                               *
+* Argument  Type         IO     Description                                     *
+* --------- --------     --     ---------------------------------               *
+* m         KalmanIMM*   IO     Bank object                                     *
+* u         float        I      IMU acceleration data computed                  *
+*                                                                               *
+* RETURN VALUE: void                                                            *
+*                                                                               *
+********************************************************************************/
+void vKalmanIMM_Predict(KalmanIMM *m, float u)
+{
+    const float dt  = m->dt;
+    const float dt2 = 0.5f * dt * dt;
+    unsigned int j;
+
+    vMix(m);
+
+    for (j = 0; j < M; j++)
+    {
+        /* P_p=A*P*A^T + Q, A=[1 dt; 0 1] */
+        const float a = m->p01[j] + dt * m->p11[j];
+
+        m->x0[j]  += dt * m->x1[j] + dt2 * u;
+        m->x1[j]  += dt * u;
+        m->p00[j] += dt * (m->p01[j] + a) + m->q0[j];
+        m->p01[j]  = a;
+        m->p11[j] += m->q1[j];
+        m->mu[j]   = m->c[j];
+    }
+
+    vCombine(m);
+}
+
+/********************************************************************************
+*                                                                               *
+* FUNCTION NAME: vKalmanIMM_Update                                              *
+*                                                                               *
+* PURPOSE: Measurement update of every model with S = P + R, then               *
+*           mu_j = c_j N(e_j; 0, S_j) / sum and the combined estimate           *
+*                                                                               *
+* ARGUMENT LIST:                                                                *
+*                                                                               *
+* Argument  Type         IO     Description                                     *
+* --------- --------     --     ---------------------------------               *
+* m         KalmanIMM*   IO     Bank object                                     *
+* zp        float        I      Measured position                               *
+* zv        float        I      Measured velocity                               *
+*                                                                               *
+* RETURN VALUE: void                                                            *
+*                                                                               *
+********************************************************************************/
+void vKalmanIMM_Update(KalmanIMM *m, float zp, float zv)
+{
+    float lmax = -INFINITY;
+    float sum  = 0;
+    unsigned int j;
+
+    for (j = 0; j < M; j++)
+    {
+        const float s00 = m->p00[j] + m->r0;
+        const float s01 = m->p01[j];
+        const float s11 = m->p11[j] + m->r1;
+        const float det = s00 * s11 - s01 * s01;
+        const float id  = 1.0f / det;
+        const float i00 = s11 * id;
+        const float i01 = -s01 * id;
+        const float i11 = s00 * id;
+        const float e0  = zp - m->x0[j];
+        const float e1  = zv - m->x1[j];
+        /* K=P*S^-1 */
+        const float k00 = m->p00[j] * i00 + m->p01[j] * i01;
+        const float k01 = m->p00[j] * i01 + m->p01[j] * i11;
+        const float k10 = m->p01[j] * i00 + m->p11[j] * i01;
+        const float k11 = m->p01[j] * i01 + m->p11[j] * i11;
+        const float p00 = m->p00[j];
+        const float p01 = m->p01[j];
+        const float p11 = m->p11[j];
+
+        m->x0[j]  += k00 * e0 + k01 * e1;
+        m->x1[j]  += k10 * e0 + k11 * e1;
+        /* P=P - K*P */
+        m->p00[j]  = p00 - (k00 * p00 + k01 * p01);
+        m->p01[j]  = p01 - (k00 * p01 + k01 * p11);
+        m->p11[j]  = p11 - (k10 * p01 + k11 * p11);
+
+        /* log N(e; 0, S) without the constant -log(2 pi) */
+        m->ll[j] = -0.5f * (e0 * (i00 * e0 + i01 * e1) + e1 * (i01 * e0 + i11 * e1) + logf(det));
+        lmax     = (m->ll[j] > lmax) ? m->ll[j] : lmax;
+    }
+
+    for (j = 0; j < M; j++)
+    {
+        m->mu[j] = m->c[j] * expf(m->ll[j] - lmax);
+        sum     += m->mu[j];
+    }
+    for (j = 0; j < M; j++)
+    {
+        m->mu[j] /= sum;
+    }
+
+    vCombine(m);
+}
@@ -0,0 +1,101 @@
+/***********************************************************************************
+* This file is part of The AHRS Project.                                           *
+*                                                                                  *
+* Copyright © 2020 By Nicola di Gruttola Giardino. All rights reserved.            *
+* @mail: nicoladgg@protonmail.com                                                  *
+*                                                                                  *
+* AHRS is free software: you can redistribute it and/or modify                     *
+* it under the terms of the GNU General Public License as published by             *
+* the Free Software Foundation, either version 3 of the License, or                *
+* (at your option) any later version.                                              *
+*                                                                                  *
+* AHRS is distributed in the hope that it will be useful,                          *
+* but WITHOUT ANY WARRANTY; without even the implied warranty of                   *
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the                    *
+* GNU General Public License for more details.                                     *
+*                                                                                  *
+* You should have received a copy of the GNU General Public License                *
+* along with The AHRS Project.  If not, see <https://www.gnu.org/licenses/>.       *
+*                                                                                  *
+* In case of use of this project, I ask you to mention me, to whom it may concern. *
+***********************************************************************************/
+
+/***************************************************************************************************
+*   FILENAME:  KalmanIMM.h                                                                         *
+*                                                                                                  *
+*                                                                                                  *
+*   PURPOSE:   Library that defines the object KalmanIMM, an interacting multiple model bank of    *
+*               KALMAN_IMM_MODELS 2-state constant velocity filters of one axis of IMU.c that      *
+*               differ in Q, stored as structure of arrays and run in one loop                     *
+*                                                                                                  *
+*                                                                                                  *
+*   GLOBAL VARIABLES:                                                                              *
+*                                                                                                  *
+*                                                                                                  *
+*   Variable           Type        Description                                                     *
+*   --------           ----        -------------------                                             *
+*   KALMAN_IMM_MODELS  macro       Number of models, set at compile time                           *
+*   KalmanIMM          KalmanIMM   Bank object                                                     *
+*                                                                                                  *
+*   DEVELOPMENT HISTORY :                                                                          *
+*                                                                                                  *
+*                                                                                                  *
+*   Date          Author            Change Id     Release     Description Of Change                *
+*   ----          ------            -------- -    ------      ----------------------               *
+*   19-10-2026    AHRS Project       1               1         Initial release                     *
+*                                                                                                  *
+***************************************************************************************************/
+
+#ifndef KalmanIMM_h
+#define KalmanIMM_h
+
+/* Include Global Parameters */
+
+#include <stdlib.h>
+
+/* Definition of Macros */
+
+/* e.g. stationary, cruising, manoeuvring; every model costs one more lane of each loop */
+#ifndef KALMAN_IMM_MODELS
+#define KALMAN_IMM_MODELS   3
+#endif
+
+/*
+* KalmanIMM Object:
+*       the models share dt, A=[1 dt; 0 1], B=[dt^2/2; dt], H=I and R
+*       (diagonal r0, r1). Model j has position x0[j], velocity x1[j],
+*       covariance [p00[j] p01[j]; p01[j] p11[j]], diagonal Q q0[j], q1[j]
+*       and probability mu[j]; Pi[i][j] is the probability of switching
+*       from model i to model j in one step, its rows sum to 1. x and P are
+*       the combined estimate of the bank
+*/
+
+typedef struct KalmanIMM
+{
+    float dt;
+    float r0;
+    float r1;
+    float Pi[KALMAN_IMM_MODELS][KALMAN_IMM_MODELS];
+
+    float x0[KALMAN_IMM_MODELS];
+    float x1[KALMAN_IMM_MODELS];
+    float p00[KALMAN_IMM_MODELS];
+    float p01[KALMAN_IMM_MODELS];
+    float p11[KALMAN_IMM_MODELS];
+    float q0[KALMAN_IMM_MODELS];
+    float q1[KALMAN_IMM_MODELS];
+    float mu[KALMAN_IMM_MODELS];
+    float c[KALMAN_IMM_MODELS];     /* predicted model probabilities */
+    float ll[KALMAN_IMM_MODELS];    /* log likelihood of the last update */
+
+    float x[2];
+    float P[2][2];
+}KalmanIMM;
+
+/* Declare Prototypes */
+
+int   iKalmanIMM_Init     (KalmanIMM *, float, float);
+void  vKalmanIMM_Predict  (KalmanIMM *, float);
+void  vKalmanIMM_Update   (KalmanIMM *, float, float);
+
+#endif /* KalmanIMM_h */
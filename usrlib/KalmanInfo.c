@@ -0,0 +1,445 @@
+/***********************************************************************************
+* This file is part of The AHRS Project.                                           *
+*                                                                                  *
+* Copyright © 2020 By Nicola di Gruttola Giardino. All rights reserved.            *
+* @mail: nicoladgg@protonmail.com                                                  *
+*                                                                                  *
+* AHRS is free software: you can redistribute it and/or modify                     *
+* it under the terms of the GNU General Public License as published by             *
+* the Free Software Foundation, either version 3 of the License, or                *
+* (at your option) any later version.                                              *
+*                                                                                  *
+* AHRS is distributed in the hope that it will be useful,                          *
+* but WITHOUT ANY WARRANTY; without even the implied warranty of                   *
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the                    *
+* GNU General Public License for more details.                                     *
+*                                                                                  *
+* You should have received a copy of the GNU General Public License                *
+* along with The AHRS Project.  If not, see <https://www.gnu.org/licenses/>.       *
+*                                                                                  *
+* In case of use of this project, I ask you to mention me, to whom it may concern. *
+***********************************************************************************/
+
+/****************************************************************************************************
+* FILE NAME: KalmanInfo.c                                                                           *
+*                                                                                                   *
+* PURPOSE: Information filter. A measurement z = h*x + v, v ~ N(0, r), of any sensor is             *
+*           Y += h^T*h/r, yv += h^T*z/r: the updates of independent sensors commute, need no        *
+*           factorization and touch only the states they observe. The prediction and the            *
+*           conversion to x and P are the only O(n^3) phases                                        *
+*                                                                                                   *
+* FILE REFERENCES:                                                                                  *
+*                                                                                                   *
+*   Name    I/O     Description                                                                     *
+*   ----    ---     -----------                                                                     *
+*   none                                                                                            *
+*                                                                                                   *
+*                                                                                                   *
+* EXTERNAL VARIABLES:                                                                               *
+*                                                                                                   *
+* Source: <KalmanInfo.h>                                                                            *
+*                                                                                                   *
+* Name          Type          IO Description                                                        *
+* ------------- -------       -- -----------------------------                                      *
+*   f           KalmanInfo       Information filter object                                          *
+*                                                                                                   *
+* STATIC VARIABLES:                                                                                 *
+*                                                                                                   *
+*   Name     Type       I/O      Description                                                        *
+*   ----     ----       ---      -----------                                                        *
+*   none                                                                                            *
+*                                                                                                   *
+* EXTERNAL REFERENCES:                                                                              *
+*                                                                                                   *
+*  Name                       Description                                                           *
+*  -------------              -----------                                                           *
+*  iChol, iTrsm, iSyrk        matrix.c, inversions of Y and P through their factors                 *
+*                                                                                                   *
+* ABNORMAL TERMINATION CONDITIONS, ERROR AND WARNING MESSAGES:                                      *
+*    Y or P not positive definite fails the phase and leaves the filter unchanged                   *
+*                                                                                                   *
+* ASSUMPTIONS, CONSTRAINTS, RESTRICTIONS: the noise of the components of one measurement is         *
+*    independent (R diagonal); correlated components must be whitened by the caller                 *
+*                                                                                                   *
+* NOTES: Y must be positive definite when predicting, i.e. every state observed at least once       *
+*         or a finite prior given by iKalmanInfo_SetState; the rounding of yv = Y*x grows with |x|, *
+*         so states far from the origin (e.g. a position in metres after minutes of travel) are     *
+*         best kept relative to a reference that is moved from time to time                        *
+*                                                                                                   *
+* REQUIREMENTS/FUNCTIONAL SPECIFICATIONS REFERENCES:                                                *
+*                                                                                                   *
+* DEVELOPMENT HISTORY:                                                                              *
+*                                                                                                   *
+*   Date          Author            Change Id     Release     Description Of Change                 *
+*   ----          ------            ---------     ------      ----------------------                *
+*   19-10-2026    AHRS Project       1               1         Initial release                      *
+*                                                                                                   *
+****************************************************************************************************/
+
+/* Include Global Parameters */
+
+#include <math.h>
+#include "KalmanInfo.h"
+
+/* Declare Prototypes */
+
+static int  iFactor  (KalmanInfo *, Matrix *);
+
+
+/********************************************************************************
+*                                                                               *
+* FUNCTION NAME: iKalmanInfo_Init                                               *
+*                                                                               *
+* PURPOSE: Creates the matrices of an n-state information filter and its        *
+*           workspace; Y and yv are zero (no information), A is the identity,   *
+*           B and Q are zero                                                    *
+*           returning -1 if failed, 0 if successfull                            *
+*                                                                               *
+* ARGUMENT LIST:                                                                *
+*                                                                               *
+* Argument  Type         IO     Description                                     *
+* --------- --------     --     ---------------------------------               *
+* f         KalmanInfo*  O      Information filter object                       *
+* n         unsigned int I      Number of states                                *
+*                                                                               *
+* RETURN VALUE: int                                                             *
+*                                                                               *
+********************************************************************************/
+int iKalmanInfo_Init(KalmanInfo *f, unsigned int n)
+{
+    if (f == NULL || n == 0)
+    {
+        return -1;
+    }
+
+    f->n   = n;
+    f->Y   = pxCreate(n, n);
+    f->yv  = pxCreate(n, 1);
+    f->A   = pxIdentity(n);
+    f->B   = pxCreate(n, 1);
+    f->Q   = pxCreate(n, n);
+    f->x   = pxCreate(n, 1);
+    f->P   = pxCreate(n, n);
+
+    f->I   = pxIdentity(n);
+    f->L   = pxCreate(n, n);
+    f->G   = pxCreate(n, n);
+    f->W   = pxCreate(n, n);
+    f->Wn1 = pxCreate(n, 1);
+    f->nz  = (unsigned int *)malloc(n * sizeof(unsigned int));
+
+    return (f->nz == NULL) ? -1 : 0;
+}
+
+/********************************************************************************
+*                                                                               *
+* FUNCTION NAME: vKalmanInfo_Destroy                                            *
+*                                                                               *
+* PURPOSE: Destroys all the matrices created by iKalmanInfo_Init                *
+*                                                                               *
+* ARGUMENT LIST:                                                                *
+*                                                                               *
+* Argument  Type         IO     Description                                     *
+* --------- --------     --     ---------------------------------               *
+* f         KalmanInfo*  IO     Information filter object                       *
+*                                                                               *
+* RETURN VALUE: void                                                            *
+*                                                                               *
+********************************************************************************/
+void vKalmanInfo_Destroy(KalmanInfo *f)
+{
+    if (f == NULL)
+    {
+        return;
+    }
+
+    vDestroy(f->Y);
+    vDestroy(f->yv);
+    vDestroy(f->A);
+    vDestroy(f->B);
+    vDestroy(f->Q);
+    vDestroy(f->x);
+    vDestroy(f->P);
+    vDestroy(f->I);
+    vDestroy(f->L);
+    vDestroy(f->G);
+    vDestroy(f->W);
+    vDestroy(f->Wn1);
+    free(f->nz);
+    f->nz = NULL;
+}
+
+/********************************************************************************
+*                                                                               *
+* FUNCTION NAME: iFactor                                                        *
+*                                                                               *
+* PURPOSE: L = chol(M) and G = L^-1, so that M^-1 = G^T*G                       *
+*           returning -1 if M is not positive definite, 0 if successfull        *
+*                                                                               *
+* ARGUMENT LIST:                                                                *
+*                                                                               *
+* Argument  Type         IO     Description                                     *
+* --------- --------     --     ---------------------------------               *
+* f         KalmanInfo*  IO     Information filter object, L and G written      *
+* M         Matrix*      I      Symmetric matrix, n x n                         *
+*                                                                               *
+* RETURN VALUE: int                                                             *
+********************************************************************************/
+static int iFactor(KalmanInfo *f, Matrix *M)
+{
+    size_t i;
+
+    if (iChol(f->L, M) != 0)
+    {
+        return -1;
+    }
+    for (i = 0; i < f->n; i++)
+    {
+        if (!(f->L->matrix[i][i] > 0) || !isfinite(f->L->matrix[i][i]))
+        {
+            return -1;
+        }
+    }
+    iCopy(f->G, f->I);
+
+    return iTrsm(f->G, f->L, f->G, TRI_LOWER, TRI_NOTRANS);
+}
+
+/********************************************************************************
+*                                                                               *
+* FUNCTION NAME: iKalmanInfo_SetState                                           *
+*                                                                               *
+* PURPOSE: Prior from the state form, Y = P^-1, yv = Y*x                        *
+*           returning -1 if P is not positive definite, 0 if successfull        *
+*                                                                               *
+* ARGUMENT LIST:                                                                *
+*                                                                               *
+* Argument  Type         IO     Description                                     *
+* --------- --------     --     ---------------------------------               *
+* f         KalmanInfo*  IO     Information filter object                       *
+* x         Matrix*      I      State, n x 1                                    *
+* P         Matrix*      I      Covariance, n x n                               *
+*                                                                               *
+* RETURN VALUE: int                                                             *
+*                                                                               *
+********************************************************************************/
+int iKalmanInfo_SetState(KalmanInfo *f, Matrix *x, Matrix *P)
+{
+    if (f == NULL || x == NULL || P == NULL || iFactor(f, P) != 0)
+    {
+        return -1;
+    }
+
+    iSyrk(f->Y, f->G, 1.0f, 0.0f, TRI_TRANS);
+    iMultiply(f->yv, f->Y, x);
+    iCopy(f->x, x);
+    iCopy(f->P, P);
+
+    return 0;
+}
+
+/********************************************************************************
+*                                                                               *
+* FUNCTION NAME: iKalmanInfo_Predict                                            *
+*                                                                               *
+* PURPOSE: Time update through the state form: x = Y^-1*yv, P = Y^-1,           *
+*           x=A*x + B*u, P=A*P*A^T + Q, then Y = P^-1 and yv = Y*x; every       *
+*           product of a factor is a triangular solve or a rank-k update, so    *
+*           Y stays exactly symmetric                                           *
+*           returning -1 if Y or P is not positive definite, 0 if successfull   *
+*                                                                               *
+* ARGUMENT LIST:                                                                *
+*                                                                               *
+* Argument  Type         IO     Description                                     *
+* --------- --------     --     ---------------------------------               *
+* f         KalmanInfo*  IO     Information filter object                       *
+* u         float        I      Control input                                   *
+*                                                                               *
+* RETURN VALUE: int                                                             *
+*                                                                               *
+********************************************************************************/
+int iKalmanInfo_Predict(KalmanInfo *f, float u)
+{
+    size_t i;
+
+    if (f == NULL || iFactor(f, f->Y) != 0)
+    {
+        return -1;
+    }
+
+    /* x = L^-T L^-1 yv */
+    iTrsm(f->Wn1, f->L, f->yv, TRI_LOWER, TRI_NOTRANS);
+    iTrsm(f->Wn1, f->L, f->Wn1, TRI_LOWER, TRI_TRANS);
+    iMultiply(f->x, f->A, f->Wn1);
+    for (i = 0; i < f->n; i++)
+    {
+        f->x->matrix[i][0] += f->B->matrix[i][0] * u;
+    }
+
+    /* A*P*A^T = (A*G^T)(A*G^T)^T */
+    iTranspose(f->W, f->G);
+    iMultiply(f->L, f->A, f->W);
+    iCopy(f->P, f->Q);
+    iSyrk(f->P, f->L, 1.0f, 1.0f, TRI_NOTRANS);
+
+    if (iFactor(f, f->P) != 0)
+    {
+        return -1;
+    }
+    iSyrk(f->Y, f->G, 1.0f, 0.0f, TRI_TRANS);
+    iMultiply(f->yv, f->Y, f->x);
+
+    return 0;
+}
+
+/********************************************************************************
+*                                                                               *
+* FUNCTION NAME: vKalmanInfo_UpdateScalar                                       *
+*                                                                               *
+* PURPOSE: One scalar measurement z = h*x + v, var(v) = r:                      *
+*           Y += h^T*h/r, yv += h^T*z/r over the nonzero entries of h only,     *
+*           O(1) for a sensor that measures one state, O(n^2) at most           *
+*                                                                               *
+* ARGUMENT LIST:                                                                *
+*                                                                               *
+* Argument  Type         IO     Description                                     *
+* --------- --------     --     ---------------------------------               *
+* f         KalmanInfo*  IO     Information filter object                       *
+* h         const float* I      Measurement row, n values                       *
+* z         float        I      Measurement                                     *
+* r         float        I      Its variance, > 0                               *
+*                                                                               *
+* RETURN VALUE: void                                                            *
+*                                                                               *
+********************************************************************************/
+void vKalmanInfo_UpdateScalar(KalmanInfo *f, const float *h, float z, float r)
+{
+    const float ir = 1.0f / r;
+    unsigned int nnz = 0;
+    unsigned int a;
+    unsigned int b;
+
+    for (a = 0; a < f->n; a++)
+    {
+        if (h[a] != 0)
+        {
+            f->nz[nnz++] = a;
+        }
+    }
+
+    for (a = 0; a < nnz; a++)
+    {
+        const unsigned int i  = f->nz[a];
+        const float        hi = h[i] * ir;
+
+        f->yv->matrix[i][0] += hi * z;
+        for (b = 0; b < nnz; b++)
+        {
+            f->Y->matrix[i][f->nz[b]] += hi * h[f->nz[b]];
+        }
+    }
+}
+
+/********************************************************************************
+*                                                                               *
+* FUNCTION NAME: iKalmanInfo_Update                                             *
+*                                                                               *
+* PURPOSE: Measurement z = H*x + v of one sensor, one scalar update per         *
+*           component; in any order with the updates of the other sensors       *
+*           returning -1 if R is not diagonal and positive, 0 if successfull    *
+*                                                                               *
+* ARGUMENT LIST:                                                                *
+*                                                                               *
+* Argument  Type         IO     Description                                     *
+* --------- --------     --     ---------------------------------               *
+* f         KalmanInfo*  IO     Information filter object                       *
+* z         Matrix*      I      Measurement, m x 1                              *
+* H         Matrix*      I      Observation matrix, m x n                       *
+* R         Matrix*      I      Measurement covariance, diagonal m x m          *
+*                                                                               *
+* RETURN VALUE: int                                                             *
+*                                                                               *
+********************************************************************************/
+int iKalmanInfo_Update(KalmanInfo *f, Matrix *z, Matrix *H, Matrix *R)
+{
+    size_t i;
+    size_t j;
+
+    if (f == NULL || z == NULL || H == NULL || R == NULL ||
+        H->c != f->n || H->r != z->r || R->r != z->r || R->c != z->r)
+    {
+        return -1;
+    }
+    for (i = 0; i < R->r; i++)
+    {
+        if (!(R->matrix[i][i] > 0))
+        {
+            return -1;
+        }
+        for (j = 0; j < R->c; j++)
+        {
+            if (i != j && R->matrix[i][j] != 0)
+            {
+                return -1;
+            }
+        }
+    }
+
+    for (i = 0; i < z->r; i++)
+    {
+        vKalmanInfo_UpdateScalar(f, H->matrix[i], z->matrix[i][0], R->matrix[i][i]);
+    }
+
+    return 0;
+}
+
+/********************************************************************************
+*                                                                               *
+* FUNCTION NAME: iKalmanInfo_State                                              *
+*                                                                               *
+* PURPOSE: Conversion to the state form when an estimate is published,          *
+*           x = Y^-1*yv and, if cov, P = Y^-1                                   *
+*           returning -1 if Y is not positive definite, 0 if successfull        *
+*                                                                               *
+* ARGUMENT LIST:                                                                *
+*                                                                               *
+* Argument  Type         IO     Description                                     *
+* --------- --------     --     ---------------------------------               *
+* f         KalmanInfo*  IO     Information filter object, x and P written      *
+* cov       int          I      1 to compute P too, 0 for x only                *
+*                                                                               *
+* RETURN VALUE: int                                                             *
+*                                                                               *
+********************************************************************************/
+int iKalmanInfo_State(KalmanInfo *f, int cov)
+{
+    if (f == NULL || iChol(f->L, f->Y) != 0)
+    {
+        return -1;
+    }
+    if (cov)
+    {
+        if (iFactor(f, f->Y) != 0)
+        {
+            return -1;
+        }
+        iSyrk(f->P, f->G, 1.0f, 0.0f, TRI_TRANS);
+    }
+    else
+    {
+        size_t i;
+
+        for (i = 0; i < f->n; i++)
+        {
+            if (!(f->L->matrix[i][i] > 0) || !isfinite(f->L->matrix[i][i]))
+            {
+                return -1;
+            }
+        }
+    }
+
+    iTrsm(f->x, f->L, f->yv, TRI_LOWER, TRI_NOTRANS);
+    iTrsm(f->x, f->L, f->x, TRI_LOWER, TRI_TRANS);
+
+    return 0;
+}
@@ -0,0 +1,93 @@
+/***********************************************************************************
+* This file is part of The AHRS Project.                                           *
+*                                                                                  *
+* Copyright © 2020 By Nicola di Gruttola Giardino. All rights reserved.            *
+* @mail: nicoladgg@protonmail.com                                                  *
+*                                                                                  *
+* AHRS is free software: you can redistribute it and/or modify                     *
+* it under the terms of the GNU General Public License as published by             *
+* the Free Software Foundation, either version 3 of the License, or                *
+* (at your option) any later version.                                              *
+*                                                                                  *
+* AHRS is distributed in the hope that it will be useful,                          *
+* but WITHOUT ANY WARRANTY; without even the implied warranty of                   *
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the                    *
+* GNU General Public License for more details.                                     *
+*                                                                                  *
+* You should have received a copy of the GNU General Public License                *
+* along with The AHRS Project.  If not, see <https://www.gnu.org/licenses/>.       *
+*                                                                                  *
+* In case of use of this project, I ask you to mention me, to whom it may concern. *
+***********************************************************************************/
+
+/***************************************************************************************************
+*   FILENAME:  KalmanInfo.h                                                                        *
+*                                                                                                  *
+*                                                                                                  *
+*   PURPOSE:   Library that defines the object KalmanInfo, the information form of the linear      *
+*               Kalman filter, Y = P^-1 and yv = P^-1*x, in which every independent measurement    *
+*               is an addition                                                                     *
+*                                                                                                  *
+*                                                                                                  *
+*   GLOBAL VARIABLES:                                                                              *
+*                                                                                                  *
+*                                                                                                  *
+*   Variable        Type        Description                                                        *
+*   --------        ----        -------------------                                                *
+*   KalmanInfo      KalmanInfo  Information filter object, model, matrices and workspace           *
+*                                                                                                  *
+*   DEVELOPMENT HISTORY :                                                                          *
+*                                                                                                  *
+*                                                                                                  *
+*   Date          Author            Change Id     Release     Description Of Change                *
+*   ----          ------            -------- -    ------      ----------------------               *
+*   19-10-2026    AHRS Project       1               1         Initial release                     *
+*                                                                                                  *
+***************************************************************************************************/
+
+#ifndef KalmanInfo_h
+#define KalmanInfo_h
+
+/* Include Global Parameters */
+
+#include "matrix.h"
+
+/*
+* KalmanInfo Object:
+*       Y the information matrix and yv the information vector; A, B and Q
+*       the model x=A*x + B*u + w, w ~ N(0, Q), filled in by the caller as
+*       for kalman. x and P are the state form, valid after
+*       iKalmanInfo_State
+*/
+
+typedef struct KalmanInfo
+{
+    unsigned int n;
+    Matrix* Y;               /* information matrix, n x n */
+    Matrix* yv;              /* information vector, n x 1 */
+    Matrix* A;               /* state transition, n x n */
+    Matrix* B;               /* control, n x 1 */
+    Matrix* Q;               /* process noise, n x n */
+    Matrix* x;               /* state, n x 1 */
+    Matrix* P;               /* covariance, n x n */
+
+    /* workspace, allocated once by iKalmanInfo_Init, no phase touches the heap */
+    Matrix* I;               /* identity, n x n */
+    Matrix* L;               /* Cholesky factor, n x n */
+    Matrix* G;               /* its inverse, n x n */
+    Matrix* W;               /* scratch, n x n */
+    Matrix* Wn1;             /* scratch, n x 1 */
+    unsigned int* nz;        /* indices of the nonzero entries of h, n */
+}KalmanInfo;
+
+/* Declare Prototypes */
+
+int   iKalmanInfo_Init          (KalmanInfo *, unsigned int);
+void  vKalmanInfo_Destroy       (KalmanInfo *);
+int   iKalmanInfo_SetState      (KalmanInfo *, Matrix *, Matrix *);
+int   iKalmanInfo_Predict       (KalmanInfo *, float);
+void  vKalmanInfo_UpdateScalar  (KalmanInfo *, const float *, float, float);
+int   iKalmanInfo_Update        (KalmanInfo *, Matrix *, Matrix *, Matrix *);
+int   iKalmanInfo_State         (KalmanInfo *, int);
+
+#endif /* KalmanInfo_h */
@@ -0,0 +1,445 @@
+/***********************************************************************************
+* This file is part of The AHRS Project.                                           *
+*                                                                                  *
+* Copyright © 2020 By Nicola di Gruttola Giardino. All rights reserved.            *
+* @mail: nicoladgg@protonmail.com                                                  *
+*                                                                                  *
+* AHRS is free software: you can redistribute it and/or modify                     *
+* it under the terms of the GNU General Public License as published by             *
+* the Free Software Foundation, either version 3 of the License, or                *
+* (at your option) any later version.                                              *
+*                                                                                  *
+* AHRS is distributed in the hope that it will be useful,                          *
+* but WITHOUT ANY WARRANTY; without even the implied warranty of                   *
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the                    *
+* GNU General Public License for more details.                                     *
+*                                                                                  *
+* You should have received a copy of the GNU General Public License                *
+* along with The AHRS Project.  If not, see <https://www.gnu.org/licenses/>.       *
+*                                                                                  *
+* In case of use of this project, I ask you to mention me, to whom it may concern. *
+***********************************************************************************/
+
+/****************************************************************************************************
+* FILE NAME: KalmanSmoother.c                                                                       *
+*                                                                                                   *
+* PURPOSE: Streaming fixed-lag Rauch-Tung-Striebel smoother. Every epoch of the filter is kept in a *
+*           ring of lag + 1 slots; when the ring is full, the backward RTS pass from the newest     *
+*           epoch gives the smoothed estimate of the oldest one, which then leaves the ring, so a   *
+*           log of any length is smoothed in one pass in memory of fixed size                       *
+*                                                                                                   *
+* FILE REFERENCES:                                                                                  *
+*                                                                                                   *
+*   Name    I/O     Description                                                                     *
+*   ----    ---     -----------                                                                     *
+*   none                                                                                            *
+*                                                                                                   *
+*                                                                                                   *
+* EXTERNAL VARIABLES:                                                                               *
+*                                                                                                   *
+* Source: <KalmanSmoother.h>                                                                        *
+*                                                                                                   *
+* Name          Type           IO Description                                                       *
+* ------------- -------        -- -----------------------------                                     *
+*   s           KalmanSmoother    Smoother object                                                   *
+*                                                                                                   *
+* STATIC VARIABLES:                                                                                 *
+*                                                                                                   *
+*   Name     Type       I/O      Description                                                        *
+*   ----     ----       ---      -----------                                                        *
+*   none                                                                                            *
+*                                                                                                   *
+* EXTERNAL REFERENCES:                                                                              *
+*                                                                                                   *
+*  Name                       Description                                                           *
+*  -------------              -----------                                                           *
+*  vKalman_Predict            Kalman.c, time update                                                 *
+*  iChol, iTrsm               matrix.c, solve of the smoother gain                                  *
+*                                                                                                   *
+* ABNORMAL TERMINATION CONDITIONS, ERROR AND WARNING MESSAGES:                                      *
+*    a predicted covariance that is not positive definite fails iKalmanSmoother_Predict             *
+*                                                                                                   *
+* ASSUMPTIONS, CONSTRAINTS, RESTRICTIONS: one epoch is iKalmanSmoother_Predict, any number of       *
+*    measurement updates on s->k and iKalmanSmoother_Push; the filter must run with the full        *
+*    covariance, the steady-state mode does not propagate P                                         *
+*                                                                                                   *
+* NOTES: the gain C_j = Pf_j A^T Pp_j+1^-1 only depends on epochs j and j + 1, it is solved         *
+*         once when j + 1 is predicted; the backward pass of each push is then lag products         *
+*         of n x n matrices, with no solve                                                          *
+*                                                                                                   *
+* REQUIREMENTS/FUNCTIONAL SPECIFICATIONS REFERENCES:                                                *
+*                                                                                                   *
+* DEVELOPMENT HISTORY:                                                                              *
+*                                                                                                   *
+*   Date          Author            Change Id     Release     Description Of Change                 *
+*   ----          ------            ---------     ------      ----------------------                *
+*   19-10-2026    AHRS Project       1               1         Initial release                      *
+*                                                                                                   *
+****************************************************************************************************/
+
+/* Include Global Parameters */
+
+#include "KalmanSmoother.h"
+
+/* Declare Prototypes */
+
+static void  vLoad      (Matrix *, const float *);
+static void  vStore     (float *, Matrix *);
+static void  vBackward  (KalmanSmoother *);
+
+
+/********************************************************************************
+*                                                                               *
+* FUNCTION NAME: iKalmanSmoother_Init                                           *
+*                                                                               *
+* PURPOSE: Allocates a window of lag + 1 epochs of filter k in one block and    *
+*           the workspace of the backward pass                                  *
+*           returning -1 if failed, 0 if successfull                            *
+*                                                                               *
+* ARGUMENT LIST:                                                                *
+*                                                                               *
+* Argument  Type         IO     Description                                     *
+* --------- --------     --     ---------------------------------               *
+* s         KalmanSm*    O      Smoother object                                 *
+* k         kalman*      I      Filter, created by iKalman_Init                 *
+* lag       unsigned int I      Epochs between the filtered and the smoothed    *
+*                                                                               *
+* RETURN VALUE: int                                                             *
+*                                                                               *
+********************************************************************************/
+int iKalmanSmoother_Init(KalmanSmoother *s, kalman *k, unsigned int lag)
+{
+    unsigned int n;
+    unsigned int cap;
+    float       *block;
+
+    if (s == NULL || k == NULL || lag == 0)
+    {
+        return -1;
+    }
+
+    n     = k->x->r;
+    cap   = lag + 1;
+    block = (float *)malloc((size_t)cap * (1 + 2 * n + 3 * n * n) * sizeof(float));
+    if (block == NULL)
+    {
+        return -1;
+    }
+
+    s->k     = k;
+    s->n     = n;
+    s->cap   = cap;
+    s->head  = 0;
+    s->count = 0;
+    s->open  = 0;
+    s->t     = block;
+    s->xp    = block + cap;
+    s->xf    = block + (1 + n) * cap;
+    s->Pp    = block + (1 + 2 * n) * cap;
+    s->Pf    = block + (1 + 2 * n + n * n) * cap;
+    s->Ct    = block + (1 + 2 * n + 2 * n * n) * cap;
+
+    s->t_s   = 0;
+    s->xs    = pxCreate(n, 1);
+    s->Ps    = pxCreate(n, n);
+    s->Xw    = pxCreate(n, 1);
+    s->Dx    = pxCreate(n, 1);
+    s->Pw    = pxCreate(n, n);
+    s->Dp    = pxCreate(n, n);
+    s->C     = pxCreate(n, n);
+    s->Tw    = pxCreate(n, n);
+    s->Lp    = pxCreate(n, n);
+
+    return 0;
+}
+
+/********************************************************************************
+*                                                                               *
+* FUNCTION NAME: vKalmanSmoother_Destroy                                        *
+*                                                                               *
+* PURPOSE: Frees the window and the workspace, the filter is not touched        *
+*                                                                               *
+* ARGUMENT LIST:                                                                *
+*                                                                               *
+* Argument  Type         IO     Description                                     *
+* --------- --------     --     ---------------------------------               *
+* s         KalmanSm*    IO     Smoother object                                 *
+*                                                                               *
+* RETURN VALUE: void                                                            *
+*                                                                               *
+********************************************************************************/
+void vKalmanSmoother_Destroy(KalmanSmoother *s)
+{
+    if (s == NULL)
+    {
+        return;
+    }
+
+    free(s->t);
+    s->t     = NULL;
+    s->count = 0;
+
+    vDestroy(s->xs);
+    vDestroy(s->Ps);
+    vDestroy(s->Xw);
+    vDestroy(s->Dx);
+    vDestroy(s->Pw);
+    vDestroy(s->Dp);
+    vDestroy(s->C);
+    vDestroy(s->Tw);
+    vDestroy(s->Lp);
+}
+
+/********************************************************************************
+*                                                                               *
+* FUNCTION NAME: vLoad                                                          *
+*                                                                               *
+* PURPOSE: Copies r x c packed values into a matrix of the workspace            *
+*                                                                               *
+* ARGUMENT LIST:                                                                *
+*                                                                               *
+* Argument  Type         IO     Description                                     *
+* --------- --------     --     ---------------------------------               *
+* m         Matrix*      O      Destination                                     *
+* v         const float* I      Row major values                                *
+*                                                                               *
+* RETURN VALUE: void                                                            *
+********************************************************************************/
+static void vLoad(Matrix *m, const float *v)
+{
+    size_t i;
+    size_t j;
+
+    for (i = 0; i < m->r; i++)
+    {
+        for (j = 0; j < m->c; j++)
+        {
+            m->matrix[i][j] = *v++;
+        }
+    }
+}
+
+/********************************************************************************
+*                                                                               *
+* FUNCTION NAME: vStore                                                         *
+*                                                                               *
+* PURPOSE: Packs a matrix into r x c values of the window                       *
+*                                                                               *
+* ARGUMENT LIST:                                                                *
+*                                                                               *
+* Argument  Type         IO     Description                                     *
+* --------- --------     --     ---------------------------------               *
+* v         float*       O      Row major values                                *
+* m         Matrix*      I      Source                                          *
+*                                                                               *
+* RETURN VALUE: void                                                            *
+********************************************************************************/
+static void vStore(float *v, Matrix *m)
+{
+    size_t i;
+    size_t j;
+
+    for (i = 0; i < m->r; i++)
+    {
+        for (j = 0; j < m->c; j++)
+        {
+            *v++ = m->matrix[i][j];
+        }
+    }
+}
+
+/********************************************************************************
+*                                                                               *
+* FUNCTION NAME: iKalmanSmoother_Predict                                        *
+*                                                                               *
+* PURPOSE: vKalman_Predict, then opens the next epoch with the prediction and   *
+*           solves the smoother gain of the previous one,                       *
+*           Pp_j+1 C_j^T = A Pf_j                                               *
+*           returning -1 if Pp is not positive definite, the epoch is then not  *
+*           opened and iKalmanSmoother_Push refuses it, 0 if successfull        *
+*                                                                               *
+* ARGUMENT LIST:                                                                *
+*                                                                               *
+* Argument  Type         IO     Description                                     *
+* --------- --------     --     ---------------------------------               *
+* s         KalmanSm*    IO     Smoother object                                 *
+* dt        float        I      Time since the previous epoch                   *
+* u         float        I      IMU acceleration data computed                  *
+*                                                                               *
+* RETURN VALUE: int                                                             *
+*                                                                               *
+********************************************************************************/
+int iKalmanSmoother_Predict(KalmanSmoother *s, float dt, float u)
+{
+    const unsigned int n  = s->n;
+    const unsigned int nn = n * n;
+    unsigned int       p;
+    size_t             i;
+
+    if (s->open)
+    {
+        return -1;
+    }
+
+    vKalman_Predict(s->k, dt, u);
+
+    /* Ct first: the epoch is opened only once it can be smoothed */
+    if (s->count != 0)
+    {
+        p = (s->head + s->cap - 1) % s->cap;
+        vLoad(s->Pw, s->Pf + (size_t)p * nn);
+        iMultiply(s->Tw, s->k->A, s->Pw);
+        if (iChol(s->Lp, s->k->P) != 0)
+        {
+            return -1;
+        }
+        for (i = 0; i < n; i++)
+        {
+            if (!(s->Lp->matrix[i][i] > 0) || !isfinite(s->Lp->matrix[i][i]))
+            {
+                return -1;
+            }
+        }
+        iTrsm(s->Tw, s->Lp, s->Tw, TRI_LOWER, TRI_NOTRANS);
+        iTrsm(s->Tw, s->Lp, s->Tw, TRI_LOWER, TRI_TRANS);
+        vStore(s->Ct + (size_t)p * nn, s->Tw);
+    }
+
+    vStore(s->xp + (size_t)s->head * n,  s->k->x);
+    vStore(s->Pp + (size_t)s->head * nn, s->k->P);
+    s->open = 1;
+
+    return 0;
+}
+
+/********************************************************************************
+*                                                                               *
+* FUNCTION NAME: vBackward                                                      *
+*                                                                               *
+* PURPOSE: RTS pass from the newest epoch back to the oldest of the window,     *
+*           xs_j = xf_j + C_j (xs_j+1 - xp_j+1)                                 *
+*           Ps_j = Pf_j + C_j (Ps_j+1 - Pp_j+1) C_j^T                           *
+*           leaving the estimate of the oldest epoch in t_s, xs, Ps             *
+*                                                                               *
+* ARGUMENT LIST:                                                                *
+*                                                                               *
+* Argument  Type         IO     Description                                     *
+* --------- --------     --     ---------------------------------               *
+* s         KalmanSm*    IO     Smoother object, count > 0                      *
+*                                                                               *
+* RETURN VALUE: void                                                            *
+********************************************************************************/
+static void vBackward(KalmanSmoother *s)
+{
+    const unsigned int n  = s->n;
+    const unsigned int nn = n * n;
+    const unsigned int o  = (s->head + s->cap - s->count) % s->cap;
+    unsigned int       j;
+    unsigned int       q;
+
+    j = (s->head + s->cap - 1) % s->cap;
+    vLoad(s->xs, s->xf + (size_t)j * n);
+    vLoad(s->Ps, s->Pf + (size_t)j * nn);
+
+    while (j != o)
+    {
+        q = j;
+        j = (j + s->cap - 1) % s->cap;
+
+        vLoad(s->Pw, s->Ct + (size_t)j * nn);
+        iTranspose(s->C, s->Pw);
+
+        vLoad(s->Xw, s->xp + (size_t)q * n);
+        iSubtract(s->Dx, s->xs, s->Xw);
+        iMultiply(s->Xw, s->C, s->Dx);
+        vLoad(s->xs, s->xf + (size_t)j * n);
+        iSum(s->xs, s->xs, s->Xw);
+
+        vLoad(s->Dp, s->Pp + (size_t)q * nn);
+        iSubtract(s->Dp, s->Ps, s->Dp);
+        iMultiply(s->Tw, s->C, s->Dp);
+        iMultiply(s->Dp, s->Tw, s->Pw);
+        vLoad(s->Ps, s->Pf + (size_t)j * nn);
+        iSum(s->Ps, s->Ps, s->Dp);
+    }
+
+    s->t_s = s->t[o];
+}
+
+/********************************************************************************
+*                                                                               *
+* FUNCTION NAME: iKalmanSmoother_Push                                           *
+*                                                                               *
+* PURPOSE: Closes the epoch of time t with the filtered x and P of s->k; once   *
+*           lag + 1 epochs are in the window the oldest is smoothed into        *
+*           t_s, xs, Ps and leaves it                                           *
+*           returning 1 if xs is new, 0 if not yet, -1 if not predicted         *
+*                                                                               *
+* ARGUMENT LIST:                                                                *
+*                                                                               *
+* Argument  Type         IO     Description                                     *
+* --------- --------     --     ---------------------------------               *
+* s         KalmanSm*    IO     Smoother object                                 *
+* t         float        I      Time of the epoch                               *
+*                                                                               *
+* RETURN VALUE: int                                                             *
+*                                                                               *
+********************************************************************************/
+int iKalmanSmoother_Push(KalmanSmoother *s, float t)
+{
+    /* the first epoch is the initial state, it has no prediction */
+    if (!s->open && s->count != 0)
+    {
+        return -1;
+    }
+
+    s->t[s->head] = t;
+    vStore(s->xf + (size_t)s->head * s->n,          s->k->x);
+    vStore(s->Pf + (size_t)s->head * s->n * s->n,   s->k->P);
+    s->head = (s->head + 1) % s->cap;
+    s->count++;
+    s->open = 0;
+
+    if (s->count < s->cap)
+    {
+        return 0;
+    }
+
+    vBackward(s);
+    s->count--;
+
+    return 1;
+}
+
+/********************************************************************************
+*                                                                               *
+* FUNCTION NAME: iKalmanSmoother_Flush                                          *
+*                                                                               *
+* PURPOSE: At the end of the stream, smooths the oldest epoch left in the       *
+*           window into t_s, xs, Ps with the epochs after it; to be called      *
+*           until it returns 0                                                  *
+*           returning 1 if xs is new, 0 if the window is empty                  *
+*                                                                               *
+* ARGUMENT LIST:                                                                *
+*                                                                               *
+* Argument  Type         IO     Description                                     *
+* --------- --------     --     ---------------------------------               *
+* s         KalmanSm*    IO     Smoother object                                 *
+*                                                                               *
+* RETURN VALUE: int                                                             *
+*                                                                               *
+********************************************************************************/
+int iKalmanSmoother_Flush(KalmanSmoother *s)
+{
+    if (s->count == 0)
+    {
+        return 0;
+    }
+
+    /* an epoch predicted and never pushed has no filtered state */
+    s->open = 0;
+    vBackward(s);
+    s->count--;
+
+    return 1;
+}
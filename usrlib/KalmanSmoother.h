@@ -0,0 +1,100 @@
+/***********************************************************************************
+* This file is part of The AHRS Project.                                           *
+*                                                                                  *
+* Copyright © 2020 By Nicola di Gruttola Giardino. All rights reserved.            *
+* @mail: nicoladgg@protonmail.com                                                  *
+*                                                                                  *
+* AHRS is free software: you can redistribute it and/or modify                     *
+* it under the terms of the GNU General Public License as published by             *
+* the Free Software Foundation, either version 3 of the License, or                *
+* (at your option) any later version.                                              *
+*                                                                                  *
+* AHRS is distributed in the hope that it will be useful,                          *
+* but WITHOUT ANY WARRANTY; without even the implied warranty of                   *
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the                    *
+* GNU General Public License for more details.                                     *
+*                                                                                  *
+* You should have received a copy of the GNU General Public License                *
+* along with The AHRS Project.  If not, see <https://www.gnu.org/licenses/>.       *
+*                                                                                  *
+* In case of use of this project, I ask you to mention me, to whom it may concern. *
+***********************************************************************************/
+
+/***************************************************************************************************
+*   FILENAME:  KalmanSmoother.h                                                                    *
+*                                                                                                  *
+*                                                                                                  *
+*   PURPOSE:   Library that defines the object KalmanSmoother, a fixed-lag Rauch-Tung-Striebel     *
+*               smoother that runs on the stream of a Kalman filter in a window of bounded size    *
+*                                                                                                  *
+*                                                                                                  *
+*   GLOBAL VARIABLES:                                                                              *
+*                                                                                                  *
+*                                                                                                  *
+*   Variable        Type           Description                                                     *
+*   --------        ----           -------------------                                             *
+*   KalmanSmoother  KalmanSmoother Window of the last lag + 1 epochs of one filter                 *
+*                                                                                                  *
+*   DEVELOPMENT HISTORY :                                                                          *
+*                                                                                                  *
+*                                                                                                  *
+*   Date          Author            Change Id     Release     Description Of Change                *
+*   ----          ------            -------- -    ------      ----------------------               *
+*   19-10-2026    AHRS Project       1               1         Initial release                     *
+*                                                                                                  *
+***************************************************************************************************/
+
+#ifndef KalmanSmoother_h
+#define KalmanSmoother_h
+
+/* Include Global Parameters */
+
+#include "Kalman.h"
+
+/*
+* KalmanSmoother Object:
+*       a ring of cap = lag + 1 epochs of filter k, oldest at (head - count)
+*       mod cap. Each epoch keeps its time t, the predicted xp, Pp, the
+*       filtered xf, Pf and the transpose of the smoother gain Ct, which is
+*       known as soon as the next epoch is predicted. t_s, xs and Ps are
+*       the smoothed estimate of the last epoch that left the window
+*/
+
+typedef struct KalmanSmoother
+{
+    kalman*      k;
+    unsigned int n;
+    unsigned int cap;
+    unsigned int head;       /* epoch being filtered */
+    unsigned int count;      /* closed epochs in the window */
+    int          open;       /* head was predicted and not pushed yet */
+    float*       t;
+    float*       xp;         /* cap x n */
+    float*       Pp;         /* cap x n x n */
+    float*       xf;
+    float*       Pf;
+    float*       Ct;
+
+    float        t_s;
+    Matrix*      xs;
+    Matrix*      Ps;
+
+    /* workspace */
+    Matrix*      Xw;
+    Matrix*      Dx;
+    Matrix*      Pw;
+    Matrix*      Dp;
+    Matrix*      C;
+    Matrix*      Tw;
+    Matrix*      Lp;
+}KalmanSmoother;
+
+/* Declare Prototypes */
+
+int   iKalmanSmoother_Init     (KalmanSmoother *, kalman *, unsigned int);
+void  vKalmanSmoother_Destroy  (KalmanSmoother *);
+int   iKalmanSmoother_Predict  (KalmanSmoother *, float, float);
+int   iKalmanSmoother_Push     (KalmanSmoother *, float);
+int   iKalmanSmoother_Flush    (KalmanSmoother *);
+
+#endif /* KalmanSmoother_h */
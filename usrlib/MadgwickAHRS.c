@@ -9,6 +9,10 @@
 // 29/09/2011	SOH Madgwick    Initial release
 // 02/10/2011	SOH Madgwick	Optimised for reduced CPU load
 // 19/02/2012	SOH Madgwick	Magnetometer measurement is normalised
+// 19/10/2026	AHRS Project	invSqrt reads the float as 32 bits, also on 64 bit hosts
+// 19/10/2026	AHRS Project	madgwick_t instances, the globals are the default one
+// 19/10/2026	AHRS Project	No volatile globals: the quaternion stays in registers during an update,
+//								other threads read it through a madgwick_snapshot_t
 //
 //=====================================================================================================
 
@@ -17,6 +21,8 @@
 
 #include "MadgwickAHRS.h"
 #include <math.h>
+#include <stdint.h>
+#include <string.h>
 
 //---------------------------------------------------------------------------------------------------
 // Definitions
@@ -25,8 +31,7 @@
 //---------------------------------------------------------------------------------------------------
 // Variable definitions
 
-volatile float beta = betaDef;								// 2 * proportional gain (Kp)
-volatile float q0 = 1.0f, q1 = 0.0f, q2 = 0.0f, q3 = 0.0f;	// quaternion of sensor frame relative to auxiliary frame
+madgwick_t madgwick = {betaDef, 1.0f, 0.0f, 0.0f, 0.0f};		// filter of MadgwickAHRSupdate and MadgwickAHRSupdateIMU
 
 //---------------------------------------------------------------------------------------------------
 // Function declarations
@@ -37,9 +42,33 @@ float invSqrt(float x);
 // Functions
 
 //---------------------------------------------------------------------------------------------------
-// AHRS algorithm update
+// Filter at rest: default gain, identity quaternion
+
+void MadgwickInit(madgwick_t *m) {
+	m->beta = betaDef;
+	m->q0 = 1.0f;
+	m->q1 = 0.0f;
+	m->q2 = 0.0f;
+	m->q3 = 0.0f;
+}
+
+//---------------------------------------------------------------------------------------------------
+// AHRS and IMU algorithm updates of the default filter
 
 void MadgwickAHRSupdate(float gx, float gy, float gz, float ax, float ay, float az, float mx, float my, float mz) {
+	MadgwickUpdate(&madgwick, gx, gy, gz, ax, ay, az, mx, my, mz);
+}
+
+void MadgwickAHRSupdateIMU(float gx, float gy, float gz, float ax, float ay, float az) {
+	MadgwickUpdateIMU(&madgwick, gx, gy, gz, ax, ay, az);
+}
+
+//---------------------------------------------------------------------------------------------------
+// AHRS algorithm update of one filter
+
+void MadgwickUpdate(madgwick_t *m, float gx, float gy, float gz, float ax, float ay, float az, float mx, float my, float mz) {
+	float q0 = m->q0, q1 = m->q1, q2 = m->q2, q3 = m->q3;	// in registers until the end of the update
+	float beta = m->beta;
 	float recipNorm;
 	float s0, s1, s2, s3;
 	float qDot1, qDot2, qDot3, qDot4;
@@ -48,7 +77,7 @@ void MadgwickAHRSupdate(float gx, float gy, float gz, float ax, float ay, float
 
 	// Use IMU algorithm if magnetometer measurement invalid (avoids NaN in magnetometer normalisation)
 	if((mx == 0.0f) && (my == 0.0f) && (mz == 0.0f)) {
-		MadgwickAHRSupdateIMU(gx, gy, gz, ax, ay, az);
+		MadgwickUpdateIMU(m, gx, gy, gz, ax, ay, az);
 		return;
 	}
 
@@ -133,12 +162,18 @@ void MadgwickAHRSupdate(float gx, float gy, float gz, float ax, float ay, float
 	q1 *= recipNorm;
 	q2 *= recipNorm;
 	q3 *= recipNorm;
+	m->q0 = q0;
+	m->q1 = q1;
+	m->q2 = q2;
+	m->q3 = q3;
 }
 
 //---------------------------------------------------------------------------------------------------
-// IMU algorithm update
+// IMU algorithm update of one filter
 
-void MadgwickAHRSupdateIMU(float gx, float gy, float gz, float ax, float ay, float az) {
+void MadgwickUpdateIMU(madgwick_t *m, float gx, float gy, float gz, float ax, float ay, float az) {
+	float q0 = m->q0, q1 = m->q1, q2 = m->q2, q3 = m->q3;	// in registers until the end of the update
+	float beta = m->beta;
 	float recipNorm;
 	float s0, s1, s2, s3;
 	float qDot1, qDot2, qDot3, qDot4;
@@ -204,6 +239,41 @@ void MadgwickAHRSupdateIMU(float gx, float gy, float gz, float ax, float ay, flo
 	q1 *= recipNorm;
 	q2 *= recipNorm;
 	q3 *= recipNorm;
+	m->q0 = q0;
+	m->q1 = q1;
+	m->q2 = q2;
+	m->q3 = q3;
+}
+
+//---------------------------------------------------------------------------------------------------
+// Publication of the quaternion to other threads, one writer: a sequence latch of two copies. The
+// writer updates copy 0 while the count is odd and copy 1 while it is even, a reader takes the copy
+// that is not being written and retries only if the writer ran in the meantime. A reader that
+// preempts the writer never waits for it, as a plain sequence lock would.
+
+void MadgwickPublish(madgwick_snapshot_t *s, const madgwick_t *m) {
+	const float q[4] = {m->q0, m->q1, m->q2, m->q3};
+	uint32_t seq = __atomic_load_n(&s->seq, __ATOMIC_RELAXED);
+
+	for(int copy = 0; copy < 2; copy++) {
+		__atomic_store_n(&s->seq, ++seq, __ATOMIC_RELEASE);	// the other copy is complete
+		__atomic_thread_fence(__ATOMIC_RELEASE);				// before this one changes
+		for(int i = 0; i < 4; i++) {
+			__atomic_store(&s->q[copy][i], &q[i], __ATOMIC_RELAXED);
+		}
+	}
+}
+
+void MadgwickSnapshot(const madgwick_snapshot_t *s, float q[4]) {
+	uint32_t seq;
+
+	do {
+		seq = __atomic_load_n(&s->seq, __ATOMIC_ACQUIRE);
+		for(int i = 0; i < 4; i++) {
+			__atomic_load(&s->q[seq & 1u][i], &q[i], __ATOMIC_RELAXED);
+		}
+		__atomic_thread_fence(__ATOMIC_ACQUIRE);
+	} while(__atomic_load_n(&s->seq, __ATOMIC_RELAXED) != seq);
 }
 
 //---------------------------------------------------------------------------------------------------
@@ -213,9 +283,10 @@ void MadgwickAHRSupdateIMU(float gx, float gy, float gz, float ax, float ay, flo
 float invSqrt(float x) {
 	float halfx = 0.5f * x;
 	float y = x;
-	long i = *(long*)&y;
+	int32_t i;
+	memcpy(&i, &y, sizeof(i));		// long is 64 bits on a host, and the cast breaks strict aliasing
 	i = 0x5f3759df - (i>>1);
-	y = *(float*)&i;
+	memcpy(&y, &i, sizeof(y));
 	y = y * (1.5f - (halfx * y * y));
 	return y;
 }
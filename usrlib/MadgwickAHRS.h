@@ -8,21 +8,44 @@
 // Date			Author          Notes
 // 29/09/2011	SOH Madgwick    Initial release
 // 02/10/2011	SOH Madgwick	Optimised for reduced CPU load
+// 19/10/2026	AHRS Project	madgwick_t instances, the globals are the default one
+// 19/10/2026	AHRS Project	No volatile globals, madgwick_snapshot_t for other threads
 //
 //=====================================================================================================
 #ifndef MadgwickAHRS_h
 #define MadgwickAHRS_h
 
+#include <stdint.h>
+
 //----------------------------------------------------------------------------------------------------
 // Variable declaration
 
-extern volatile float beta;				// algorithm gain
-extern volatile float q0, q1, q2, q3;	// quaternion of sensor frame relative to auxiliary frame
 #define sampleFreq	10.0f //frequency in Hz
+
+// One filter: gain and quaternion, for as many independent filters as needed
+typedef struct madgwick_t {
+	float beta;					// algorithm gain
+	float q0, q1, q2, q3;		// quaternion of sensor frame relative to auxiliary frame
+} madgwick_t;
+
+// Quaternion published by the thread of a filter for the others, see MadgwickPublish.
+// Zero initialised: the zero quaternion until the first publication
+typedef struct madgwick_snapshot_t {
+	uint32_t seq;				// publications, twice
+	float q[2][4];				// two copies, one of them always complete
+} madgwick_snapshot_t;
+
+extern madgwick_t madgwick;		// filter of MadgwickAHRSupdate and MadgwickAHRSupdateIMU
+
 //---------------------------------------------------------------------------------------------------
 // Function declarations
 void MadgwickAHRSupdate(float gx, float gy, float gz, float ax, float ay, float az, float mx, float my, float mz);
 void MadgwickAHRSupdateIMU(float gx, float gy, float gz, float ax, float ay, float az);
+void MadgwickInit(madgwick_t *m);
+void MadgwickUpdate(madgwick_t *m, float gx, float gy, float gz, float ax, float ay, float az, float mx, float my, float mz);
+void MadgwickUpdateIMU(madgwick_t *m, float gx, float gy, float gz, float ax, float ay, float az);
+void MadgwickPublish(madgwick_snapshot_t *s, const madgwick_t *m);
+void MadgwickSnapshot(const madgwick_snapshot_t *s, float q[4]);
 
 #endif
 //=====================================================================================================
@@ -0,0 +1,379 @@
+/***********************************************************************************
+* This file is part of The AHRS Project.                                           *
+*                                                                                  *
+* Copyright © 2020 By Nicola di Gruttola Giardino. All rights reserved.            *
+* @mail: nicoladgg@protonmail.com                                                  *
+*                                                                                  *
+* AHRS is free software: you can redistribute it and/or modify                     *
+* it under the terms of the GNU General Public License as published by             *
+* the Free Software Foundation, either version 3 of the License, or                *
+* (at your option) any later version.                                              *
+*                                                                                  *
+* AHRS is distributed in the hope that it will be useful,                          *
+* but WITHOUT ANY WARRANTY; without even the implied warranty of                   *
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the                    *
+* GNU General Public License for more details.                                     *
+*                                                                                  *
+* You should have received a copy of the GNU General Public License                *
+* along with The AHRS Project.  If not, see <https://www.gnu.org/licenses/>.       *
+*                                                                                  *
+* In case of use of this project, I ask you to mention me, to whom it may concern. *
+***********************************************************************************/
+
+/****************************************************************************************************
+* FILE NAME: Probe.c                                                                                *
+*                                                                                                   *
+* PURPOSE: Statistics of the timing probes of Probe.h. A duration v falls in the bin                *
+*           4*(log2(v) - 1) + the two bits of v after its leading one, exact below 8: recording     *
+*           is a count leading zeros, a shift and four additions, no division and no float          *
+*                                                                                                   *
+* FILE REFERENCES:                                                                                  *
+*                                                                                                   *
+*   Name    I/O     Description                                                                     *
+*   ----    ---     -----------                                                                     *
+*   none                                                                                            *
+*                                                                                                   *
+*                                                                                                   *
+* EXTERNAL VARIABLES:                                                                               *
+*                                                                                                   *
+* Source: <Probe.h>                                                                                 *
+*                                                                                                   *
+* Name          Type          IO Description                                                        *
+* ------------- -------       -- -----------------------------                                      *
+*   s           ProbeStats       Summary of one probe                                               *
+*                                                                                                   *
+* STATIC VARIABLES:                                                                                 *
+*                                                                                                   *
+*   Name         Type          I/O  Description                                                     *
+*   ----         ----          ---  -----------                                                     *
+*   probe_names  const char*[]      Names reported for the probes                                   *
+*   probes       Probe[]            Count, min, max, sum and histogram of each probe                *
+*                                                                                                   *
+* EXTERNAL REFERENCES:                                                                              *
+*                                                                                                   *
+*  Name                       Description                                                           *
+*  -------------              -----------                                                           *
+*  none                                                                                             *
+*                                                                                                   *
+* ABNORMAL TERMINATION CONDITIONS, ERROR AND WARNING MESSAGES:                                      *
+*    none                                                                                           *
+*                                                                                                   *
+* ASSUMPTIONS, CONSTRAINTS, RESTRICTIONS: every probe is recorded by one thread; a print from       *
+*    another thread may see a sample half recorded, which is good enough for telemetry              *
+*                                                                                                   *
+* NOTES: the DWT counter wraps after ~19 s at 216 MHz, a probe must be shorter                      *
+*                                                                                                   *
+* REQUIREMENTS/FUNCTIONAL SPECIFICATIONS REFERENCES:                                                *
+*                                                                                                   *
+* DEVELOPMENT HISTORY:                                                                              *
+*                                                                                                   *
+*   Date          Author            Change Id     Release     Description Of Change                 *
+*   ----          ------            ---------     ------      ----------------------                *
+*   19-10-2026    AHRS Project       1               1         Initial release                      *
+*   19-10-2026    AHRS Project       2               1.1       vProbe_Clock, the clock of every     *
+*                                                               module timed by uProbe_Now          *
+*                                                                                                   *
+****************************************************************************************************/
+
+/* Include Global Parameters */
+
+#include <stdio.h>
+#include <string.h>
+#include "Probe.h"
+
+/* Definition of Macros */
+
+#define PROBE_LINE   160
+
+/*
+* Probe Object:
+*       count, extremes and sum of the durations of one probe and their
+*       histogram, PROBE_BINS bins
+*/
+
+typedef struct Probe
+{
+    uint32_t count;
+    uint32_t min;
+    uint32_t max;
+    uint64_t sum;
+    uint32_t bins[PROBE_BINS];
+}Probe;
+
+/* Declare Prototypes */
+
+static unsigned int  uBin       (uint32_t);
+static uint32_t      uBinTop    (unsigned int);
+
+/* Define Static Variables */
+
+static const char* const probe_names[PROBES] =
+{
+    "MadgwickAHRSupdate",
+    "vCalculateYPR",
+    "vCalculate_velocity",
+    "vPredict",
+    "iInnovation",
+    "vUpdate",
+    "gps_update",
+    "sample"
+};
+
+static Probe probes[PROBES];
+
+
+/********************************************************************************
+*                                                                               *
+* FUNCTION NAME: uBin                                                           *
+*                                                                               *
+* PURPOSE: Histogram bin of a duration, 4 bins per octave                       *
+*                                                                               *
+* ARGUMENT LIST:                                                                *
+*                                                                               *
+* Argument  Type         IO     Description                                     *
+* --------- --------     --     ---------------------------------               *
+* v         uint32_t     I      Duration                                        *
+*                                                                               *
+* RETURN VALUE: unsigned int                                                    *
+********************************************************************************/
+static unsigned int uBin(uint32_t v)
+{
+    unsigned int o;
+
+    if (v < 8)
+    {
+        return v;
+    }
+    o = 31 - (unsigned int)__builtin_clz(v);
+
+    return 4 * (o - 1) + ((v >> (o - 2)) & 3);
+}
+
+/********************************************************************************
+*                                                                               *
+* FUNCTION NAME: uBinTop                                                        *
+*                                                                               *
+* PURPOSE: Largest duration of a histogram bin                                  *
+*                                                                               *
+* ARGUMENT LIST:                                                                *
+*                                                                               *
+* Argument  Type         IO     Description                                     *
+* --------- --------     --     ---------------------------------               *
+* b         unsigned int I      Bin                                             *
+*                                                                               *
+* RETURN VALUE: uint32_t                                                        *
+********************************************************************************/
+static uint32_t uBinTop(unsigned int b)
+{
+    unsigned int o;
+
+    if (b < 8)
+    {
+        return b;
+    }
+    o = b / 4 + 1;
+
+    return (uint32_t)((((uint64_t)(5 + b % 4)) << (o - 2)) - 1);
+}
+
+/********************************************************************************
+*                                                                               *
+* FUNCTION NAME: vProbe_Init                                                    *
+*                                                                               *
+* PURPOSE: Clears every probe and, on the target, starts the DWT cycle counter  *
+*                                                                               *
+* ARGUMENT LIST:                                                                *
+*                                                                               *
+* Argument  Type         IO     Description                                     *
+* --------- --------     --     ---------------------------------               *
+* none                                                                          *
+*                                                                               *
+* RETURN VALUE: void                                                            *
+*                                                                               *
+********************************************************************************/
+void vProbe_Init(void)
+{
+    vProbe_Clock();
+    vProbe_Reset();
+}
+
+/********************************************************************************
+*                                                                               *
+* FUNCTION NAME: vProbe_Clock                                                   *
+*                                                                               *
+* PURPOSE: Starts the clock of uProbe_Now: the DWT cycle counter on the         *
+*           target, nothing to do on the host; for every module that times      *
+*           itself with uProbe_Now                                              *
+*                                                                               *
+* ARGUMENT LIST:                                                                *
+*                                                                               *
+* Argument  Type         IO     Description                                     *
+* --------- --------     --     ---------------------------------               *
+* none                                                                          *
+*                                                                               *
+* RETURN VALUE: void                                                            *
+*                                                                               *
+********************************************************************************/
+void vProbe_Clock(void)
+{
+#if defined(__ARM_ARCH_7EM__)
+    /* DEMCR.TRCENA, unlock, DWT_CTRL.CYCCNTENA */
+    *(volatile uint32_t *)0xE000EDFCUL |= (1UL << 24);
+    *(volatile uint32_t *)0xE0001FB0UL  = 0xC5ACCE55UL;
+    *(volatile uint32_t *)0xE0001000UL |= 1UL;
+#endif
+}
+
+/********************************************************************************
+*                                                                               *
+* FUNCTION NAME: vProbe_Reset                                                   *
+*                                                                               *
+* PURPOSE: Clears every probe, e.g. after a print, to report one period         *
+*                                                                               *
+* ARGUMENT LIST:                                                                *
+*                                                                               *
+* Argument  Type         IO     Description                                     *
+* --------- --------     --     ---------------------------------               *
+* none                                                                          *
+*                                                                               *
+* RETURN VALUE: void                                                            *
+*                                                                               *
+********************************************************************************/
+void vProbe_Reset(void)
+{
+    unsigned int i;
+
+    memset(probes, 0, sizeof(probes));
+    for (i = 0; i < PROBES; i++)
+    {
+        probes[i].min = UINT32_MAX;
+    }
+}
+
+/********************************************************************************
+*                                                                               *
+* FUNCTION NAME: vProbe_Record                                                  *
+*                                                                               *
+* PURPOSE: Adds one duration to a probe, called by PROBE_END                    *
+*                                                                               *
+* ARGUMENT LIST:                                                                *
+*                                                                               *
+* Argument  Type         IO     Description                                     *
+* --------- --------     --     ---------------------------------               *
+* id        unsigned int I      Probe, PROBE_MADGWICK ... PROBE_SAMPLE          *
+* v         uint32_t     I      Duration in PROBE_UNIT                          *
+*                                                                               *
+* RETURN VALUE: void                                                            *
+*                                                                               *
+********************************************************************************/
+void vProbe_Record(unsigned int id, uint32_t v)
+{
+    Probe *p;
+
+    if (id >= PROBES)
+    {
+        return;
+    }
+    p = &probes[id];
+
+    p->count++;
+    p->sum += v;
+    p->min  = (v < p->min) ? v : p->min;
+    p->max  = (v > p->max) ? v : p->max;
+    p->bins[uBin(v)]++;
+}
+
+/********************************************************************************
+*                                                                               *
+* FUNCTION NAME: iProbe_Stats                                                   *
+*                                                                               *
+* PURPOSE: Summary of a probe, min, mean, max and p99, all 0 without samples    *
+*           returning -1 if id is not a probe, 0 if successfull                 *
+*                                                                               *
+* ARGUMENT LIST:                                                                *
+*                                                                               *
+* Argument  Type         IO     Description                                     *
+* --------- --------     --     ---------------------------------               *
+* id        unsigned int I      Probe, PROBE_MADGWICK ... PROBE_SAMPLE          *
+* s         ProbeStats*  O      Summary                                         *
+*                                                                               *
+* RETURN VALUE: int                                                             *
+*                                                                               *
+********************************************************************************/
+int iProbe_Stats(unsigned int id, ProbeStats *s)
+{
+    const Probe *p;
+    uint32_t     need;
+    uint32_t     acc;
+    unsigned int b;
+
+    if (id >= PROBES || s == NULL)
+    {
+        return -1;
+    }
+    p = &probes[id];
+
+    memset(s, 0, sizeof(*s));
+    s->name  = probe_names[id];
+    s->count = p->count;
+    if (p->count == 0)
+    {
+        return 0;
+    }
+    s->min  = p->min;
+    s->max  = p->max;
+    s->mean = (uint32_t)(p->sum / p->count);
+
+    /* smallest bin that holds 99% of the samples, rounded up */
+    need = p->count - p->count / 100;
+    acc  = 0;
+    for (b = 0; b < PROBE_BINS; b++)
+    {
+        acc += p->bins[b];
+        if (acc >= need)
+        {
+            break;
+        }
+    }
+    s->p99 = (uBinTop(b) < p->max) ? uBinTop(b) : p->max;
+
+    return 0;
+}
+
+/********************************************************************************
+*                                                                               *
+* FUNCTION NAME: vProbe_Print                                                   *
+*                                                                               *
+* PURPOSE: Writes every probe that has samples as one JSON object per line,     *
+*           integers only, so no float printf is needed on the target           *
+*                                                                               *
+* ARGUMENT LIST:                                                                *
+*                                                                               *
+* Argument  Type         IO     Description                                     *
+* --------- --------     --     ---------------------------------               *
+* emit      ProbeEmit    I      Line sink, e.g. chprintf on SD3                 *
+*                                                                               *
+* RETURN VALUE: void                                                            *
+*                                                                               *
+********************************************************************************/
+void vProbe_Print(ProbeEmit emit)
+{
+    char         line[PROBE_LINE];
+    ProbeStats   s;
+    unsigned int i;
+
+    for (i = 0; i < PROBES; i++)
+    {
+        iProbe_Stats(i, &s);
+        if (s.count == 0)
+        {
+            continue;
+        }
+        snprintf(line, sizeof(line),
+                 "{\"probe\": \"%s\", \"unit\": \"%s\", \"count\": %lu, \"min\": %lu, "
+                 "\"mean\": %lu, \"max\": %lu, \"p99\": %lu}\n",
+                 s.name, PROBE_UNIT, (unsigned long)s.count, (unsigned long)s.min,
+                 (unsigned long)s.mean, (unsigned long)s.max, (unsigned long)s.p99);
+        emit(line);
+    }
+}
@@ -0,0 +1,133 @@
+/***********************************************************************************
+* This file is part of The AHRS Project.                                           *
+*                                                                                  *
+* Copyright © 2020 By Nicola di Gruttola Giardino. All rights reserved.            *
+* @mail: nicoladgg@protonmail.com                                                  *
+*                                                                                  *
+* AHRS is free software: you can redistribute it and/or modify                     *
+* it under the terms of the GNU General Public License as published by             *
+* the Free Software Foundation, either version 3 of the License, or                *
+* (at your option) any later version.                                              *
+*                                                                                  *
+* AHRS is distributed in the hope that it will be useful,                          *
+* but WITHOUT ANY WARRANTY; without even the implied warranty of                   *
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the                    *
+* GNU General Public License for more details.                                     *
+*                                                                                  *
+* You should have received a copy of the GNU General Public License                *
+* along with The AHRS Project.  If not, see <https://www.gnu.org/licenses/>.       *
+*                                                                                  *
+* In case of use of this project, I ask you to mention me, to whom it may concern. *
+***********************************************************************************/
+
+/***************************************************************************************************
+*   FILENAME:  Probe.h                                                                             *
+*                                                                                                  *
+*                                                                                                  *
+*   PURPOSE:   Named timing probes of the AHRS loop: every probe keeps count, min, max, sum and a   *
+*               log-linear histogram of its durations, from which mean and p99 are read back on    *
+*               the target (vProbe_Print, on SD3) or on the host (iProbe_Stats). Compiled out,     *
+*               unless USE_PROBES is defined, PROBE_BEGIN and PROBE_END are empty                  *
+*                                                                                                  *
+*                                                                                                  *
+*   GLOBAL VARIABLES:                                                                              *
+*                                                                                                  *
+*                                                                                                  *
+*   Variable        Type        Description                                                        *
+*   --------        ----        -------------------                                                *
+*   ProbeStats      ProbeStats  Summary of one probe                                               *
+*   PROBE_UNIT      macro       Unit of the durations, "cycles" (DWT) or "ns" (CLOCK_MONOTONIC)    *
+*                                                                                                  *
+*   DEVELOPMENT HISTORY :                                                                          *
+*                                                                                                  *
+*                                                                                                  *
+*   Date          Author            Change Id     Release     Description Of Change                *
+*   ----          ------            -------- -    ------      ----------------------               *
+*   19-10-2026    AHRS Project       1               1         Initial release                     *
+*   19-10-2026    AHRS Project       2               1.1       vProbe_Clock, the clock of every    *
+*                                                               module timed by uProbe_Now         *
+*                                                                                                  *
+***************************************************************************************************/
+
+#ifndef Probe_h
+#define Probe_h
+
+/* Include Global Parameters */
+
+#include <stdint.h>
+#if !defined(__ARM_ARCH_7EM__)
+#include <time.h>
+#endif
+
+/* Definition of Macros */
+
+/* the probes, in the order vProbe_Print reports them */
+#define PROBE_MADGWICK     0    /* MadgwickAHRSupdate */
+#define PROBE_YPR          1    /* vCalculateYPR */
+#define PROBE_VELOCITY     2    /* vCalculate_velocity, the three axis filters */
+#define PROBE_PREDICT      3    /* vPredict */
+#define PROBE_INNOVATION   4    /* iInnovation */
+#define PROBE_UPDATE       5    /* vUpdate */
+#define PROBE_GPS_UPDATE   6    /* GPS update of the three axes in vCalculate_velocity */
+#define PROBE_SAMPLE       7    /* one IMU sample of the SPI thread, out of the 1 ms budget */
+#define PROBES             8
+
+/* 4 bins per octave of 32 bit durations, a p99 within 25% */
+#define PROBE_BINS         128
+
+#if defined(__ARM_ARCH_7EM__)
+#define PROBE_UNIT         "cycles"
+#else
+#define PROBE_UNIT         "ns"
+#endif
+
+#if defined(USE_PROBES)
+#define PROBE_BEGIN(id)    const uint32_t probe_t0_##id = uProbe_Now()
+#define PROBE_END(id)      vProbe_Record((id), uProbe_Now() - probe_t0_##id)
+#else
+#define PROBE_BEGIN(id)
+#define PROBE_END(id)
+#endif
+
+/*
+* ProbeStats Object:
+*       name of the probe, number of samples and min, mean, max and 99th
+*       percentile of the durations in PROBE_UNIT; the percentile is the upper
+*       edge of its histogram bin, capped at max
+*/
+
+typedef struct ProbeStats
+{
+    const char* name;
+    uint32_t    count;
+    uint32_t    min;
+    uint32_t    mean;
+    uint32_t    max;
+    uint32_t    p99;
+}ProbeStats;
+
+typedef void (*ProbeEmit)(const char *);
+
+/* Declare Prototypes */
+
+void  vProbe_Init    (void);
+void  vProbe_Clock   (void);
+void  vProbe_Reset   (void);
+void  vProbe_Record  (unsigned int, uint32_t);
+int   iProbe_Stats   (unsigned int, ProbeStats *);
+void  vProbe_Print   (ProbeEmit);
+
+/* time stamp of PROBE_BEGIN and PROBE_END, wraps: only differences are used */
+static inline uint32_t uProbe_Now(void)
+{
+#if defined(__ARM_ARCH_7EM__)
+    return *(volatile uint32_t *)0xE0001004UL;          /* DWT_CYCCNT */
+#else
+    struct timespec ts;
+
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint32_t)((uint64_t)ts.tv_sec * 1000000000ULL + (uint64_t)ts.tv_nsec);
+#endif
+}
+
+#endif /* Probe_h */
@@ -0,0 +1,656 @@
+/***********************************************************************************
+* This file is part of The AHRS Project.                                           *
+*                                                                                  *
+* Copyright © 2020 By Nicola di Gruttola Giardino. All rights reserved.            *
+* @mail: nicoladgg@protonmail.com                                                  *
+*                                                                                  *
+* AHRS is free software: you can redistribute it and/or modify                     *
+* it under the terms of the GNU General Public License as published by             *
+* the Free Software Foundation, either version 3 of the License, or                *
+* (at your option) any later version.                                              *
+*                                                                                  *
+* AHRS is distributed in the hope that it will be useful,                          *
+* but WITHOUT ANY WARRANTY; without even the implied warranty of                   *
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the                    *
+* GNU General Public License for more details.                                     *
+*                                                                                  *
+* You should have received a copy of the GNU General Public License                *
+* along with The AHRS Project.  If not, see <https://www.gnu.org/licenses/>.       *
+*                                                                                  *
+* In case of use of this project, I ask you to mention me, to whom it may concern. *
+***********************************************************************************/
+
+/****************************************************************************************************
+* FILE NAME: UKF.c                                                                                  *
+*                                                                                                   *
+* PURPOSE: Unscented Kalman filter with additive noise for nonlinear process and measurement        *
+*           models. The models receive all the 2n+1 sigma points as the columns of one matrix,      *
+*           so a model is a few matrix operations rather than a loop of 2n+1 calls, and the         *
+*           weighted covariances are rank-k updates of the deviation matrices                       *
+*                                                                                                   *
+* FILE REFERENCES:                                                                                  *
+*                                                                                                   *
+*   Name    I/O     Description                                                                     *
+*   ----    ---     -----------                                                                     *
+*   none                                                                                            *
+*                                                                                                   *
+*                                                                                                   *
+* EXTERNAL VARIABLES:                                                                               *
+*                                                                                                   *
+* Source: <UKF.h>                                                                                   *
+*                                                                                                   *
+* Name          Type    IO Description                                                              *
+* ------------- ------- -- -----------------------------                                            *
+*   u           UKF        UKF object                                                               *
+*                                                                                                   *
+* STATIC VARIABLES:                                                                                 *
+*                                                                                                   *
+*   Name     Type       I/O      Description                                                        *
+*   ----     ----       ---      -----------                                                        *
+*   none                                                                                            *
+*                                                                                                   *
+* EXTERNAL REFERENCES:                                                                              *
+*                                                                                                   *
+*  Name                       Description                                                           *
+*  -------------              -----------                                                           *
+*  iChol, iTria, iCholUpdate  matrix.c, factorization and factor updates                            *
+*  iSyrk, iTrsm               matrix.c, covariances and gain                                        *
+*                                                                                                   *
+* ABNORMAL TERMINATION CONDITIONS, ERROR AND WARNING MESSAGES:                                      *
+*    none, compliant with the standard ISO9899:1999                                                 *
+*                                                                                                   *
+* ASSUMPTIONS, CONSTRAINTS, RESTRICTIONS: additive process and measurement noise, Q and R positive  *
+*    definite; in float alpha = 1, beta = 2, kappa = 0 keep every weight positive                   *
+*                                                                                                   *
+* NOTES: the factor S of P is kept between steps. UKF_STANDARD factors P only when it changed       *
+*         since S was computed; UKF_SQRT never factors P: the predicted S is the triangular factor  *
+*         of [sqrt(wi)*(X - x), chol(Q)] (iTria) updated with the central point, and the update     *
+*         downdates S by the m columns of K*chol(Pz)                                                *
+*                                                                                                   *
+* REQUIREMENTS/FUNCTIONAL SPECIFICATIONS REFERENCES:                                                *
+*                                                                                                   *
+* DEVELOPMENT HISTORY:                                                                              *
+*                                                                                                   *
+*   Date          Author            Change Id     Release     Description Of Change                 *
+*   ----          ------            ---------     ------      ----------------------                *
+*   19-10-2026    AHRS Project       1               1         Initial release                      *
+*                                                                                                   *
+****************************************************************************************************/
+
+/* Include Global Parameters */
+
+#include "UKF.h"
+
+/* Declare Prototypes */
+
+static int   iFactor      (Matrix *, Matrix *);
+static int   iSigma       (UKF *);
+static void  vMean        (UKF *, Matrix *, Matrix *);
+static void  vDeviation   (Matrix *, Matrix *, Matrix *);
+static int   iCovariance  (UKF *, Matrix *, Matrix *, Matrix *, Matrix *, Matrix *, Matrix *, Matrix *);
+
+
+/********************************************************************************
+*                                                                               *
+* FUNCTION NAME: iUKF_Init                                                      *
+*                                                                               *
+* PURPOSE: Creates all the matrices of the filter and its workspace and         *
+*           computes the sigma point weights; the models, the state and the     *
+*           noise must be set by the caller                                     *
+*           returning -1 if failed, 0 if successfull                            *
+*                                                                               *
+* ARGUMENT LIST:                                                                *
+*                                                                               *
+* Argument  Type         IO     Description                                     *
+* --------- --------     --     ---------------------------------               *
+* u         UKF*         O      UKF structure                                   *
+* n         unsigned int I      Number of states                                *
+* m         unsigned int I      Number of measurements                          *
+* mode      int          I      UKF_STANDARD or UKF_SQRT                        *
+* alpha     float        I      Spread of the sigma points                      *
+* beta      float        I      Prior knowledge of the distribution, 2 Gaussian *
+* kappa     float        I      Secondary scaling                               *
+*                                                                               *
+* RETURN VALUE: int                                                             *
+*                                                                               *
+********************************************************************************/
+int iUKF_Init(UKF *u, unsigned int n, unsigned int m, int mode, float alpha, float beta, float kappa)
+{
+    float lambda;
+
+    if (u == NULL || n == 0 || m == 0)
+    {
+        return -1;
+    }
+    lambda = alpha * alpha * ((float)n + kappa) - (float)n;
+    if (!((float)n + lambda > 0))
+    {
+        return -1;
+    }
+
+    u->n     = n;
+    u->m     = m;
+    u->np    = 2 * n + 1;
+    u->mode  = mode;
+    u->gamma = sqrtf((float)n + lambda);
+    u->wm0   = lambda / ((float)n + lambda);
+    u->wc0   = u->wm0 + 1 - alpha * alpha + beta;
+    u->wi    = 0.5f / ((float)n + lambda);
+
+    u->iProcess = NULL;
+    u->iMeasure = NULL;
+    u->ctx      = NULL;
+
+    u->x   = pxCreate(n, 1);
+    u->P   = pxIdentity(n);
+    u->S   = pxIdentity(n);
+    u->Q   = pxCreate(n, n);
+    u->R   = pxCreate(m, m);
+    u->Lq  = pxCreate(n, n);
+    u->Lr  = pxCreate(m, m);
+    u->y   = pxCreate(m, 1);
+    u->K   = pxCreate(n, m);
+
+    u->X   = pxCreate(n, u->np);
+    u->Xf  = pxCreate(n, u->np);
+    u->Z   = pxCreate(m, u->np);
+    u->Dx  = pxCreate(n, u->np);
+    u->Dz  = pxCreate(m, u->np);
+    u->DzT = pxCreate(u->np, m);
+    u->zp  = pxCreate(m, 1);
+    u->Pz  = pxCreate(m, m);
+    u->Lz  = pxCreate(m, m);
+    u->Pxz = pxCreate(n, m);
+    u->Wmn = pxCreate(m, n);
+    u->Wnm = pxCreate(n, m);
+    u->Cx  = pxCreate(n, u->np - 1 + n);
+    u->Cz  = pxCreate(m, u->np - 1 + m);
+    u->Wn1 = pxCreate(n, 1);
+    u->Wm1 = pxCreate(m, 1);
+    u->Wnn = pxCreate(n, n);
+
+    u->fresh = 1;
+
+    return 0;
+}
+
+/********************************************************************************
+*                                                                               *
+* FUNCTION NAME: vUKF_Destroy                                                   *
+*                                                                               *
+* PURPOSE: Destroys all the matrices created by iUKF_Init                       *
+*                                                                               *
+* ARGUMENT LIST:                                                                *
+*                                                                               *
+* Argument  Type         IO     Description                                     *
+* --------- --------     --     ---------------------------------               *
+* u         UKF*         IO     UKF structure                                   *
+*                                                                               *
+* RETURN VALUE: void                                                            *
+*                                                                               *
+********************************************************************************/
+void vUKF_Destroy(UKF *u)
+{
+    if (u == NULL)
+    {
+        return;
+    }
+
+    vDestroy(u->x);
+    vDestroy(u->P);
+    vDestroy(u->S);
+    vDestroy(u->Q);
+    vDestroy(u->R);
+    vDestroy(u->Lq);
+    vDestroy(u->Lr);
+    vDestroy(u->y);
+    vDestroy(u->K);
+
+    vDestroy(u->X);
+    vDestroy(u->Xf);
+    vDestroy(u->Z);
+    vDestroy(u->Dx);
+    vDestroy(u->Dz);
+    vDestroy(u->DzT);
+    vDestroy(u->zp);
+    vDestroy(u->Pz);
+    vDestroy(u->Lz);
+    vDestroy(u->Pxz);
+    vDestroy(u->Wmn);
+    vDestroy(u->Wnm);
+    vDestroy(u->Cx);
+    vDestroy(u->Cz);
+    vDestroy(u->Wn1);
+    vDestroy(u->Wm1);
+    vDestroy(u->Wnn);
+}
+
+/********************************************************************************
+*                                                                               *
+* FUNCTION NAME: iFactor                                                        *
+*                                                                               *
+* PURPOSE: L = chol(M), failing if M is not positive definite, which iChol      *
+*           does not detect                                                     *
+*           returning -1 if failed, 0 if successfull                            *
+*                                                                               *
+* ARGUMENT LIST:                                                                *
+*                                                                               *
+* Argument  Type         IO     Description                                     *
+* --------- --------     --     ---------------------------------               *
+* L         Matrix*      O      Lower triangular factor                         *
+* M         Matrix*      I      Symmetric matrix                                *
+*                                                                               *
+* RETURN VALUE: int                                                             *
+********************************************************************************/
+static int iFactor(Matrix *L, Matrix *M)
+{
+    unsigned int i;
+
+    if (iChol(L, M) != 0)
+    {
+        return -1;
+    }
+    for (i = 0; i < L->r; i++)
+    {
+        if (!(L->matrix[i][i] > 0) || !isfinite(L->matrix[i][i]))
+        {
+            return -1;
+        }
+    }
+
+    return 0;
+}
+
+/********************************************************************************
+*                                                                               *
+* FUNCTION NAME: iUKF_SetState                                                  *
+*                                                                               *
+* PURPOSE: Sets the state and its covariance, factoring it into S               *
+*           returning -1 if failed, 0 if successfull                            *
+*                                                                               *
+* ARGUMENT LIST:                                                                *
+*                                                                               *
+* Argument  Type         IO     Description                                     *
+* --------- --------     --     ---------------------------------               *
+* u         UKF*         IO     UKF structure                                   *
+* x         Matrix*      I      State, n x 1, NULL to keep it                   *
+* P         Matrix*      I      Covariance, n x n, NULL to keep it              *
+*                                                                               *
+* RETURN VALUE: int                                                             *
+*                                                                               *
+********************************************************************************/
+int iUKF_SetState(UKF *u, Matrix *x, Matrix *P)
+{
+    if (x != NULL && iCopy(u->x, x) != 0)
+    {
+        return -1;
+    }
+    if (P != NULL)
+    {
+        if (iCopy(u->P, P) != 0 || iFactor(u->S, u->P) != 0)
+        {
+            return -1;
+        }
+        u->fresh = 1;
+    }
+
+    return 0;
+}
+
+/********************************************************************************
+*                                                                               *
+* FUNCTION NAME: iUKF_SetNoise                                                  *
+*                                                                               *
+* PURPOSE: Sets the process and measurement noise covariances, and in         *
+*           UKF_SQRT their factors; both are validated before either is         *
+*           copied, a failure leaves the filter as it was. UKF_STANDARD takes   *
+*           any Q and R of the right size, e.g. Q with a zero diagonal entry    *
+*           returning -1 if failed, 0 if successfull                            *
+*                                                                               *
+* ARGUMENT LIST:                                                                *
+*                                                                               *
+* Argument  Type         IO     Description                                     *
+* --------- --------     --     ---------------------------------               *
+* u         UKF*         IO     UKF structure                                   *
+* Q         Matrix*      I      Process noise, n x n, NULL to keep it           *
+* R         Matrix*      I      Measurement noise, m x m, NULL to keep it       *
+*                                                                               *
+* RETURN VALUE: int                                                             *
+*                                                                               *
+********************************************************************************/
+int iUKF_SetNoise(UKF *u, Matrix *Q, Matrix *R)
+{
+    if ((Q != NULL && (Q->r != u->n || Q->c != u->n)) ||
+        (R != NULL && (R->r != u->m || R->c != u->m)))
+    {
+        return -1;
+    }
+
+    if (u->mode == UKF_SQRT)
+    {
+        /* the factors go to scratch first, Lz is rebuilt by every update */
+        iZeroMat(u->Wnn);
+        iZeroMat(u->Lz);
+        if ((Q != NULL && iFactor(u->Wnn, Q) != 0) || (R != NULL && iFactor(u->Lz, R) != 0))
+        {
+            return -1;
+        }
+        if (Q != NULL)
+        {
+            iCopy(u->Lq, u->Wnn);
+        }
+        if (R != NULL)
+        {
+            iCopy(u->Lr, u->Lz);
+        }
+    }
+
+    if (Q != NULL)
+    {
+        iCopy(u->Q, Q);
+    }
+    if (R != NULL)
+    {
+        iCopy(u->R, R);
+    }
+
+    return 0;
+}
+
+/********************************************************************************
+*                                                                               *
+* FUNCTION NAME: iSigma                                                         *
+*                                                                               *
+* PURPOSE: X = [x, x + gamma*S, x - gamma*S], refactoring P first only if it    *
+*           changed since S was computed (UKF_STANDARD)                         *
+*           returning -1 if failed, 0 if successfull                            *
+*                                                                               *
+* ARGUMENT LIST:                                                                *
+*                                                                               *
+* Argument  Type         IO     Description                                     *
+* --------- --------     --     ---------------------------------               *
+* u         UKF*         IO     UKF structure                                   *
+*                                                                               *
+* RETURN VALUE: int                                                             *
+********************************************************************************/
+static int iSigma(UKF *u)
+{
+    unsigned int i;
+    unsigned int j;
+
+    if (u->mode == UKF_STANDARD && !u->fresh)
+    {
+        if (iFactor(u->S, u->P) != 0)
+        {
+            return -1;
+        }
+        u->fresh = 1;
+    }
+
+    for (i = 0; i < u->n; i++)
+    {
+        const float  xi = u->x->matrix[i][0];
+        const float *s  = u->S->matrix[i];
+        float       *X  = u->X->matrix[i];
+
+        X[0] = xi;
+        for (j = 0; j < u->n; j++)
+        {
+            X[1 + j]        = xi + u->gamma * s[j];
+            X[1 + u->n + j] = xi - u->gamma * s[j];
+        }
+    }
+
+    return 0;
+}
+
+/********************************************************************************
+*                                                                               *
+* FUNCTION NAME: vMean                                                          *
+*                                                                               *
+* PURPOSE: Weighted mean of the columns of Y                                    *
+*                                                                               *
+* ARGUMENT LIST:                                                                *
+*                                                                               *
+* Argument  Type         IO     Description                                     *
+* --------- --------     --     ---------------------------------               *
+* u         UKF*         I      UKF structure, weights                          *
+* mean      Matrix*      O      Mean, r x 1                                     *
+* Y         Matrix*      I      Sigma points, r x np                            *
+*                                                                               *
+* RETURN VALUE: void                                                            *
+********************************************************************************/
+static void vMean(UKF *u, Matrix *mean, Matrix *Y)
+{
+    unsigned int i;
+    unsigned int j;
+
+    for (i = 0; i < Y->r; i++)
+    {
+        const float *y = Y->matrix[i];
+        float        s = 0;
+
+        for (j = 1; j < Y->c; j++)
+            s += y[j];
+        mean->matrix[i][0] = u->wm0 * y[0] + u->wi * s;
+    }
+}
+
+/********************************************************************************
+*                                                                               *
+* FUNCTION NAME: vDeviation                                                     *
+*                                                                               *
+* PURPOSE: D = Y - mean, column by column                                       *
+*                                                                               *
+* ARGUMENT LIST:                                                                *
+*                                                                               *
+* Argument  Type         IO     Description                                     *
+* --------- --------     --     ---------------------------------               *
+* D         Matrix*      O      Deviations, r x np                              *
+* Y         Matrix*      I      Sigma points, r x np                            *
+* mean      Matrix*      I      Mean, r x 1                                     *
+*                                                                               *
+* RETURN VALUE: void                                                            *
+********************************************************************************/
+static void vDeviation(Matrix *D, Matrix *Y, Matrix *mean)
+{
+    unsigned int i;
+    unsigned int j;
+
+    for (i = 0; i < Y->r; i++)
+    {
+        for (j = 0; j < Y->c; j++)
+            D->matrix[i][j] = Y->matrix[i][j] - mean->matrix[i][0];
+    }
+}
+
+/********************************************************************************
+*                                                                               *
+* FUNCTION NAME: iCovariance                                                    *
+*                                                                               *
+* PURPOSE: Weighted covariance of the deviations D plus the noise N:            *
+*           UKF_STANDARD  C = wi*D*D^T + (wc0 - wi)*d0*d0^T + N                 *
+*           UKF_SQRT      L = tria([sqrt(wi)*D(:,1:), Ln]), then the rank-1     *
+*                          update (or downdate if wc0 < 0) by d0                *
+*           returning -1 if failed, 0 if successfull                            *
+*                                                                               *
+* ARGUMENT LIST:                                                                *
+*                                                                               *
+* Argument  Type         IO     Description                                     *
+* --------- --------     --     ---------------------------------               *
+* u         UKF*         I      UKF structure, weights and mode                 *
+* C         Matrix*      O      Covariance (UKF_STANDARD)                       *
+* L         Matrix*      O      Its factor (UKF_SQRT)                           *
+* D         Matrix*      I      Deviations, r x np                              *
+* N         Matrix*      I      Noise covariance                                *
+* Ln        Matrix*      I      Its factor                                      *
+* W         Matrix*      -      Compound scratch, r x (np - 1 + r)              *
+* W1        Matrix*      -      Scratch, r x 1                                  *
+*                                                                               *
+* RETURN VALUE: int                                                             *
+********************************************************************************/
+static int iCovariance(UKF *u, Matrix *C, Matrix *L, Matrix *D, Matrix *N, Matrix *Ln,
+                       Matrix *W, Matrix *W1)
+{
+    unsigned int i;
+    unsigned int j;
+    const float  sw = sqrtf(u->wi);
+    const float  dw = u->wc0 - u->wi;
+
+    if (u->mode == UKF_STANDARD)
+    {
+        if (iSyrk(C, D, u->wi, 0.0f, TRI_NOTRANS) != 0)
+        {
+            return -1;
+        }
+        for (i = 0; i < C->r; i++)
+        {
+            for (j = 0; j < C->c; j++)
+                C->matrix[i][j] += dw * D->matrix[i][0] * D->matrix[j][0] + N->matrix[i][j];
+        }
+        return 0;
+    }
+
+    for (i = 0; i < D->r; i++)
+    {
+        for (j = 1; j < D->c; j++)
+            W->matrix[i][j - 1] = sw * D->matrix[i][j];
+        for (j = 0; j < D->r; j++)
+            W->matrix[i][D->c - 1 + j] = Ln->matrix[i][j];
+        W1->matrix[i][0] = D->matrix[i][0];
+    }
+    if (iTria(L, W) != 0)
+    {
+        return -1;
+    }
+
+    return (u->wc0 == 0) ? 0 : iCholUpdate(L, W1, u->wc0);
+}
+
+/********************************************************************************
+*                                                                               *
+* FUNCTION NAME: iUKF_Predict                                                   *
+*                                                                               *
+* PURPOSE: Draws the sigma points, propagates all of them with one iProcess     *
+*           call and recovers the predicted mean and covariance (or factor)     *
+*           returning -1 if failed, 0 if successfull                            *
+*                                                                               *
+* ARGUMENT LIST:                                                                *
+*                                                                               *
+* Argument  Type         IO     Description                                     *
+* --------- --------     --     ---------------------------------               *
+* u         UKF*         IO     UKF structure                                   *
+* dt        float        I      Time step, passed to iProcess                   *
+*                                                                               *
+* RETURN VALUE: int                                                             *
+*                                                                               *
+********************************************************************************/
+int iUKF_Predict(UKF *u, float dt)
+{
+    Matrix *t;
+
+    if (u == NULL || u->iProcess == NULL || iSigma(u) != 0)
+    {
+        return -1;
+    }
+    if (u->iProcess(u, u->Xf, u->X, dt) != 0)
+    {
+        return -1;
+    }
+
+    /* the propagated points become the current ones, no copy */
+    t     = u->X;
+    u->X  = u->Xf;
+    u->Xf = t;
+
+    vMean(u, u->x, u->X);
+    vDeviation(u->Dx, u->X, u->x);
+    u->fresh = 0;
+
+    return iCovariance(u, u->P, u->S, u->Dx, u->Q, u->Lq, u->Cx, u->Wn1);
+}
+
+/********************************************************************************
+*                                                                               *
+* FUNCTION NAME: iUKF_Update                                                    *
+*                                                                               *
+* PURPOSE: Redraws the sigma points around the prediction, maps all of them     *
+*           with one iMeasure call and corrects the state with the gain         *
+*           K = Pxz*Pz^-1, solved with the factor of Pz                         *
+*           returning -1 if failed, 0 if successfull                            *
+*                                                                               *
+* ARGUMENT LIST:                                                                *
+*                                                                               *
+* Argument  Type         IO     Description                                     *
+* --------- --------     --     ---------------------------------               *
+* u         UKF*         IO     UKF structure                                   *
+* z         Matrix*      I      Measurement, m x 1                              *
+*                                                                               *
+* RETURN VALUE: int                                                             *
+*                                                                               *
+********************************************************************************/
+int iUKF_Update(UKF *u, Matrix *z)
+{
+    unsigned int i;
+    unsigned int j;
+    float        dw;
+
+    if (u == NULL || z == NULL || u->iMeasure == NULL || iSigma(u) != 0)
+    {
+        return -1;
+    }
+    if (u->iMeasure(u, u->Z, u->X) != 0)
+    {
+        return -1;
+    }
+
+    vMean(u, u->zp, u->Z);
+    vDeviation(u->Dz, u->Z, u->zp);
+    vDeviation(u->Dx, u->X, u->x);
+
+    /* Lz = chol(Pz) */
+    if (iCovariance(u, u->Pz, u->Lz, u->Dz, u->R, u->Lr, u->Cz, u->Wm1) != 0)
+    {
+        return -1;
+    }
+    if (u->mode == UKF_STANDARD && iFactor(u->Lz, u->Pz) != 0)
+    {
+        return -1;
+    }
+
+    /* Pxz = wi*Dx*Dz^T + (wc0 - wi)*dx0*dz0^T */
+    dw = u->wc0 - u->wi;
+    iTranspose(u->DzT, u->Dz);
+    iMultiply(u->Pxz, u->Dx, u->DzT);
+    for (i = 0; i < u->n; i++)
+    {
+        for (j = 0; j < u->m; j++)
+            u->Pxz->matrix[i][j] = u->wi * u->Pxz->matrix[i][j] + dw * u->Dx->matrix[i][0] * u->Dz->matrix[j][0];
+    }
+
+    /* U = Pxz*Lz^-T, K = U*Lz^-1 */
+    iTranspose(u->Wmn, u->Pxz);
+    if (iTrsm(u->Wmn, u->Lz, u->Wmn, TRI_LOWER, TRI_NOTRANS) != 0)
+    {
+        return -1;
+    }
+    iTranspose(u->Wnm, u->Wmn);
+    iTrsm(u->Wmn, u->Lz, u->Wmn, TRI_LOWER, TRI_TRANS);
+    iTranspose(u->K, u->Wmn);
+
+    iSubtract(u->y, z, u->zp);
+    iMultiply(u->Wn1, u->K, u->y);
+    for (i = 0; i < u->n; i++)
+    {
+        u->x->matrix[i][0] += u->Wn1->matrix[i][0];
+    }
+
+    /* P = P - K*Pz*K^T = P - U*U^T */
+    if (u->mode == UKF_STANDARD)
+    {
+        u->fresh = 0;
+        return iSyrk(u->P, u->Wnm, -1.0f, 1.0f, TRI_NOTRANS);
+    }
+
+    return iCholUpdate(u->S, u->Wnm, -1.0f);
+}
@@ -0,0 +1,126 @@
+/***********************************************************************************
+* This file is part of The AHRS Project.                                           *
+*                                                                                  *
+* Copyright © 2020 By Nicola di Gruttola Giardino. All rights reserved.            *
+* @mail: nicoladgg@protonmail.com                                                  *
+*                                                                                  *
+* AHRS is free software: you can redistribute it and/or modify                     *
+* it under the terms of the GNU General Public License as published by             *
+* the Free Software Foundation, either version 3 of the License, or                *
+* (at your option) any later version.                                              *
+*                                                                                  *
+* AHRS is distributed in the hope that it will be useful,                          *
+* but WITHOUT ANY WARRANTY; without even the implied warranty of                   *
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the                    *
+* GNU General Public License for more details.                                     *
+*                                                                                  *
+* You should have received a copy of the GNU General Public License                *
+* along with The AHRS Project.  If not, see <https://www.gnu.org/licenses/>.       *
+*                                                                                  *
+* In case of use of this project, I ask you to mention me, to whom it may concern. *
+***********************************************************************************/
+
+/***************************************************************************************************
+*   FILENAME:  UKF.h                                                                               *
+*                                                                                                  *
+*                                                                                                  *
+*   PURPOSE:   Library that defines the object UKF, an unscented Kalman filter with additive       *
+*               noise whose process and measurement models transform all the sigma points in      *
+*               one call, with a standard and a square-root variant                                *
+*                                                                                                  *
+*                                                                                                  *
+*   GLOBAL VARIABLES:                                                                              *
+*                                                                                                  *
+*                                                                                                  *
+*   Variable        Type        Description                                                        *
+*   --------        ----        -------------------                                                *
+*   UKF             UKF         UKF object, models, matrices and workspace                         *
+*                                                                                                  *
+*   DEVELOPMENT HISTORY :                                                                          *
+*                                                                                                  *
+*                                                                                                  *
+*   Date          Author            Change Id     Release     Description Of Change                *
+*   ----          ------            -------- -    ------      ----------------------               *
+*   19-10-2026    AHRS Project       1               1         Initial release                     *
+*                                                                                                  *
+***************************************************************************************************/
+
+#ifndef UKF_h
+#define UKF_h
+
+/* Include Global Parameters */
+
+#include "matrix.h"
+
+/* Definition of Macros */
+
+#define UKF_STANDARD    0       /* P is propagated, S = chol(P) only when P changed */
+#define UKF_SQRT        1       /* S is propagated by iTria and iCholUpdate, P is not used */
+
+/*
+* UKF Object:
+*       x the state, P its covariance (UKF_STANDARD only) and S the lower
+*       Cholesky factor of P, Q and R the additive noise covariances and
+*       Lq, Lr their factors, y the innovation and K the gain of the last
+*       update. The sigma points are the 2n+1 columns of X:
+*       X = [x, x + gamma*S, x - gamma*S].
+*       iProcess writes f(X) into Y and iMeasure h(X) into Z, every column
+*       at once (for a linear model one iMultiply), ctx is left to them
+*/
+
+typedef struct UKF
+{
+    unsigned int n;
+    unsigned int m;
+    unsigned int np;         /* 2n+1 sigma points */
+    int          mode;       /* UKF_STANDARD or UKF_SQRT */
+    int          fresh;      /* UKF_STANDARD: S is the factor of the current P */
+    float        gamma;
+    float        wm0;        /* weight of the central point in the means */
+    float        wc0;        /* weight of the central point in the covariances */
+    float        wi;         /* weight of the other points */
+
+    Matrix* x;               /* state, n x 1 */
+    Matrix* P;               /* covariance, n x n */
+    Matrix* S;               /* lower Cholesky factor of P, n x n */
+    Matrix* Q;               /* process noise, n x n */
+    Matrix* R;               /* measurement noise, m x m */
+    Matrix* Lq;              /* chol(Q) */
+    Matrix* Lr;              /* chol(R) */
+    Matrix* y;               /* innovation, m x 1 */
+    Matrix* K;               /* gain, n x m */
+
+    int   (*iProcess)(struct UKF *, Matrix *, Matrix *, float);
+    int   (*iMeasure)(struct UKF *, Matrix *, Matrix *);
+    void*   ctx;
+
+    /* workspace, allocated once by iUKF_Init, no phase touches the heap */
+    Matrix* X;               /* sigma points, n x np */
+    Matrix* Xf;              /* propagated sigma points, n x np */
+    Matrix* Z;               /* measured sigma points, m x np */
+    Matrix* Dx;              /* X - x, n x np */
+    Matrix* Dz;              /* Z - z, m x np */
+    Matrix* DzT;             /* Dz^T, np x m */
+    Matrix* zp;              /* predicted measurement, m x 1 */
+    Matrix* Pz;              /* innovation covariance, m x m */
+    Matrix* Lz;              /* its lower Cholesky factor, m x m */
+    Matrix* Pxz;             /* cross covariance, n x m */
+    Matrix* Wmn;             /* scratch, m x n */
+    Matrix* Wnm;             /* scratch, n x m */
+    Matrix* Cx;              /* compound [sqrt(wi)*Dx, Lq], n x (np - 1 + n) */
+    Matrix* Cz;              /* compound [sqrt(wi)*Dz, Lr], m x (np - 1 + m) */
+    Matrix* Wn1;             /* scratch, n x 1 */
+    Matrix* Wm1;             /* scratch, m x 1 */
+    Matrix* Wnn;             /* scratch, n x n, chol(Q) before it is committed */
+}UKF;
+
+/* Declare Prototypes */
+
+int   iUKF_Init      (UKF *, unsigned int, unsigned int, int, float, float, float);
+void  vUKF_Destroy   (UKF *);
+int   iUKF_SetState  (UKF *, Matrix *, Matrix *);
+int   iUKF_SetNoise  (UKF *, Matrix *, Matrix *);
+int   iUKF_Predict   (UKF *, float);
+int   iUKF_Update    (UKF *, Matrix *);
+
+#endif /* UKF_h */
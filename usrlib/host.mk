@@ -0,0 +1,43 @@
+##############################################################################
+# Host build of the user libraries as the static library libusr.a, for the
+# benchmarks and for any other Linux program that links the algorithms
+# (see bench/Makefile). The firmware build is usr.mk.
+#
+# The includer sets USRLIB (this directory), BUILDDIR, CC and CFLAGS; the
+# objects go to $(BUILDDIR)/usrlib. Objects built with other CFLAGS are not
+# rebuilt, run make clean after changing them (e.g. PROBES=yes).
+#
+
+AR        ?= ar
+
+# Every user library but the firmware-only ones: none needs ChibiOS.
+HOSTSRC   := $(USRLIB)/matrix.c \
+             $(USRLIB)/rng.c \
+             $(USRLIB)/Kalman.c \
+             $(USRLIB)/KalmanGen_CV2.c \
+             $(USRLIB)/KalmanBatch.c \
+             $(USRLIB)/ESKF.c \
+             $(USRLIB)/UKF.c \
+             $(USRLIB)/KalmanHistory.c \
+             $(USRLIB)/KalmanSmoother.c \
+             $(USRLIB)/KalmanIMM.c \
+             $(USRLIB)/KalmanInfo.c \
+             $(USRLIB)/Checkpoint.c \
+             $(USRLIB)/Probe.c \
+             $(USRLIB)/MadgwickAHRS.c \
+             $(USRLIB)/IMU.c \
+             $(USRLIB)/GPS_Lib.c
+
+HOSTOBJ   := $(patsubst $(USRLIB)/%.c,$(BUILDDIR)/usrlib/%.o,$(HOSTSRC))
+HOSTHDR   := $(wildcard $(USRLIB)/*.h)
+USRLIB_A  := $(BUILDDIR)/libusr.a
+
+$(BUILDDIR)/usrlib:
+	mkdir -p $@
+
+$(BUILDDIR)/usrlib/%.o: $(USRLIB)/%.c $(HOSTHDR) | $(BUILDDIR)/usrlib
+	$(CC) $(CFLAGS) -c -o $@ $<
+
+$(USRLIB_A): $(HOSTOBJ)
+	rm -f $@
+	$(AR) rcs $@ $^
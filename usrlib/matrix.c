@@ -48,7 +48,9 @@
 *                                                                                                   *
 *   Name     Type       I/O      Description                                                        *
 *   ----     ----       ---      -----------                                                        *
-*   none                                                                                            *
+*   heap_usage  int              Bytes currently allocated in heap memory                          *
+*   alloc_calls unsigned long    Number of malloc/realloc calls since boot                         *
+*   alloc_bytes unsigned long    Bytes requested to malloc/realloc since boot                      *
 *                                                                                                   *
 * EXTERNAL REFERENCES:                                                                              *
 *                                                                                                   *
@@ -77,17 +79,49 @@
 *                   Giardino &                                  nomenclature                        *
 *                G. Di Cecio                                                                        *
 *                                                                                                   *
+*   19-10-2026    AHRS Project                       3         iInverse pivots on the largest       *
+*                                                              entry, refuses a singular matrix     *
 *                                                                                                   *
 ****************************************************************************************************/
 
 /* Include Global Parameters */
 
-#include "../include/matrix.h"
+#include "matrix.h"
+#include "rng.h"
 
 /* Declare Prototypes */
 
 static float  vec_mult             (float *, float *, unsigned int);
 static int    row_scalar_multiply  (Matrix *, unsigned int , float);
+static void   count_alloc          (size_t);
+
+/* Declare Static Variables */
+
+static int           heap_usage  = 0;
+static unsigned long alloc_calls = 0;
+static unsigned long alloc_bytes = 0;
+
+/********************************************************************************
+*                                                                               *
+* FUNCTION NAME: count_alloc                                                    *
+*                                                                               *
+* PURPOSE: Accounts one heap allocation, declared as static,                    *
+*           to be used in this file only                                        *
+*                                                                               *
+* ARGUMENT LIST:                                                                *
+*                                                                               *
+* Argument  Type         IO     Description                                     *
+* --------- --------     --     ---------------------------------               *
+* bytes     size_t       I      Allocated bytes                                 *
+*                                                                               *
+* RETURN VALUE: void                                                            *
+********************************************************************************/
+static void count_alloc(size_t bytes)
+{
+    heap_usage  += bytes;
+    alloc_bytes += bytes;
+    alloc_calls++;
+}
 
 /********************************************************************************
 *                                                                               *
@@ -111,13 +145,13 @@ Matrix* pxCreate(unsigned int r, unsigned int c)
 	size_t i;
 
     Matrix *m = (Matrix*) malloc(sizeof(Matrix));
-	  heap_usage += sizeof(Matrix);
+	  count_alloc(sizeof(Matrix));
     m->matrix=(float**)malloc(r*sizeof(float*));
-	  heap_usage += r*sizeof(float*);
+	  count_alloc(r*sizeof(float*));
     for (i=0; i < r; i++)
     {
         m->matrix[i] =(float *)malloc(c * sizeof(float));
-        heap_usage += c*sizeof(float);
+        count_alloc(c*sizeof(float));
     }
 
     m->c = c;
@@ -158,12 +192,12 @@ int iResize(Matrix* m, unsigned int r, unsigned int c)
     size_t i;
 
     m->matrix=(float**)realloc(m->matrix, r*sizeof(float*));
-	  heap_usage += r*sizeof(float*);
+	  count_alloc(r*sizeof(float*));
 
     for (i=0; i < r; i++)
     {
         m->matrix[i] =(float *)realloc(m->matrix[i], c * sizeof(float));
-        heap_usage += c*sizeof(float);
+        count_alloc(c*sizeof(float));
     }
     m->c = c;
     m->r = r;
@@ -191,10 +225,10 @@ Vector* pxVectorCreate(unsigned int n)
 {
 
     Vector* v = (Vector*) malloc(sizeof(Vector));
-    heap_usage += sizeof(Vector);
+    count_alloc(sizeof(Vector));
     v->n = n;
     v->vector = (float*) malloc(n*sizeof(float));
-    heap_usage += n*sizeof(float);
+    count_alloc(n*sizeof(float));
 
     return v;
 }
@@ -263,15 +297,17 @@ void vDestroy(Matrix* m)
 *                                                                               *
 * FUNCTION NAME: iInverse                                                       *
 *                                                                               *
-* PURPOSE: Creates the inverse of the matrix given as input,                    *
-*            returning -1 if failed, , 0 if successful	                        *
+* PURPOSE: Creates the inverse of the matrix given as input, by Gauss-Jordan    *
+*            elimination on the columns with partial pivoting; m is reduced to  *
+*            the identity and invert, an identity on entry, becomes the inverse *
+*            returning -1 if failed or m is singular, 0 if successful           *
 *                                                                               *
 * ARGUMENT LIST:                                                                *
 *                                                                               *
 * Argument  Type         IO     Description                                     *
 * --------- --------     --     ---------------------------------               *
-* m1        Matrix*      I      Pointer to the object to invert                 *
-* invert    Matrix*      O      Pointer to the object to invert                 *
+* invert    Matrix*      IO     Identity, the inverse on return                 *
+* m         Matrix*      IO     Pointer to the object to invert, destroyed      *
 *                                                                               *
 * RETURN VALUE: int                                                             *
 ********************************************************************************/
@@ -279,50 +315,46 @@ int iInverse(Matrix *invert, Matrix *m)
 {
     size_t i;
     size_t j;
-    size_t l;
+    size_t p;
 
     float factor;
 
-    if (m == NULL)
+    if (m == NULL || invert == NULL)
     {
-        return NULL;
+        return -1;
     }
-    if ((m)->r != (m)->c)
+    if ((m)->r != (m)->c || invert->r != m->r || invert->c != m->c)
     {
-        return NULL;
+        return -1;
     }
-    /* reduce each of the rows to get a lower triangle */
     for (i = 0; i < (m)->r; i++)
     {
+        /* pivot: the column of the largest entry of row i not yet used */
+        p = i;
         for (j = i + 1; j < (m)->c; j++)
         {
-            if ((m)->matrix[i][i] == 0)
+            if (fabsf((m)->matrix[i][j]) > fabsf((m)->matrix[i][p]))
             {
-                for (l = i + 1; l < m->c; l++)
-                {
-                    if (m->matrix[l][l] != 0)
-                    {
-                        iRowSwap(m, i, l);
-                        break;
-                    }
-                }
-                continue;
+                p = j;
             }
-            factor = (m)->matrix[i][j] / ((m)->matrix[i][i]);
-            iReduce(invert, i, j, factor);
-            iReduce((m), i, j, factor);
         }
-    }
+        if ((m)->matrix[i][p] == 0)
+        {
+            return -1;
+        }
+        if (p != i)
+        {
+            iRowSwap(invert, i, p);
+            iRowSwap((m), i, p);
+        }
 
-    /* now finish the upper triangle  */
-    for (i = (m)->r - 1; i > 0; i--)
-    {
-        for (j = i - 1; j >= 0; j--)
+        /* clear the rest of row i; the rows above keep their zeros */
+        for (j = 0; j < (m)->c; j++)
         {
-            if ((m)->matrix[i][i] == 0)
+            if (j == i)
+            {
                 continue;
-            if (j == -1)
-                break;
+            }
             factor = (m)->matrix[i][j] / ((m)->matrix[i][i]);
             iReduce(invert, i, j, factor);
             iReduce((m), i, j, factor);
@@ -332,8 +364,6 @@ int iInverse(Matrix *invert, Matrix *m)
     /* scale everything to 1 */
     for (i = 0; i < (m)->r; i++)
     {
-        if ((m)->matrix[i][i] == 0)
-            continue;
         factor = 1 / ((m)->matrix[i][i]);
         row_scalar_multiply(invert, i, factor);
         row_scalar_multiply((m), i, factor);
@@ -655,7 +685,8 @@ int iEquals(Matrix* m1, Matrix* m2)
 *                                                                               *
 * FUNCTION NAME: iMultiply                                                      *
 *                                                                               *
-* PURPOSE: Multiplies the 2 matrices                                            *
+* PURPOSE: Multiplies the 2 matrices, overwriting product, which must not be    *
+*            the same object as m1 or m2                                        *
 *            returns -1 if failed, 0 if successfull                             *
 *                                                                               *
 * ARGUMENT LIST:                                                                *
@@ -691,10 +722,12 @@ int iMultiply(Matrix* product,Matrix *m1, Matrix *m2)
     {
         for (j = 0; j < m2->c; ++j)
         {
+            float acc = 0;
             for (k = 0; k < m1->c; ++k)
             {
-                product->matrix[i][j] += m1->matrix[i][k] * m2->matrix[k][j];
+                acc += m1->matrix[i][k] * m2->matrix[k][j];
             }
+            product->matrix[i][j] = acc;
         }
     }
     return 0;
@@ -1375,6 +1408,478 @@ Matrix*  pxChol (Matrix* m)
         return c;
 }
 
+/********************************************************************************
+*                                                                               *
+* FUNCTION NAME: iTrsm                                                          *
+*                                                                               *
+* PURPOSE: Solves op(T)*X = B with T triangular, by forward (lower) or back     *
+*           (upper) substitution column by column, op(T) being T or T^T.        *
+*           X may be the same object as B (in place), T is never written        *
+*           returning -1 if failed, 0 if successfull                            *
+*                                                                               *
+* ARGUMENT LIST:                                                                *
+*                                                                               *
+* Argument  Type         IO     Description                                     *
+* --------- --------     --     ---------------------------------               *
+* X         Matrix*      O      Pointer to the solution object (n x m)          *
+* T         Matrix*      I      Pointer to the triangular object (n x n)        *
+* B         Matrix*      I      Pointer to the right hand side (n x m)          *
+* uplo      int          I      TRI_LOWER or TRI_UPPER, the other triangle of   *
+*                                T is not read                                  *
+* trans     int          I      TRI_NOTRANS or TRI_TRANS                        *
+*                                                                               *
+* RETURN VALUE: int                                                             *
+********************************************************************************/
+int iTrsm(Matrix *X, Matrix *T, Matrix *B, int uplo, int trans)
+{
+    size_t i;
+    size_t j;
+    size_t k;
+    size_t n;
+    int    forward;
+
+    if (X == NULL || T == NULL || B == NULL)
+    {
+        return -1;
+    }
+    if ((T->r != T->c) || (B->r != T->r) || (X->r != B->r) || (X->c != B->c))
+    {
+        return -1;
+    }
+
+    n = T->r;
+    for (i = 0; i < n; i++)
+    {
+        if (T->matrix[i][i] == 0)
+        {
+            return -1;
+        }
+    }
+
+    /* L*x and U^T*x are solved top down, U*x and L^T*x bottom up */
+    forward = ((uplo == TRI_LOWER) == (trans == TRI_NOTRANS));
+
+    for (j = 0; j < B->c; j++)
+    {
+        size_t s;
+        for (s = 0; s < n; s++)
+        {
+            float acc;
+
+            i   = forward ? s : (n - 1 - s);
+            acc = B->matrix[i][j];
+
+            if (forward)
+            {
+                for (k = 0; k < i; k++)
+                {
+                    acc -= ((trans == TRI_NOTRANS) ? T->matrix[i][k] : T->matrix[k][i]) * X->matrix[k][j];
+                }
+            }
+            else
+            {
+                for (k = i + 1; k < n; k++)
+                {
+                    acc -= ((trans == TRI_NOTRANS) ? T->matrix[i][k] : T->matrix[k][i]) * X->matrix[k][j];
+                }
+            }
+            X->matrix[i][j] = acc / T->matrix[i][i];
+        }
+    }
+
+    return 0;
+}
+
+/********************************************************************************
+*                                                                               *
+* FUNCTION NAME: iTrsv                                                          *
+*                                                                               *
+* PURPOSE: Solves op(T)*x = b with T triangular, see iTrsm,                     *
+*           x may be the same object as b (in place)                            *
+*           returning -1 if failed, 0 if successfull                            *
+*                                                                               *
+* ARGUMENT LIST:                                                                *
+*                                                                               *
+* Argument  Type         IO     Description                                     *
+* --------- --------     --     ---------------------------------               *
+* x         Vector*      O      Pointer to the solution object                  *
+* T         Matrix*      I      Pointer to the triangular object                *
+* b         Vector*      I      Pointer to the right hand side                  *
+* uplo      int          I      TRI_LOWER or TRI_UPPER                          *
+* trans     int          I      TRI_NOTRANS or TRI_TRANS                        *
+*                                                                               *
+* RETURN VALUE: int                                                             *
+********************************************************************************/
+int iTrsv(Vector *x, Matrix *T, Vector *b, int uplo, int trans)
+{
+    size_t i;
+    size_t k;
+    size_t s;
+    size_t n;
+    int    forward;
+
+    if (x == NULL || T == NULL || b == NULL)
+    {
+        return -1;
+    }
+    if ((T->r != T->c) || (b->n != T->r) || (x->n != b->n))
+    {
+        return -1;
+    }
+
+    n = T->r;
+    for (i = 0; i < n; i++)
+    {
+        if (T->matrix[i][i] == 0)
+        {
+            return -1;
+        }
+    }
+
+    forward = ((uplo == TRI_LOWER) == (trans == TRI_NOTRANS));
+
+    for (s = 0; s < n; s++)
+    {
+        float acc;
+
+        i   = forward ? s : (n - 1 - s);
+        acc = b->vector[i];
+
+        if (trans == TRI_NOTRANS)
+        {
+            float *row = T->matrix[i];
+            if (forward)
+            {
+                for (k = 0; k < i; k++)
+                    acc -= row[k] * x->vector[k];
+            }
+            else
+            {
+                for (k = i + 1; k < n; k++)
+                    acc -= row[k] * x->vector[k];
+            }
+        }
+        else
+        {
+            if (forward)
+            {
+                for (k = 0; k < i; k++)
+                    acc -= T->matrix[k][i] * x->vector[k];
+            }
+            else
+            {
+                for (k = i + 1; k < n; k++)
+                    acc -= T->matrix[k][i] * x->vector[k];
+            }
+        }
+        x->vector[i] = acc / T->matrix[i][i];
+    }
+
+    return 0;
+}
+
+/********************************************************************************
+*                                                                               *
+* FUNCTION NAME: iSyrk                                                          *
+*                                                                               *
+* PURPOSE: Symmetric rank-k update C = alpha*A*A^T + beta*C (TRI_NOTRANS)       *
+*           or C = alpha*A^T*A + beta*C (TRI_TRANS). Only the lower triangle    *
+*           is computed, then mirrored, so C stays exactly symmetric.           *
+*           C is updated in place and must not be the same object as A          *
+*           returning -1 if failed, 0 if successfull                            *
+*                                                                               *
+* ARGUMENT LIST:                                                                *
+*                                                                               *
+* Argument  Type         IO     Description                                     *
+* --------- --------     --     ---------------------------------               *
+* C         Matrix*      IO     Pointer to the symmetric object (n x n)         *
+* A         Matrix*      I      Pointer to the factor (n x k, or k x n)         *
+* alpha     float        I      Multiplier of the product                       *
+* beta      float        I      Multiplier of C, 0 overwrites C                 *
+* trans     int          I      TRI_NOTRANS or TRI_TRANS                        *
+*                                                                               *
+* RETURN VALUE: int                                                             *
+********************************************************************************/
+int iSyrk(Matrix *C, Matrix *A, float alpha, float beta, int trans)
+{
+    size_t i;
+    size_t j;
+    size_t l;
+    size_t n;
+    size_t kk;
+
+    if (C == NULL || A == NULL || C == A)
+    {
+        return -1;
+    }
+    n  = (trans == TRI_NOTRANS) ? A->r : A->c;
+    kk = (trans == TRI_NOTRANS) ? A->c : A->r;
+    if ((C->r != n) || (C->c != n))
+    {
+        return -1;
+    }
+
+    for (i = 0; i < n; i++)
+    {
+        for (j = 0; j <= i; j++)
+        {
+            float acc = 0;
+
+            if (trans == TRI_NOTRANS)
+            {
+                float *ai = A->matrix[i];
+                float *aj = A->matrix[j];
+                for (l = 0; l < kk; l++)
+                    acc += ai[l] * aj[l];
+            }
+            else
+            {
+                for (l = 0; l < kk; l++)
+                    acc += A->matrix[l][i] * A->matrix[l][j];
+            }
+            C->matrix[i][j] = alpha * acc + ((beta == 0) ? 0 : beta * C->matrix[i][j]);
+            C->matrix[j][i] = C->matrix[i][j];
+        }
+    }
+
+    return 0;
+}
+
+/********************************************************************************
+*                                                                               *
+* FUNCTION NAME: iSyr2k                                                         *
+*                                                                               *
+* PURPOSE: Symmetric rank-2k update C = alpha*(A*B^T + B*A^T) + beta*C          *
+*           (TRI_NOTRANS) or C = alpha*(A^T*B + B^T*A) + beta*C (TRI_TRANS).    *
+*           Only the lower triangle is computed, then mirrored.                 *
+*           C is updated in place and must not be the same object as A or B     *
+*           returning -1 if failed, 0 if successfull                            *
+*                                                                               *
+* ARGUMENT LIST:                                                                *
+*                                                                               *
+* Argument  Type         IO     Description                                     *
+* --------- --------     --     ---------------------------------               *
+* C         Matrix*      IO     Pointer to the symmetric object (n x n)         *
+* A         Matrix*      I      Pointer to the 1st factor (n x k, or k x n)     *
+* B         Matrix*      I      Pointer to the 2nd factor, same size as A       *
+* alpha     float        I      Multiplier of the products                      *
+* beta      float        I      Multiplier of C, 0 overwrites C                 *
+* trans     int          I      TRI_NOTRANS or TRI_TRANS                        *
+*                                                                               *
+* RETURN VALUE: int                                                             *
+********************************************************************************/
+int iSyr2k(Matrix *C, Matrix *A, Matrix *B, float alpha, float beta, int trans)
+{
+    size_t i;
+    size_t j;
+    size_t l;
+    size_t n;
+    size_t kk;
+
+    if (C == NULL || A == NULL || B == NULL || C == A || C == B)
+    {
+        return -1;
+    }
+    if ((A->r != B->r) || (A->c != B->c))
+    {
+        return -1;
+    }
+    n  = (trans == TRI_NOTRANS) ? A->r : A->c;
+    kk = (trans == TRI_NOTRANS) ? A->c : A->r;
+    if ((C->r != n) || (C->c != n))
+    {
+        return -1;
+    }
+
+    for (i = 0; i < n; i++)
+    {
+        for (j = 0; j <= i; j++)
+        {
+            float acc = 0;
+
+            if (trans == TRI_NOTRANS)
+            {
+                for (l = 0; l < kk; l++)
+                    acc += A->matrix[i][l] * B->matrix[j][l] + B->matrix[i][l] * A->matrix[j][l];
+            }
+            else
+            {
+                for (l = 0; l < kk; l++)
+                    acc += A->matrix[l][i] * B->matrix[l][j] + B->matrix[l][i] * A->matrix[l][j];
+            }
+            C->matrix[i][j] = alpha * acc + ((beta == 0) ? 0 : beta * C->matrix[i][j]);
+            C->matrix[j][i] = C->matrix[i][j];
+        }
+    }
+
+    return 0;
+}
+
+/********************************************************************************
+*                                                                               *
+* FUNCTION NAME: iTria                                                          *
+*                                                                               *
+* PURPOSE: Triangularization, the lower triangular L with a positive diagonal   *
+*           such that L*L^T = A*A^T, by Householder reflections applied from    *
+*           the right (A = L*Q). This is the QR step of square-root filters:    *
+*           A is a compound [sqrt(W)*D, sqrt(Q)] and P = A*A^T is never formed. *
+*           A is overwritten, L must not be the same object                     *
+*           returning -1 if failed, 0 if successfull                            *
+*                                                                               *
+* ARGUMENT LIST:                                                                *
+*                                                                               *
+* Argument  Type         IO     Description                                     *
+* --------- --------     --     ---------------------------------               *
+* L         Matrix*      O      Pointer to the triangular object (n x n)        *
+* A         Matrix*      IO     Pointer to the factor (n x k, k >= n), scratch  *
+*                                                                               *
+* RETURN VALUE: int                                                             *
+********************************************************************************/
+int iTria(Matrix *L, Matrix *A)
+{
+    size_t i;
+    size_t j;
+    size_t r;
+    size_t n;
+    size_t kk;
+
+    if (L == NULL || A == NULL || L == A)
+    {
+        return -1;
+    }
+    n  = A->r;
+    kk = A->c;
+    if ((L->r != n) || (L->c != n) || (kk < n))
+    {
+        return -1;
+    }
+
+    for (i = 0; i < n; i++)
+    {
+        float *v = A->matrix[i];
+        float  norm = 0;
+        float  alpha;
+        float  vv;
+
+        for (j = i; j < kk; j++)
+            norm += v[j] * v[j];
+        norm = sqrtf(norm);
+        if (norm == 0)
+        {
+            continue;
+        }
+
+        /* v = row i - alpha*e_i, the reflector maps row i onto alpha*e_i */
+        alpha = (v[i] > 0) ? -norm : norm;
+        vv    = 2.0f * (norm * norm - alpha * v[i]);
+        v[i] -= alpha;
+
+        for (r = i + 1; r < n; r++)
+        {
+            float *a = A->matrix[r];
+            float  w = 0;
+
+            for (j = i; j < kk; j++)
+                w += a[j] * v[j];
+            w = 2.0f * w / vv;
+            for (j = i; j < kk; j++)
+                a[j] -= w * v[j];
+        }
+        v[i] = alpha;
+    }
+
+    /* the sign of each column is free, make the diagonal positive */
+    for (j = 0; j < n; j++)
+    {
+        float sign = (A->matrix[j][j] < 0) ? -1.0f : 1.0f;
+
+        for (r = 0; r < j; r++)
+            L->matrix[r][j] = 0;
+        for (r = j; r < n; r++)
+            L->matrix[r][j] = sign * A->matrix[r][j];
+    }
+
+    return 0;
+}
+
+/********************************************************************************
+*                                                                               *
+* FUNCTION NAME: iCholUpdate                                                    *
+*                                                                               *
+* PURPOSE: Rank-k update of a lower Cholesky factor in place,                   *
+*           L*L^T <- L*L^T + alpha*X*X^T, one rank-1 update (alpha > 0) or      *
+*           downdate (alpha < 0) per column of X, O(n^2) each instead of the    *
+*           O(n^3) refactorization. X is overwritten. A downdate that would     *
+*           make the matrix not positive definite fails, leaving L partially    *
+*           updated                                                             *
+*           returning -1 if failed, 0 if successfull                            *
+*                                                                               *
+* ARGUMENT LIST:                                                                *
+*                                                                               *
+* Argument  Type         IO     Description                                     *
+* --------- --------     --     ---------------------------------               *
+* L         Matrix*      IO     Pointer to the lower triangular object (n x n)  *
+* X         Matrix*      IO     Pointer to the columns to add (n x k), scratch  *
+* alpha     float        I      Weight of the columns, its sign selects update  *
+*                                or downdate                                    *
+*                                                                               *
+* RETURN VALUE: int                                                             *
+********************************************************************************/
+int iCholUpdate(Matrix *L, Matrix *X, float alpha)
+{
+    size_t i;
+    size_t j;
+    size_t k;
+    size_t n;
+    float  sign;
+    float  scale;
+
+    if (L == NULL || X == NULL || L == X)
+    {
+        return -1;
+    }
+    n = L->r;
+    if ((L->c != n) || (X->r != n))
+    {
+        return -1;
+    }
+
+    sign  = (alpha < 0) ? -1.0f : 1.0f;
+    scale = sqrtf(fabsf(alpha));
+
+    for (j = 0; j < X->c; j++)
+    {
+        for (i = 0; i < n; i++)
+            X->matrix[i][j] *= scale;
+
+        for (k = 0; k < n; k++)
+        {
+            float lkk = L->matrix[k][k];
+            float xk  = X->matrix[k][j];
+            float r2  = lkk * lkk + sign * xk * xk;
+            float r;
+            float c;
+            float s;
+
+            if (!(r2 > 0) || lkk == 0)
+            {
+                return -1;
+            }
+            r = sqrtf(r2);
+            c = r / lkk;
+            s = xk / lkk;
+            L->matrix[k][k] = r;
+            for (i = k + 1; i < n; i++)
+            {
+                L->matrix[i][k]  = (L->matrix[i][k] + sign * s * X->matrix[i][j]) / c;
+                X->matrix[i][j]  = c * X->matrix[i][j] - s * L->matrix[i][k];
+            }
+        }
+    }
+
+    return 0;
+}
+
 /********************************************************************************
 *                                                                               *
 * FUNCTION NAME: iSqrtm                                                         *
@@ -1768,7 +2273,7 @@ float* pxCsvToFloat(const char* path, int* dim)
     }
 	 *dim = n+1;
     val = malloc(*dim*sizeof(*dim));
-    heap_usage += *dim*sizeof(*dim);
+    count_alloc(*dim*sizeof(*dim));
     while (fscanf(myFile, "%f", &val[i++]) == 1)
     {
         fscanf(myFile, ",");
@@ -1783,7 +2288,9 @@ float* pxCsvToFloat(const char* path, int* dim)
 *                                                                               *
 * FUNCTION NAME: vSeed	                                                        *
 *                                                                               *
-* PURPOSE: Sets the seed for a random values generator                          *
+* PURPOSE: Sets the seed of the default random values generator, threads       *
+*           that need their own stream must use vRngSeed on a private Rng.      *
+*           The seed is the bit pattern of s, defined for any float             *
 *                                                                               *
 * ARGUMENT LIST:                                                                *
 *                                                                               *
@@ -1794,20 +2301,24 @@ float* pxCsvToFloat(const char* path, int* dim)
 * RETURN VALUE: void                                                            *
 ********************************************************************************/
 
-static float rand_n;
+static Rng rand_n;
+static int rand_seeded = 0;
 void vSeed(const float s)
 {
-    rand_n = s;
+    uint32_t bits;
+
+    memcpy(&bits, &s, sizeof(bits));
+    vRngSeed(&rand_n, bits, 0);
+    rand_seeded = 1;
 }
 
 /********************************************************************************
 *                                                                               *
 * FUNCTION NAME: fRandn                                                          *
 *                                                                               *
-* PURPOSE: Normally distributed random numbers generator that uses a            *
-*           congruent linear algorithm, with c=0, a=16807 and m=2147483647      *
-*           returning -1 if failed,                                             *
-*           the pointer to the value if successfull                             *
+* PURPOSE: Normally distributed random numbers generator, zero mean and unit    *
+*           variance, drawn with the Ziggurat method from the default stream    *
+*           (seed 0 if vSeed has never been called)                             *
 *                                                                               *
 * ARGUMENT LIST:                                                                *
 *                                                                               *
@@ -1819,17 +2330,12 @@ void vSeed(const float s)
 ********************************************************************************/
 float fRandn()
 {
-    if (rand_n > 0)
+    if (!rand_seeded)
     {
-        rand_n = rand_n * 16807;
-        rand_n = fmodf(rand_n, 2147483647);
-        return rand_n;
-    }
-    else
-    {
-        perror("Not a valid seed");
-        return -1;
+        vSeed(0);
     }
+
+    return fRngNormal(&rand_n);
 }
 /********************************************************************************
 *                                                                               *
@@ -1852,3 +2358,48 @@ int uGetHeapUsage()
     return heap_usage;
 
 }
+
+/********************************************************************************
+*                                                                               *
+* FUNCTION NAME: uGetAllocCalls                                                 *
+*                                                                               *
+* PURPOSE: Returns the number of heap allocations made by the library,          *
+*           never decremented, so the difference of two readings gives the      *
+*           allocations made in between                                         *
+*                                                                               *
+* ARGUMENT LIST:                                                                *
+*                                                                               *
+* Argument  Type         IO     Description                                     *
+* --------- --------     --     ---------------------------------               *
+* none                                                                          *
+*                                                                               *
+* RETURN VALUE: unsigned long                                                   *
+********************************************************************************/
+unsigned long uGetAllocCalls()
+{
+
+    return alloc_calls;
+
+}
+
+/********************************************************************************
+*                                                                               *
+* FUNCTION NAME: uGetAllocBytes                                                 *
+*                                                                               *
+* PURPOSE: Returns the bytes requested to the heap by the library,              *
+*           never decremented                                                   *
+*                                                                               *
+* ARGUMENT LIST:                                                                *
+*                                                                               *
+* Argument  Type         IO     Description                                     *
+* --------- --------     --     ---------------------------------               *
+* none                                                                          *
+*                                                                               *
+* RETURN VALUE: unsigned long                                                   *
+********************************************************************************/
+unsigned long uGetAllocBytes()
+{
+
+    return alloc_bytes;
+
+}
@@ -82,15 +82,18 @@
         (retf == 0 ? 0 : (retf < 0 ? -1 : 1)); \
     })
 
+/* Triangle and transposition selectors of iTrsv, iTrsm, iSyrk, iSyr2k */
+#define TRI_LOWER    0
+#define TRI_UPPER    1
+#define TRI_NOTRANS  0
+#define TRI_TRANS    1
+
 /*
 * Matrix Object:
 *       float** being the pointer to the matrix
 *       int c and r are no. of columns and no. of rows
 */
 
-/* Declare Static Variables */
-static int heap_usage = 0;
-
 /* Declare Global Variables */
 
 /*
@@ -145,6 +148,12 @@ int      iRowSwap        (Matrix *, unsigned int, unsigned int);
 int      iReduce         (Matrix *, unsigned int , unsigned int , float);   
 int      iChol           (Matrix*, Matrix *);             
 Matrix*  pxChol          (Matrix*);                       
+int      iTrsv           (Vector*, Matrix *, Vector *, int, int);
+int      iTrsm           (Matrix*, Matrix *, Matrix *, int, int);
+int      iSyrk           (Matrix*, Matrix *, float, float, int);
+int      iSyr2k          (Matrix*, Matrix *, Matrix *, float, float, int);
+int      iTria           (Matrix*, Matrix *);
+int      iCholUpdate     (Matrix*, Matrix *, float);
 int      iLU             (Matrix *, Matrix *, Matrix *);  
 int      iSqrtm          (Matrix*, Matrix *);             
 Matrix*  pxSqrtm         (Matrix*);                       
@@ -159,5 +168,7 @@ float*   pxCsvToFloat    (const char *, int*);
 float    fRandn          ();                              
 void     vSeed           (const float);                   
 int    uGetHeapUsage   ();                              
+unsigned long uGetAllocCalls  ();
+unsigned long uGetAllocBytes  ();
 
 #endif /* matrix_h */
@@ -0,0 +1,478 @@
+/***********************************************************************************
+* This file is part of The AHRS Project.                                           *
+*                                                                                  *
+* Copyright © 2020 By Nicola di Gruttola Giardino. All rights reserved.            *
+* @mail: nicoladgg@protonmail.com                                                  *
+*                                                                                  *
+* AHRS is free software: you can redistribute it and/or modify                     *
+* it under the terms of the GNU General Public License as published by             *
+* the Free Software Foundation, either version 3 of the License, or                *
+* (at your option) any later version.                                              *
+*                                                                                  *
+* AHRS is distributed in the hope that it will be useful,                          *
+* but WITHOUT ANY WARRANTY; without even the implied warranty of                   *
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the                    *
+* GNU General Public License for more details.                                     *
+*                                                                                  *
+* You should have received a copy of the GNU General Public License                *
+* along with The AHRS Project.  If not, see <https://www.gnu.org/licenses/>.       *
+*                                                                                  *
+* In case of use of this project, I ask you to mention me, to whom it may concern. *
+***********************************************************************************/
+
+/****************************************************************************************************
+* FILE NAME: rng.c                                                                                  *
+*                                                                                                   *
+* PURPOSE: This library gives a fast, reproducible, per thread random generator and a Ziggurat      *
+*           sampler to fill Matrix and Vector objects with gaussian noise                           *
+*                                                                                                   *
+* FILE REFERENCES:                                                                                  *
+*                                                                                                   *
+*   Name    I/O     Description                                                                     *
+*   ----    ---     -----------                                                                     *
+*   none                                                                                            *
+*                                                                                                   *
+*                                                                                                   *
+* EXTERNAL VARIABLES:                                                                               *
+*                                                                                                   *
+* Source: <rng.h>                                                                                   *
+*                                                                                                   *
+* Name          Type    IO Description                                                              *
+* ------------- ------- -- -----------------------------                                            *
+*   Rng         Rng        Generator object, contains the 128 bit state                             *
+*                                                                                                   *
+* STATIC VARIABLES:                                                                                 *
+*                                                                                                   *
+*   Name     Type       I/O      Description                                                        *
+*   ----     ----       ---      -----------                                                        *
+*   kn       uint32_t[]          Ziggurat layer thresholds                                          *
+*   wn       float[]             Ziggurat layer widths                                              *
+*   fn       float[]             Ziggurat layer densities                                           *
+*   zig_init int                 1 once the tables have been computed                               *
+*                                                                                                   *
+* EXTERNAL REFERENCES:                                                                              *
+*                                                                                                   *
+*  Name                       Description                                                           *
+*  -------------              -----------                                                           *
+*  none                                                                                             *
+*                                                                                                   *
+* ABNORMAL TERMINATION CONDITIONS, ERROR AND WARNING MESSAGES:                                      *
+*    none, compliant with the standard ISO9899:1999                                                 *
+*                                                                                                   *
+* ASSUMPTIONS, CONSTRAINTS, RESTRICTIONS: the tables are shared by all the streams and are built    *
+*    by the first vRngSeed, seed one generator before starting the worker threads                   *
+*                                                                                                   *
+* NOTES: xoshiro128** by D. Blackman and S. Vigna, Ziggurat by G. Marsaglia and W. W. Tsang         *
+*                                                                                                   *
+* REQUIREMENTS/FUNCTIONAL SPECIFICATIONS REFERENCES:                                                *
+*                                                                                                   *
+* DEVELOPMENT HISTORY:                                                                              *
+*                                                                                                   *
+*   Date          Author            Change Id     Release     Description Of Change                 *
+*   ----          ------            ---------     ------      ----------------------                *
+*   19-10-2026    AHRS Project       1               1         Initial release                      *
+*                                                                                                   *
+****************************************************************************************************/
+
+/* Include Global Parameters */
+
+#include "rng.h"
+
+/* Definition of Macros */
+
+#define ZIG_LAYERS  128
+#define ZIG_R       3.442619855899f       /* start of the right tail */
+#define ZIG_V       9.91256303526217e-3   /* area of every layer */
+
+/* Declare Static Variables */
+
+static uint32_t kn[ZIG_LAYERS];
+static float    wn[ZIG_LAYERS];
+static float    fn[ZIG_LAYERS];
+static int      zig_init = 0;
+
+/* Declare Prototypes */
+
+static uint32_t rotl             (uint32_t, int);
+static uint64_t splitmix64       (uint64_t *);
+static void     zig_setup        (void);
+static float    zig_tail         (Rng *, int32_t, uint32_t);
+
+/********************************************************************************
+*                                                                               *
+* FUNCTION NAME: rotl                                                           *
+*                                                                               *
+* PURPOSE: Rotates left a 32 bit word                                           *
+*                                                                               *
+* ARGUMENT LIST:                                                                *
+*                                                                               *
+* Argument  Type         IO     Description                                     *
+* --------- --------     --     ---------------------------------               *
+* x         uint32_t     I      Word to rotate                                  *
+* k         int          I      Number of bits                                  *
+*                                                                               *
+* RETURN VALUE: uint32_t                                                        *
+********************************************************************************/
+static uint32_t rotl(uint32_t x, int k)
+{
+    return (x << k) | (x >> (32 - k));
+}
+
+/********************************************************************************
+*                                                                               *
+* FUNCTION NAME: splitmix64                                                     *
+*                                                                               *
+* PURPOSE: Expands a 64 bit seed into well mixed words, used only to seed       *
+*                                                                               *
+* ARGUMENT LIST:                                                                *
+*                                                                               *
+* Argument  Type         IO     Description                                     *
+* --------- --------     --     ---------------------------------               *
+* x         uint64_t*    IO     SplitMix state                                  *
+*                                                                               *
+* RETURN VALUE: uint64_t                                                        *
+********************************************************************************/
+static uint64_t splitmix64(uint64_t *x)
+{
+    uint64_t z = (*x += 0x9E3779B97F4A7C15ULL);
+    z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ULL;
+    z = (z ^ (z >> 27)) * 0x94D049BB133111EBULL;
+    return z ^ (z >> 31);
+}
+
+/********************************************************************************
+*                                                                               *
+* FUNCTION NAME: zig_setup                                                      *
+*                                                                               *
+* PURPOSE: Computes the 128 layers Ziggurat tables for the normal density       *
+*                                                                               *
+* ARGUMENT LIST:                                                                *
+*                                                                               *
+* Argument  Type         IO     Description                                     *
+* --------- --------     --     ---------------------------------               *
+* none                                                                          *
+*                                                                               *
+* RETURN VALUE: void                                                            *
+********************************************************************************/
+static void zig_setup(void)
+{
+    const double m1 = 2147483648.0;
+    double dn = ZIG_R;
+    double tn = dn;
+    double q;
+    int    i;
+
+    q = ZIG_V / exp(-0.5 * dn * dn);
+    kn[0] = (uint32_t)((dn / q) * m1);
+    kn[1] = 0;
+    wn[0] = (float)(q / m1);
+    wn[ZIG_LAYERS - 1] = (float)(dn / m1);
+    fn[0] = 1.0f;
+    fn[ZIG_LAYERS - 1] = (float)exp(-0.5 * dn * dn);
+
+    for (i = ZIG_LAYERS - 2; i >= 1; i--)
+    {
+        dn = sqrt(-2.0 * log(ZIG_V / dn + exp(-0.5 * dn * dn)));
+        kn[i + 1] = (uint32_t)((dn / tn) * m1);
+        tn = dn;
+        fn[i] = (float)exp(-0.5 * dn * dn);
+        wn[i] = (float)(dn / m1);
+    }
+
+    zig_init = 1;
+}
+
+/********************************************************************************
+*                                                                               *
+* FUNCTION NAME: vRngSeed                                                       *
+*                                                                               *
+* PURPOSE: Seeds the generator; the same seed with a different stream number    *
+*           gives non overlapping sequences of 2^64 values each, so every       *
+*           thread can own a reproducible stream                                *
+*                                                                               *
+* ARGUMENT LIST:                                                                *
+*                                                                               *
+* Argument  Type         IO     Description                                     *
+* --------- --------     --     ---------------------------------               *
+* r         Rng*         O      Generator to seed                               *
+* seed      uint64_t     I      Seed, any value is valid                        *
+* stream    uint32_t     I      Stream number, e.g. the thread index            *
+*                                                                               *
+* RETURN VALUE: void                                                            *
+********************************************************************************/
+void vRngSeed(Rng *r, uint64_t seed, uint32_t stream)
+{
+    uint64_t sm = seed;
+    uint64_t w;
+    uint32_t i;
+
+    if (!zig_init)
+    {
+        zig_setup();
+    }
+
+    w = splitmix64(&sm);
+    r->s[0] = (uint32_t)w;
+    r->s[1] = (uint32_t)(w >> 32);
+    w = splitmix64(&sm);
+    r->s[2] = (uint32_t)w;
+    r->s[3] = (uint32_t)(w >> 32);
+
+    if ((r->s[0] | r->s[1] | r->s[2] | r->s[3]) == 0)
+    {
+        r->s[0] = 1;
+    }
+
+    for (i = 0; i < stream; i++)
+    {
+        vRngJump(r);
+    }
+}
+
+/********************************************************************************
+*                                                                               *
+* FUNCTION NAME: uRngNext                                                       *
+*                                                                               *
+* PURPOSE: Returns the next 32 uniformly distributed bits                       *
+*                                                                               *
+* ARGUMENT LIST:                                                                *
+*                                                                               *
+* Argument  Type         IO     Description                                     *
+* --------- --------     --     ---------------------------------               *
+* r         Rng*         IO     Generator                                       *
+*                                                                               *
+* RETURN VALUE: uint32_t                                                        *
+********************************************************************************/
+uint32_t uRngNext(Rng *r)
+{
+    uint32_t *s = r->s;
+    const uint32_t result = rotl(s[1] * 5, 7) * 9;
+    const uint32_t t = s[1] << 9;
+
+    s[2] ^= s[0];
+    s[3] ^= s[1];
+    s[1] ^= s[2];
+    s[0] ^= s[3];
+    s[2] ^= t;
+    s[3] = rotl(s[3], 11);
+
+    return result;
+}
+
+/********************************************************************************
+*                                                                               *
+* FUNCTION NAME: vRngJump                                                       *
+*                                                                               *
+* PURPOSE: Advances the generator by 2^64 steps                                 *
+*                                                                               *
+* ARGUMENT LIST:                                                                *
+*                                                                               *
+* Argument  Type         IO     Description                                     *
+* --------- --------     --     ---------------------------------               *
+* r         Rng*         IO     Generator                                       *
+*                                                                               *
+* RETURN VALUE: void                                                            *
+********************************************************************************/
+void vRngJump(Rng *r)
+{
+    static const uint32_t jump[4] = { 0x8764000b, 0xf542d2d3, 0x6fa035c3, 0x77f2db5b };
+    uint32_t s0 = 0;
+    uint32_t s1 = 0;
+    uint32_t s2 = 0;
+    uint32_t s3 = 0;
+    size_t   i;
+    int      b;
+
+    for (i = 0; i < 4; i++)
+    {
+        for (b = 0; b < 32; b++)
+        {
+            if (jump[i] & (1UL << b))
+            {
+                s0 ^= r->s[0];
+                s1 ^= r->s[1];
+                s2 ^= r->s[2];
+                s3 ^= r->s[3];
+            }
+            uRngNext(r);
+        }
+    }
+
+    r->s[0] = s0;
+    r->s[1] = s1;
+    r->s[2] = s2;
+    r->s[3] = s3;
+}
+
+/********************************************************************************
+*                                                                               *
+* FUNCTION NAME: fRngUniform                                                    *
+*                                                                               *
+* PURPOSE: Returns a uniformly distributed value in the open interval (0,1)     *
+*                                                                               *
+* ARGUMENT LIST:                                                                *
+*                                                                               *
+* Argument  Type         IO     Description                                     *
+* --------- --------     --     ---------------------------------               *
+* r         Rng*         IO     Generator                                       *
+*                                                                               *
+* RETURN VALUE: float                                                           *
+********************************************************************************/
+float fRngUniform(Rng *r)
+{
+    return ((float)(uRngNext(r) >> 8) + 0.5f) * (1.0f / 16777216.0f);
+}
+
+/********************************************************************************
+*                                                                               *
+* FUNCTION NAME: zig_tail                                                       *
+*                                                                               *
+* PURPOSE: Slow path of the Ziggurat, taken about 1.2% of the times: samples    *
+*           the wedges by rejection and the tail beyond ZIG_R                   *
+*                                                                               *
+* ARGUMENT LIST:                                                                *
+*                                                                               *
+* Argument  Type         IO     Description                                     *
+* --------- --------     --     ---------------------------------               *
+* r         Rng*         IO     Generator                                       *
+* hz        int32_t      I      Rejected draw                                   *
+* iz        uint32_t     I      Layer of the rejected draw                      *
+*                                                                               *
+* RETURN VALUE: float                                                           *
+********************************************************************************/
+static float zig_tail(Rng *r, int32_t hz, uint32_t iz)
+{
+    float    x;
+    float    y;
+    uint32_t ahz;
+
+    for (;;)
+    {
+        x = (float)hz * wn[iz];
+
+        if (iz == 0)
+        {
+            do
+            {
+                x = -logf(fRngUniform(r)) * (1.0f / ZIG_R);
+                y = -logf(fRngUniform(r));
+            } while (y + y < x * x);
+
+            return (hz > 0) ? (ZIG_R + x) : -(ZIG_R + x);
+        }
+
+        if (fn[iz] + fRngUniform(r) * (fn[iz - 1] - fn[iz]) < expf(-0.5f * x * x))
+        {
+            return x;
+        }
+
+        hz  = (int32_t)uRngNext(r);
+        iz  = (uint32_t)hz & (ZIG_LAYERS - 1);
+        ahz = (hz < 0) ? (0u - (uint32_t)hz) : (uint32_t)hz;
+        if (ahz < kn[iz])
+        {
+            return (float)hz * wn[iz];
+        }
+    }
+}
+
+/********************************************************************************
+*                                                                               *
+* FUNCTION NAME: fRngNormal                                                     *
+*                                                                               *
+* PURPOSE: Returns a normally distributed value, zero mean and unit variance    *
+*                                                                               *
+* ARGUMENT LIST:                                                                *
+*                                                                               *
+* Argument  Type         IO     Description                                     *
+* --------- --------     --     ---------------------------------               *
+* r         Rng*         IO     Generator                                       *
+*                                                                               *
+* RETURN VALUE: float                                                           *
+********************************************************************************/
+float fRngNormal(Rng *r)
+{
+    const int32_t  hz  = (int32_t)uRngNext(r);
+    const uint32_t iz  = (uint32_t)hz & (ZIG_LAYERS - 1);
+    const uint32_t ahz = (hz < 0) ? (0u - (uint32_t)hz) : (uint32_t)hz;
+
+    if (ahz < kn[iz])
+    {
+        return (float)hz * wn[iz];
+    }
+
+    return zig_tail(r, hz, iz);
+}
+
+/********************************************************************************
+*                                                                               *
+* FUNCTION NAME: iRandnMatrix                                                   *
+*                                                                               *
+* PURPOSE: Fills the whole matrix with gaussian noise of the given sigma        *
+*           returning -1 if failed, 0 if successfull                            *
+*                                                                               *
+* ARGUMENT LIST:                                                                *
+*                                                                               *
+* Argument  Type         IO     Description                                     *
+* --------- --------     --     ---------------------------------               *
+* m         Matrix*      O      Pointer to the object to fill                   *
+* r         Rng*         IO     Generator                                       *
+* sigma     float        I      Standard deviation                              *
+*                                                                               *
+* RETURN VALUE: int                                                             *
+********************************************************************************/
+int iRandnMatrix(Matrix *m, Rng *r, float sigma)
+{
+    size_t i;
+    size_t j;
+
+    if (m == NULL || r == NULL)
+    {
+        return -1;
+    }
+
+    for (i = 0; i < m->r; i++)
+    {
+        float *row = m->matrix[i];
+        for (j = 0; j < m->c; j++)
+        {
+            row[j] = sigma * fRngNormal(r);
+        }
+    }
+
+    return 0;
+}
+
+/********************************************************************************
+*                                                                               *
+* FUNCTION NAME: iRandnVector                                                   *
+*                                                                               *
+* PURPOSE: Fills the whole vector with gaussian noise of the given sigma        *
+*           returning -1 if failed, 0 if successfull                            *
+*                                                                               *
+* ARGUMENT LIST:                                                                *
+*                                                                               *
+* Argument  Type         IO     Description                                     *
+* --------- --------     --     ---------------------------------               *
+* v         Vector*      O      Pointer to the object to fill                   *
+* r         Rng*         IO     Generator                                       *
+* sigma     float        I      Standard deviation                              *
+*                                                                               *
+* RETURN VALUE: int                                                             *
+********************************************************************************/
+int iRandnVector(Vector *v, Rng *r, float sigma)
+{
+    size_t i;
+
+    if (v == NULL || r == NULL)
+    {
+        return -1;
+    }
+
+    for (i = 0; i < v->n; i++)
+    {
+        v->vector[i] = sigma * fRngNormal(r);
+    }
+
+    return 0;
+}
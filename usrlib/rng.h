@@ -0,0 +1,78 @@
+/***********************************************************************************
+* This file is part of The AHRS Project.                                           *
+*                                                                                  *
+* Copyright © 2020 By Nicola di Gruttola Giardino. All rights reserved.            *
+* @mail: nicoladgg@protonmail.com                                                  *
+*                                                                                  *
+* AHRS is free software: you can redistribute it and/or modify                     *
+* it under the terms of the GNU General Public License as published by             *
+* the Free Software Foundation, either version 3 of the License, or                *
+* (at your option) any later version.                                              *
+*                                                                                  *
+* AHRS is distributed in the hope that it will be useful,                          *
+* but WITHOUT ANY WARRANTY; without even the implied warranty of                   *
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the                    *
+* GNU General Public License for more details.                                     *
+*                                                                                  *
+* You should have received a copy of the GNU General Public License                *
+* along with The AHRS Project.  If not, see <https://www.gnu.org/licenses/>.       *
+*                                                                                  *
+* In case of use of this project, I ask you to mention me, to whom it may concern. *
+***********************************************************************************/
+
+/***************************************************************************************************
+*   FILENAME:  rng.h                                                                               *
+*                                                                                                  *
+*                                                                                                  *
+*   PURPOSE:   Library that defines the object Rng, a xoshiro128** pseudo random generator,        *
+*               and a Ziggurat sampler for normally distributed noise                              *
+*                                                                                                  *
+*                                                                                                  *
+*   GLOBAL VARIABLES:                                                                              *
+*                                                                                                  *
+*                                                                                                  *
+*   Variable        Type        Description                                                        *
+*   --------        ----        -------------------                                                *
+*   Rng             Rng         Generator object, contains the 128 bit state.                      *
+*                                Every thread must own its Rng, streams seeded with the same       *
+*                                seed and a different stream number never overlap                  *
+*                                                                                                  *
+*   DEVELOPMENT HISTORY :                                                                          *
+*                                                                                                  *
+*                                                                                                  *
+*   Date          Author            Change Id     Release     Description Of Change                *
+*   ----          ------            -------- -    ------      ----------------------               *
+*   19-10-2026    AHRS Project       1               1         Initial release, replaces the       *
+*                                                               LCG behind fRandn                  *
+*                                                                                                  *
+***************************************************************************************************/
+
+#ifndef RNG_h
+#define RNG_h
+
+/* Include Global Parameters */
+
+#include <stdint.h>
+#include "matrix.h"
+
+/*
+* Rng Object:
+*       uint32_t s[4] being the xoshiro128** state, must never be all zeros
+*/
+
+typedef struct Rng
+{
+    uint32_t s[4];
+}Rng;
+
+/* Declare Prototypes */
+
+void     vRngSeed        (Rng *, uint64_t, uint32_t);
+void     vRngJump        (Rng *);
+uint32_t uRngNext        (Rng *);
+float    fRngUniform     (Rng *);
+float    fRngNormal      (Rng *);
+int      iRandnMatrix    (Matrix *, Rng *, float);
+int      iRandnVector    (Vector *, Rng *, float);
+
+#endif /* RNG_h */
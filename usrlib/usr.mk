@@ -4,14 +4,58 @@ USRLIB = ./usrlib
 # List of all the Userlib device files.
 USRSRC := $(USRLIB)/IMU.c \
 		  $(USRLIB)/Kalman.c \
+		  $(USRLIB)/KalmanGen_CV2.c \
+		  $(USRLIB)/KalmanBatch.c \
+		  $(USRLIB)/ESKF.c \
+		  $(USRLIB)/UKF.c \
+		  $(USRLIB)/KalmanHistory.c \
+		  $(USRLIB)/KalmanSmoother.c \
+		  $(USRLIB)/KalmanIMM.c \
+		  $(USRLIB)/KalmanInfo.c \
+		  $(USRLIB)/Checkpoint.c \
+		  $(USRLIB)/Probe.c \
 		  $(USRLIB)/MadgwickAHRS.c \
-		  $(USRLIB)/matrices.c  \
+		  $(USRLIB)/matrix.c  \
+		  $(USRLIB)/rng.c  \
 		  $(USRLIB)/GPS_Lib.c
 					
 
 # Required include directories
 USRINC := $(USRLIB)
 
+# Kalman filters of IMU.c frozen at their steady-state gain after setup
+ifeq ($(USE_KALMAN_STEADY_STATE),yes)
+  USRDEFS += -DUSE_KALMAN_STEADY_STATE
+endif
+
+# Kalman filters of IMU.c propagating the Cholesky factor of P (square-root form)
+ifeq ($(USE_KALMAN_SQRT),yes)
+  USRDEFS += -DUSE_KALMAN_SQRT
+endif
+
+# Number of models of the IMM bank of KalmanIMM.c, 3 if not set
+ifneq ($(KALMAN_IMM_MODELS),)
+  USRDEFS += -DKALMAN_IMM_MODELS=$(KALMAN_IMM_MODELS)
+endif
+
+# Warm start: attitude and filter state saved to the backup SRAM every 10 s
+ifeq ($(USE_CHECKPOINT),yes)
+  USRDEFS += -DUSE_CHECKPOINT
+endif
+
+# Timing probes of the AHRS phases, min/mean/max/p99 printed on SD3 every 10 s
+ifeq ($(USE_PROBES),yes)
+  USRDEFS += -DUSE_PROBES
+endif
+
+# Matrix microbenchmark, printed on SD3 at boot in DWT cycles
+ifeq ($(USE_MATRIX_BENCH),yes)
+  USRSRC  += ./bench/matrix_bench.c
+  USRSRC  += ./bench/bench_report.c
+  USRINC  += ./bench
+  USRDEFS += -DUSE_MATRIX_BENCH -DBENCH_NO_MAIN
+endif
+
 # Shared variables
 ALLCSRC += $(USRSRC)
 ALLINC  += $(USRINC)
\ No newline at end of file